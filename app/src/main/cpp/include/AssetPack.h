@@ -0,0 +1,82 @@
+#ifndef __ARKANOID_ASSET_PACK__H__
+#define __ARKANOID_ASSET_PACK__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace native {
+
+enum class AssetFormat : uint32_t {
+  UNKNOWN = 0, PNG = 1, WAV = 2
+};
+
+/// @brief Header at the beginning of pack, little-endian.
+struct AssetPackHeader {
+  char magic[4];          //!< "ARKP"
+  uint32_t version;
+  uint32_t count;         //!< Number of entries in index.
+  uint32_t index_offset;  //!< Offset of index, sorted by hash and name.
+  uint32_t names_offset;  //!< Offset of names, not null-terminated.
+  uint32_t page_size;     //!< Alignment of payloads.
+};
+
+/// @brief Single entry of pack index.
+struct AssetPackEntry {
+  uint32_t hash;  //!< AssetPack::hash() of name.
+  uint32_t name_offset;  //!< Relative to names_offset.
+  uint32_t name_length;
+  uint32_t format;  //!< AssetFormat.
+  uint32_t offset;  //!< Offset of payload, multiple of page_size.
+  uint32_t size;
+};
+
+/**
+ * @class AssetPack AssetPack.h "include/AssetPack.h"
+ * @brief Read-only view of assets packed into single file, so that the file
+ * is opened and mapped once and assets are accessed as slices of it.
+ * @details Assets are looked up by full name (e.g. "sound/bite_1.wav") with
+ * binary search over hashes. Packs are built by tools/assetpack.
+ */
+class AssetPack {
+public:
+  typedef std::shared_ptr<AssetPack> Ptr;
+  typedef std::function<void ()> Release;
+
+  constexpr static const char* filename = "assets.pack";
+  constexpr static uint32_t version = 1;
+  constexpr static uint32_t pageSize = 4096;
+
+  /// @param release Called on destruction, to release mapping of @a data.
+  AssetPack(const void* data, size_t size, Release release);
+  virtual ~AssetPack() noexcept;
+
+  /// @brief Whether header and index are consistent with size of pack.
+  bool isValid() const;
+  size_t getCount() const;
+  const AssetPackEntry& getEntry(size_t index) const;
+  std::string getName(const AssetPackEntry& entry) const;
+  /// @brief Finds content of asset without copying.
+  /// @return Whether asset is present.
+  bool find(const char* name, const uint8_t** data, size_t* size) const;
+
+  /// @brief FNV-1a hash of name.
+  static uint32_t hash(const char* name, size_t length);
+  /// @brief Format of asset by its extension.
+  static AssetFormat getFormat(const std::string& name);
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  Release m_release;
+  const AssetPackHeader* m_header;
+  const AssetPackEntry* m_index;
+  const char* m_names;
+  bool m_is_valid;
+};
+
+}
+
+#endif  // __ARKANOID_ASSET_PACK__H__
@@ -30,25 +30,47 @@
 #define SURFACE3D_ASSETSTORAGE_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <jni.h>
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
+#include "AssetPack.h"
 
 class AssetStorage {
 public:
   typedef std::shared_ptr<AssetStorage> Ptr;
 
   AssetStorage(JNIEnv* jenv, const jobject& assetManager);
+  /// @brief Creates independent reader sharing the same asset manager
+  /// and pack, so that assets could be read concurrently from different threads.
+  AssetStorage(const AssetStorage& other);
+  AssetStorage& operator = (const AssetStorage& rhs) = delete;
   virtual ~AssetStorage();
 
   const char* getName() const;
   const char* getInternalFileStorage() const;
   void setInternalFileStorage(const char* path);
 
+  /// @brief Maps pack of assets, if present, so that assets are read
+  /// from it rather than opened one by one.
+  bool openPack();
+  bool hasPack() const;
+  /// @brief Lists names of assets within directory, from pack if present.
+  std::vector<std::string> list(const char* directory) const;
+
   bool open(const char* asset_filename);
   void close();
   bool read(void* buffer);
   bool read(void* buffer, size_t size);
+
+  /// @brief Opens asset for direct access to its content without copying,
+  /// independently of open() / close().
+  /// @param data Output pointer to content, valid until unmap().
+  /// @param asset Output asset to unmap, nullptr for slice of pack.
+  /// @return Whether asset has been mapped.
+  bool map(const char* asset_filename, const void** data, off_t* length, AAsset** asset) const;
+  static void unmap(AAsset* asset);
   inline off_t length() const {
     return m_length;
   }
@@ -59,6 +81,9 @@ private:
   off_t m_length;
   AAssetManager* m_manager;
   AAsset* m_asset;
+  native::AssetPack::Ptr m_pack;  //!< Shared by copies, mapped once.
+  const uint8_t* m_slice;  //!< Opened asset within pack, if any.
+  off_t m_position;
 };
 
 #endif /* SURFACE3D_ASSETSTORAGE_H_ */
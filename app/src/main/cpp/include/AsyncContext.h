@@ -22,16 +22,20 @@
 #include "ActiveObject.h"
 #include "Ball.h"
 #include "Bite.h"
+#include "BlockChangeBatch.h"
 #include "ExplosionPackage.h"
 #include "LaserPackage.h"
 #include "Level.h"
 #include "LevelDimens.h"
+#include "LevelPreloader.h"
 #include "Prize.h"
 #include "PrizePackage.h"
+#include "Renderer.h"
 #include "Resources.h"
 #include "rgbstruct.h"
 #include "RowCol.h"
-#include "Shader.h"
+#include "TextureLoader.h"
+#include "TouchRing.h"
 
 namespace game {
 
@@ -58,8 +62,9 @@ public:
   /// @brief Called when load resources requested.
   void callback_loadResources(bool /* dummy */);
   /// @brief Called when user makes a motion gesture within the surface.
-  /// @param distance Distance the user's pointer has passed.
-  void callback_shiftGamepad(float distance);
+  /// @param samples Timestamped positions of user's pointer, including
+  /// historical ones, in order. Lock-free, samples are applied at frame time.
+  void callback_shiftGamepad(const TouchSample* samples, size_t count);
   /// @brief Called when user sends a command to throw a ball.
   void callback_throwBall(float angle /* dummy */);
   /// @brief Called when user requests a level to be loaded
@@ -70,14 +75,13 @@ public:
   void callback_lostBall(game::BallLost status);
   /// @brief Called when ball has been stopped.
   void callback_stopBall(bool /* dummy */);
-  /// @brief Called when block has been impacted.
-  void callback_blockImpact(RowCol block);
+  /// @brief Called when new version of level has been published.
+  void callback_levelChanged(LevelVersion version);
   /// @brief Called when level has been successfully finished.
   void callback_levelFinished(bool is_finished);
-  /// @brief Called when requested to draw particle system explosion.
-  void callback_explosion(ExplosionPackage package);
-  /// @brief Called when prize has been generated.
-  void callback_prizeReceived(PrizePackage package);
+  /// @brief Called when explosions have been requested and prizes have been
+  /// generated within single tick.
+  void callback_blockChanged(BlockChangeBatch::Ptr batch);
   /// @brief Called when prize has been caught.
   void callback_prizeCaught(PrizePackage package);
   /// @brief Called when drop ball's appearance to standard has been requested.
@@ -90,12 +94,18 @@ public:
   void callback_laserBlockImpact(bool /* dummy */);
   /// @brief Called when delay request has been issued.
   void callback_delayRequested(bool /* dummy */);
+  /// @brief Called from worker thread when texture has been decoded.
+  void callback_textureDecoded();
   /** @} */  // end of Callbacks group
 
+  /// @brief Enables extrapolation of rendered bite along the motion, see BiteParams::predictionHorizon.
+  inline void setBitePrediction(bool enabled) { m_bite_prediction.store(enabled); }
+
   /** @defgroup GameStat Get game statistics
    * @{
    */
   /// @brief Gets current state of last loaded level.
+  /// @note Returned level is an immutable snapshot and must not be modified.
   Level::Ptr getCurrentLevelState();
   /** @} */  // end of GameStat group
 
@@ -104,6 +114,9 @@ public:
    */
   /// @brief Sets the pointer to external resources.
   void setResourcesPtr(Resources* resources);
+  /// @brief Sets preloader of next level, geometry of level is taken
+  /// from it on load if ready.
+  void setLevelPreloader(LevelPreloader* preloader);
   /** @} */  // end of Resources group
 
 // ----------------------------------------------
@@ -125,6 +138,7 @@ public:
    */
   inline void setMasterObject(jobject object) { master_object = object; }
   inline void setOnErrorTextureLoadMethodID(jmethodID id) { fireJavaEvent_errorTextureLoad_id = id; }
+  inline void setOnTextureLoadProgressMethodID(jmethodID id) { fireJavaEvent_textureLoadProgress_id = id; }
   /** @} */  // end of JNIEnvironment group
 
 // ----------------------------------------------
@@ -137,8 +151,6 @@ public:
   EventListener<ANativeWindow*> surface_received_listener;
   /// @brief Listens for load resources request.
   EventListener<bool> load_resources_listener;
-  /// @brief Listens for event which occurs when user performs a motion gesture.
-  EventListener<float> shift_gesture_listener;
   /// @brief Listens for event which occurs when user sends throw ball command.
   EventListener<float> throw_ball_listener;
   /// @brief Listens for event which occurs when user requests a level to be loaded.
@@ -149,14 +161,12 @@ public:
   EventListener<BallLost> lost_ball_listener;
   /// @brief Listens for event which occurs when ball has been stopped.
   EventListener<bool> stop_ball_listener;
-  /// @brief Listens for event which occurs when block has been impacted.
-  EventListener<RowCol> block_impact_listener;
+  /// @brief Listens for event which occurs when new version of level has been published.
+  EventListener<LevelVersion> level_changed_listener;
   /// @brief Listens for event which occurs when level has been successfully finished.
   EventListener<bool> level_finished_listener;
-  /// @brief Listens for event which occurs when particle system explosion has been requested.
-  EventListener<ExplosionPackage> explosion_listener;
-  /// @brief Listens for event which occurs when prize has been generated.
-  EventListener<PrizePackage> prize_listener;
+  /// @brief Listens for event which occurs when blocks have changed within single tick.
+  EventListener<BlockChangeBatch::Ptr> block_change_listener;
   /// @brief Listens for event which occurs when prize has been caught.
   EventListener<PrizePackage> prize_caught_listener;
   /// @brief Listens for event which drop ball's appearance to standard has been requested.
@@ -200,6 +210,7 @@ private:
   JNIEnv* m_jenv;  //!< Pointer to environment local within this thread.
   jobject master_object;
   jmethodID fireJavaEvent_errorTextureLoad_id;
+  jmethodID fireJavaEvent_textureLoadProgress_id;
   /** @} */  // end of JNIEnvironment group
 
   jint m_fdn;  //!< delay between sequential frames (in nanos)
@@ -224,46 +235,23 @@ private:
   /** @defgroup LogicData Game logic related data members.
    * @{
    */
-  constexpr static int particleSize = 5;
-  constexpr static int particleSystemSize = 1000;
-
-  constexpr static int particleSpiralSize = 4;
-  constexpr static int particeSpiralSystemBranches = 4;
-  constexpr static int particleSpiralSystemBranchSize = 100;
-  constexpr static int particleSpiralSystemSize = particleSpiralSystemBranchSize * particeSpiralSystemBranches;
-
-  GLfloat m_position;  //!< Last received position value of user's motion gesture.
+  TouchRing m_touch_ring;  //!< Samples of user's motion gesture pending to be applied.
+  TouchSample m_touch_samples[TouchRing::capacity];  //!< Re-usable buffer for drained samples.
+  int64_t m_touch_time;  //!< Time of the last applied sample (in nanos).
+  GLfloat m_touch_velocity;  //!< Velocity of bite along the last batch (per nano).
+  std::atomic_bool m_bite_prediction;  //!< Whether rendered bite is extrapolated.
+  GLfloat m_bite_rendered_x;  //!< Position of bite drawn by renderer.
   Bite m_bite;  //!< Physical bite's representation.
   BiteEffect m_bite_effect;  //!< Changed width of bite due to prize.
   Ball m_ball;  //!< Physical ball's representation.
   bool m_ball_inited;  //!< Indicated that ball init measurement has finished.
-  std::queue<RowCol> m_impact_queue;  //!< Queue of impacted blocks' indices.
-
-  GLfloat* m_bite_vertex_buffer;  //!< Re-usable buffer for vertices of bite.
-  GLfloat* m_bite_color_buffer;   //!< Re-usable buffer for colors of bite.
-  GLfloat* m_ball_vertex_buffer;  //!< Re-usable buffer for vertices of ball.
-  GLfloat* m_ball_color_buffer;   //!< Re-usable buffer for color of ball.
-  GLfloat* m_bg_vertex_buffer;    //!< Re-usable buffer for background vertices.
-  GLfloat* m_particle_diverge_buffer;    //!< Re-usable buffer for diverging particle system.
-  GLfloat* m_particle_converge_buffer;   //!< Re-usable buffer for converging particle system.
-  GLfloat* m_particle_spiral_buffer;     //!< Re-usable buffer for particle spiral system.
-  GLfloat* m_particle_vacuum_buffer;     //!< Re-usable buffer for particle vacuum system.
-  GLushort* m_rectangle_index_buffer;    //!< Re-usable buffer for indices of rectangle.
-  GLushort* m_octagon_index_buffer;      //!< Re-usable buffer for indices of octagon.
-  GLfloat* m_rectangle_texCoord_buffer;  //!< Re-usable buffer for texture coords of rectangle.
-
-  Level::Ptr m_level;  //!< Last loaded game level.
-  GLfloat* m_level_vertex_buffer;  //!< Re-usable buffer for vertices of level.
-  GLfloat* m_level_color_buffer;   //!< Re-usable buffer for colors of level.
-  GLushort* m_level_index_buffer;  //!< Re-usable buffer for indices of level's blocks.
-
-  std::default_random_engine m_generator;
-  std::uniform_real_distribution<float> m_particle_distribution;
-  std::normal_distribution<float> m_particle_normal_distribution;
-  clock_t m_last_time;
-  float m_particle_time;
-  bool m_render_explosion;
-  std::vector<ExplosionPackage> m_explosion_packages;
+  std::queue<LevelVersion> m_level_versions;  //!< Published versions of level pending to be applied.
+
+  Level::Ptr m_level;  //!< Latest applied version of loaded level, never modified.
+  Level::Ptr m_level_origin;  //!< Level as it was loaded, versions of other levels are dropped.
+  uint32_t m_level_version;  //!< Number of latest applied version.
+  Renderer m_renderer;  //!< Draw routines and GL objects of current context.
+  std::vector<ExplosionPackage> m_explosion_packages;  //!< Explosions pending to be spawned.
 
   std::unordered_map<int, PrizePackage> m_prize_packages;
   std::unordered_map<int, clock_t> m_prize_last_timers;
@@ -281,32 +269,18 @@ private:
   bool m_laser_interruption;
   /** @} */  // end of LogicData group
 
-  /** @defgroup Shaders Shaders for rendering game components.
-   * @{
-   */
-  shader::ShaderHelper::Ptr m_level_shader;
-  shader::ShaderHelper::Ptr m_bite_shader;
-  shader::ShaderHelper::Ptr m_ball_shader;
-  shader::ShaderHelper::Ptr m_explosion_shader;
-  shader::ShaderHelper::Ptr m_sample_shader;
-  shader::ShaderHelper::Ptr m_prize_shader;
-  shader::ShaderHelper::Ptr m_prize_catch_shader;
-  shader::ShaderHelper::Ptr m_laser_shader;
-  /** @} */  // end of Shaders group
-
   /** @defgroup Mutex Thread-safety variables
    * @{
    */
   std::mutex m_jnienvironment_mutex;  //!< Sentinel for thread attach to JVM.
   std::mutex m_surface_mutex;  //!< Sentinel for window setting.
   std::mutex m_load_resources_mutex;  //!< Sentinel for load resources.
-  std::mutex m_shift_gamepad_mutex;  //!< Sentinel for shifting gesture event.
   std::mutex m_throw_ball_mutex;  //!< Sentinel for throw ball user command.
   std::mutex m_load_level_mutex;  //!< Sentinel for load level user request.
   std::mutex m_move_ball_mutex;  //!< Sentinel for move ball to a new position.
   std::mutex m_lost_ball_mutex;  //!< Sentinel for lost ball flag.
   std::mutex m_stop_ball_mutex;
-  std::mutex m_block_impact_mutex;  //!< Sentinel for block impact event.
+  std::mutex m_level_changed_mutex;  //!< Sentinel for published versions of level.
   std::mutex m_level_finished_mutex;  //!< Sentinel for level has been successfully finished.
   std::mutex m_explosion_mutex;  //!< Sentinel for particle system explosion.
   std::mutex m_prize_mutex;  //!< Sentinel for prize receiving.
@@ -316,6 +290,7 @@ private:
   std::mutex m_laser_beam_visibility_mutex;
   std::mutex m_laser_block_impact_mutex;
   std::mutex m_delay_request_mutex;
+  std::mutex m_texture_decoded_mutex;  //!< Sentinel for decoded textures pending upload.
   std::atomic_bool m_surface_received;  //!< Window has been set.
   std::atomic_bool m_load_resources_received;  //!< Load resources requested.
   std::atomic_bool m_shift_gamepad_received;  //!< Shift gesture has occurred.
@@ -324,7 +299,7 @@ private:
   std::atomic_bool m_move_ball_received;  //!< Move ball event has been received.
   std::atomic_bool m_lost_ball_received;  //!< Ball has been lost received.
   std::atomic_bool m_stop_ball_received;
-  std::atomic_bool m_block_impact_received;  //!< Block impact has been received.
+  std::atomic_bool m_level_changed_received;  //!< New version of level has been received.
   std::atomic_bool m_level_finished_received;  //!< Level has been successfully finished.
   std::atomic_bool m_explosion_received;  //!< Request for explosion received.
   std::atomic_bool m_prize_received;  //!< Prize has been received.
@@ -334,6 +309,7 @@ private:
   std::atomic_bool m_laser_beam_visibility_received;
   std::atomic_bool m_laser_block_impact_received;
   std::atomic_bool m_delay_request_received;
+  std::atomic_bool m_texture_decoded_received;  //!< Decoded textures are pending upload.
   /** @} */  // end of Mutex group
 
   /** @defgroup SafetyFlag Logic-safety variables
@@ -346,7 +322,11 @@ private:
    * @{
    */
   Resources* m_resources;
-  const native::Texture* m_bg_texture;
+  LevelPreloader* m_preloader;
+  /// @brief Decodes textures on worker threads. Declared after mutexes and flags,
+  /// so that workers are joined before those are destroyed.
+  native::TextureLoader m_texture_loader;
+  constexpr static int textureUploadBudget = 4;  //!< Time (in ms) for texture upload per frame.
   /** @} */  // end of Resources group
 
 // ----------------------------------------------
@@ -387,8 +367,8 @@ private:
   void process_lostBall();
   /// @brief Processing when ball has been stopped.
   void process_stopBall();
-  /// @brief Performs visual block impact.
-  void process_blockImpact();
+  /// @brief Applies cells changed in published versions of level.
+  void process_levelChanged();
   /// @brief Performs visual level finalization.
   void process_levelFinished();
   /// @brief Performs visual particle system explosion.
@@ -407,6 +387,9 @@ private:
   void process_laserBlockImpact();
   /// @brief Performs delay to play visual effect without disturbance.
   void process_delayRequested();
+  /// @brief Uploads decoded textures into Graphic memory within time budget
+  /// and reports load progress to Java layer.
+  void process_textureDecoded();
   /** @} */  // end of Processors group
 
 private:
@@ -420,6 +403,9 @@ private:
   /// @param silent If set to TRUE, bite will be moved w/o notification event.
   /// @note Position should be within [-1, 1] segment.
   void moveBite(float position, bool silent = false);
+  /// @brief Extrapolates rendered bite along recent motion of user's pointer,
+  /// physical bite is intact.
+  void predictBite();
   /// @brief Sets the ball into shifted state.
   /// @param x_position Normalized position along X axis the ball should move at.
   /// @param y_position Normalized position along Y axis the ball should move at.
@@ -431,14 +417,8 @@ private:
   void clearRemovedPrizes();
   /// @brief Clean-up prize structures and counters.
   void clearPrizeStructures();
-  /// @brief Checks whether specified block is present in current level.
-  /// @return TRUE is block is present in newly loaded level, FALSE otherwise.
-  /// @detail This allows to avoid crash when load level event is followed by
-  /// block impact event, but it's processing is performed before the former's
-  /// processing due to asynchronous event handling.
-  bool checkBlockPresense(int row, int col);
-  /// @brief Sets bite's and ball's appearance according to current ball's effect.
-  void setBiteBallAppearance(BallEffect effect);
+  /// @brief Chooses another background, which is loaded unless it's resident.
+  void changeBackground();
   /** @} */  // end of LogicFunc group
 
 private:
@@ -448,42 +428,23 @@ private:
   /// @brief Configures rendering surface, context and display.
   /// @return false in case of error, true in case of success.
   bool displayConfig();
-  /// @brief Sets gl options for already prepared context.
-  /// @note Different contexts could have different gl options.
-  void glOptionsConfig();
   /// @brief Releases surface, context and display resources.
   void destroyDisplay();
   /// @brief Render a frame.
   void render();
-  /// @brief Initializes particle system.
-  void initParticleSystem();
   /// @brief Continue rendering for specified delay in ms.
   /// @param ms Time in ms.
   void delay(int ms);
   /** @} */  // end of GraphicsContext group
 
-  /** @defgroup Drawings Draw routines.
+  /** @defgroup Drawings Animations of sprites, drawn by Renderer.
    * @{
    */
-  /// @brief Draws current level's state.
-  void drawLevel();
-  /// @brief Draws block of current level.
-  void drawBlock(int row, int col);
-  /// @brief Draws textured block of current level,
-  void drawTexturedBlock(int row, int col, const std::string& texture);
-  /// @brief Draws bite at it's current position.m_load_resources_received
-  void drawBite();
-  /// @brief Draws ball at it's current position.
-  void drawBall();
-  /// @brief Draws particle system explosion.
-  void drawExplosion(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, Kind kind);
-  /// @brief Draws textured background.
-  void drawBackground();
-  /// @brief Draws prize of specified type at given location.
+  /// @brief Advances falling prize, notifies its location and draws it.
   void drawPrize(const PrizePackage& prize);
-  /// @brief Draws prize catch animation.
+  /// @brief Advances and draws prize catch animation.
   void drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra);
-  /// @brief Draws laser sprite originated at specified point.
+  /// @brief Advances laser beam originated at specified point, notifies its location and draws it.
   void drawLaser(GLfloat x, GLfloat y);
   /** @} */  // end of Drawings group
 };
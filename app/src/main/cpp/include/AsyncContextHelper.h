@@ -74,10 +74,18 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadResourc
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
  * Method:    shiftGamepad
- * Signature: (JF)V
+ * Signature: (J[F[JI)V
  */
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_shiftGamepad
-  (JNIEnv *, jobject, jlong, jfloat);
+  (JNIEnv *, jobject, jlong, jfloatArray, jlongArray, jint);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    setBitePrediction
+ * Signature: (JZ)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBitePrediction
+  (JNIEnv *, jobject, jlong, jboolean);
 
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
@@ -97,6 +105,25 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_throwBall
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
   (JNIEnv *, jobject, jlong, jobjectArray);
 
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevelFromPack
+  (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    preloadLevel
+ * Signature: (JI[Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_preloadLevel
+  (JNIEnv *, jobject, jlong, jint, jobjectArray);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    preloadLevelFromPack
+ * Signature: (JI)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_preloadLevelFromPack
+  (JNIEnv *, jobject, jlong, jint);
+
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
  * Method:    saveLevel
@@ -105,6 +132,54 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
 JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
   (JNIEnv *, jobject, jlong);
 
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    saveState
+ * Signature: (JZ)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveState
+  (JNIEnv *, jobject, jlong, jboolean);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    restoreState
+ * Signature: (J[B)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_restoreState
+  (JNIEnv *, jobject, jlong, jbyteArray);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    getUiState
+ * Signature: (J)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getUiState
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    startRecording
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_startRecording
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    stopRecording
+ * Signature: (J)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_stopRecording
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    nativeReplayState
+ * Signature: ([BI)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_nativeReplayState
+  (JNIEnv *, jclass, jbyteArray, jint);
+
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
  * Method:    setBonusBlocks
@@ -136,10 +211,14 @@ JNIEXPORT jint JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getScore
 
 /* Core */
 // ----------------------------------------------------------------------------
+#include <vector>
+
 #include "AsyncContext.h"
 #include "GameProcessor.h"
+#include "LevelPreloader.h"
 #include "PrizeProcessor.h"
 #include "SoundProcessor.h"
+#include "UiState.h"
 
 /**
  * @class AsyncContextHelper AsyncContext.h "include/AsyncContext.h"
@@ -168,23 +247,32 @@ struct AsyncContextHelper {
   /// @brief Shared pointer to an instance of sound processor thread.
   native::sound::SoundProcessor::Ptr sound_processor;
 
+  /// @brief Pointer to external resources, levels are loaded from them.
+  game::Resources* resources;
+
+  /// @brief Loads next level in background, see preloadLevel().
+  game::LevelPreloader* level_preloader;
+
+  /// @brief Block of frequently updated values polled by UI, see getUiState().
+  game::UiState ui_state;
+
+  /// @brief Payload of the last saved or restored snapshot, deltas are made against it.
+  std::vector<uint8_t> snapshot_base;
+
   /** @defgroup AsyncContextEvent Events coming to render thread from outside.
    * @{
    */
   Event<ANativeWindow*> surface_received_event;  //!< When surface has been prepared.
   Event<bool> load_resources_event;  //!< Requested load resources.
-  Event<float> shift_gesture_event;  //!< When user does a motion gesture.
   Event<float> throw_ball_event;  //<! When user sends a throw ball command.
   Event<game::Level::Ptr> load_level_event;  //<! When user's requested to load level.
+  Event<game::Level::Ptr> preload_level_event;  //<! When next level has been preloaded.
   /** @} */  // end of AsyncContextEvent group
 
   jmethodID fireJavaEvent_lostBall_id;
   jmethodID fireJavaEvent_levelFinished_id;
-  jmethodID fireJavaEvent_scoreUpdated_id;
-  jmethodID fireJavaEvent_angleChanged_id;
-  jmethodID fireJavaEvent_cardinalityChanged_id;
-  jmethodID fireJavaEvent_prizeCatch_id;
   jmethodID fireJavaEvent_errorTextureLoad_id;
+  jmethodID fireJavaEvent_textureLoadProgress_id;
   jmethodID fireJavaEvent_errorSoundLoad_id;
   jmethodID fireJavaEvent_debugMessage_id;
 
@@ -0,0 +1,99 @@
+#ifndef __ARKANOID_AUDIO_SINK__H__
+#define __ARKANOID_AUDIO_SINK__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace native {
+namespace sound {
+
+/**
+ * @class AudioSink AudioSink.h "include/AudioSink.h"
+ * @brief Output stream of mono 16-bit PCM, which pulls samples
+ * from render callback whenever it needs more data.
+ */
+class AudioSink {
+public:
+  /// @brief Fills buffer with given number of frames.
+  typedef std::function<void(int16_t* buffer, size_t frames)> RenderCallback;
+
+  virtual ~AudioSink() {}
+
+  /// @brief Starts streaming, @a render is called from thread owned by sink.
+  virtual bool start(RenderCallback render) = 0;
+  /// @brief Stops streaming, render callback is not called after return.
+  virtual void stop() = 0;
+};
+
+/**
+ * @class NullSink AudioSink.h "include/AudioSink.h"
+ * @brief Sink without audio device: pulls samples on its own thread
+ * and drops them, either at pace of playback or as fast as possible.
+ * @details Lets mixer run headless, e.g. on host or when output stream
+ * couldn't be created.
+ */
+class NullSink : public AudioSink {
+public:
+  constexpr static size_t bufferFrames = 1024;  //!< ~23 ms at 44.1 kHz.
+  constexpr static uint32_t sampleRate = 44100;
+
+  /// @param realtime Pulls a buffer per its playback time, if TRUE.
+  explicit NullSink(bool realtime = true);
+  virtual ~NullSink();
+
+  bool start(RenderCallback render) override;
+  void stop() override;
+  /// @brief Total frames rendered since start().
+  inline size_t getRenderedFrames() const { return m_rendered_frames.load(); }
+
+protected:
+  /// @brief Receives rendered buffer, called from thread of sink.
+  virtual void consume(const int16_t* buffer, size_t frames);
+
+private:
+  /// @brief Renders buffers until stopped.
+  void loop();
+
+  bool m_realtime;
+  std::atomic_bool m_is_running;
+  std::atomic<size_t> m_rendered_frames;
+  std::thread m_thread;
+  RenderCallback m_render;
+  std::vector<int16_t> m_buffer;
+};
+
+/**
+ * @class WavFileSink AudioSink.h "include/AudioSink.h"
+ * @brief Sink writing rendered samples into WAV file, for offline
+ * inspection of mixed output.
+ */
+class WavFileSink : public NullSink {
+public:
+  /// @param realtime See NullSink, file is written as fast as possible by default.
+  explicit WavFileSink(const char* filepath, bool realtime = false);
+  virtual ~WavFileSink();
+
+  /// @brief Creates file, replacing existing one.
+  bool start(RenderCallback render) override final;
+  /// @brief Stops rendering and completes header of file.
+  void stop() override final;
+
+protected:
+  void consume(const int16_t* buffer, size_t frames) override final;
+
+private:
+  std::string m_filepath;
+  FILE* m_file;
+  uint32_t m_data_size;  //!< Bytes of samples written so far.
+};
+
+}  // namespace sound
+}  // namespace native
+
+#endif  // __ARKANOID_AUDIO_SINK__H__
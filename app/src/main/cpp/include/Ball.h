@@ -22,6 +22,7 @@ enum class BallEffect : int {
   DEGRADE = 11,  //! block effect
   ZYGOTE = 12
 };
+constexpr int totalBallEffects = 13;  // NONE included
 
 enum class BallLost : int {
   NONE = 0,
@@ -51,6 +52,7 @@ public:
   inline void fastSpeed() { m_velocity = BallParams::ballFastSpeed; }
   inline void normalSpeed() { m_velocity = BallParams::ballSpeed; }
   inline void slowSpeed() { m_velocity = BallParams::ballSlowSpeed; }
+  inline void setVelocity(GLfloat velocity) { m_velocity = velocity; }
   inline void setEffect(BallEffect effect) { m_effect = effect; }
 
  private:
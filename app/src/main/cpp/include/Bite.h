@@ -12,6 +12,7 @@ enum class BiteEffect : int {
   SHORT = 2,   //! timed effect
   FULL = 3,    //! timed effect
 };
+constexpr int totalBiteEffects = 4;  // NONE included
 
 class Bite {
 public:
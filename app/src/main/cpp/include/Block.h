@@ -4,9 +4,13 @@
 #include <random>
 #include <string>
 #include "rgbstruct.h"
+#include "SoundGroup.h"
 
 namespace game {
 
+class SnapshotReader;
+class SnapshotWriter;
+
 enum class Block : int {
   NONE = 0,        //! ' ' - not disturbing
 
@@ -54,10 +58,13 @@ enum class Block : int {
   ZYGOTE_SPAWN = 39 //! '@' - [ 1 ] large disturbing
 };
 
+/// @brief Lookups of block properties, all of them index single table in Block.cpp.
+/// @note Block must be valid, i.e. less than BlockUtils::totalBlocks.
 class BlockUtils {
 public:
   constexpr static int ordinaryBlockOffset = 27;
   constexpr static int totalOrdinaryBlocks = 13;
+  constexpr static int totalBlocks = 40;  // NONE included
 
   static Block charToBlock(char ch);
   static char blockToChar(Block block);
@@ -66,7 +73,8 @@ public:
   static int getBlockScore(Block block);
   static util::BGRA<GLfloat> getBlockColor(Block block);
   static util::BGRA<GLfloat> getBlockEdgeColor(Block block);
-  static std::string getBlockTexture(Block block);
+  static const char* getBlockTexture(Block block);  //!< nullptr if block is not textured
+  static SoundGroup getBlockSound(Block block);  //!< NONE if block impact is silent
   static bool cardinalityAffectingBlock(Block block);
   static bool cardinalityNotAffectingVisibleBlock(Block block);
 };
@@ -76,6 +84,9 @@ public:
   BlockGenerator();
   Block generateBlock();  //!< Generates random ordinary block
 
+  void writeState(SnapshotWriter* writer) const;
+  bool readState(SnapshotReader* reader);
+
 private:
   std::default_random_engine m_generator;
   std::uniform_int_distribution<int> m_distribution;
@@ -0,0 +1,54 @@
+#ifndef __ARKANOID_BLOCK_CHANGE_BATCH__H__
+#define __ARKANOID_BLOCK_CHANGE_BATCH__H__
+
+#include <memory>
+#include <vector>
+
+#include "Block.h"
+#include "ExplosionPackage.h"
+#include "PrizePackage.h"
+
+namespace game {
+
+/// @brief Change of single block within physics tick.
+struct BlockChange {
+  int row, col;
+  Block old_block;  //!< Block before the change.
+  Block new_block;  //!< Block after the change.
+  bool impacted;  //!< Whether the block has been hit itself, rather than
+                  //!< affected by effect of another block.
+
+  BlockChange(int row = 0, int col = 0, Block old_block = Block::NONE, Block new_block = Block::NONE, bool impacted = false)
+    : row(row), col(col), old_block(old_block), new_block(new_block), impacted(impacted) {
+  }
+};
+
+/**
+ * @struct BlockChangeBatch BlockChangeBatch.h "include/BlockChangeBatch.h"
+ * @brief Blocks changed, explosions and prizes spawned within single
+ * physics tick, so that cascade of effects is handed over to other
+ * threads at once.
+ * @details Published batch is shared by all listeners and never modified.
+ */
+struct BlockChangeBatch {
+  typedef std::shared_ptr<const BlockChangeBatch> Ptr;
+
+  std::vector<BlockChange> changes;  //!< Changed blocks, in order of changing.
+  std::vector<ExplosionPackage> explosions;  //!< Requested explosions.
+  std::vector<PrizePackage> prizes;  //!< Spawned prizes.
+
+  inline bool empty() const {
+    return changes.empty() && explosions.empty() && prizes.empty();
+  }
+
+  /// @brief Drops contents, keeping allocated memory for the next tick.
+  inline void clear() {
+    changes.clear();
+    explosions.clear();
+    prizes.clear();
+  }
+};
+
+}
+
+#endif  // __ARKANOID_BLOCK_CHANGE_BATCH__H__
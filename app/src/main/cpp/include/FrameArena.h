@@ -0,0 +1,59 @@
+#ifndef __ARKANOID_FRAME_ARENA__H__
+#define __ARKANOID_FRAME_ARENA__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Macro.h"
+
+namespace util {
+
+/**
+ * @class FrameArena FrameArena.h "include/FrameArena.h"
+ * @brief Linear (bump) allocator for transient data living within a single frame.
+ *
+ * @details Memory is handed out by advancing an offset and is released all at
+ * once by reset(), which is expected to be called right after buffers swap.
+ * Should the arena run out of space, request is served from heap and the arena
+ * is grown at the next reset(), so steady-state frames never touch the heap.
+ * Not thread-safe, must be owned by a single (render) thread.
+ */
+class FrameArena {
+public:
+  explicit FrameArena(size_t capacity);
+  virtual ~FrameArena() noexcept;
+
+  /// @brief Allocates uninitialized storage for @a count objects of type T.
+  template <typename T>
+  T* allocate(size_t count) {
+    return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+  }
+
+  /// @brief Releases all memory allocated since the last reset.
+  void reset();
+
+  inline size_t getCapacity() const { return m_capacity; }
+  inline size_t getPeakUsage() const { return m_peak_usage; }
+  /// @brief Total number of allocations served from heap due to overflow.
+  inline uint64_t getOverflowCount() const { return m_overflow_count; }
+
+private:
+  void* allocateBytes(size_t size, size_t alignment);
+
+  uint8_t* m_memory;
+  size_t m_capacity;
+  size_t m_offset;
+  size_t m_peak_usage;  //!< Max bytes requested within a single frame.
+  uint64_t m_overflow_count;
+  std::vector<uint8_t*> m_overflow_blocks;  //!< Heap blocks to be freed at reset.
+};
+
+/// @brief Number of heap allocations performed by calling thread so far.
+/// @note Returns 0 unless ENABLED_ALLOCATION_COUNTER is set, in which case
+/// global operator new is replaced with a counting one.
+uint64_t getThreadHeapAllocations();
+
+}
+
+#endif  // __ARKANOID_FRAME_ARENA__H__
@@ -6,15 +6,18 @@
 #include <mutex>
 #include <random>
 #include <utility>
+#include <vector>
 
 #include <jni.h>
 
 #include "ActiveObject.h"
 #include "Ball.h"
 #include "Bite.h"
+#include "BlockChangeBatch.h"
 #include "Event.h"
 #include "EventListener.h"
 #include "ExplosionPackage.h"
+#include "InputRecording.h"
 #include "LaserPackage.h"
 #include "Level.h"
 #include "LevelDimens.h"
@@ -22,6 +25,8 @@
 #include "Prize.h"
 #include "PrizePackage.h"
 #include "RowCol.h"
+#include "Snapshot.h"
+#include "UiState.h"
 #include "utils.h"
 
 namespace game {
@@ -79,10 +84,9 @@ public:
   inline void setMasterObject(jobject object) { master_object = object; }
   inline void setOnLostBallMethodID(jmethodID id) { fireJavaEvent_lostBall_id = id; }
   inline void setOnLevelFinishedMethodID(jmethodID id) { fireJavaEvent_levelFinished_id = id; }
-  inline void setOnScoreUpdatedMethodID(jmethodID id) { fireJavaEvent_scoreUpdated_id = id; }
-  inline void setOnAngleChangedMethodID(jmethodID id) { fireJavaEvent_angleChanged_id = id; }
-  inline void setOnCardinalityChangedMethodID(jmethodID id) { fireJavaEvent_cardinalityChanged_id = id; }
   inline void setOnDebugMessageMethodID(jmethodID id) { fireJavaEvent_debugMessage_id = id; }
+  /// @brief Frequent updates go to block shared with UI instead of JNI upcalls.
+  inline void setUiState(UiState* ui_state) { m_ui_state = ui_state; }
   /** @} */  // end of JNIEnvironment group
 
   /** @addtogroup LogicFunc
@@ -92,6 +96,39 @@ public:
   void setBonusPrizes(Prize type);
   /** @} */  // end of LogicFunc group
 
+  /** @defgroup Snapshot Save and restore of complete game state.
+   * @{
+   */
+  /// @brief Writes level and game sections of snapshot.
+  /// @return FALSE if no level has been loaded yet.
+  /// @note Could be called from any thread, waits for current frame to finish.
+  bool saveState(SnapshotWriter* writer);
+  /// @brief Reads game section of snapshot and keeps it until the
+  /// restored level is loaded and ball is placed, then applies it.
+  /// @param prizes Falling prizes to be spawned again.
+  /// @return FALSE if game section is corrupted.
+  /// @note Must be called before restored level is notified to be loaded.
+  bool restoreState(SnapshotReader* reader, std::vector<PrizePackage>&& prizes);
+  /** @} */  // end of Snapshot group
+
+  /** @defgroup Recording Recording and replay of inputs.
+   * @{
+   */
+  /// @brief Starts recording inputs, beginning with keyframe of current state.
+  /// @return FALSE if no level has been loaded yet.
+  bool startRecording();
+  /// @brief Stops recording.
+  /// @param recording Output recording, see InputRecorder.
+  /// @return FALSE if recording has not been started.
+  bool stopRecording(std::vector<uint8_t>* recording);
+  /// @brief Resimulates recorded session from the latest keyframe up to
+  /// @a tick, as fast as possible.
+  /// @param writer Output snapshot of state at @a tick, see restoreState().
+  /// @return FALSE if recording has no keyframe before @a tick.
+  /// @note Only for standalone instance which is never launched nor subscribed.
+  bool replay(InputReplay* replay, uint32_t tick, SnapshotWriter* writer);
+  /** @} */  // end of Recording group
+
 // ----------------------------------------------
 /* Public data-members */
 public:
@@ -125,16 +162,15 @@ public:
   Event<bool> stop_ball_event;
   /// @brief Notifies bite has been impacted.
   Event<bool> bite_impact_event;
-  /// @brief Notifies block has been impacted.
-  Event<RowCol> block_impact_event;
+  /// @brief Notifies blocks have changed, explosions and prizes have been
+  /// spawned within single tick.
+  Event<BlockChangeBatch::Ptr> block_change_event;
+  /// @brief Notifies blocks of level have changed, publishes new version.
+  Event<LevelVersion> level_changed_event;
   /// @brief Notifies wall has benn impacted.
   Event<bool> wall_impact_event;
   /// @brief Notifies level has been successfully finished.
   Event<bool> level_finished_event;
-  /// @brief Notifies particle system has exploded.
-  Event<ExplosionPackage> explosion_event;
-  /// @brief Notifies prize has been generated.
-  Event<PrizePackage> prize_event;
   /// @brief Notifies when to drop ball's appearance to standard.
   Event<bool> drop_ball_appearance_event;
   /// @brief Notifies bite width has changed.
@@ -160,10 +196,8 @@ private:
   jobject master_object;
   jmethodID fireJavaEvent_lostBall_id;
   jmethodID fireJavaEvent_levelFinished_id;
-  jmethodID fireJavaEvent_scoreUpdated_id;
-  jmethodID fireJavaEvent_angleChanged_id;
-  jmethodID fireJavaEvent_cardinalityChanged_id;
   jmethodID fireJavaEvent_debugMessage_id;
+  UiState* m_ui_state;  //!< Block shared with UI, not owned.
   /** @} */  // end of JNIEnvironment group
 
   jint m_fdn;  //!< delay between sequential frames (in nanos)
@@ -181,7 +215,8 @@ private:
   int m_internalTimerForWidthThreshold;
   int m_internalTimerForLaserThreshold;
 
-  Level::Ptr m_level;  //!< Game level at it's current state.
+  Level::Ptr m_level;  //!< Game level at it's current state, owned by this thread.
+  Level::Ptr m_level_origin;  //!< Game level as it was loaded, shared with other threads.
   GLfloat m_throw_angle;  //!< Initial throw level between ball's trajectory and X axis.
   GLfloat m_aspect;  //!< Measured aspect ratio.
   bool m_level_finished;  //!< Whether level has been successfully finished.
@@ -199,10 +234,14 @@ private:
   int m_internal_timer_for_speed;  //!< Timer used for ball speed changed.
   int m_internal_timer_for_width;  //!< Timer used for bite width changed.
   int m_internal_timer_for_laser;  //!< Timer used for laser beam visibility.
+  BiteEffect m_bite_effect;  //!< Effect of the last width changed event.
+  bool m_laser_visible;  //!< Whether laser beam is visible.
   std::atomic<int> explosionID;
   std::atomic<int> prizeID;
+  std::shared_ptr<BlockChangeBatch> m_block_changes;  //!< Changes within current tick, published at its end.
   long long m_next_move_iteration;
   long long m_prev_move_iteration;
+  Bite m_moved_bite;  //!< Bite location received, applied in process_biteMoved().
   /** @} */  // end of LogicData group
 
   /** @defgroup Maths Maths auxiliary members.
@@ -214,6 +253,37 @@ private:
   std::uniform_int_distribution<int> m_viscosity_distribution;
   /** @} */  // Maths
 
+  /** @addtogroup Snapshot
+   * @{
+   */
+  /// @brief State read from snapshot, to be applied in process_initBall().
+  struct RestoredState {
+    bool ball_is_flying;
+    GLfloat throw_angle;
+    GLfloat x, y, angle, velocity;
+    BallEffect ball_effect;
+    BiteEffect bite_effect;
+    bool laser_visible;
+    bool level_finished, is_ball_lost, is_ball_death;
+    int timer, timer_for_speed, timer_for_width, timer_for_laser;
+    std::default_random_engine generator;
+    std::normal_distribution<float> angle_distribution;
+    std::vector<PrizePackage> prizes;
+  };
+
+  RestoredState m_restored;
+  bool m_restore_armed;  //!< Restored level is being loaded, ball isn't placed yet.
+  /** @} */  // end of Snapshot group
+
+  /** @addtogroup Recording
+   * @{
+   */
+  uint32_t m_tick;  //!< Number of ball moves, time base of recordings.
+  std::unique_ptr<InputRecorder> m_recorder;  //!< Not null while recording.
+  bool m_keyframe_requested;  //!< State has changed not by recorded inputs.
+  bool m_realtime;  //!< Whether ball moves are paced by frame delay, FALSE in replay.
+  /** @} */  // end of Recording group
+
   /** @defgroup Mutex Thread-safety variables
    * @{
    */
@@ -227,6 +297,8 @@ private:
   std::mutex m_bite_location_mutex;  //!< Sentinel for bite's center location changes.
   std::mutex m_prize_caught_mutex;  //!< Sentinel for prize has been caught.
   std::mutex m_laser_beam_mutex;
+  std::mutex m_state_mutex;  //!< Sentinel for state between frames, for snapshots.
+  std::mutex m_restore_state_mutex;  //!< Sentinel for state read from snapshot.
   std::atomic_bool m_aspect_ratio_received;  //!< Aspect ratio has been measured.
   std::atomic_bool m_load_level_received;  //!< Load level request has been received.
   std::atomic_bool m_throw_ball_received;  //!< Throw ball command has been received.
@@ -236,6 +308,7 @@ private:
   std::atomic_bool m_bite_location_received;  //!< New bite's center location has been received.
   std::atomic_bool m_prize_caught_received;  //!< Prize has been caught received.
   std::atomic_bool m_laser_beam_received;
+  std::atomic_bool m_restore_state_received;  //!< State has been read from snapshot.
   /** @} */  // end of Mutex group
 
 // ----------------------------------------------
@@ -285,6 +358,39 @@ private:
   void process_laserBeam();
   /** @} */  // end of Processors group
 
+  /** @addtogroup Snapshot
+   * @{
+   */
+  /// @brief Applies state read from snapshot to the placed ball.
+  void applyRestoredState();
+  /// @brief Writes level and game sections, caller holds the state.
+  void writeState(SnapshotWriter* writer);
+  /// @brief Reads game section of snapshot.
+  static bool readGameState(SnapshotReader* reader, RestoredState* state);
+  /** @} */  // end of Snapshot group
+
+  /** @addtogroup Recording
+   * @{
+   */
+  /// @brief Moves the ball for a single frame and checks timers of effects.
+  void advance();
+  /// @brief Records input processed at current tick.
+  inline void record(InputType type, const uint32_t* words) {
+    if (m_recorder != nullptr) m_recorder->record(m_tick, type, words);
+  }
+  /// @brief Publishes immutable snapshot of level along with cells
+  /// changed since previous version, if any.
+  void publishLevel();
+  /// @brief Publishes changes accumulated within current tick, if any.
+  void publishBlockChanges();
+  /// @brief Records full state, including environment measured by renderer.
+  void recordKeyframe();
+  /// @brief Restores full state from keyframe, with no notifications.
+  bool readKeyframe(const uint8_t* data, size_t size);
+  /// @brief Applies recorded input as if it came from outside.
+  void applyInput(const InputEvent& event);
+  /** @} */  // end of Recording group
+
   /** @defgroup LogicFunc Game logic related member functions.
    * @{
    */
@@ -310,14 +416,20 @@ private:
   void onLostBall(BallLost ball_lost);
   /// @brief Notifies Java layer level has been successfully finished.
   void onLevelFinished(bool /* dummy */);
-  /// @brief Notifies Java layer level with additive score value.
+  /// @brief Adds score value to UI state.
   void onScoreUpdated(int score);
-  /// @brief Notifies Java layer ball's angle has been changed.
+  /// @brief Stores ball's angle to UI state.
   /// @details Angle re-calculated in degrees.
   void onAngleChanged();
-  /// @brief Notifies Java layer cardinality value has been updated.
+  /// @brief Stores updated cardinality value to UI state.
   void onCardinalityChanged(int new_cardinality);
-  /// @brief Notifies block explosion has occurred.
+  /// @brief Adds change of block into batch of current tick.
+  /// @param row Row index of changed block.
+  /// @param col Column index of changed block.
+  /// @param old_block Block before the change.
+  /// @param impacted Whether the block has been hit itself.
+  void onBlockChanged(int row, int col, Block old_block, bool impacted);
+  /// @brief Adds block explosion into batch of current tick.
   /// @param x Center of explosion along X axis.
   /// @param y Center of explosion along Y axis.
   /// @param color Color of explosion.
@@ -330,7 +442,8 @@ private:
   void explodeBlock(int row, int col, Kind kind);
   /// @brief Same as above but with specified color.
   void explodeBlock(int row, int col, const util::BGRA<GLfloat>& color, Kind kind);
-  /// @brief Spawns prize of specified type at given location.
+  /// @brief Adds prize of specified type spawned at given location
+  /// into batch of current tick.
   /// @param x Spawn point along X axis.
   /// @param y Spawn point along Y axis.
   /// @param prize Type of prize to be spawned.
@@ -0,0 +1,41 @@
+#ifndef __ARKANOID_IMA_ADPCM__H__
+#define __ARKANOID_IMA_ADPCM__H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace native {
+
+/**
+ * @class ImaAdpcm ImaAdpcm.h "include/ImaAdpcm.h"
+ * @brief Codec of mono IMA-ADPCM blocks, as stored in WAV files (format 0x11).
+ * @details Each block starts with 4-byte header (first sample and step index),
+ * followed by 4-bit codes, low nibble first. Blocks are decoded independently,
+ * so sound could be decoded incrementally block by block.
+ */
+class ImaAdpcm {
+public:
+  constexpr static size_t headerSize = 4;
+  constexpr static size_t defaultBlockAlign = 256;  //!< 505 samples per block.
+
+  /// @brief Number of samples in full block of @a block_align bytes.
+  static size_t getSamplesPerBlock(size_t block_align);
+  /// @brief Number of samples in blocks of @a size bytes in total.
+  static size_t getSamplesCount(size_t size, size_t block_align);
+  /// @brief Number of bytes needed to encode @a samples.
+  static size_t getEncodedSize(size_t samples, size_t block_align);
+
+  /// @brief Decodes single block into at most @a max_samples of @a output.
+  /// @param size Size of block, last block of sound could be shorter.
+  /// @return Number of decoded samples.
+  static size_t decodeBlock(const uint8_t* block, size_t size, int16_t* output, size_t max_samples);
+  /// @brief Encodes @a samples into blocks of @a block_align bytes.
+  /// @param output Buffer of at least getEncodedSize() bytes.
+  /// @return Number of written bytes.
+  /// @note Sounds are encoded offline by tools/soundbank, not by the game.
+  static size_t encode(const int16_t* input, size_t samples, size_t block_align, uint8_t* output);
+};
+
+}
+
+#endif  // __ARKANOID_IMA_ADPCM__H__
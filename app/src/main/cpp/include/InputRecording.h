@@ -0,0 +1,119 @@
+#ifndef __ARKANOID_INPUT_RECORDING__H__
+#define __ARKANOID_INPUT_RECORDING__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+/// @brief Header at the beginning of recording, little-endian.
+struct InputRecordingHeader {
+  char magic[4];  //!< "ARKR"
+  uint32_t version;
+  int32_t frame_delay;  //!< Frame delay (in nanos) of recorded session.
+};
+
+/// @brief Inputs of GameProcessor, in the order they have been processed.
+enum class InputType : uint8_t {
+  KEYFRAME = 0,      //!< Full state, see GameProcessor::startRecording().
+  ASPECT = 1,        //!< aspect
+  INIT_BALL = 2,     //!< width, height, x, y
+  INIT_BITE = 3,     //!< width, height, x
+  LEVEL_DIMENS = 4,  //!< rows, cols (integers), width, height, block width, block height
+  BITE_MOVED = 5,    //!< width, height, x
+  THROW_BALL = 6,    //!< angle
+  PRIZE_CAUGHT = 7,  //!< prize (integer)
+  LASER_BEAM = 8     //!< x, y
+};
+
+constexpr int totalInputTypes = 9;
+
+/// @brief Single decoded record of recording.
+struct InputEvent {
+  constexpr static int maxWords = 6;
+
+  InputType type;
+  uint32_t tick;  //!< Number of ball moves before the input has been processed.
+  uint32_t words[maxWords];  //!< Values, floats are kept as bit patterns.
+  const uint8_t* keyframe;  //!< Payload of KEYFRAME within recording.
+  size_t keyframe_size;
+
+  inline float getFloat(int i) const { float value; std::memcpy(&value, &words[i], sizeof(float)); return value; }
+  inline int getInt(int i) const { return static_cast<int32_t>(words[i]); }
+};
+
+/**
+ * @class InputRecorder InputRecording.h "include/InputRecording.h"
+ * @brief Encodes inputs of GameProcessor into compact stream.
+ * @details Each record is type, varint delta of tick and values as zigzag
+ * varint deltas of bit patterns against the previous record of the same type,
+ * so that unchanged values take single byte and small moves of bite take two.
+ * Keyframe keeps absolute tick and resets all deltas, so that decoding could
+ * start at any keyframe.
+ */
+class InputRecorder {
+public:
+  constexpr static uint32_t version = 1;
+  /// @brief Keyframe is written at least each that many ticks, about 10 s of flight.
+  constexpr static uint32_t keyframeInterval = 600;
+
+  explicit InputRecorder(int32_t frame_delay);
+
+  void record(uint32_t tick, InputType type, const uint32_t* words);
+  void recordKeyframe(uint32_t tick, const std::vector<uint8_t>& payload);
+  inline bool needsKeyframe(uint32_t tick) const { return tick - m_keyframe_tick >= keyframeInterval; }
+  inline std::vector<uint8_t>& getData() { return m_data; }
+
+  static inline uint32_t toWord(float value) { uint32_t word; std::memcpy(&word, &value, sizeof(float)); return word; }
+  static inline uint32_t toWord(int value) { return static_cast<uint32_t>(value); }
+
+private:
+  std::vector<uint8_t> m_data;
+  uint32_t m_tick;  //!< Tick of the last record.
+  uint32_t m_keyframe_tick;
+  uint32_t m_last[InputEvent::maxWords * totalInputTypes];  //!< Last values of each type.
+};
+
+/**
+ * @class InputReplay InputRecording.h "include/InputRecording.h"
+ * @brief Reads recording made by InputRecorder, seeks to keyframes.
+ * @note Recording is referenced, not copied.
+ */
+class InputReplay {
+public:
+  InputReplay(const uint8_t* data, size_t size);
+
+  /// @brief Whether header and all records are consistent.
+  inline bool isValid() const { return m_is_valid; }
+  inline int32_t getFrameDelay() const { return m_frame_delay; }
+  /// @brief Tick of the last record.
+  inline uint32_t getDuration() const { return m_duration; }
+
+  /// @brief Positions reader at the latest keyframe not later than @a tick.
+  /// @return FALSE if there is no such keyframe.
+  bool seek(uint32_t tick);
+  /// @brief Decodes next record.
+  /// @return FALSE at the end of recording.
+  bool next(InputEvent* event);
+
+  /// @brief Number of values of record of given type, -1 if type is unknown.
+  static int getWordsCount(InputType type);
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_offset;
+  uint32_t m_tick;
+  uint32_t m_last[InputEvent::maxWords * totalInputTypes];
+  std::vector<std::pair<uint32_t, size_t>> m_keyframes;  //!< Tick and offset of each keyframe.
+  int32_t m_frame_delay;
+  uint32_t m_duration;
+  bool m_is_valid;
+};
+
+}
+
+#endif  // __ARKANOID_INPUT_RECORDING__H__
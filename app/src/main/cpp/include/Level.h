@@ -8,6 +8,8 @@
 #ifndef INCLUDE_LEVEL_H_
 #define INCLUDE_LEVEL_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +23,9 @@
 
 namespace game {
 
+class SnapshotReader;
+class SnapshotWriter;
+
 enum class Direction : int {
   NONE = 0,
   UP = 1,
@@ -54,11 +59,23 @@ public:
   /// @return Level instance.
   static Level::Ptr fromStringArray(const std::vector<std::string>& array, size_t length);
 
+  /// @brief Get Level instance from characters of level strings.
+  /// @param cells Characters of all rows, @a cols per each row.
+  /// @return Level instance.
+  static Level::Ptr fromCells(const char* cells, int rows, int cols);
+
   /// @brief Converts this Level instance to string array.
   /// @param array Pointer to an output string array.
   /// @return Size of output array.
   size_t toStringArray(std::vector<std::string>* array) const;
 
+  /// @brief Writes blocks, recorded cardinality and state of generators
+  /// into section of snapshot.
+  void writeState(SnapshotWriter* writer) const;
+  /// @brief Restores Level instance from section of snapshot.
+  /// @return Level instance, nullptr if section is corrupted.
+  static Level::Ptr readState(SnapshotReader* reader);
+
   /// @brief Converts this Level instance to vertex array.
   /// @param width Width of each block to display.
   /// @param height Height of each block to display.
@@ -69,8 +86,8 @@ public:
   /// @param array Output vertex array.
   /// @return Size of output array.
   /// @details Memory for output array should be allocated manually
-  /// by Client, required size for allocation is 16 * cols * rows.
-  /// @note Each vertex has 2 coordinates (x, y, z=0, w=1).
+  /// by Client, required size for allocation is 8 * cols * rows.
+  /// @note Each vertex has 2 coordinates (x, y).
   void toVertexArray(
       GLfloat width,
       GLfloat height,
@@ -84,7 +101,8 @@ public:
   /// @param array Output color array.
   /// @details Memory for output array should be allocated manually
   /// by Client, required size for allocation is 16 * cols * rows.
-  void fillColorArray(GLfloat* const array) const;
+  /// @note Colors are stored as normalized unsigned bytes (b, g, r, a).
+  void fillColorArray(GLubyte* const array) const;
   /// @brief Fills input array with color values at position corresponding
   /// to the specified block in this Level instance.
   /// @param array Output color array.
@@ -92,7 +110,7 @@ public:
   /// @param col Column index of specified block.
   /// @details Memory for output array should be allocated manually
   /// by Client, required size for allocation is 16 * cols * rows.
-  void fillColorArrayAtBlock(GLfloat* const array, int row, int col) const;
+  void fillColorArrayAtBlock(GLubyte* const array, int row, int col) const;
 
   /// @brief Returns height of level.
   inline int numRows() const { return rows; }
@@ -107,7 +125,16 @@ public:
   /// @brief Gets block by row and column indices.
   inline Block getBlock(int row, int col) const { return blocks[row][col]; }
   /// @brief Sets the block by row and column indices.
-  inline void setBlock(int row, int col, Block value) { blocks[row][col] = value; }
+  /// @note Records the cell into change journal of current version.
+  /// Row shared with clones is copied before it's modified. Called only
+  /// by the thread owning this level, see LevelVersion.
+  inline void setBlock(int row, int col, Block value) {
+    if (row_clones[row] != clones.load(std::memory_order_acquire)) {
+      detachRow(row);
+    }
+    blocks[row][col] = value;
+    journal.emplace_back(row, col, value);
+  }
   /// @brief Sets the block by row and column indices only
   /// in case it is vulnerable.
   /// @note Re-calculates cardinality.
@@ -142,14 +169,16 @@ public:
   /// @param col Column index of certain block.
   /// @param type Type the block will be modified to.
   /// @param ignoreNone Whether to ignore NONE blocks.
-  /// @param output Array of valid indices of influenced blocks.
+  /// @param output Array of valid indices of influenced blocks,
+  /// along with blocks they had before.
   /// @return Score of affected blocks.
   int modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std::vector<RowCol>* output);
   /// @brief Upgrades or degrades blocks around certain block.
   /// @param row Row index of certain block.
   /// @param col Column index of certain block.
   /// @param mode Upgrade or degrade nearest blocks.
-  /// @param output Array of valid indices of influenced blocks.
+  /// @param output Array of valid indices of influenced blocks,
+  /// along with blocks they had before.
   /// @return Score of affected blocks.
   int changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>* output);
   /// @brief Destroys blocks around certain block.
@@ -161,7 +190,8 @@ public:
   /// @param type Type the block will be modified to.
   /// @param ignoreNone Whether to ignore NONE blocks.
   /// @param direction Direction behind the block.
-  /// @param output Array of valid indices of influenced blocks.
+  /// @param output Array of valid indices of influenced blocks,
+  /// along with blocks they had before.
   /// @return Score of affected blocks.
   int modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Direction direction, std::vector<RowCol>* output);
   /// @brief Same as above, but modifies one block behind certain block.
@@ -177,7 +207,8 @@ public:
   /// @param row Row index of certain block.
   /// @param col Column index of certain block.
   /// @param type Type the block will be modified to.
-  /// @param output Valid indices of influenced block.
+  /// @param output Valid indices of influenced block, along with
+  /// block it had before.
   /// @return TRUE is place for near block is found, FALSE otherwise.
   bool modifyBlockNear(int row, int col, Block type, RowCol* output);
   /// @brief Finds all blocks of given type.
@@ -194,10 +225,36 @@ public:
   Block generatePresentBlock();
   /** @} */  // end of Modifiers group
 
+  /** @defgroup Versioning Versions of level shared between threads.
+   * @{
+   */
+  /// @brief Copies blocks, cardinality and generators at current version.
+  /// @return Level instance with empty change journal.
+  /// @note Used both to take a private mutable grid and to publish
+  /// an immutable snapshot of it. Rows are shared copy-on-write, so
+  /// clone costs a pointer per row, and only rows set afterwards are copied,
+  /// either in this level or in the clone, once per row.
+  Level::Ptr clone() const;
+  /// @brief Gets number of versions committed so far.
+  inline uint32_t getVersion() const { return version; }
+  /// @brief Checks whether any block has been set since last commit.
+  inline bool hasChanges() const { return !journal.empty(); }
+  /// @brief Closes current version and drains change journal.
+  /// @param changes Output array of cells set since previous version,
+  /// in order of setting, each one with its new block.
+  /// @return Number of the new version.
+  uint32_t commit(std::vector<RowCol>* changes);
+  /** @} */  // end of Versioning group
+
   void print() const;
 
 private:
   Level(int rows, int cols);
+  /// @brief Shares given rows with other level.
+  Level(int rows, int cols, const std::vector<std::shared_ptr<Block>>& row_pages);
+
+  /// @brief Replaces shared row with private copy of it, owned until next clone.
+  void detachRow(int row);
 
   /// @brief Calculates current cardinality of this Level instance.
   int calculateCardinality() const;
@@ -206,9 +263,29 @@ private:
 
   int rows, cols;
   int initial_cardinality;
-  Block** blocks;
+  Block** blocks;  //!< Rows of blocks, owned by row_pages.
+  std::vector<std::shared_ptr<Block>> row_pages;  //!< Rows, shared with clones of this level.
+  mutable std::atomic<uint32_t> clones;  //!< Number of clones taken of this level.
+  std::vector<uint32_t> row_clones;  //!< Value of clones when row was copied, shared if it differs.
   BlockGenerator generator;
   PrizeGenerator prize_generator;
+  uint32_t version;  //!< Number of versions committed so far.
+  std::vector<RowCol> journal;  //!< Cells set since last commit.
+};
+
+/**
+ * @struct LevelVersion Level.h "include/Level.h"
+ * @brief Version of level published by the thread owning mutable grid.
+ */
+struct LevelVersion {
+  Level::Ptr origin;  //!< Level as it was loaded, identifies sequence of versions.
+  uint32_t version;  //!< Number of this version within sequence.
+  Level::Ptr snapshot;  //!< Blocks at this version, must not be modified.
+  std::vector<RowCol> changes;  //!< Cells changed since previous version.
+
+  LevelVersion()
+    : origin(nullptr), version(0), snapshot(nullptr) {
+  }
 };
 
 }  // namespace game
@@ -0,0 +1,81 @@
+#ifndef __ARKANOID_LEVEL_PACK__H__
+#define __ARKANOID_LEVEL_PACK__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "byteutils.h"
+
+namespace game {
+
+class Level;
+
+/// @brief Header at the beginning of level pack, little-endian.
+/// @details Header is followed by table of count + 1 offsets of levels,
+/// the last one is the end of the last level.
+struct LevelPackHeader {
+  char magic[4];  //!< "ARKL"
+  uint32_t version;
+  uint32_t count;
+  uint32_t table_offset;
+};
+
+enum class LevelEncoding : uint8_t {
+  RAW = 0,  //!< Single character per cell, row by row.
+  RLE = 1   //!< Pairs of run length (1 - 255) and character.
+};
+
+/// @brief Header of single level, followed by encoded cells.
+struct LevelRecord {
+  uint8_t rows;
+  uint8_t cols;
+  uint8_t encoding;  //!< LevelEncoding.
+  uint8_t reserved;
+  uint32_t checksum;  //!< LevelPack::checksum() of decoded cells.
+};
+
+/**
+ * @class LevelPack LevelPack.h "include/LevelPack.h"
+ * @brief Read-only view of levels packed into single file, loaded by index
+ * without any parsing of strings.
+ * @details Cells are stored as characters of level strings, see BlockUtils::charToBlock().
+ * Packs are built from Levels.java by tools/levelpack.
+ */
+class LevelPack {
+public:
+  typedef std::shared_ptr<LevelPack> Ptr;
+  typedef std::function<void ()> Release;
+
+  constexpr static const char* filename = "level/levels.pack";
+  constexpr static uint32_t version = 1;
+
+  /// @param release Called on destruction, to release mapping of @a data.
+  LevelPack(const void* data, size_t size, Release release);
+  virtual ~LevelPack() noexcept;
+
+  /// @brief Whether header and offset table are consistent with size of pack.
+  bool isValid() const;
+  int getCount() const;
+  /// @brief Decodes level at @a index.
+  /// @return Level, nullptr if index is out of range or level is corrupted.
+  std::shared_ptr<Level> load(int index) const;
+
+  /// @brief FNV-1a hash of cells.
+  static uint32_t checksum(const uint8_t* data, size_t size) {
+    return util::fnv1a(data, size);
+  }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  Release m_release;
+  const LevelPackHeader* m_header;
+  const uint32_t* m_table;
+  bool m_is_valid;
+};
+
+}
+
+#endif  // __ARKANOID_LEVEL_PACK__H__
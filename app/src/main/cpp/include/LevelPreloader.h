@@ -0,0 +1,82 @@
+#ifndef __ARKANOID_LEVEL_PRELOADER__H__
+#define __ARKANOID_LEVEL_PRELOADER__H__
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <GLES2/gl2.h>
+
+#include "Level.h"
+#include "LevelDimens.h"
+
+namespace game {
+
+/// @brief Level along with geometry ready to be uploaded by renderer.
+struct PreparedLevel {
+  PreparedLevel();
+
+  Level::Ptr level;
+  GLfloat aspect;  //!< Aspect ratio geometry has been built for.
+  LevelDimens dimens;
+  std::vector<GLfloat> vertices;  //!< 8 per block, see Level::toVertexArray().
+  std::vector<GLubyte> colors;    //!< 16 per block, see Level::fillColorArray().
+  std::vector<GLushort> indices;  //!< 6 per block, see util::rectangleIndices().
+};
+
+/**
+ * @class LevelPreloader LevelPreloader.h "include/LevelPreloader.h"
+ * @brief Loads next level and builds its geometry on worker thread
+ * while current level is played, so that switching to the next level
+ * costs no more than swap of buffers.
+ * @details Level is taken once by index on load request and passed to all
+ * threads as usual, geometry is then taken by renderer for that very level.
+ */
+class LevelPreloader {
+public:
+  typedef std::function<Level::Ptr ()> Source;
+  typedef std::function<void (Level::Ptr)> LoadedCallback;
+
+  LevelPreloader();
+  virtual ~LevelPreloader() noexcept;
+
+  /// @brief Sets aspect ratio of surface, called by renderer.
+  void setAspect(GLfloat aspect);
+
+  /// @brief Starts loading of level @a index from @a source on worker thread,
+  /// discarding previously preloaded level. No-op if level @a index is
+  /// being preloaded or has been preloaded already.
+  /// @param on_loaded Called from worker thread once level is loaded,
+  /// so that other threads could prefetch its resources.
+  void preload(int index, Source source, LoadedCallback on_loaded);
+  /// @brief Whether level @a index has been preloaded along with its geometry,
+  /// so that takeLevel() returns it.
+  bool isPreloaded(int index);
+  /// @brief Takes preloaded level, never waits for worker: level which is
+  /// still being preloaded is dropped, so that caller loads it by itself.
+  /// @return Level, nullptr if level @a index hasn't been preloaded yet.
+  Level::Ptr takeLevel(int index);
+  /// @brief Takes geometry of @a level taken before.
+  /// @return FALSE if geometry has been built for other level or aspect ratio.
+  /// @note Called by renderer.
+  bool takeGeometry(const Level::Ptr& level, GLfloat aspect, PreparedLevel* prepared);
+
+  /// @brief Builds geometry of level in place.
+  static void buildGeometry(GLfloat aspect, PreparedLevel* prepared);
+
+private:
+  /// @brief Waits for worker thread to exit.
+  void join();
+
+  std::thread m_worker;
+  std::mutex m_mutex;  //!< Guards all of the following.
+  int m_index;  //!< Index of level being preloaded, -1 if none.
+  GLfloat m_aspect;
+  PreparedLevel m_prepared;  //!< Level being preloaded.
+  PreparedLevel m_taken;  //!< Level handed out, geometry is waiting for renderer.
+};
+
+}
+
+#endif  // __ARKANOID_LEVEL_PRELOADER__H__
@@ -3,5 +3,9 @@
 
 #define USE_TEXTURE 0
 #define DEBUG 0
+#define ENABLED_ALLOCATION_COUNTER 0  //!< Count heap allocations per thread, see FrameArena.h
+#ifndef ENABLED_RENDER_PROFILER
+#define ENABLED_RENDER_PROFILER 0  //!< Log render stage timings and draw calls, see RenderProfiler.h
+#endif
 
 #endif  // __ARKANOID_MACRO__H__
@@ -0,0 +1,73 @@
+#ifndef __ARKANOID_MIXER__H__
+#define __ARKANOID_MIXER__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "SoundBuffer.h"
+
+namespace native {
+namespace sound {
+
+/**
+ * @class Mixer Mixer.h "include/Mixer.h"
+ * @brief Mixes up to maxVoices sounds into single stream of mono 16-bit PCM.
+ * @details Voices are accumulated into 32 bits with NEON or SSE2 if available
+ * and saturated to 16 bits. When all voices are busy, new sound steals voice
+ * of lower or equal priority which has been playing the longest.
+ * IMA-ADPCM sounds are decoded block by block while mixing, into per-voice
+ * buffer allocated in play(). Output is mixed in chunks of at most
+ * maxChunkFrames, so that mix() never allocates, whatever buffer size is.
+ * @note play() and mix() could be called from different threads.
+ */
+class Mixer {
+public:
+  constexpr static int maxVoices = 16;
+  constexpr static size_t maxChunkFrames = 1024;  //!< Frames accumulated at once.
+
+  Mixer();
+  virtual ~Mixer() noexcept;
+
+  /// @brief Starts playing sound from the beginning.
+  /// @param gain Volume of sound, 1.0 is unity, at most 2.0.
+  /// @param priority Voices of higher priority are never stolen by lower ones.
+  /// @return Whether a voice has been given to sound.
+  bool play(const SoundBuffer* sound, float gain, int priority);
+  /// @brief Stops all voices.
+  void stopAll();
+  /// @brief Whether sound is being played by some voice.
+  bool isPlaying(const SoundBuffer* sound);
+  /// @brief Mixes next @a frames of active voices into @a output.
+  void mix(int16_t* output, size_t frames);
+
+private:
+  struct Voice {
+    const SoundBuffer* sound;  //!< nullptr if voice is free.
+    const int16_t* samples;  //!< PCM16 samples, nullptr if sound is encoded.
+    size_t length;    //!< Total frames.
+    size_t position;  //!< Next frame to be mixed.
+    int16_t gain;     //!< Q14 fixed point, so that unity and above fit into int16.
+    int priority;
+    std::vector<int16_t> decoded;  //!< Samples of single decoded block.
+    size_t decoded_block;  //!< Index of block in decoded, or noBlock.
+    size_t decoded_count;
+  };
+
+  constexpr static size_t noBlock = static_cast<size_t>(-1);
+
+  /// @brief Mixes at most maxChunkFrames of active voices.
+  void mixChunk(int16_t* output, size_t frames);
+  /// @brief Returns next samples of voice, at most @a frames of them.
+  const int16_t* fetch(Voice& voice, size_t frames, size_t* count);
+
+  Voice m_voices[maxVoices];
+  std::vector<int32_t> m_accumulator;  //!< maxChunkFrames, allocated once.
+  std::mutex m_voices_mutex;
+};
+
+}  // namespace sound
+}  // namespace native
+
+#endif  // __ARKANOID_MIXER__H__
@@ -1,6 +1,8 @@
 #ifndef __ARKANOID_PARAMS__H__
 #define __ARKANOID_PARAMS__H__
 
+#include <cstdint>
+
 namespace game {
 
 struct BiteParams {
@@ -14,6 +16,9 @@ struct BiteParams {
   constexpr static float biteElevation = 0.2f;
   constexpr static float neg_biteElevation = 1.0f - biteElevation;
   constexpr static float radius = biteWidth * 0.64f;  //!< Curvature radius of bite.
+  /// @brief Rendered bite is extrapolated along the motion for at most that long
+  /// after the last touch sample (in nanos), about two frames.
+  constexpr static int64_t predictionHorizon = 32000000;
 };
 
 struct BallParams {
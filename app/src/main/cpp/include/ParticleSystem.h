@@ -0,0 +1,115 @@
+#ifndef __ARKANOID_PARTICLE_SYSTEM__H__
+#define __ARKANOID_PARTICLE_SYSTEM__H__
+
+#include <chrono>
+
+#include <GLES2/gl2.h>
+
+#include "ExplosionPackage.h"
+
+namespace game {
+
+/**
+ * @class ParticleSystem ParticleSystem.h "include/ParticleSystem.h"
+ * @brief Fixed-capacity pool of explosion emitters sharing a single
+ * interleaved vertex buffer, so that all live explosions are drawn
+ * in one call.
+ *
+ * @details Each emitter owns a slot of @a particleSystemSize vertices.
+ * Slot is written once when emitter is spawned, afterwards only the
+ * global time uniform changes, so no per-frame CPU work is needed.
+ * Slots written since last upload are tracked as dirty range, so that
+ * only freshly spawned emitters are transferred into buffer object.
+ * Particle seeds are generated once at construction for each Kind.
+ */
+class ParticleSystem {
+public:
+  constexpr static int particleSize = 5;  //!< Seed layout: lifetime, end.x, end.y, start.x, start.y
+  constexpr static int particleSystemSize = 1000;  //!< Particles per single emitter.
+  constexpr static int emitterCapacity = 32;  //!< Max simultaneously live emitters.
+  constexpr static float emitterDuration = 1.0f;  //!< Lifetime of emitter (in seconds).
+
+  /** @defgroup VertexLayout Interleaved layout of a single particle vertex.
+   * @{
+   */
+  constexpr static int lifetimeOffset = 0;     //!< float lifetime
+  constexpr static int endOffset = 1;          //!< vec2 end position
+  constexpr static int startOffset = 3;        //!< vec2 start position
+  constexpr static int centerOffset = 5;       //!< vec2 emitter center
+  constexpr static int startTimeOffset = 7;    //!< float emitter start time
+  constexpr static int colorOffset = 8;        //!< vec3 emitter color
+  constexpr static int vertexSize = 11;        //!< total floats per vertex
+  /** @} */  // end of VertexLayout group
+
+  ParticleSystem();
+  virtual ~ParticleSystem() noexcept;
+
+  /// @brief Sets aspect ratio of rendering surface, applied to newly spawned emitters.
+  inline void setAspect(GLfloat aspect) { m_aspect = aspect; }
+
+  /// @brief Acquires free emitter from pool and fills it's slot.
+  /// @note The oldest emitter is stolen when pool is exhausted.
+  void spawn(const ExplosionPackage& package);
+  /// @brief Retires emitters which have outlived @a emitterDuration.
+  void update();
+  /// @brief Retires all emitters at once.
+  void clear();
+
+  /// @brief Current time (in seconds) to be passed as uniform to shader.
+  float getTime() const;
+  /// @brief Whether there is no live emitter.
+  inline bool empty() const { return m_live_emitters == 0; }
+  /// @brief Pointer to packed interleaved vertex buffer.
+  inline const GLfloat* getVertexBuffer() const { return m_vertex_buffer; }
+  /// @brief Number of vertices to draw to cover all live emitters.
+  inline int getVertexCount() const { return m_used_slots * particleSystemSize; }
+  /// @brief Total number of vertices in all slots of the pool.
+  constexpr static int getCapacity() { return emitterCapacity * particleSystemSize; }
+
+  /** @defgroup DirtyRange Slots written since last upload.
+   * @{
+   */
+  /// @brief Whether any slot has been written since last upload.
+  inline bool isDirty() const { return m_dirty_begin < m_dirty_end; }
+  /// @brief First vertex of dirty range.
+  inline int getDirtyVertexOffset() const { return m_dirty_begin * particleSystemSize; }
+  /// @brief Number of vertices in dirty range.
+  inline int getDirtyVertexCount() const { return (m_dirty_end - m_dirty_begin) * particleSystemSize; }
+  /// @brief Marks all slots as uploaded.
+  void markClean();
+  /// @brief Marks all used slots as dirty, i.e. when buffer object has been lost.
+  void markDirty();
+  /** @} */  // end of DirtyRange group
+
+private:
+  struct Emitter {
+    float start_time;
+    bool is_alive;
+  };
+
+  /// @brief Generates particle seeds for each kind of explosion.
+  void generateSeeds();
+  /// @brief Marks emitter at given slot as retired and shrinks used range.
+  void retire(int slot);
+  /// @brief Gets seeds corresponding to given kind of explosion.
+  const GLfloat* getSeeds(Kind kind) const;
+
+  GLfloat m_aspect;
+  GLfloat* m_diverge_seeds;   //!< Pre-generated seeds for diverging explosion.
+  GLfloat* m_converge_seeds;  //!< Pre-generated seeds for converging explosion.
+  GLfloat* m_vacuum_seeds;    //!< Pre-generated seeds for vacuum explosion.
+  GLfloat* m_vertex_buffer;   //!< Packed slots of all emitters.
+
+  Emitter m_emitters[emitterCapacity];
+  int m_live_emitters;  //!< Total number of live emitters.
+  int m_used_slots;     //!< Highest live slot index plus one.
+  int m_dirty_begin;    //!< First slot written since last upload.
+  int m_dirty_end;      //!< Last slot written since last upload plus one.
+  /// @brief Origin of time, rebased each time the pool becomes empty
+  /// to keep float precision of time uniform.
+  std::chrono::steady_clock::time_point m_epoch;
+};
+
+}  // namespace game
+
+#endif  // __ARKANOID_PARTICLE_SYSTEM__H__
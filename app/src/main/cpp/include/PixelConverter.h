@@ -0,0 +1,44 @@
+#ifndef __ARKANOID_PIXEL_CONVERTER__H__
+#define __ARKANOID_PIXEL_CONVERTER__H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace native {
+
+/**
+ * @defgroup PixelConverter Conversion of 8 bits per channel images
+ * into reduced-precision formats suitable for glTexImage2D().
+ *
+ * @details Source image is tightly packed RGB (3 channels) or RGBA
+ * (4 channels). Ordered dithering uses 4x4 Bayer matrix. All conversions
+ * are vectorized with NEON or SSE2 if available, with the same result
+ * as scalar code bit for bit.
+ * @{
+ */
+
+/// @brief Converts to GL_UNSIGNED_SHORT_5_6_5 (GL_RGB).
+/// @param premultiply Multiply color by alpha, so that opaque result blended
+/// over black looks the same as source with alpha.
+void convertToRGB565(const uint8_t* src, int channels, uint16_t* dst,
+                     uint32_t width, uint32_t height, bool premultiply, bool dither);
+
+/// @brief Converts to GL_UNSIGNED_SHORT_4_4_4_4 (GL_RGBA).
+void convertToRGBA4444(const uint8_t* src, int channels, uint16_t* dst,
+                       uint32_t width, uint32_t height, bool dither);
+
+/// @brief Converts to GL_UNSIGNED_SHORT_5_5_5_1 (GL_RGBA).
+/// @note Alpha is thresholded at 128.
+void convertToRGBA5551(const uint8_t* src, int channels, uint16_t* dst,
+                       uint32_t width, uint32_t height, bool dither);
+
+/// @brief Converts to GL_LUMINANCE_ALPHA of GL_UNSIGNED_BYTE type.
+/// @note Luminance is computed with BT.601 weights, alpha is 255 for RGB source.
+void convertToLA88(const uint8_t* src, int channels, uint8_t* dst,
+                   uint32_t width, uint32_t height);
+
+/** @} */  // end of PixelConverter group
+
+}  // namespace native
+
+#endif  // __ARKANOID_PIXEL_CONVERTER__H__
@@ -2,9 +2,13 @@
 #define __ARKANOID_PRIZE__H__
 
 #include <random>
+#include "SoundGroup.h"
 
 namespace game {
 
+class SnapshotReader;
+class SnapshotWriter;
+
 enum class Prize : int {
   NONE = 0,
   BLOCK = 1,      //! produces BRICK block (0 cardinality)    { level }
@@ -46,6 +50,9 @@ public:
   constexpr static int totalPrizes = 32;  // WIN not included
   constexpr static double prizeProbability = 0.315;
   constexpr static double winProbability = 0.0025;
+
+  static const char* getPrizeTexture(Prize prize);  //!< nullptr for NONE prize
+  static SoundGroup getPrizeSound(Prize prize);
 };
 
 class PrizeGenerator {
@@ -55,6 +62,9 @@ public:
 
   inline void setBonusPrizes(Prize prize_type) { m_bonus_prize = prize_type; }
 
+  void writeState(SnapshotWriter* writer) const;
+  bool readState(SnapshotReader* reader);
+
 private:
   Prize m_bonus_prize;
   std::default_random_engine m_generator;
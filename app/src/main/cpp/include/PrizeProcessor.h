@@ -6,15 +6,19 @@
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <GLES2/gl2.h>
 #include <jni.h>
 
 #include "ActiveObject.h"
 #include "Bite.h"
+#include "BlockChangeBatch.h"
 #include "Event.h"
 #include "EventListener.h"
 #include "PrizePackage.h"
+#include "Snapshot.h"
+#include "UiState.h"
 
 namespace game {
 
@@ -37,8 +41,8 @@ public:
   void callback_initBite(Bite bite);
   /// @brief Called when bite's location has changed.
   void callback_biteMoved(Bite moved_bite);
-  /// @brief Called when prize has been generated.
-  void callback_prizeReceived(PrizePackage package);
+  /// @brief Called when prizes have been generated within single tick.
+  void callback_blockChanged(BlockChangeBatch::Ptr batch);
   /// @brief Called when prize has been located.
   void callback_prizeLocated(PrizePackage package);
   /// @brief Called when prize has gone.
@@ -63,9 +67,21 @@ public:
    * @{
    */
   inline void setMasterObject(jobject object) { master_object = object; }
-  inline void setOnPrizeCatchMethodID(jmethodID id) { fireJavaEvent_prizeCatch_id = id; };
+  /// @brief Caught prizes go to block shared with UI instead of JNI upcalls.
+  inline void setUiState(UiState* ui_state) { m_ui_state = ui_state; }
   /** @} */  // end of JNIEnvironment group
 
+  /** @defgroup Snapshot Save and restore of falling prizes.
+   * @{
+   */
+  /// @brief Writes prizes section of snapshot, prizes at their last known locations.
+  void saveState(SnapshotWriter* writer);
+  /// @brief Reads prizes section of snapshot.
+  /// @return FALSE if section is corrupted.
+  /// @note Prizes are spawned again by GameProcessor::restoreState().
+  static bool readState(SnapshotReader* reader, std::vector<PrizePackage>* prizes);
+  /** @} */  // end of Snapshot group
+
 // ----------------------------------------------
 /* Public data-members */
 public:
@@ -78,8 +94,8 @@ public:
   EventListener<Bite> init_bite_listener;
   /// @brief Listens for bite location changes.
   EventListener<Bite> bite_location_listener;
-  /// @brief Listens for event which occurs when prize has been generated.
-  EventListener<PrizePackage> prize_listener;
+  /// @brief Listens for event which occurs when blocks have changed within single tick.
+  EventListener<BlockChangeBatch::Ptr> block_change_listener;
   /// @brief Listens for prize location changes.
   EventListener<PrizePackage> prize_location_listener;
   /// @brief Listens whether prize has gone.
@@ -98,7 +114,7 @@ private:
   JavaVM* m_jvm;  //!< Pointer to Java Virtual Machine in current session.
   JNIEnv* m_jenv;  //!< Pointer to environment local within this thread.
   jobject master_object;
-  jmethodID fireJavaEvent_prizeCatch_id;
+  UiState* m_ui_state;  //!< Block shared with UI, not owned.
   /** @} */  // end of JNIEnvironment group
 
   /** @defgroup LogicData Game logic related data members.
@@ -171,7 +187,7 @@ private:
   void addPrizeToRemoved(int prize_id);
   /// @brief Clears removed prizes.
   void clearRemovedPrizes();
-  /// @brief Notifies Java layer prize has been caught.
+  /// @brief Pushes caught prize to UI state.
   void onPrizeCatch(int prize_id);
   /** @} */  // end of LogicFunc group
 };
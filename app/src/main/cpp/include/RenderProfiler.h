@@ -0,0 +1,110 @@
+#ifndef __ARKANOID_RENDER_PROFILER__H__
+#define __ARKANOID_RENDER_PROFILER__H__
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Macro.h"
+
+namespace util {
+
+/// @brief Consecutive stages of a single rendered frame.
+enum class RenderStage : int {
+  STATIC_LAYER = 0,  //!< Background and level (cached or direct).
+  BITE_BALL = 1,     //!< Bite and ball.
+  EXPLOSION = 2,     //!< Particle system explosions.
+  SPRITES = 3,       //!< Laser, prizes and prize catch animation.
+  SWAP = 4           //!< Buffers swap, including driver flush.
+};
+
+/**
+ * @class RenderProfiler RenderProfiler.h "include/RenderProfiler.h"
+ * @brief Collects per-stage CPU time, draw call counts and frame time
+ * percentiles of render loop, and logs report every @a reportInterval frames.
+ *
+ * @details Every method is a no-op unless ENABLED_RENDER_PROFILER is set,
+ * so calls could be left in render loop unconditionally.
+ * Not thread-safe, must be owned by a single (render) thread.
+ */
+class RenderProfiler {
+public:
+  constexpr static bool enabled = ENABLED_RENDER_PROFILER;
+  constexpr static int totalStages = 5;
+  constexpr static int reportInterval = 300;  //!< Frames between reports.
+
+  /// @brief Statistics collected over single interval.
+  struct Profile {
+    size_t frames;  //!< Total frames within interval.
+    float p50, p90, p99, max;  //!< Frame time percentiles in ms.
+    double stage_time[totalStages];  //!< Average time in ms per frame of each stage.
+    double draw_calls[totalStages];  //!< Average draw calls per frame of each stage.
+    double total_draw_calls;  //!< Average draw calls per frame.
+    size_t latency_samples;  //!< Total touch-to-bite latency samples.
+    float latency_p50, latency_p90, latency_max;  //!< Touch-to-bite latency percentiles in ms.
+  };
+
+  /// @param report_interval Frames between reports, 0 to never report automatically.
+  explicit RenderProfiler(int report_interval = reportInterval);
+  virtual ~RenderProfiler() noexcept;
+
+  /// @brief Marks beginning of a frame and it's first stage.
+  inline void beginFrame() {
+    if (!enabled) return;
+    m_frame_start = std::chrono::steady_clock::now();
+    m_stage_start = m_frame_start;
+    m_stage_draw_calls = 0;
+  }
+
+  /// @brief Marks the end of specified stage, which started at the end
+  /// of the previous one (or at the beginning of frame).
+  inline void endStage(RenderStage stage) {
+    if (!enabled) return;
+    auto now = std::chrono::steady_clock::now();
+    int index = static_cast<int>(stage);
+    m_stage_time[index] += std::chrono::duration<double, std::milli>(now - m_stage_start).count();
+    m_draw_calls[index] += m_stage_draw_calls;
+    m_stage_start = now;
+    m_stage_draw_calls = 0;
+  }
+
+  /// @brief Counts single glDraw* call within current stage.
+  inline void onDrawCall() {
+    if (!enabled) return;
+    ++m_stage_draw_calls;
+  }
+
+  /// @brief Records delay between touch sample and the frame it has been applied in.
+  inline void onInputLatency(float latency_ms) {
+    if (!enabled) return;
+    m_input_latencies.push_back(latency_ms);
+  }
+
+  /// @brief Marks the end of a frame, reports statistics if interval has elapsed.
+  void endFrame();
+
+  /// @brief Summarizes statistics collected so far and starts a new interval.
+  /// @return FALSE if no frame has been collected.
+  bool takeProfile(Profile* profile);
+
+  /// @brief Human-readable name of render stage.
+  static const char* getStageName(RenderStage stage);
+
+private:
+  /// @brief Logs collected statistics and starts a new interval.
+  void report();
+
+  int m_report_interval;  //!< Frames between reports, 0 if never.
+
+  std::chrono::steady_clock::time_point m_frame_start;
+  std::chrono::steady_clock::time_point m_stage_start;
+  uint32_t m_stage_draw_calls;  //!< Draw calls within current stage.
+  double m_stage_time[totalStages];  //!< Accumulated time in ms per stage.
+  uint64_t m_draw_calls[totalStages];  //!< Accumulated draw calls per stage.
+  std::vector<float> m_frame_times;  //!< Frame times in ms within current interval.
+  std::vector<float> m_input_latencies;  //!< Touch-to-bite latencies in ms within current interval.
+};
+
+}
+
+#endif  // __ARKANOID_RENDER_PROFILER__H__
@@ -0,0 +1,186 @@
+#ifndef __ARKANOID_RENDERER__H__
+#define __ARKANOID_RENDERER__H__
+
+#include <vector>
+
+#include <GLES2/gl2.h>
+
+#include "Ball.h"
+#include "Bite.h"
+#include "ExplosionPackage.h"
+#include "FrameArena.h"
+#include "Level.h"
+#include "LevelPreloader.h"
+#include "ParticleSystem.h"
+#include "Prize.h"
+#include "PrizePackage.h"
+#include "RenderProfiler.h"
+#include "Resources.h"
+#include "rgbstruct.h"
+#include "RowCol.h"
+#include "Shader.h"
+#include "Texture.h"
+
+namespace game {
+
+/**
+ * @class Renderer Renderer.h "include/Renderer.h"
+ * @brief Draw routines of game scene along with GL objects and buffers they use.
+ * @details Renderer knows neither surface nor events: AsyncContext feeds it
+ * with state of the game, advances animation timers and swaps buffers, while
+ * headless benchmark drives it over off-screen surface the very same way.
+ * @note Must be used on the thread owning GL context.
+ */
+class Renderer {
+public:
+  /// @param report_interval Frames between reports of profiler, see RenderProfiler.
+  explicit Renderer(int report_interval = util::RenderProfiler::reportInterval);
+  virtual ~Renderer() noexcept;
+
+  /** @defgroup Context Lifecycle of GL objects.
+   * @{
+   */
+  /// @brief Creates shaders and static layer for current context, re-uploads
+  /// buffers of level, since buffer objects of previous context are gone.
+  void init(GLint width, GLint height);
+  /// @brief Deletes buffer objects and static layer, context must still be current.
+  void release();
+  /** @} */  // end of Context group
+
+  /** @defgroup Scene Set state of the game to be drawn.
+   * @{
+   */
+  /// @brief Resolves textures used by draw routines from loaded resources.
+  void setTextures(const Resources* resources);
+  void setBackground(const native::Texture* background);
+  /// @brief Takes geometry of newly loaded level, buffers of @a prepared are swapped.
+  void setLevel(Level::Ptr level, PreparedLevel* prepared);
+  /// @brief Applies published version of level, re-uploading colors of changed blocks.
+  void changeLevel(Level::Ptr snapshot, const std::vector<RowCol>& changes);
+  /// @brief Marks cached static layer as outdated, it will be re-rendered next frame.
+  inline void invalidateStaticLayer() { m_static_layer_valid = false; }
+  /// @param x Rendered position of bite, which may be ahead of physical one.
+  void setBitePose(const Bite& bite, GLfloat x);
+  void setBallPose(const Ball& ball, GLfloat x, GLfloat y);
+  /// @brief Sets bite's and ball's appearance according to current ball's effect.
+  void setBiteBallAppearance(BallEffect effect);
+  void spawnExplosion(const ExplosionPackage& package);
+  inline bool hasExplosions() const { return !m_particle_system.empty(); }
+  /** @} */  // end of Scene group
+
+  /** @defgroup Drawings Draw routines, each stage of frame is timed by profiler.
+   * @{
+   */
+  void beginFrame();
+  /// @brief Releases scratch memory of frame, called after buffers swap.
+  void endFrame();
+  inline util::RenderProfiler& getProfiler() { return m_profiler; }
+
+  /// @brief Draws background and level, cached in offscreen framebuffer if available.
+  void drawStaticLayer();
+  /// @brief Draws bite at it's current position.
+  void drawBite();
+  /// @brief Draws ball at it's current position.
+  void drawBall();
+  /// @brief Draws all live particle system explosions in a single call.
+  void drawExplosion();
+  /// @brief Draws prize falling for @a time (in seconds).
+  void drawPrize(const PrizePackage& prize, float time, bool is_visible);
+  /// @brief Draws prize catch animation at moment @a time (in seconds).
+  void drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, float time);
+  /// @brief Draws laser sprite originated at specified point, climbing for @a time (in seconds).
+  void drawLaser(GLfloat x, GLfloat y, float time, bool is_visible);
+  /** @} */  // end of Drawings group
+
+private:
+  /// @brief Initializes particle spiral system.
+  void initParticleSystem();
+  /// @brief Uploads vertices and colors of current level to buffer objects.
+  /// @note Does nothing until both context and level are ready.
+  void uploadLevelBuffers();
+  /// @brief Re-uploads colors of the specified block to buffer object.
+  void updateLevelColorBuffer(int row, int col);
+  /// @brief Creates offscreen framebuffer of surface size for static layer.
+  /// @note Static layer is drawn directly each frame if framebuffer is incomplete.
+  void initStaticLayer();
+  /// @brief Renders static layer into offscreen framebuffer.
+  void renderStaticLayer();
+
+  /// @brief Draws background and all blocks of current level.
+  void drawStaticLayerDirect();
+  /// @brief Draws cached static layer as single full-screen quad.
+  void drawStaticLayerCache();
+  /// @brief Draws current level's state.
+  void drawLevel();
+  /// @brief Draws block of current level.
+  void drawBlock(int row, int col);
+  /// @brief Draws textured block of current level,
+  void drawTexturedBlock(int row, int col, const native::Texture* texture);
+  /// @brief Draws textured background.
+  void drawBackground();
+
+private:
+  constexpr static int particleSpiralSize = 4;
+  constexpr static int particeSpiralSystemBranches = 4;
+  constexpr static int particleSpiralSystemBranchSize = 100;
+  constexpr static int particleSpiralSystemSize = particleSpiralSystemBranchSize * particeSpiralSystemBranches;
+
+  GLint m_width, m_height;  //!< Surface sizes.
+  GLfloat m_aspect;  //!< Surface aspect ratio.
+  bool m_is_ready;  //!< Whether shaders have been created for current context.
+
+  GLfloat* m_bite_vertex_buffer;  //!< Re-usable buffer for 2D vertices of bite.
+  GLubyte* m_bite_color_buffer;   //!< Re-usable buffer for colors of bite.
+  GLfloat* m_ball_vertex_buffer;  //!< Re-usable buffer for 2D vertices of ball.
+  GLubyte* m_ball_color_buffer;   //!< Re-usable buffer for color of ball.
+  GLfloat* m_bg_vertex_buffer;    //!< Re-usable buffer for background vertices.
+  GLfloat* m_particle_spiral_buffer;     //!< Re-usable buffer for particle spiral system.
+  GLushort* m_rectangle_index_buffer;    //!< Re-usable buffer for indices of rectangle.
+  GLushort* m_octagon_index_buffer;      //!< Re-usable buffer for indices of octagon.
+  GLfloat* m_rectangle_texCoord_buffer;  //!< Re-usable buffer for texture coords of rectangle.
+  GLfloat* m_static_layer_texCoord_buffer;  //!< Texture coords of full-screen static layer quad.
+
+  Level::Ptr m_level;  //!< Latest applied version of level, never modified.
+  std::vector<GLfloat> m_level_vertex_buffer;  //!< Vertices of level, swapped with preloaded ones.
+  std::vector<GLubyte> m_level_color_buffer;   //!< Colors of level.
+  std::vector<GLushort> m_level_index_buffer;  //!< Indices of level's blocks.
+  GLuint m_level_vertex_vbo;  //!< Static buffer object with vertices of level.
+  GLuint m_level_color_vbo;   //!< Dynamic buffer object with colors of level.
+  GLuint m_particle_vbo;      //!< Dynamic buffer object with slots of particle system.
+
+  /// @brief Offscreen framebuffer caching background and level, which change
+  /// only on block impact, level load or surface change.
+  GLuint m_static_layer_fbo;
+  GLuint m_static_layer_texture;  //!< Color attachment of static layer framebuffer.
+  bool m_static_layer_valid;  //!< Whether cached static layer is up to date.
+
+  /// @brief Scratch memory for transient vertex and uniform data, reset at swap.
+  util::FrameArena m_frame_arena;
+  util::RenderProfiler m_profiler;  //!< Render stages statistics, see ENABLED_RENDER_PROFILER.
+  ParticleSystem m_particle_system;  //!< Pool of live explosion emitters.
+
+  /** @defgroup Shaders Shaders for rendering game components.
+   * @{
+   */
+  shader::ShaderHelper::Ptr m_level_shader;
+  shader::ShaderHelper::Ptr m_bite_shader;
+  shader::ShaderHelper::Ptr m_ball_shader;
+  shader::ShaderHelper::Ptr m_explosion_shader;
+  shader::ShaderHelper::Ptr m_sample_shader;
+  shader::ShaderHelper::Ptr m_prize_shader;
+  shader::ShaderHelper::Ptr m_prize_catch_shader;
+  shader::ShaderHelper::Ptr m_laser_shader;
+  /** @} */  // end of Shaders group
+
+  const native::Texture* m_bg_texture;
+  /// @brief Textures resolved once after loading to avoid lookup by name in render loop.
+  const native::Texture* m_block_textures[BlockUtils::totalBlocks];
+  const native::Texture* m_prize_textures[PrizeUtils::totalPrizes + 1];
+  const native::Texture* m_smoke_texture;
+  const native::Texture* m_spark_texture;
+  const native::Texture* m_laser_texture;
+};
+
+}  // namespace game
+
+#endif  // __ARKANOID_RENDERER__H__
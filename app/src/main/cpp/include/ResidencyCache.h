@@ -0,0 +1,139 @@
+#ifndef __ARKANOID_RESIDENCY_CACHE__H__
+#define __ARKANOID_RESIDENCY_CACHE__H__
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "logger.h"
+
+namespace native {
+
+/// @brief Residency statistics of a single resource class.
+struct ResidencyStats {
+  size_t budget;          //!< Memory budget (in bytes).
+  size_t resident_bytes;  //!< Memory taken by resident resources (in bytes).
+  size_t peak_bytes;      //!< Maximum of resident memory ever reached (in bytes).
+  int resident;           //!< Total resident resources.
+  int hits;               //!< Requests of resident resources.
+  int misses;             //!< Requests of resources which had to be loaded.
+  int prefetches;         //!< Resources loaded ahead of request.
+  int evictions;          //!< Resources unloaded to fit the budget.
+};
+
+/**
+ * @class ResidencyCache ResidencyCache.h "include/ResidencyCache.h"
+ * @brief Keeps track of recently used resources of a single class and
+ * evicts least recently used ones once resident memory exceeds the budget.
+ * @details Cache doesn't load anything by itself: resource size is queried
+ * through @a SizeOf callback (0 means resource is not resident) and eviction
+ * is delegated to @a Evict callback.
+ * @note Not thread-safe, each cache is supposed to be accessed by the thread
+ * owning corresponding resources.
+ */
+template <typename Resource>
+class ResidencyCache {
+public:
+  typedef std::function<size_t(const Resource*)> SizeOf;
+  typedef std::function<void(Resource*)> Evict;
+  typedef std::function<bool(const Resource*)> Pinned;
+
+  ResidencyCache(const char* name, size_t budget, SizeOf size_of, Evict evict)
+    : m_name(name)
+    , m_size_of(size_of)
+    , m_evict(evict)
+    , m_stats{budget, 0, 0, 0, 0, 0, 0, 0} {
+  }
+
+  inline void setBudget(size_t budget) { m_stats.budget = budget; }
+  inline size_t getBudget() const { return m_stats.budget; }
+
+  /// @brief Marks resource as most recently used.
+  /// @param prefetch Whether resource is requested ahead of use.
+  /// @return Whether resource is resident, otherwise caller must load it.
+  bool touch(Resource* resource, bool prefetch = false) {
+    auto it = m_index.find(resource);
+    if (it != m_index.end()) {
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+    } else {
+      m_lru.push_front(resource);
+      m_index[resource] = m_lru.begin();
+    }
+    bool resident = m_size_of(resource) > 0;
+    if (prefetch) {
+      m_stats.prefetches += resident ? 0 : 1;
+    } else if (resident) {
+      ++m_stats.hits;
+    } else {
+      ++m_stats.misses;
+    }
+    return resident;
+  }
+
+  /// @brief Evicts least recently used resources until resident memory fits
+  /// the budget. Most recently used resource is never evicted.
+  /// @param pinned Resources being in use, which must not be evicted.
+  void trim(const Pinned& pinned = nullptr) {
+    size_t total = 0;
+    for (auto resource : m_lru) {
+      total += m_size_of(resource);
+    }
+    if (total > m_stats.peak_bytes) {
+      m_stats.peak_bytes = total;
+    }
+    auto it = m_lru.end();
+    while (total > m_stats.budget && it != m_lru.begin()) {
+      --it;
+      if (it == m_lru.begin()) {
+        break;
+      }
+      size_t size = m_size_of(*it);
+      if (size == 0 || (pinned && pinned(*it))) {
+        continue;
+      }
+      DBG("Evicting %s resource %p: %zu bytes", m_name, *it, size);
+      m_evict(*it);
+      total -= size;
+      ++m_stats.evictions;
+      m_index.erase(*it);
+      it = m_lru.erase(it);
+    }
+    m_stats.resident_bytes = total;
+  }
+
+  /// @brief Gets statistics, resident memory is recalculated.
+  ResidencyStats getStats() const {
+    ResidencyStats stats = m_stats;
+    stats.resident_bytes = 0;
+    stats.resident = 0;
+    for (auto resource : m_lru) {
+      size_t size = m_size_of(resource);
+      stats.resident_bytes += size;
+      stats.resident += size > 0 ? 1 : 0;
+    }
+    return stats;
+  }
+
+  /// @brief Prints statistics to log, no-op unless logging is enabled.
+  void report() const {
+#if ENABLED_LOGGING
+    ResidencyStats stats = getStats();
+    INF("Residency of %s: %i resident, %zu / %zu KB (peak %zu KB), hits %i, misses %i, prefetches %i, evictions %i",
+        m_name, stats.resident, stats.resident_bytes >> 10, stats.budget >> 10, stats.peak_bytes >> 10,
+        stats.hits, stats.misses, stats.prefetches, stats.evictions);
+#endif
+  }
+
+private:
+  const char* m_name;
+  SizeOf m_size_of;
+  Evict m_evict;
+  std::list<Resource*> m_lru;  //!< Most recently used resource goes first.
+  std::unordered_map<Resource*, typename std::list<Resource*>::iterator> m_index;
+  ResidencyStats m_stats;
+};
+
+}  // namespace native
+
+#endif  // __ARKANOID_RESIDENCY_CACHE__H__
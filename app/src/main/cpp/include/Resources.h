@@ -23,19 +23,11 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_init
 
 /*
  * Class:     com_orcchg_arkanoid_surface_NativeResources
- * Method:    readTexture
- * Signature: (JLjava/lang/String;)Z
+ * Method:    readAssets
+ * Signature: (J)Z
  */
-JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readTexture
-  (JNIEnv *, jobject, jlong, jstring);
-
-/*
- * Class:     com_orcchg_arkanoid_surface_NativeResources
- * Method:    readSound
- * Signature: (JLjava/lang/String;)Z
- */
-JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readSound
-  (JNIEnv *, jobject, jlong, jstring);
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readAssets
+  (JNIEnv *, jobject, jlong);
 
 /*
  * Class:     com_orcchg_arkanoid_surface_NativeResources
@@ -52,15 +44,21 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_release
 
 /* Core */
 // ----------------------------------------------------------------------------
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <cstdlib>
 
 #include "Level.h"
+#include "LevelPack.h"
 #include "Prize.h"
+#include "ResidencyCache.h"
 #include "SoundBuffer.h"
+#include "SoundGroup.h"
 #include "Texture.h"
+#include "TextureCache.h"
 
 namespace game {
 
@@ -71,16 +69,32 @@ public:
   Resources(JNIEnv* jenv, jobject assets, jstring internalFileStorage_Java);
   ~Resources() noexcept;
 
+  /// @brief Registers all textures and sounds, enumerated natively
+  /// from asset pack if present, or from asset directories otherwise.
+  bool readAssets();
+
   /** @defgroup Texture Access texture resources.
    * @{
    */
   typedef std::unordered_map<std::string, native::Texture*>::iterator tex_iterator;
   typedef std::unordered_map<std::string, native::Texture*>::const_iterator const_tex_iterator;
 
-  bool readTexture(jstring filename);
+  typedef int TextureHandle;  //!< Index of texture, interned at registration.
+  constexpr static TextureHandle invalidHandle = -1;
+
+  bool readTexture(const std::string& name);
+  /// @brief Resolves handle of texture by name, invalidHandle if not registered.
+  TextureHandle getTextureHandle(const std::string& name) const;
+  /// @return Texture, nullptr if handle is out of range (e.g. invalidHandle).
+  const native::Texture* const getTexture(TextureHandle handle) const;
+  /// @brief Resolves texture through its handle, nullptr if not registered.
   const native::Texture* const getTexture(const std::string& name) const;
+  /// @brief Chooses random texture from group of names sharing the prefix
+  /// before the first underscore, e.g. "bg" for 'bg_blueov.png'.
   const native::Texture* const getRandomTexture(const std::string& prefix) const;
   const native::Texture* const getPrizeTexture(const Prize& prize) const;
+  /// @brief Chooses format of texture in Graphic memory by it's name.
+  static void setTextureFormat(native::Texture* texture, const std::string& name);
 
   tex_iterator beginTexture();
   tex_iterator endTexture();
@@ -94,9 +108,9 @@ public:
   typedef std::unordered_map<std::string, native::SoundBuffer*>::iterator sound_iterator;
   typedef std::unordered_map<std::string, native::SoundBuffer*>::const_iterator const_sound_iterator;
 
-  bool readSound(jstring filename);
+  bool readSound(const std::string& name);
   const native::SoundBuffer* const getSound(const std::string& name) const;
-  const native::SoundBuffer* const getRandomSound(const std::string& prefix) const;
+  const native::SoundBuffer* const getRandomSound(SoundGroup group) const;
 
   sound_iterator beginSound();
   sound_iterator endSound();
@@ -104,13 +118,83 @@ public:
   const_sound_iterator cendSound() const;
   /** @} */  // end of Sound group
 
+  /** @defgroup Residency Load resources on demand within memory budget
+   * per resource class, least recently used ones are evicted.
+   * @{
+   */
+  typedef native::ResidencyCache<native::SoundBuffer>::Pinned SoundPinned;
+
+  constexpr static size_t defaultBackgroundBudget = 2 * 1024 * 1024;  //!< Single 1024 x 1024 RGB565 image.
+  constexpr static size_t defaultSoundBudget = 2 * 1024 * 1024;
+
+  /// @brief Whether texture is a background, backgrounds are loaded on demand.
+  static bool isBackground(const std::string& name);
+
+  void setBackgroundBudget(size_t bytes);
+  void setSoundBudget(size_t bytes);
+
+  /// @brief Chooses random background and marks it as recently used.
+  /// @return Background texture, caller must load it if it's not resident (getID() == 0).
+  /// @note Must be called on the thread owning GL context.
+  native::Texture* acquireBackground();
+  /// @brief Evicts least recently used backgrounds beyond the budget.
+  /// @note Must be called on the thread owning GL context, after acquired
+  /// background has been uploaded.
+  void trimBackgrounds();
+
+  /// @brief Chooses random sound from group and loads it if it's not resident,
+  /// evicting least recently used sounds beyond the budget.
+  /// @param pinned Sounds being played, which must not be evicted.
+  /// @return Resident sound or nullptr if it has failed to load.
+  /// @note Must be called on the thread playing sounds.
+  const native::SoundBuffer* const acquireSound(SoundGroup group, const SoundPinned& pinned);
+  /// @brief Loads all sounds of group ahead of use.
+  /// @return Whether all sounds have been loaded successfully.
+  /// @note Must be called on the thread playing sounds.
+  bool prefetchSounds(SoundGroup group, const SoundPinned& pinned);
+
+  /// @brief Prints residency statistics of backgrounds to log.
+  /// @note Must be called on the thread owning GL context.
+  void reportBackgroundResidency() const;
+  /// @brief Prints residency statistics of sounds to log.
+  /// @note Must be called on the thread playing sounds.
+  void reportSoundResidency() const;
+  /** @} */  // end of Residency group
+
+  /** @defgroup Levels Access levels from binary level pack.
+   * @{
+   */
+  /// @brief Whether level pack has been mapped.
+  bool hasLevelPack() const;
+  int getLevelsCount() const;
+  /// @brief Loads level by index, out-of-range index stands for the first level.
+  /// @return Level, nullptr if there is no level pack or level is corrupted.
+  Level::Ptr loadLevel(int index) const;
+  /** @} */  // end of Levels group
+
   Ptr getSharedPtr();
 
 private:
+  /// @brief Maps level pack from assets, if present.
+  void openLevelPack();
+  /// @brief Chooses random item of group, nullptr if group is empty.
+  template <typename T>
+  static T* pickRandom(const std::vector<T*>& group);
+
   JNIEnv* m_jenv;
   AssetStorage* m_assets;
+  native::TextureCache* m_texture_cache;  //!< Decoded textures in internal storage.
   std::unordered_map<std::string, native::Texture*> m_textures;
+  std::unordered_map<std::string, TextureHandle> m_texture_handles;
+  std::vector<native::Texture*> m_texture_table;  //!< Textures by handle.
+  std::unordered_map<std::string, std::vector<native::Texture*>> m_texture_groups;  //!< Textures by prefix of name.
+  const native::Texture* m_prize_textures[PrizeUtils::totalPrizes + 1];  //!< Textures by prize.
   std::unordered_map<std::string, native::SoundBuffer*> m_sounds;
+  std::vector<native::SoundBuffer*> m_sound_groups[SoundGroupUtils::totalGroups];  //!< Sounds by group.
+  native::ResidencyCache<native::Texture> m_background_residency;
+  native::ResidencyCache<native::SoundBuffer> m_sound_residency;
+
+  LevelPack::Ptr m_level_pack;  //!< Mapped levels, nullptr if absent.
 };
 
 }
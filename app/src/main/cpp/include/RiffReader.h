@@ -0,0 +1,62 @@
+#ifndef __ARKANOID_RIFF_READER__H__
+#define __ARKANOID_RIFF_READER__H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace native {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IMA_ADPCM = 0x0011;
+constexpr size_t WAV_HEADER_SIZE = 44;  //!< Canonical PCM header: 'RIFF', 'fmt ' and 'data' chunk headers.
+constexpr size_t WAV_ADPCM_HEADER_SIZE = 60;  //!< IMA-ADPCM header, with extended 'fmt ' chunk and 'fact' chunk.
+
+/// @brief Format of samples, as stored in 'fmt ' chunk of WAV file.
+struct PCMFormat {
+  uint16_t audio_format;  //!< WAVE_FORMAT_PCM or WAVE_FORMAT_IMA_ADPCM.
+  uint16_t channels;
+  uint32_t sample_rate;
+  uint16_t block_align;  //!< Bytes per frame (PCM) or per block (ADPCM) of all channels.
+  uint16_t bits_per_sample;
+};
+
+enum class RiffError : int {
+  NONE = 0,
+  TRUNCATED = 1,    //!< File is shorter than its headers claim.
+  NOT_RIFF = 2,     //!< No 'RIFF' signature.
+  NOT_WAVE = 3,     //!< RIFF form type isn't 'WAVE'.
+  NO_FORMAT = 4,    //!< 'fmt ' chunk is absent or precedes no 'data' chunk.
+  BAD_FORMAT = 5,   //!< 'fmt ' chunk is inconsistent or isn't integer PCM nor IMA-ADPCM.
+  NO_DATA = 6       //!< 'data' chunk is absent.
+};
+
+const char* toString(RiffError error);
+
+/// @brief Walks RIFF chunks of WAV file in memory, validates format and
+/// locates PCM samples without copying.
+/// @param data Content of the whole file.
+/// @param size Size of the content.
+/// @param format Output format of samples.
+/// @param pcm Output pointer to samples within @a data.
+/// @param pcm_size Output size of samples (in bytes), whole PCM frames only.
+/// @details Unknown chunks are skipped, 'data' chunk running past the end
+/// of file is truncated to the whole PCM frames available, ADPCM blocks
+/// are kept as is, the last one could be partial.
+RiffError parseWAV(const uint8_t* data, size_t size,
+                   PCMFormat* format, const uint8_t** pcm, size_t* pcm_size);
+
+/// @brief Size of header written by writeWAVHeader() for @a format.
+size_t getWAVHeaderSize(const PCMFormat& format);
+
+/// @brief Writes header of WAV file, to be followed by samples.
+/// @param format Format of samples.
+/// @param data_size Size of samples (in bytes).
+/// @param header Output buffer of getWAVHeaderSize() bytes.
+/// @details PCM header is canonical one. IMA-ADPCM header has 20-byte 'fmt '
+/// chunk, ending with cbSize and wSamplesPerBlock, and 'fact' chunk with
+/// number of samples per channel, both required for format 0x11.
+void writeWAVHeader(const PCMFormat& format, uint32_t data_size, uint8_t* header);
+
+}  // namespace native
+
+#endif  // __ARKANOID_RIFF_READER__H__
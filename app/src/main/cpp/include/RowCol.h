@@ -5,9 +5,14 @@
 
 namespace game {
 
+/// @brief Cell of level. Meaning of block depends on producer: modifiers
+/// of Level output block the cell had before modification, journal of
+/// changes (Level::commit()) holds block the cell has been set to,
+/// finders of Level leave it NONE.
+/// @see BlockChange for cell with both blocks.
 struct RowCol {
   int row, col;
-  Block block;
+  Block block;  //!< Old block in modifiers output, new block in journal.
 
   RowCol(int row = 0, int col = 0, Block block = Block::NONE)
     : row(row), col(col), block(block) {
@@ -0,0 +1,32 @@
+#ifndef __ARKANOID_SAMPLE_CONVERTER__H__
+#define __ARKANOID_SAMPLE_CONVERTER__H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "RiffReader.h"
+
+namespace native {
+
+/**
+ * @defgroup SampleConverter Conversion of integer PCM samples of WAV files
+ * into mono 16-bit samples at given sample rate.
+ *
+ * @details Source is 8-bit unsigned or 16-bit signed PCM of any number
+ * of channels, which are averaged. Resampling is linear.
+ * @{
+ */
+
+/// @brief Number of frames @a size bytes of samples in @a format are converted into.
+size_t getConvertedFrames(size_t size, const PCMFormat& format, uint32_t sample_rate);
+
+/// @brief Converts samples into mono 16-bit at @a sample_rate.
+/// @param output Buffer of getConvertedFrames() samples.
+void convertToMono16(const uint8_t* pcm, size_t size, const PCMFormat& format,
+                     uint32_t sample_rate, int16_t* output);
+
+/** @} */  // end of SampleConverter group
+
+}  // namespace native
+
+#endif  // __ARKANOID_SAMPLE_CONVERTER__H__
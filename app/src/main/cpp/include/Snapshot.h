@@ -0,0 +1,138 @@
+#ifndef __ARKANOID_SNAPSHOT__H__
+#define __ARKANOID_SNAPSHOT__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace game {
+
+/// @brief Header at the beginning of snapshot, little-endian.
+/// @details Header is followed by payload, or by delta of payload against
+/// base payload if Snapshot::DELTA flag is set.
+struct SnapshotHeader {
+  char magic[4];  //!< "ARKS"
+  uint16_t version;
+  uint16_t flags;
+  uint32_t size;  //!< Size of payload, once delta has been applied.
+  uint32_t checksum;  //!< Snapshot::checksum() of payload.
+  uint32_t base_checksum;  //!< Checksum of base payload for delta, 0 otherwise.
+};
+
+/// @brief Payload consists of sections: tag (1 byte), size (4 bytes) and body.
+/// @note Unknown sections are skipped, so that older builds read newer snapshots.
+enum class SnapshotSection : uint8_t {
+  LEVEL = 1,   //!< Blocks, cardinality and generators of level.
+  GAME = 2,    //!< Ball, effects and timers of GameProcessor.
+  PRIZES = 3,  //!< Falling prizes of PrizeProcessor.
+  ENVIRONMENT = 4  //!< Dimensions measured by renderer, only in keyframes of recordings.
+};
+
+/**
+ * @class SnapshotWriter Snapshot.h "include/Snapshot.h"
+ * @brief Appends values to payload of snapshot, in native byte order
+ * (little-endian on all supported ABIs).
+ */
+class SnapshotWriter {
+public:
+  explicit SnapshotWriter(std::vector<uint8_t>* out);
+
+  template <typename T>
+  void put(T value) {
+    static_assert(std::is_arithmetic<T>::value, "Only arithmetic values could be written");
+    putBytes(&value, sizeof(T));
+  }
+  void putBytes(const void* data, size_t size);
+  void putString(const std::string& str);
+  /// @brief Writes state of random engine or distribution, in its
+  /// standard textual form.
+  template <typename Random>
+  void putRandom(const Random& random) {
+    std::ostringstream out;
+    out << random;
+    putString(out.str());
+  }
+
+  void beginSection(SnapshotSection section);
+  void endSection();
+
+private:
+  std::vector<uint8_t>* m_out;
+  size_t m_section;  //!< Offset of size of currently open section.
+};
+
+/**
+ * @class SnapshotReader Snapshot.h "include/Snapshot.h"
+ * @brief Reads values from payload of snapshot with bounds checking,
+ * any failed read makes reader invalid.
+ */
+class SnapshotReader {
+public:
+  SnapshotReader();
+  SnapshotReader(const uint8_t* data, size_t size);
+
+  template <typename T>
+  bool get(T* value) {
+    static_assert(std::is_arithmetic<T>::value, "Only arithmetic values could be read");
+    return getBytes(value, sizeof(T));
+  }
+  bool getBytes(void* data, size_t size);
+  bool getString(std::string* str);
+  template <typename Random>
+  bool getRandom(Random* random) {
+    std::string state;
+    if (getString(&state)) {
+      std::istringstream in(state);
+      in >> *random;
+      m_is_valid = !in.fail();
+    }
+    return m_is_valid;
+  }
+
+  /// @brief Steps to the next section of payload.
+  /// @param body Output reader of section's body.
+  /// @return FALSE at the end of payload or if section is truncated.
+  bool nextSection(SnapshotSection* section, SnapshotReader* body);
+
+  inline bool isValid() const { return m_is_valid; }
+  inline bool atEnd() const { return m_offset == m_size; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_offset;
+  bool m_is_valid;
+};
+
+/**
+ * @class Snapshot Snapshot.h "include/Snapshot.h"
+ * @brief Wraps payload of game state into versioned blob, optionally as
+ * delta against previous payload.
+ * @details Delta is XOR of payloads encoded as pairs of varint counts:
+ * run of unchanged bytes and run of changed ones, followed by XOR-ed bytes
+ * of the latter. Within single level only ball, timers and few blocks change
+ * between snapshots, so delta is mostly a handful of runs.
+ */
+class Snapshot {
+public:
+  constexpr static uint16_t version = 1;
+  constexpr static uint16_t DELTA = 1;
+
+  static void pack(const std::vector<uint8_t>& payload, std::vector<uint8_t>* blob);
+  static void packDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& payload, std::vector<uint8_t>* blob);
+  /// @brief Validates blob and extracts payload from it.
+  /// @param base Payload delta has been made against, ignored for full blobs.
+  /// @return FALSE if blob is corrupted, of unknown version or
+  /// delta has been made against other base.
+  static bool unpack(const uint8_t* blob, size_t size, const std::vector<uint8_t>& base, std::vector<uint8_t>* payload);
+
+  /// @brief FNV-1a hash of payload.
+  static uint32_t checksum(const uint8_t* data, size_t size);
+};
+
+}
+
+#endif  // __ARKANOID_SNAPSHOT__H__
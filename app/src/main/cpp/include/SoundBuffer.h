@@ -2,25 +2,51 @@
 #define __ARKANOID_SOUND_BUFFER__H__
 
 #include "AssetStorage.h"
+#include "RiffReader.h"
 
 namespace native {
 
 class SoundBuffer {
 public:
-  SoundBuffer(AssetStorage* assets, const char* filename);
-  SoundBuffer(const char* filepath);
+  constexpr static uint32_t outputSampleRate = 44100;
+
+  /// @brief Representation of samples held in memory.
+  enum class Encoding : int {
+    PCM16 = 0,     //!< Mono 16-bit PCM.
+    IMA_ADPCM = 1  //!< Mono IMA-ADPCM blocks, 4 times smaller.
+  };
+
+  SoundBuffer(AssetStorage* assets, const char* filename, Encoding encoding);
+  SoundBuffer(const char* filepath, Encoding encoding);
   virtual ~SoundBuffer();
 
   const char* getFilename() const;
+  /// @brief File name without directory.
   const char* getName() const;
-  uint8_t* const getData() const;
+  /// @brief Samples at outputSampleRate in getEncoding(), nullptr unless loaded.
+  const uint8_t* getData() const;
   off_t getLength() const;
+  Encoding getEncoding() const;
+  size_t getFrames() const;
+  /// @brief Size of single IMA-ADPCM block, 0 for PCM16.
+  size_t getBlockAlign() const;
+  size_t getSamplesPerBlock() const;
+  /// @brief Decodes single IMA-ADPCM block of samples.
+  /// @param output Buffer of at least getSamplesPerBlock() samples.
+  /// @return Number of decoded samples.
+  size_t decodeBlock(size_t block, int16_t* output) const;
 
   virtual bool load();
   virtual void unload();
 
 protected:
-  virtual uint8_t* loadSound() = 0;
+  /// @brief Loads samples and sets length of them.
+  /// @return Samples either owned or referenced within mapped file.
+  virtual const uint8_t* loadSound() = 0;
+  /// @brief Maps the whole file into memory without copying.
+  const uint8_t* mapFile(size_t* size);
+  /// @brief Releases mapping made by mapFile(), if any.
+  void unmapFile();
 
   enum class ReadMode : int {
     ASSETS = 0, FILESYSTEM = 1
@@ -30,47 +56,48 @@ protected:
   AssetStorage* m_assets;
   char* m_filename;
   off_t m_length;
-  uint8_t* m_data;
+  const uint8_t* m_data;
+  Encoding m_encoding;  //!< Encoding of samples in memory.
+  size_t m_frames;
+  size_t m_block_align;
+  uint8_t* m_owned_data;  //!< Samples converted from source format, if any.
+  AAsset* m_asset_mapping;  //!< Mapped asset, if samples are referenced within it, not within pack.
+  void* m_file_mapping;  //!< Mapped file, if samples are referenced within it.
+  size_t m_file_mapping_size;
   int m_error_code;
 };
 
 /**
  * Error codes (SoundBuffer)
  *
- * 2021 - assets->open() failed
- * 2022 - data allocation failed from assets
- * 2023 - assets->read() failed
- * 2024 - fopen() failed
- * 2025 - data allocation failed from file
- * 2026 - fread() failed
+ * 2021 - assets->map() failed
+ * 2022 - parseWAV() failed, wrong RIFF structure
+ * 2023 - unsupported sample format
+ * 2024 - open() failed
+ * 2025 - mmap() failed
+ * 2026 - samples allocation failed during conversion
+ * 2027 - IMA-ADPCM file isn't mono at outputSampleRate
  */
 
 // ----------------------------------------------------------------------------
 /// @brief Class allows to operate with WAV and PCM files.
+/// @details IMA-ADPCM and mono 16-bit PCM samples at outputSampleRate are
+/// referenced within mapped file, PCM samples of other formats are converted
+/// into the latter. Sounds are never encoded at runtime, shipped ones are
+/// encoded into IMA-ADPCM offline by tools/soundbank.
 class WAVSound : public SoundBuffer {
 public:
   WAVSound(AssetStorage* assets, const char* filename);
   WAVSound(const char* filepath);
   virtual ~WAVSound();
 
-  struct WAVHeader{
-    char                RIFF[4];
-    unsigned long       ChunkSize;
-    char                WAVE[4];
-    char                fmt[4];
-    unsigned long       Subchunk1Size;
-    unsigned short      AudioFormat;
-    unsigned short      NumOfChan;
-    unsigned long       SamplesPerSec;
-    unsigned long       bytesPerSec;
-    unsigned short      blockAlign;
-    unsigned short      bitsPerSample;
-    char                Subchunk2ID[4];
-    unsigned long       Subchunk2Size;
-  };
-
 protected:
-  uint8_t* loadSound() override final;
+  const uint8_t* loadSound() override final;
+
+private:
+  /// @brief Converts samples into mono 16-bit at outputSampleRate.
+  /// @return Converted samples, nullptr if allocation failed.
+  uint8_t* convert(const uint8_t* pcm, size_t size, const PCMFormat& format);
 };
 
 }
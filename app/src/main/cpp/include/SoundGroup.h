@@ -0,0 +1,56 @@
+#ifndef __ARKANOID_SOUND_GROUP__H__
+#define __ARKANOID_SOUND_GROUP__H__
+
+namespace game {
+
+/// @brief Group of sound variants sharing the prefix of file name,
+/// e.g. 'block_1.wav' ... 'block_4.wav', one of them is played at random.
+enum class SoundGroup : int {
+  NONE = -1,
+  BITE = 0,
+  BLOCK = 1,
+  BOOM = 2,
+  CHANGE = 3,
+  DESTROY = 4,
+  EXPLODE = 5,
+  FOG = 6,
+  GLASS = 7,
+  HYPER = 8,
+  INIT = 9,
+  INVUL = 10,
+  IRON = 11,
+  LASER = 12,
+  LOSE = 13,
+  MAGIC = 14,
+  MIDAS = 15,
+  PREQUICK = 16,
+  PRIZE = 17,
+  PROTECT = 18,
+  QUICK = 19,
+  SHORT = 20,
+  SKULL = 21,
+  ULTRA = 22,
+  VITALITY = 23,
+  WATER = 24,
+  WIN = 25,
+  ZYGOTE = 26
+};
+
+class SoundGroupUtils {
+public:
+  constexpr static int totalGroups = 27;  // NONE not included
+
+  /// @brief Prefix of file names of sounds in group, e.g. "block_".
+  static const char* getPrefix(SoundGroup group);
+  /// @brief Resolves group by file name, NONE if it doesn't match any group.
+  static SoundGroup fromFilename(const char* filename);
+  /// @brief Priority of sounds in group, higher ones are never cut off
+  /// by lower ones when all voices are busy.
+  static int getPriority(SoundGroup group);
+  /// @brief Minimum interval (ms) between sounds of group, 0 if unlimited.
+  static int getMinInterval(SoundGroup group);
+};
+
+}
+
+#endif  // __ARKANOID_SOUND_GROUP__H__
@@ -4,23 +4,55 @@
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
 
+#include "AudioSink.h"
+
 namespace native {
 namespace sound {
 
-class SoundProcessor;
-
-class SoundPlayer {
-  friend class SoundProcessor;
+/// @class SoundPlayer SoundPlayer.h "include/SoundPlayer.h"
+/// @brief OpenSL audio player streaming mono 16-bit PCM at 44.1 kHz,
+/// its buffer queue is refilled from render callback.
+class SoundPlayer : public AudioSink {
 public:
-  SoundPlayer();
+  constexpr static int buffersCount = 2;
+  constexpr static size_t bufferFrames = 1024;  //!< ~23 ms at 44.1 kHz.
+
+  SoundPlayer(SLEngineItf engine, SLObjectItf output_mix);
   virtual ~SoundPlayer();
 
+  bool start(RenderCallback render) override final;
+  void stop() override final;
+  inline int getErrorCode() const { return m_error_code; }
+
 private:
+  /// @brief Called by OpenSL each time a buffer has been played.
+  static void callback_bufferQueue(SLBufferQueueItf queue, void* context);
+  /// @brief Renders next buffer and enqueues it.
+  bool enqueue();
+
+  SLEngineItf m_engine;
+  SLObjectItf m_output_mix;
   SLObjectItf m_player;
   SLPlayItf m_player_interface;
   SLBufferQueueItf m_player_queue;
+  RenderCallback m_render;
+  int16_t* m_buffers;  //!< buffersCount buffers of bufferFrames each.
+  int m_next_buffer;
+  int m_error_code;
 };
 
+/**
+ * Error codes (SoundPlayer)
+ *
+ * 2006 - CreateAudioPlayer() failed
+ * 2007 - Realize() for AudioPlayer failed
+ * 2008 - GetInterface() SL_IID_PLAY failed
+ * 2009 - GetInterface() SL_IID_BUFFERQUEUE failed
+ * 2010 - RegisterCallback() failed
+ * 2011 - SetPlayState() failed
+ * 2012 - Enqueue() failed
+ */
+
 }  // namespace sound
 }  // namespace native
 
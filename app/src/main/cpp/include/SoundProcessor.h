@@ -4,6 +4,7 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
@@ -11,20 +12,27 @@
 #include "ActiveObject.h"
 #include "Ball.h"
 #include "Block.h"
+#include "BlockChangeBatch.h"
 #include "Event.h"
 #include "EventListener.h"
 #include "ExplosionPackage.h"
+#include "Level.h"
+#include "Mixer.h"
 #include "Prize.h"
 #include "PrizePackage.h"
 #include "Resources.h"
 #include "RowCol.h"
+#include "SoundGroup.h"
 #include "SoundPlayer.h"
+#include "SoundScheduler.h"
 
 namespace native {
 namespace sound {
 
 /// @class SoundProcessor SoundProcessor.h "include/SoundProcessor.h"
-/// @brief Standalone thread to play sounds from sound buffers' queue.
+/// @brief Standalone thread to play sounds, which are mixed natively
+/// into single OpenSL output stream. Sounds requested while handling
+/// events are deduplicated and rate limited by scheduler.
 /// http://habrahabr.ru/post/176933/
 class SoundProcessor : public ActiveObject {
 public:
@@ -39,18 +47,20 @@ public:
    */
   /// @brief Called when load resources requested.
   void callback_loadResources(bool /* dummy */);
+  /// @brief Called when level has been loaded.
+  void callback_loadLevel(game::Level::Ptr level);
+  /// @brief Called when next level has been preloaded.
+  void callback_preloadLevel(game::Level::Ptr level);
   /// @brief Called when ball has been lost.
   void callback_lostBall(game::BallLost status);
   /// @brief Called when bite has been impacted.
   void callback_biteImpact(bool /* dummy */);
-  /// @brief Called when block has been impacted.
-  void callback_blockImpact(game::RowCol block);
+  /// @brief Called when blocks have been impacted within single tick.
+  void callback_blockChanged(game::BlockChangeBatch::Ptr batch);
   /// @brief Called when wall has been impacted.
   void callback_wallImpact(bool /* dummy */);
   /// @brief Called when level has been successfully finished.
   void callback_levelFinished(bool is_finished);
-  /// @brief Called when requested to draw particle system explosion.
-  void callback_explosion(game::ExplosionPackage package);
   /// @brief Called when prize has been caught.
   void callback_prizeCaught(game::PrizePackage package);
   /// @brief Called when laser beam changed visibility.
@@ -99,18 +109,20 @@ public:
    */
   /// @brief Listens for load resources request.
   EventListener<bool> load_resources_listener;
+  /// @brief Listens for load level request.
+  EventListener<game::Level::Ptr> load_level_listener;
+  /// @brief Listens for next level preloaded in background.
+  EventListener<game::Level::Ptr> preload_level_listener;
   /// @brief Listens for event which occurs when ball has been lost.
   EventListener<game::BallLost> lost_ball_listener;
   /// @brief Listens for event which occurs when bite has been impacted.
   EventListener<bool> bite_impact_listener;
-  /// @brief Listens for event which occurs when block has been impacted.
-  EventListener<game::RowCol> block_impact_listener;
+  /// @brief Listens for event which occurs when blocks have changed within single tick.
+  EventListener<game::BlockChangeBatch::Ptr> block_change_listener;
   /// @brief Listens for event which occurs when wall has been impacted.
   EventListener<bool> wall_impact_listener;
   /// @brief Listens for event which occurs when level has been successfully finished.
   EventListener<bool> level_finished_listener;
-  /// @brief Listens for event which occurs when particle system explosion has been requested.
-  EventListener<game::ExplosionPackage> explosion_listener;
   /// @brief Listens for event which occurs when prize has been caught.
   EventListener<game::PrizePackage> prize_caught_listener;
   /// @brief Listens for laser beam visibility.
@@ -140,21 +152,22 @@ private:
    */
   int m_error_code;
   SLObjectItf m_engine;
-  SLObjectItf m_mixer;
+  SLObjectItf m_output_mix;
   SLEngineItf m_interface;
 
-  SoundPlayer* m_players;
-  int m_queue_size;
-  int m_selected_player;
+  Mixer m_mixer;  //!< Voices of sounds being played.
+  SoundPlayer* m_player;  //!< Output stream fed by mixer.
+  SoundScheduler m_scheduler;  //!< Sounds requested within current event handling.
 
-  constexpr static int queueMaxSize = 1;
-  constexpr static int playersCount = 8;
+  constexpr static float voiceGain = 0.7f;  //!< Headroom for overlapping sounds.
   /** @} */  // end of Core group
 
   /** @defgroup LogicData Game Logic related data members.
    * @{
    */
-  game::Block m_impacted_block;  //!< Last received impacted block.
+  game::Level::Ptr m_level;  //!< Last loaded level, its sounds are prefetched.
+  game::Level::Ptr m_next_level;  //!< Preloaded level, its sounds are prefetched ahead.
+  std::vector<game::Block> m_impacted_blocks;  //!< Blocks impacted since last processing.
   game::Prize m_prize;  //!< Last received prize.
   game::BallEffect m_ball_effect;  //!< Last received ball effect.
   /** @} */  // end of LogicData group
@@ -164,6 +177,7 @@ private:
    */
   std::mutex m_jnienvironment_mutex;  //!< Sentinel for thread attach to JVM.
   std::mutex m_load_resources_mutex;  //!< Sentinel for load resources.
+  std::mutex m_load_level_mutex;  //!< Sentinel for load level request.
   std::mutex m_lost_ball_mutex;  //!< Sentinel for lost ball flag.
   std::mutex m_bite_impact_mutex;
   std::mutex m_block_impact_mutex;  //!< Sentinel for block impact event.
@@ -176,6 +190,8 @@ private:
   std::mutex m_laser_pulse_mutex;
   std::mutex m_ball_effect_mutex;
   std::atomic_bool m_load_resources_received;  //!< Load resources requested.
+  std::atomic_bool m_load_level_received;  //!< Load level requested.
+  std::atomic_bool m_preload_level_received;  //!< Next level has been preloaded.
   std::atomic_bool m_lost_ball_received;  //!< Ball has been lost received.
   std::atomic_bool m_bite_impact_received;
   std::atomic_bool m_block_impact_received;  //!< Block impact has been received.
@@ -193,6 +209,7 @@ private:
    * @{
    */
   game::Resources* m_resources;
+  game::Resources::SoundPinned m_is_playing;  //!< Keeps sounds being played resident.
   /** @} */  // end of Resources group
 
 // ----------------------------------------------
@@ -216,29 +233,33 @@ private:
    *  corresponding event occurred and has been caught.
    *  @{
    */
-  /// @brief Loads external resources into Graphic memory.
+  /// @brief Loads sounds which could be played at any level.
   void process_loadResources();
-  /// @brief Plays sound when ball has been lost.
+  /// @brief Prefetches sounds of blocks present in loaded level.
+  void process_loadLevel();
+  /// @brief Prefetches sounds of blocks present in preloaded level.
+  void process_preloadLevel();
+  /// @brief Requests sound when ball has been lost.
   void process_lostBall();
-  /// @brief Plays sound when bite gets impacted.
+  /// @brief Requests sound when bite gets impacted.
   void process_biteImpact();
-  /// @brief Plays sound when block gets impacted.
+  /// @brief Requests sounds of all blocks impacted since last processing.
   void process_blockImpact();
-  /// @brief Plays sound when wall gets impacted.
+  /// @brief Requests sound when wall gets impacted.
   void process_wallImpact();
-  /// @brief Plays sound when level has been finished.
+  /// @brief Requests sound when level has been finished.
   void process_levelFinished();
-  /// @brief Plays sound for particle system explosion.
+  /// @brief Requests sound for particle system explosion.
   void process_explosion();
-  /// @brief Plays sound for prize catching.
+  /// @brief Requests sound for prize catching.
   void process_prizeCaught();
-  /// @brief Plays sound when laser beam visibility changes.
+  /// @brief Requests sound when laser beam visibility changes.
   void process_laserBeamVisibility();
-  /// @brief Plays sound when laser impacts a block.
+  /// @brief Requests sound when laser impacts a block.
   void process_laserBlockImpact();
-  /// @brief Plays sound when laser pulse emerges.
+  /// @brief Requests sound when laser pulse emerges.
   void process_laserPulse();
-  /// @brief Plays sound for ball effect.
+  /// @brief Requests sound for ball effect.
   void process_ballEffect();
   /** @} */  // end of Processors group
 
@@ -246,8 +267,10 @@ private:
    * @{
    */
   bool init();  //!< Initializes sound processor stuff.
-  bool initPlayerQueue(int player_id);  //!< Initializes queue for sound buffers.
-  bool playSound(const SoundBuffer* sound);  //!< Plays new sound, stopping any previous one.
+  bool playSound(const SoundBuffer* sound, int priority);  //!< Mixes new sound with ones being played.
+  bool playSound(game::SoundGroup group);  //!< Plays random sound of group, loading it on demand.
+  bool isPlaying(const SoundBuffer* sound);  //!< Whether sound is being mixed.
+  void prefetchLevelSounds(const game::Level::Ptr& level);  //!< Prefetches sounds of blocks present in level.
   void destroy();  //!< Releases sound processor stuff.
   /** @} */  // end of CoreFunc group
 };
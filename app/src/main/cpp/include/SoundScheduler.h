@@ -0,0 +1,51 @@
+#ifndef __ARKANOID_SOUND_SCHEDULER__H__
+#define __ARKANOID_SOUND_SCHEDULER__H__
+
+#include <chrono>
+#include <functional>
+
+#include "SoundGroup.h"
+
+namespace native {
+namespace sound {
+
+/**
+ * @class SoundScheduler SoundScheduler.h "include/SoundScheduler.h"
+ * @brief Collects sound requests between dispatches, so that many requests
+ * of the same group result in a single sound.
+ * @details On dispatch, requested groups are played in order of priority.
+ * Groups of ordinary priority are rate limited by SoundGroupUtils::getMinInterval()
+ * and at most maxPerDispatch of them are played at once, while groups of
+ * criticalPriority are always played.
+ * @note Not thread-safe, requests and dispatches should come from the same thread.
+ */
+class SoundScheduler {
+public:
+  typedef std::function<bool (game::SoundGroup)> Play;
+
+  constexpr static int maxPerDispatch = 3;
+  constexpr static int criticalPriority = 3;  //!< Loss and level finish.
+
+  SoundScheduler();
+  virtual ~SoundScheduler() noexcept;
+
+  /// @brief Requests sound of group to be played on next dispatch.
+  void request(game::SoundGroup group);
+  /// @brief Plays requested sounds, the rest of requests is dropped.
+  /// @return Number of played sounds.
+  int dispatch(const Play& play);
+  /// @brief Forgets pending requests and rate limits.
+  void reset();
+
+private:
+  typedef std::chrono::steady_clock clock;
+
+  bool m_requested[game::SoundGroupUtils::totalGroups];
+  clock::time_point m_last_played[game::SoundGroupUtils::totalGroups];
+  int m_total_requested;  //!< Requests since last dispatch, including duplicates.
+};
+
+}
+}
+
+#endif  // __ARKANOID_SOUND_SCHEDULER__H__
@@ -37,6 +37,8 @@
 
 namespace native {
 
+class TextureCache;
+
 enum class ImageCode : int {
   none = 1000, png  = 1020
 };
@@ -49,6 +51,15 @@ static const char* toString(ImageCode code) {
   }
 }
 
+/// @brief Format of texture in Graphic memory, image is converted after decode.
+enum class TargetFormat : int {
+  SOURCE = 0,    //!< 8 bits per channel, as decoded.
+  RGB565 = 1,    //!< Opaque, color is premultiplied by source alpha.
+  RGBA4444 = 2,  //!< Sprites with smooth alpha.
+  RGBA5551 = 3,  //!< Sprites with binary alpha.
+  LA88 = 4       //!< Grayscale with alpha.
+};
+
 class Texture {
 public:
   Texture(AssetStorage* assets, const char* filename);
@@ -67,8 +78,31 @@ public:
   virtual void unload();
   virtual void apply() const;
 
+  /// @brief CPU stage of load(): decodes image into memory.
+  /// @note Doesn't touch GL, so could be called from any thread.
+  virtual bool decode();
+  /// @brief GL stage of load(): uploads decoded image and releases it.
+  /// @note Must be called on the thread owning GL context.
+  virtual bool upload();
+
+  /// @brief Sets disk cache of decoded images, used by decode() when set.
+  void setCache(const TextureCache* cache);
+  /// @brief Sets format of texture in Graphic memory, @a dither enables
+  /// ordered dithering for reduced-precision formats.
+  void setTargetFormat(TargetFormat format, bool dither);
+  /// @brief Size of texture in Graphic memory (in bytes).
+  size_t getMemoryUsage() const;
+  /// @brief Size texture would take with 8 bits per channel (in bytes).
+  size_t getSourceMemoryUsage() const;
+
 protected:
   virtual const uint8_t* loadImage() = 0;
+  /// @brief Frees decoded image either allocated or mapped from cache.
+  void releasePixels();
+  /// @brief Computes checksum of source image file.
+  bool readSourceChecksum(uint32_t* checksum) const;
+  /// @brief Converts decoded pixels into target format.
+  void convertPixels();
 
   enum class ReadMode : int {
     ASSETS = 0, FILESYSTEM = 1
@@ -78,6 +112,12 @@ protected:
   AssetStorage* m_assets;
   char* m_filename;
   unsigned int m_data_size;
+  const uint8_t* m_pixels;  //!< Decoded image pending upload.
+  size_t m_pixels_mapping;  //!< Size of mapping if pixels are mapped from cache, 0 otherwise.
+  const TextureCache* m_cache;
+  TargetFormat m_target_format;
+  bool m_dither;
+  GLint m_source_format;  //!< Format of decoded image, before conversion.
   GLuint m_id;
   GLint m_format;
   GLint m_type;
@@ -0,0 +1,68 @@
+#ifndef __ARKANOID_TEXTURE_CACHE__H__
+#define __ARKANOID_TEXTURE_CACHE__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <GLES2/gl2.h>
+
+namespace native {
+
+/**
+ * @class TextureCache TextureCache.h "include/TextureCache.h"
+ * @brief Disk cache of decoded images, ready to be passed to glTexImage2D().
+ *
+ * @details Each image is stored in a separate file within cache directory,
+ * starting with a Header, followed by raw pixels. Cached image is valid
+ * only while checksum of it's source file matches the one in Header.
+ * Cached files are mapped into memory rather than read.
+ * Thread-safe: different threads could access different entries concurrently.
+ */
+class TextureCache {
+public:
+  constexpr static uint32_t magic = 0x58455441;  //!< "ATEX"
+  constexpr static uint32_t version = 2;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t checksum;  //!< CRC32 of the source file.
+    GLint format;
+    GLint source_format;  //!< Format of decoded image, before conversion.
+    GLint type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t data_size;  //!< Size of pixels following the header.
+  };
+
+  /// @param directory Path to cache directory, created if missing.
+  explicit TextureCache(const std::string& directory);
+  virtual ~TextureCache() noexcept;
+
+  /// @brief Maps cached image into memory.
+  /// @param name Name of source file.
+  /// @param checksum Checksum of source file.
+  /// @param header Output header of cached image.
+  /// @param mapping_size Output size of mapping, to be passed to release().
+  /// @return Pointer to pixels, or nullptr if image is absent or outdated.
+  const uint8_t* load(const char* name, uint32_t checksum, Header* header, size_t* mapping_size) const;
+  /// @brief Stores decoded image, replacing the previous one if any.
+  bool store(const char* name, const Header& header, const uint8_t* pixels) const;
+  /// @brief Unmaps pixels obtained from load().
+  static void release(const uint8_t* pixels, size_t mapping_size);
+
+  /// @brief Computes checksum of source file content.
+  /// @param seed Checksum of preceding data, to combine several blocks.
+  static uint32_t checksum(const uint8_t* data, size_t size, uint32_t seed = 0);
+
+private:
+  /// @brief Path of cache file corresponding to given source file name.
+  std::string getPath(const char* name) const;
+
+  std::string m_directory;
+};
+
+}  // namespace native
+
+#endif  // __ARKANOID_TEXTURE_CACHE__H__
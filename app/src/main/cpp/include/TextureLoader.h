@@ -0,0 +1,81 @@
+#ifndef __ARKANOID_TEXTURE_LOADER__H__
+#define __ARKANOID_TEXTURE_LOADER__H__
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Texture.h"
+
+namespace native {
+
+/**
+ * @class TextureLoader TextureLoader.h "include/TextureLoader.h"
+ * @brief Loads textures in two stages: images are decoded in parallel
+ * on worker threads, then decoded images are uploaded to GL by the thread
+ * owning GL context within a time budget per call.
+ * @details Worker threads are started by the first decode() and wait for
+ * textures until destruction, so that a new batch never waits for
+ * the previous one: it's queued behind textures not yet decoded.
+ */
+class TextureLoader {
+public:
+  typedef std::function<void()> DecodedCallback;
+
+  TextureLoader();
+  virtual ~TextureLoader() noexcept;
+
+  /// @brief Queues given textures for decoding on worker threads.
+  /// @param on_decoded Called from worker thread each time a texture is decoded.
+  /// @note Never blocks. Until previous batch is finished, new textures are
+  /// counted within it, textures of it which are still pending are skipped.
+  void decode(const std::vector<Texture*>& textures, DecodedCallback on_decoded);
+  /// @brief Uploads decoded textures until time budget is exhausted.
+  /// @return Number of textures failed either to decode or to upload.
+  /// @note Must be called on the thread owning GL context,
+  /// never blocks on worker threads.
+  int upload(std::chrono::milliseconds budget);
+
+  /// @brief Whether there are decoded textures waiting for upload.
+  bool hasPendingUploads();
+  /// @brief Whether all textures of the batch have been processed.
+  inline bool isFinished() const { return m_processed == m_total; }
+  inline int getProcessed() const { return m_processed; }
+  inline int getTotal() const { return m_total; }
+
+private:
+  struct Job {
+    Texture* texture;
+    DecodedCallback on_decoded;
+  };
+
+  /// @brief Decodes queued textures one by one until stopped.
+  void worker();
+  /// @brief Stops worker threads and waits for them to exit.
+  void join();
+
+  std::vector<Texture*> m_textures;  //!< Textures of current batch, accessed by GL thread only.
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_jobs_mutex;
+  std::condition_variable m_jobs_condition;
+  std::deque<Job> m_jobs;  //!< Textures waiting for decoding.
+  bool m_stopped;  //!< Whether workers should exit, guarded by m_jobs_mutex.
+
+  std::mutex m_decoded_mutex;
+  std::queue<std::pair<Texture*, bool>> m_decoded;  //!< Decoded textures and decode status.
+
+  int m_processed;  //!< Textures uploaded or failed, accessed by GL thread only.
+  int m_total;
+  std::chrono::steady_clock::time_point m_start_time;  //!< When decoding of the batch started.
+};
+
+}  // namespace native
+
+#endif  // __ARKANOID_TEXTURE_LOADER__H__
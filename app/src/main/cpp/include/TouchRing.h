@@ -0,0 +1,65 @@
+#ifndef __ARKANOID_TOUCH_RING__H__
+#define __ARKANOID_TOUCH_RING__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace game {
+
+/// @brief Single position of user's pointer.
+struct TouchSample {
+  float position;  //!< Normalized position along X axis.
+  int64_t time;  //!< Time of sample (in nanos), CLOCK_MONOTONIC as SystemClock.uptimeMillis().
+};
+
+/**
+ * @class TouchRing TouchRing.h "include/TouchRing.h"
+ * @brief Lock-free queue of touch samples with single producer (UI thread)
+ * and single consumer (render thread).
+ * @details Capacity covers seconds of motion events with all historical
+ * samples, so samples are dropped only if consumer has stalled.
+ */
+class TouchRing {
+public:
+  constexpr static uint32_t capacity = 256;  //!< Power of 2.
+
+  TouchRing() : m_head(0), m_tail(0) {}
+
+  /// @brief Appends samples, called by producer.
+  /// @return Number of samples pushed, less than @a count if ring is full.
+  size_t push(const TouchSample* samples, size_t count) {
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t tail = m_tail.load(std::memory_order_acquire);
+    size_t pushed = 0;
+    for (; pushed < count && head - tail < capacity; ++pushed, ++head) {
+      m_samples[head & (capacity - 1)] = samples[pushed];
+    }
+    m_head.store(head, std::memory_order_release);
+    return pushed;
+  }
+
+  /// @brief Takes all available samples in order, called by consumer.
+  /// @param samples Output array of @a capacity elements.
+  /// @return Number of samples taken.
+  size_t drain(TouchSample* samples) {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    size_t count = 0;
+    for (; tail != head; ++tail, ++count) {
+      samples[count] = m_samples[tail & (capacity - 1)];
+    }
+    m_tail.store(tail, std::memory_order_release);
+    return count;
+  }
+
+private:
+  static_assert((capacity & (capacity - 1)) == 0, "Capacity must be power of 2");
+  TouchSample m_samples[capacity];
+  std::atomic<uint32_t> m_head;  //!< Total samples pushed.
+  std::atomic<uint32_t> m_tail;  //!< Total samples drained.
+};
+
+}
+
+#endif  // __ARKANOID_TOUCH_RING__H__
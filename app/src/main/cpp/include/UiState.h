@@ -0,0 +1,84 @@
+#ifndef __ARKANOID_UI_STATE__H__
+#define __ARKANOID_UI_STATE__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace game {
+
+/**
+ * @class UiState UiState.h "include/UiState.h"
+ * @brief Block of 32-bit words shared with Java as direct ByteBuffer,
+ * replaces JNI upcalls from processor threads for frequent UI updates.
+ * @details Native threads store words lock-free and bump sequence counter,
+ * UI polls the block once per frame and skips it while sequence is unchanged.
+ * Score is accumulated total, UI takes difference with the value it has seen
+ * before. Caught prizes are kept in a ring indexed by total number of prizes
+ * written, UI keeps number of prizes read.
+ * @note Layout must be kept in sync with constants of AsyncContext.java.
+ */
+class UiState {
+public:
+  enum Word : int {
+    SEQUENCE = 0,        //!< Incremented after any change.
+    SCORE = 1,           //!< Total score of destroyed blocks.
+    CARDINALITY = 2,     //!< Remaining blocks on level.
+    ANGLE = 3,           //!< Angle of the ball thrown (in degrees).
+    FLAGS = 4,           //!< See UiState::Flag.
+    PRIZES_WRITTEN = 5,  //!< Total number of prizes caught.
+    PRIZES = 6           //!< Ring of caught prizes.
+  };
+
+  enum Flag : int32_t {
+    BALL_FLYING = 1,
+    LASER_VISIBLE = 2
+  };
+
+  constexpr static int prizesCapacity = 16;
+  constexpr static int totalWords = PRIZES + prizesCapacity;
+
+  UiState() {
+    for (auto& word : m_words) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /** @defgroup Writers Called from processor threads.
+   * @{
+   */
+  inline void addScore(int score) {
+    m_words[SCORE].fetch_add(score, std::memory_order_relaxed);
+    publish();
+  }
+  inline void setCardinality(int cardinality) { set(CARDINALITY, cardinality); }
+  inline void setAngle(int angle) { set(ANGLE, angle); }
+  inline void setFlags(int32_t flags) { set(FLAGS, flags); }
+  /// @brief Only PrizeProcessor writes prizes, so ring has single producer.
+  inline void pushPrize(int prize) {
+    int32_t written = m_words[PRIZES_WRITTEN].load(std::memory_order_relaxed);
+    m_words[PRIZES + written % prizesCapacity].store(prize, std::memory_order_relaxed);
+    m_words[PRIZES_WRITTEN].store(written + 1, std::memory_order_release);
+    publish();
+  }
+  /** @} */  // end of Writers group
+
+  inline void* getData() { return m_words; }
+  inline size_t getSize() const { return sizeof(m_words); }
+
+private:
+  /// @brief Stores word and bumps sequence, unless value is unchanged.
+  inline void set(Word word, int32_t value) {
+    if (m_words[word].exchange(value, std::memory_order_relaxed) != value) {
+      publish();
+    }
+  }
+  inline void publish() { m_words[SEQUENCE].fetch_add(1, std::memory_order_release); }
+
+  static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t), "Words must be plain integers for Java");
+  std::atomic<int32_t> m_words[totalWords];
+};
+
+}
+
+#endif  // __ARKANOID_UI_STATE__H__
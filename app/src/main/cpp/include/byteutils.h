@@ -0,0 +1,57 @@
+#ifndef __ARKANOID_BYTEUTILS__H__
+#define __ARKANOID_BYTEUTILS__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @defgroup ByteUtils Helpers of binary formats, free of graphics
+ * dependencies, so that host tools share them with the game.
+ * @{
+ */
+namespace util {
+
+constexpr uint32_t fnvOffsetBasis = 2166136261u;
+constexpr uint32_t fnvPrime = 16777619u;
+
+/// @brief FNV-1a hash of @a size bytes, continuing from @a hash.
+inline uint32_t fnv1a(const void* data, size_t size, uint32_t hash = fnvOffsetBasis) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= fnvPrime;
+  }
+  return hash;
+}
+
+/// @brief Appends @a value as LEB128 varint: 7 bits per byte, low bits first.
+template <typename T>
+void putVarint(std::vector<uint8_t>* out, T value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+/// @brief Reads varint of at most 5 bytes at @a offset, advancing it.
+/// @return false, if data ends before the last byte of varint or the
+/// varint is too long.
+template <typename T>
+bool getVarint(const uint8_t* data, size_t size, size_t* offset, T* value) {
+  *value = 0;
+  for (int shift = 0; shift < 35 && *offset < size; shift += 7) {
+    uint8_t byte = data[(*offset)++];
+    *value |= static_cast<T>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+/** @} */  // end of ByteUtils group
+
+#endif  // __ARKANOID_BYTEUTILS__H__
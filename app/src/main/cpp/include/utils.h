@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <cstdlib>
+#include <random>
 
 #include "logger.h"
 #include "rgbstruct.h"
@@ -43,6 +44,16 @@ void setColor(const BGRA<T>& bgra, T* const color_buffer, size_t size) {
 
 void setColor(const GLfloat* const bgra, GLfloat* const color_buffer, size_t size);
 
+/// @brief Converts color component from [0, 1] range to normalized unsigned byte.
+inline GLubyte toUnsignedByte(GLfloat value) {
+  return value <= 0.0f ? 0 : (value >= 1.0f ? 255 : static_cast<GLubyte>(value * 255.0f + 0.5f));
+}
+
+/// @brief Same as above, but fills the buffer of GL_UNSIGNED_BYTE normalized colors.
+void setColor(const BGRA<GLfloat>& bgra, GLubyte* const color_buffer, size_t size);
+void setColor(const GLfloat* const bgra, GLubyte* const color_buffer, size_t size);
+
+/// @brief Fills 2D positions (x, y) of rectangles grid, 8 floats per rectangle.
 void setRectangleVertices(
     GLfloat* const vertices,
     GLfloat width,
@@ -52,6 +63,7 @@ void setRectangleVertices(
     size_t cols,
     size_t rows);
 
+/// @brief Fills 2D positions (x, y) of octagons grid, 18 floats per octagon.
 void setOctagonVertices(
     GLfloat* const vertices,
     GLfloat width,
@@ -72,6 +84,14 @@ size_t getRandomElement(const std::vector<T>& array) {
   return std::rand() % array.size();
 }
 
+/// @brief Picks random index drawn from given engine, reproducible along
+/// with the state of the engine.
+template <typename T, typename Engine>
+size_t getRandomElement(const std::vector<T>& array, Engine& engine) {
+  std::uniform_int_distribution<size_t> distribution(0, array.size() - 1);
+  return distribution(engine);
+}
+
 }
 
 #endif  // __ARKANOID_UTILS__H__
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "AssetPack.h"
+#include "byteutils.h"
+
+namespace native {
+
+AssetPack::AssetPack(const void* data, size_t size, Release release)
+  : m_data(static_cast<const uint8_t*>(data))
+  , m_size(size)
+  , m_release(release)
+  , m_header(nullptr)
+  , m_index(nullptr)
+  , m_names(nullptr)
+  , m_is_valid(false) {
+  if (m_data == nullptr || m_size < sizeof(AssetPackHeader)) {
+    return;
+  }
+  m_header = reinterpret_cast<const AssetPackHeader*>(m_data);
+  if (std::memcmp(m_header->magic, "ARKP", 4) != 0 ||
+      m_header->version != AssetPack::version ||
+      m_header->index_offset > m_size ||
+      m_header->count > (m_size - m_header->index_offset) / sizeof(AssetPackEntry) ||
+      m_header->names_offset > m_size) {
+    return;
+  }
+  m_index = reinterpret_cast<const AssetPackEntry*>(m_data + m_header->index_offset);
+  m_names = reinterpret_cast<const char*>(m_data + m_header->names_offset);
+  size_t names_size = m_size - m_header->names_offset;
+  for (size_t i = 0; i < m_header->count; ++i) {
+    const AssetPackEntry& entry = m_index[i];
+    if (entry.name_offset > names_size || entry.name_length > names_size - entry.name_offset ||
+        entry.offset > m_size || entry.size > m_size - entry.offset) {
+      return;
+    }
+  }
+  m_is_valid = true;
+}
+
+AssetPack::~AssetPack() noexcept {
+  if (m_release) {
+    m_release();
+  }
+}
+
+bool AssetPack::isValid() const { return m_is_valid; }
+size_t AssetPack::getCount() const { return m_is_valid ? m_header->count : 0; }
+const AssetPackEntry& AssetPack::getEntry(size_t index) const { return m_index[index]; }
+
+std::string AssetPack::getName(const AssetPackEntry& entry) const {
+  return std::string(m_names + entry.name_offset, entry.name_length);
+}
+
+bool AssetPack::find(const char* name, const uint8_t** data, size_t* size) const {
+  if (!m_is_valid) {
+    return false;
+  }
+  size_t length = std::strlen(name);
+  uint32_t key = hash(name, length);
+  const AssetPackEntry* end = m_index + m_header->count;
+  const AssetPackEntry* it = std::lower_bound(m_index, end, key,
+      [](const AssetPackEntry& entry, uint32_t key) { return entry.hash < key; });
+  // names are compared as well, since hashes could collide
+  for (; it != end && it->hash == key; ++it) {
+    if (it->name_length == length && std::memcmp(m_names + it->name_offset, name, length) == 0) {
+      *data = m_data + it->offset;
+      *size = it->size;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t AssetPack::hash(const char* name, size_t length) {
+  return util::fnv1a(name, length);
+}
+
+AssetFormat AssetPack::getFormat(const std::string& name) {
+  size_t dot = name.rfind('.');
+  if (dot == std::string::npos) {
+    return AssetFormat::UNKNOWN;
+  }
+  std::string extension = name.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  if (extension == "png") return AssetFormat::PNG;
+  if (extension == "wav") return AssetFormat::WAV;
+  return AssetFormat::UNKNOWN;
+}
+
+}
@@ -26,20 +26,37 @@
  * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <cstring>
 #include "AssetStorage.h"
 #include "logger.h"
 
 
 AssetStorage::AssetStorage(JNIEnv* jenv, const jobject& assetManager)
-  : m_internal_file_storage(new char[256])
+  : m_internal_file_storage(new char[256]())
   , m_asset_filename(nullptr)
   , m_length(-1)
   , m_manager(AAssetManager_fromJava(jenv, assetManager))
-  , m_asset(nullptr) {
+  , m_asset(nullptr)
+  , m_pack(nullptr)
+  , m_slice(nullptr)
+  , m_position(0) {
+}
+
+AssetStorage::AssetStorage(const AssetStorage& other)
+  : m_internal_file_storage(new char[256]())
+  , m_asset_filename(nullptr)
+  , m_length(-1)
+  , m_manager(other.m_manager)
+  , m_asset(nullptr)
+  , m_pack(other.m_pack)
+  , m_slice(nullptr)
+  , m_position(0) {
+  strcpy(m_internal_file_storage, other.m_internal_file_storage);
 }
 
 AssetStorage::~AssetStorage() {
+  close();
   delete [] m_internal_file_storage;
 }
 
@@ -55,10 +72,63 @@ void AssetStorage::setInternalFileStorage(const char* path) {
   strcpy(m_internal_file_storage, path);
 }
 
+bool AssetStorage::openPack() {
+  AAsset* asset = AAssetManager_open(m_manager, native::AssetPack::filename, AASSET_MODE_BUFFER);
+  if (asset == nullptr) {
+    INF("No asset pack, assets are opened individually");
+    return false;
+  }
+  const void* data = AAsset_getBuffer(asset);
+  m_pack = std::make_shared<native::AssetPack>(data, AAsset_getLength(asset), [asset]() { AAsset_close(asset); });
+  if (!m_pack->isValid()) {
+    ERR("Asset pack is corrupted!");
+    m_pack.reset();
+    return false;
+  }
+  INF("Asset pack has been mapped: %zu assets", m_pack->getCount());
+  return true;
+}
+
+bool AssetStorage::hasPack() const {
+  return m_pack != nullptr;
+}
+
+std::vector<std::string> AssetStorage::list(const char* directory) const {
+  std::vector<std::string> names;
+  if (m_pack != nullptr) {
+    std::string prefix = std::string(directory) + "/";
+    for (size_t i = 0; i < m_pack->getCount(); ++i) {
+      std::string name = m_pack->getName(m_pack->getEntry(i));
+      if (name.compare(0, prefix.length(), prefix) == 0) {
+        names.push_back(name.substr(prefix.length()));
+      }
+    }
+  } else {
+    AAssetDir* dir = AAssetManager_openDir(m_manager, directory);
+    if (dir != nullptr) {
+      while (const char* name = AAssetDir_getNextFileName(dir)) {
+        names.push_back(name);
+      }
+      AAssetDir_close(dir);
+    }
+  }
+  std::sort(names.begin(), names.end());  // the same order regardless of source
+  return names;
+}
+
 bool AssetStorage::open(const char* asset_filename) {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  if (m_pack != nullptr && m_pack->find(asset_filename, &data, &size)) {
+    m_slice = data;
+    m_position = 0;
+    m_asset_filename = asset_filename;
+    m_length = size;
+    return true;
+  }
   m_asset = AAssetManager_open(m_manager, asset_filename, AASSET_MODE_UNKNOWN);
   if (m_asset == nullptr) {
-    ERR("Failed to open asset from file: %s!", m_asset_filename);
+    ERR("Failed to open asset from file: %s!", asset_filename);
     return false;
   }
   m_asset_filename = asset_filename;
@@ -71,32 +141,66 @@ void AssetStorage::close() {
     AAsset_close(m_asset);
     m_asset = nullptr;
   }
+  m_slice = nullptr;
+  m_position = 0;
   m_asset_filename = nullptr;
   m_length = -1;
 }
 
 bool AssetStorage::read(void* buffer) {
+  return read(buffer, m_length);
+}
+
+bool AssetStorage::read(void* buffer, size_t size) {
   if (buffer == nullptr) {
     ERR("Buffer not allocated for asset!");
     return false;
   }
-  int32_t read_count = AAsset_read(m_asset, buffer, m_length);
-  if (read_count != m_length) {
+  if (m_slice != nullptr) {
+    if (size > static_cast<size_t>(m_length - m_position)) {
+      ERR("Error during reading asset from pack: %s!", m_asset_filename);
+      return false;
+    }
+    std::memcpy(buffer, m_slice + m_position, size);
+    m_position += size;
+    return true;
+  }
+  int32_t read_count = AAsset_read(m_asset, buffer, size);
+  if (read_count != size) {
     ERR("Error during reading asset from file: %s!", m_asset_filename);
     return false;
   }
   return true;
 }
 
-bool AssetStorage::read(void* buffer, size_t size) {
-  if (buffer == nullptr) {
-    ERR("Buffer not allocated for asset!");
+bool AssetStorage::map(const char* asset_filename, const void** data, off_t* length, AAsset** asset) const {
+  const uint8_t* slice = nullptr;
+  size_t size = 0;
+  if (m_pack != nullptr && m_pack->find(asset_filename, &slice, &size)) {
+    *data = slice;
+    *length = size;
+    *asset = nullptr;  // pack outlives slice
+    return true;
+  }
+  // uncompressed assets are mapped from APK, others are decompressed once
+  *asset = AAssetManager_open(m_manager, asset_filename, AASSET_MODE_BUFFER);
+  if (*asset == nullptr) {
+    ERR("Failed to open asset from file: %s!", asset_filename);
     return false;
   }
-  int32_t read_count = AAsset_read(m_asset, buffer, size);
-  if (read_count != size) {
-    ERR("Error during reading asset from file: %s!", m_asset_filename);
+  *data = AAsset_getBuffer(*asset);
+  *length = AAsset_getLength(*asset);
+  if (*data == nullptr) {
+    ERR("Failed to map asset from file: %s!", asset_filename);
+    AAsset_close(*asset);
+    *asset = nullptr;
     return false;
   }
   return true;
 }
+
+void AssetStorage::unmap(AAsset* asset) {
+  if (asset != nullptr) {
+    AAsset_close(asset);
+  }
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 #include <GLES2/gl2.h>
@@ -18,6 +20,7 @@ AsyncContext::AsyncContext(JavaVM* jvm, jint fdn)
   : m_jvm(jvm), m_jenv(nullptr)
   , master_object(nullptr)
   , fireJavaEvent_errorTextureLoad_id(nullptr)
+  , fireJavaEvent_textureLoadProgress_id(nullptr)
   , m_fdn(fdn)
   , m_move_events(0)
   , m_window(nullptr)
@@ -27,34 +30,18 @@ AsyncContext::AsyncContext(JavaVM* jvm, jint fdn)
   , m_width(0), m_height(0)
   , m_config(nullptr)
   , m_num_configs(0), m_format(0)
-  , m_position(0.0f)
+  , m_touch_time(0)
+  , m_touch_velocity(0.0f)
+  , m_bite_rendered_x(0.0f)
   , m_bite()
   , m_bite_effect(BiteEffect::NONE)
   , m_ball()
   , m_ball_inited(false)
-  , m_impact_queue()
-  , m_bite_vertex_buffer(new GLfloat[16])
-  , m_bite_color_buffer(new GLfloat[16])
-  , m_ball_vertex_buffer(new GLfloat[36])
-  , m_ball_color_buffer(new GLfloat[36])
-  , m_bg_vertex_buffer(new GLfloat[16]{-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f})
-  , m_particle_diverge_buffer(nullptr)
-  , m_particle_converge_buffer(nullptr)
-  , m_particle_spiral_buffer(nullptr)
-  , m_particle_vacuum_buffer(nullptr)
-  , m_rectangle_index_buffer(new GLushort[6]{0, 3, 2, 0, 1, 3})
-  , m_octagon_index_buffer(new GLushort[24]{0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 7, 0, 7, 8, 0, 8, 1})
-  , m_rectangle_texCoord_buffer(new GLfloat[8]{1.f, 1.f, 0.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+  , m_level_versions()
   , m_level(nullptr)
-  , m_level_vertex_buffer(nullptr)
-  , m_level_color_buffer(nullptr)
-  , m_level_index_buffer(nullptr)
-  , m_generator(std::chrono::system_clock::now().time_since_epoch().count())
-  , m_particle_distribution(0.0f, 1.0f)
-  , m_particle_normal_distribution(0.0f, 1.0f)
-  , m_last_time(0)
-  , m_particle_time(0.0f)
-  , m_render_explosion(false)
+  , m_level_origin(nullptr)
+  , m_level_version(0)
+  , m_renderer()
   , m_explosion_packages()
   , m_prize_packages()
   , m_prize_last_timers()
@@ -67,27 +54,20 @@ AsyncContext::AsyncContext(JavaVM* jvm, jint fdn)
   , m_laser_last_time(0)
   , m_laser_time(0.0f)
   , m_render_laser(false)
-  , m_laser_interruption(false)
-  , m_level_shader(nullptr)
-  , m_bite_shader(nullptr)
-  , m_ball_shader(nullptr)
-  , m_explosion_shader(nullptr)
-  , m_sample_shader(nullptr)
-  , m_prize_shader(nullptr)
-  , m_prize_catch_shader(nullptr)
-  , m_laser_shader(nullptr) {
+  , m_laser_interruption(false) {
 
   DBG("enter AsyncContext ctor");
   INF("Frame delay is %i (nanos)", m_fdn);
   m_surface_received.store(false);
   m_load_resources_received.store(false);
   m_shift_gamepad_received.store(false);
+  m_bite_prediction.store(true);
   m_throw_ball_received.store(false);
   m_load_level_received.store(false);
   m_move_ball_received.store(false);
   m_lost_ball_received.store(false);
   m_stop_ball_received.store(false);
-  m_block_impact_received.store(false);
+  m_level_changed_received.store(false);
   m_level_finished_received.store(false);
   m_explosion_received.store(false);
   m_prize_received.store(false);
@@ -96,15 +76,10 @@ AsyncContext::AsyncContext(JavaVM* jvm, jint fdn)
   m_bite_width_changed_received.store(false);
   m_laser_beam_visibility_received.store(false);
   m_laser_block_impact_received.store(false);
+  m_texture_decoded_received.store(false);
   m_window_set = false;
   m_resources = nullptr;
-
-  setBiteBallAppearance(BallEffect::NONE);
-
-  m_particle_diverge_buffer = new GLfloat[particleSize * particleSystemSize];
-  m_particle_converge_buffer = new GLfloat[particleSize * particleSystemSize];
-  m_particle_spiral_buffer = new GLfloat[particleSpiralSize * particleSpiralSystemSize];
-  m_particle_vacuum_buffer = new GLfloat[particleSize * particleSystemSize];
+  m_preloader = nullptr;
   DBG("exit AsyncContext ctor");
 }
 
@@ -114,23 +89,8 @@ AsyncContext::~AsyncContext() noexcept {
   m_window = nullptr;
   destroyDisplay();
 
-  delete [] m_bite_vertex_buffer; m_bite_vertex_buffer = nullptr;
-  delete [] m_bite_color_buffer; m_bite_color_buffer = nullptr;
-  delete [] m_ball_vertex_buffer; m_ball_vertex_buffer = nullptr;
-  delete [] m_ball_color_buffer; m_ball_color_buffer = nullptr;
-  delete [] m_bg_vertex_buffer; m_bg_vertex_buffer = nullptr;
-  delete [] m_particle_diverge_buffer; m_particle_diverge_buffer = nullptr;
-  delete [] m_particle_converge_buffer; m_particle_converge_buffer = nullptr;
-  delete [] m_particle_spiral_buffer; m_particle_spiral_buffer = nullptr;
-  delete [] m_particle_vacuum_buffer; m_particle_vacuum_buffer = nullptr;
-  delete [] m_rectangle_index_buffer; m_rectangle_index_buffer = nullptr;
-  delete [] m_octagon_index_buffer; m_octagon_index_buffer = nullptr;
-  delete [] m_rectangle_texCoord_buffer; m_rectangle_texCoord_buffer = nullptr;
-
   m_level = nullptr;
-  delete [] m_level_vertex_buffer; m_level_vertex_buffer = nullptr;
-  delete [] m_level_color_buffer; m_level_color_buffer = nullptr;
-  delete [] m_level_index_buffer; m_level_index_buffer = nullptr;
+  m_level_origin = nullptr;
 
   m_resources = nullptr;
   DBG("exit AsyncContext ~dtor");
@@ -153,10 +113,12 @@ void AsyncContext::callback_loadResources(bool /* dummy */) {
   interrupt();
 }
 
-void AsyncContext::callback_shiftGamepad(float position) {
-  std::lock_guard<std::mutex> lock(m_shift_gamepad_mutex);
-  DBG("EVENT CALLBACK: callback_shiftGamepad(%f)", position);
-  m_position = position;
+void AsyncContext::callback_shiftGamepad(const TouchSample* samples, size_t count) {
+  DBG("EVENT CALLBACK: callback_shiftGamepad(%zu samples)", count);
+  size_t pushed = m_touch_ring.push(samples, count);
+  if (pushed < count) {
+    WRN("Touch ring is full, %zu samples dropped", count - pushed);
+  }
   m_shift_gamepad_received.store(true);
   interrupt();
 }
@@ -172,6 +134,8 @@ void AsyncContext::callback_loadLevel(Level::Ptr level) {
   std::lock_guard<std::mutex> lock(m_load_level_mutex);
   DBG("EVENT CALLBACK: callback_loadLevel");
   m_level = level;
+  m_level_origin = level;
+  m_level_version = level->getVersion();
   m_load_level_received.store(true);
   interrupt();
 }
@@ -208,11 +172,11 @@ void AsyncContext::callback_stopBall(bool /* dummy */) {
   interrupt();
 }
 
-void AsyncContext::callback_blockImpact(RowCol block) {
-  std::lock_guard<std::mutex> lock(m_block_impact_mutex);
-  DBG("EVENT CALLBACK: callback_blockImpact(%i, %i, %i)", block.row, block.col, static_cast<int>(block.block));
-  m_impact_queue.push(block);
-  m_block_impact_received.store(true);
+void AsyncContext::callback_levelChanged(LevelVersion version) {
+  std::lock_guard<std::mutex> lock(m_level_changed_mutex);
+  DBG("EVENT CALLBACK: callback_levelChanged(%u, %zu)", version.version, version.changes.size());
+  m_level_versions.push(std::move(version));
+  m_level_changed_received.store(true);
   interrupt();
 }
 
@@ -223,21 +187,25 @@ void AsyncContext::callback_levelFinished(bool is_finished) {
   interrupt();
 }
 
-void AsyncContext::callback_explosion(ExplosionPackage package) {
-  std::lock_guard<std::mutex> lock(m_explosion_mutex);
-  DBG("EVENT CALLBACK: callback_explosion");
-  m_explosion_packages.push_back(package);
-  m_explosion_received.store(true);
-  interrupt();
-}
-
-void AsyncContext::callback_prizeReceived(PrizePackage package) {
-  std::lock_guard<std::mutex> lock(m_prize_mutex);
-  DBG("EVENT CALLBACK: callback_prizeReceived");
-  m_prize_packages[package.getID()] = package;
-  m_prize_last_timers[package.getID()] = 0;
-  m_prize_timers[package.getID()] = 0.0f;
-  m_prize_received.store(true);
+void AsyncContext::callback_blockChanged(BlockChangeBatch::Ptr batch) {
+  DBG("EVENT CALLBACK: callback_blockChanged(%zu, %zu)", batch->explosions.size(), batch->prizes.size());
+  if (batch->explosions.empty() && batch->prizes.empty()) {
+    return;  // changed blocks are rendered from published versions of level
+  }
+  if (!batch->explosions.empty()) {
+    std::lock_guard<std::mutex> lock(m_explosion_mutex);
+    m_explosion_packages.insert(m_explosion_packages.end(), batch->explosions.begin(), batch->explosions.end());
+    m_explosion_received.store(true);
+  }
+  if (!batch->prizes.empty()) {
+    std::lock_guard<std::mutex> lock(m_prize_mutex);
+    for (auto& package : batch->prizes) {
+      m_prize_packages[package.getID()] = package;
+      m_prize_last_timers[package.getID()] = 0;
+      m_prize_timers[package.getID()] = 0.0f;
+    }
+    m_prize_received.store(true);
+  }
   interrupt();
 }
 
@@ -252,32 +220,32 @@ void AsyncContext::callback_prizeCaught(PrizePackage package) {
   switch (package.getPrize()) {
     case Prize::EASY:  // not timed, but with special appearance
     case Prize::EASY_T:
-      setBiteBallAppearance(BallEffect::EASY);
+      m_renderer.setBiteBallAppearance(BallEffect::EASY);
       break;
     case Prize::EXPLODE:  // not timed, but with special appearance
     case Prize::JUMP:
-      setBiteBallAppearance(BallEffect::EXPLODE);
+      m_renderer.setBiteBallAppearance(BallEffect::EXPLODE);
       break;
     case Prize::GOO:
-      setBiteBallAppearance(BallEffect::GOO);
+      m_renderer.setBiteBallAppearance(BallEffect::GOO);
       break;
     case Prize::MIRROR:
-      setBiteBallAppearance(BallEffect::MIRROR);
+      m_renderer.setBiteBallAppearance(BallEffect::MIRROR);
       break;
     case Prize::PIERCE:
-      setBiteBallAppearance(BallEffect::PIERCE);
+      m_renderer.setBiteBallAppearance(BallEffect::PIERCE);
       break;
     case Prize::PROTECT:
-      setBiteBallAppearance(BallEffect::PROTECT);
+      m_renderer.setBiteBallAppearance(BallEffect::PROTECT);
       break;
     case Prize::RANDOM:
-      setBiteBallAppearance(BallEffect::RANDOM);
+      m_renderer.setBiteBallAppearance(BallEffect::RANDOM);
       break;
     case Prize::UPGRADE:  // not timed, but with special appearance
-      setBiteBallAppearance(BallEffect::UPGRADE);
+      m_renderer.setBiteBallAppearance(BallEffect::UPGRADE);
       break;
     case Prize::DEGRADE:  // not timed, but with special appearance
-      setBiteBallAppearance(BallEffect::DEGRADE);
+      m_renderer.setBiteBallAppearance(BallEffect::DEGRADE);
       break;
     default:
       break;
@@ -326,6 +294,13 @@ void AsyncContext::callback_delayRequested(bool /* dummy */) {
   interrupt();
 }
 
+void AsyncContext::callback_textureDecoded() {
+  std::lock_guard<std::mutex> lock(m_texture_decoded_mutex);
+  DBG("EVENT CALLBACK: callback_textureDecoded");
+  m_texture_decoded_received.store(true);
+  interrupt();
+}
+
 // ----------------------------------------------
 Level::Ptr AsyncContext::getCurrentLevelState() {
   std::lock_guard<std::mutex> lock(m_load_level_mutex);
@@ -336,6 +311,10 @@ void AsyncContext::setResourcesPtr(Resources* resources) {
   m_resources = resources;
 }
 
+void AsyncContext::setLevelPreloader(LevelPreloader* preloader) {
+  m_preloader = preloader;
+}
+
 /* *** Private methods *** */
 /* JNIEnvironment group */
 // ----------------------------------------------------------------------------
@@ -374,7 +353,7 @@ bool AsyncContext::checkForWakeUp() {
       m_move_ball_received.load() ||
       m_lost_ball_received.load() ||
       m_stop_ball_received.load() ||
-      m_block_impact_received.load() ||
+      m_level_changed_received.load() ||
       m_level_finished_received.load() ||
       m_explosion_received.load() ||
       m_prize_received.load() ||
@@ -383,7 +362,8 @@ bool AsyncContext::checkForWakeUp() {
       m_bite_width_changed_received.load() ||
       m_laser_beam_visibility_received.load() ||
       m_laser_block_impact_received.load() ||
-      m_delay_request_received.load();
+      m_delay_request_received.load() ||
+      m_texture_decoded_received.load();
 }
 
 void AsyncContext::eventHandler() {
@@ -397,6 +377,10 @@ void AsyncContext::eventHandler() {
       m_load_resources_received.store(false);
       process_loadResources();
     }
+    if (m_texture_decoded_received.load()) {
+      m_texture_decoded_received.store(false);
+      process_textureDecoded();
+    }
     if (m_shift_gamepad_received.load()) {
       m_shift_gamepad_received.store(false);
       process_shiftGamepad();
@@ -417,11 +401,10 @@ void AsyncContext::eventHandler() {
       m_laser_block_impact_received.store(false);
       process_laserBlockImpact();
     }
-    if (m_block_impact_received.load()) {
-      m_block_impact_received.store(false);
-      process_blockImpact();
-    }  // block impact must be processed before
-       // new level loaded to avoid crash
+    if (m_level_changed_received.load()) {
+      m_level_changed_received.store(false);
+      process_levelChanged();
+    }
     if (m_load_level_received.load()) {
       m_load_level_received.store(false);
       process_loadLevel();
@@ -482,8 +465,7 @@ void AsyncContext::process_setWindow() {
     ERR("Failed to configure display, surface and context !");
     throw GraphicsNotConfiguredException();
   }
-  glOptionsConfig();
-  initParticleSystem();
+  m_renderer.init(m_width, m_height);
   m_window_set = true;
   DBG("exit AsyncContext::process_setWindow()");
 }
@@ -492,23 +474,46 @@ void AsyncContext::process_loadResources() {
   std::lock_guard<std::mutex> lock(m_load_resources_mutex);
   DBG("EVENT PROCESS: process_loadResources");
   if (m_resources != nullptr) {
+    std::vector<native::Texture*> textures;
     for (auto it = m_resources->beginTexture(); it != m_resources->endTexture(); ++it) {
-      DBG("Loading texture resources: %s %p", it->first.c_str(), it->second);
-      if (!it->second->load()) {
-        // notify Java layer about internal problem
-        m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorTextureLoad_id);
+      if (Resources::isBackground(it->first)) {
+        continue;  // only one background is loaded at once, on demand
       }
+      DBG("Loading texture resources: %s %p", it->first.c_str(), it->second);
+      textures.push_back(it->second);
+    }
+    native::Texture* background = m_resources->acquireBackground();
+    if (background != nullptr) {
+      textures.push_back(background);
     }
+    m_renderer.setBackground(background);
+    // decoded on worker threads, uploaded in process_textureDecoded()
+    m_texture_loader.decode(textures, [this]() { callback_textureDecoded(); });
+    m_renderer.setTextures(m_resources);
   } else {
     ERR("Resources pointer was not set !");
   }
-  m_bg_texture = m_resources->getRandomTexture("bg");
 }
 
 void AsyncContext::process_shiftGamepad() {
-  std::lock_guard<std::mutex> lock(m_shift_gamepad_mutex);
-  DBG("EVENT PROCESS: process_shiftGamepad(%f)", m_position);
-  moveBite(m_position);
+  size_t count = m_touch_ring.drain(m_touch_samples);
+  DBG("EVENT PROCESS: process_shiftGamepad(%zu samples)", count);
+  if (count == 0) {
+    return;
+  }
+  // every sample moves the bite, so that fast gesture isn't lost out of touch area
+  GLfloat previous_x = m_bite.getXPose();
+  for (size_t i = 0; i < count; ++i) {
+    moveBite(m_touch_samples[i].position, true /* silent */);
+  }
+  int64_t time = m_touch_samples[count - 1].time;
+  int64_t elapsed = time - m_touch_time;
+  m_touch_velocity = (elapsed > 0 && elapsed <= BiteParams::predictionHorizon) ? (m_bite.getXPose() - previous_x) / elapsed : 0.0f;
+  m_touch_time = time;
+  bite_location_event.notifyListeners(m_bite);  // once per batch
+
+  int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  m_renderer.getProfiler().onInputLatency((now - time) / 1000000.0f);
 }
 
 void AsyncContext::process_throwBall() {
@@ -521,32 +526,15 @@ void AsyncContext::process_loadLevel() {
   std::lock_guard<std::mutex> lock(m_load_level_mutex);
   DBG("EVENT PROCESS: process_loadLevel");
   initGame();
-  {
-    std::queue<RowCol> empty_queue;
-    std::swap(m_impact_queue, empty_queue);
-  }
 
-  // release memory allocated for previous level if any
-  delete [] m_level_vertex_buffer;
-  delete [] m_level_color_buffer;
-  delete [] m_level_index_buffer;
-  m_level_vertex_buffer = new GLfloat[m_level->size() * 16];
-  m_level_color_buffer = new GLfloat[m_level->size() * 16];
-  m_level_index_buffer = new GLushort[m_level->size() * 6];
-
-  LevelDimens dimens(
-      m_level->numRows(),
-      m_level->numCols(),
-      m_level->numCols() * LevelDimens::blockWidth,
-      m_level->numRows() * LevelDimens::blockHeight * m_aspect,
-      LevelDimens::blockWidth,
-      LevelDimens::blockHeight * m_aspect);
-
-  m_level->toVertexArray(dimens.getBlockWidth(), dimens.getBlockHeight(), -1.0f, 1.0f, &m_level_vertex_buffer[0]);
-  m_level->fillColorArray(&m_level_color_buffer[0]);
-  util::rectangleIndices(&m_level_index_buffer[0], (size_t) m_level->size() * 6);
-
-  level_dimens_event.notifyListeners(dimens);
+  // geometry of preloaded level is ready, otherwise it's built right here
+  PreparedLevel prepared;
+  if (m_preloader == nullptr || !m_preloader->takeGeometry(m_level, m_aspect, &prepared)) {
+    prepared.level = m_level;
+    LevelPreloader::buildGeometry(m_aspect, &prepared);
+  }
+  m_renderer.setLevel(m_level, &prepared);
+  level_dimens_event.notifyListeners(prepared.dimens);
 }
 
 void AsyncContext::process_moveBall() {
@@ -560,7 +548,7 @@ void AsyncContext::process_lostBall() {
   std::lock_guard<std::mutex> lock(m_lost_ball_mutex);
   DBG("EVENT PROCESS: process_lostBall");
   clearPrizeStructures();
-  if (m_render_explosion) {
+  if (m_renderer.hasExplosions()) {
     moveBall(0.0f, 1000.f);
     delay(DELAY_INT);
   }
@@ -573,19 +561,22 @@ void AsyncContext::process_stopBall() {
   m_render_laser = false;
 }
 
-void AsyncContext::process_blockImpact() {
-  std::lock_guard<std::mutex> lock(m_block_impact_mutex);
-  DBG("EVENT PROCESS: process_blockImpact");
-  while (!m_impact_queue.empty()) {
-    auto impact = m_impact_queue.front();
-    if (!checkBlockPresense(impact.row, impact.col)) {
-      WRN("Impacted block is absent in level!");
-      std::queue<RowCol> empty_queue;
-      std::swap(m_impact_queue, empty_queue);
-      return;
+void AsyncContext::process_levelChanged() {
+  std::lock_guard<std::mutex> lock(m_level_changed_mutex);
+  std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+  DBG("EVENT PROCESS: process_levelChanged");
+  // buffers of pending level will be built from the latest version at once
+  bool apply_changes = !m_load_level_received.load();
+  for (; !m_level_versions.empty(); m_level_versions.pop()) {
+    const LevelVersion& version = m_level_versions.front();
+    if (version.origin != m_level_origin || version.version <= m_level_version) {
+      continue;  // stale version of previous level
+    }
+    m_level = version.snapshot;
+    m_level_version = version.version;
+    if (apply_changes) {
+      m_renderer.changeLevel(m_level, version.changes);
     }
-    m_level->fillColorArrayAtBlock(&m_level_color_buffer[0], impact.row, impact.col);
-    m_impact_queue.pop();
   }
 }
 
@@ -593,8 +584,8 @@ void AsyncContext::process_levelFinished() {
   std::lock_guard<std::mutex> lock(m_level_finished_mutex);
   DBG("EVENT PROCESS: process_levelFinished");
   clearPrizeStructures();
-  m_bg_texture = m_resources->getRandomTexture("bg");
-  if (m_render_explosion) {
+  changeBackground();
+  if (m_renderer.hasExplosions()) {
     moveBall(0.0f, 1000.f);
     delay(DELAY_INT);
   }
@@ -604,8 +595,10 @@ void AsyncContext::process_levelFinished() {
 void AsyncContext::process_explosion() {
   std::lock_guard<std::mutex> lock(m_explosion_mutex);
   DBG("EVENT PROCESS: process_explosion");
-  m_last_time = 0;
-  m_render_explosion = true;
+  for (auto& item : m_explosion_packages) {
+    m_renderer.spawnExplosion(item);
+  }
+  m_explosion_packages.clear();
 }
 
 void AsyncContext::process_prizeReceived() {
@@ -623,7 +616,7 @@ void AsyncContext::process_prizeCaught() {
 void AsyncContext::process_dropBallAppearance() {
   std::lock_guard<std::mutex> lock(m_drop_ball_appearance_mutex);
   DBG("EVENT PROCESS: process_dropBallAppearance");
-  setBiteBallAppearance(BallEffect::NONE);
+  m_renderer.setBiteBallAppearance(BallEffect::NONE);
 }
 
 void AsyncContext::process_biteWidthChanged() {
@@ -665,6 +658,26 @@ void AsyncContext::process_delayRequested() {
   delay(DELAY_INT);
 }
 
+void AsyncContext::process_textureDecoded() {
+  // mutex isn't held during upload, workers lock it in callback_textureDecoded()
+  DBG("EVENT PROCESS: process_textureDecoded");
+  int failed = m_texture_loader.upload(std::chrono::milliseconds(textureUploadBudget));
+  if (failed > 0) {
+    // notify Java layer about internal problem
+    m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorTextureLoad_id);
+  }
+  m_jenv->CallVoidMethod(master_object, fireJavaEvent_textureLoadProgress_id,
+      m_texture_loader.getProcessed(), m_texture_loader.getTotal());
+  if (m_texture_loader.hasPendingUploads()) {
+    std::lock_guard<std::mutex> lock(m_texture_decoded_mutex);
+    m_texture_decoded_received.store(true);  // continue upload within the next frame
+  } else if (m_texture_loader.isFinished()) {
+    m_resources->trimBackgrounds();  // previous background is no longer needed
+    m_resources->reportBackgroundResidency();
+  }
+  m_renderer.invalidateStaticLayer();  // background might have been uploaded
+}
+
 /* LogicFunc group */
 // ----------------------------------------------------------------------------
 void AsyncContext::initGame() {
@@ -686,7 +699,7 @@ void AsyncContext::initGame() {
     m_ball.setXPose(m_bite.getXPose());
     m_ball.setYPose(-BiteParams::neg_biteElevation + m_ball.getDimens().halfHeight());
     moveBall(m_ball.getPose().getX(), m_ball.getPose().getY());
-    setBiteBallAppearance(BallEffect::NONE);
+    m_renderer.setBiteBallAppearance(BallEffect::NONE);
 
     init_ball_position_event.notifyListeners(m_ball);
     m_ball_inited = true;
@@ -708,25 +721,32 @@ void AsyncContext::moveBite(float position, bool silent) {
     m_bite.setXPose(hw - 1.0f);
   }
 
-  util::setRectangleVertices(
-      &m_bite_vertex_buffer[0],
-      m_bite.getDimens().width(), m_bite.getDimens().height(),
-      -hw + m_bite.getXPose(),
-      -BiteParams::neg_biteElevation,
-      1, 1);
+  m_renderer.setBitePose(m_bite, m_bite.getXPose());
+  m_bite_rendered_x = m_bite.getXPose();
 
   if (!silent) {
     bite_location_event.notifyListeners(m_bite);
   }
 }
 
+void AsyncContext::predictBite() {
+  GLfloat x = m_bite.getXPose();
+  if (m_bite_prediction.load() && m_touch_velocity != 0.0f) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t elapsed = now - m_touch_time;
+    if (elapsed >= 0 && elapsed <= BiteParams::predictionHorizon) {
+      auto hw = m_bite.getDimens().halfWidth();
+      x = std::min(1.0f - hw, std::max(hw - 1.0f, x + m_touch_velocity * elapsed));
+    }
+  }
+  if (x != m_bite_rendered_x) {
+    m_renderer.setBitePose(m_bite, x);
+    m_bite_rendered_x = x;
+  }
+}
+
 void AsyncContext::moveBall(float x_position, float y_position) {
-  util::setOctagonVertices(
-      &m_ball_vertex_buffer[0],
-      m_ball.getDimens().width(), m_ball.getDimens().height(),
-      -m_ball.getDimens().halfWidth() + x_position,
-      m_ball.getDimens().halfHeight() + y_position,
-      1, 1);
+  m_renderer.setBallPose(m_ball, x_position, y_position);
 }
 
 void AsyncContext::addPrizeToRemoved(int prize_id) {
@@ -750,129 +770,12 @@ void AsyncContext::clearPrizeStructures() {
   m_removed_prizes.clear();
 }
 
-bool AsyncContext::checkBlockPresense(int row, int col) {
-  return (row >= 0 && row < m_level->numRows()) && (col >= 0 && col < m_level->numCols());
-}
-
-void AsyncContext::setBiteBallAppearance(BallEffect effect) {
-  switch (effect) {
-    default:
-    case BallEffect::NONE:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
-      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
-      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::EASY:
-    case BallEffect::EASY_T:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::YELLOW, &m_ball_color_buffer[0], 4);
-      util::setColor(util::TITAN, &m_ball_color_buffer[4], 16);
-      util::setColor(util::MIDAS, &m_ball_color_buffer[20], 4);
-      util::setColor(util::MIDAS_EDGE, &m_ball_color_buffer[24], 12);
-      util::setColor(util::TITAN_EDGE, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::EXPLODE:
-    case BallEffect::JUMP:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::WATER_EDGE, &m_ball_color_buffer[0], 4);
-      util::setColor(util::WATER, &m_ball_color_buffer[4], 16);
-      util::setColor(util::ULTRA, &m_ball_color_buffer[20], 4);
-      util::setColor(util::ULTRA_EDGE, &m_ball_color_buffer[24], 12);
-      util::setColor(util::MAGENTA, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::GOO:
-      // bite
-      util::setColor(util::ZYGOTE_SPAWN, &m_bite_color_buffer[0], 8);
-      util::setColor(util::ZYGOTE_SPAWN_EDGE, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::GREEN, &m_ball_color_buffer[0], 4);
-      util::setColor(util::ZYGOTE_SPAWN, &m_ball_color_buffer[4], 16);
-      util::setColor(util::NETWORK, &m_ball_color_buffer[20], 4);
-      util::setColor(util::ZYGOTE_EDGE, &m_ball_color_buffer[24], 12);
-      util::setColor(util::NETWORK, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::PIERCE:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::BLACK, &m_ball_color_buffer[0], 4);
-      util::setColor(util::DESTROY, &m_ball_color_buffer[4], 16);
-      util::setColor(util::KNOCK_EDGE, &m_ball_color_buffer[20], 4);
-      util::setColor(util::ROLLING, &m_ball_color_buffer[24], 12);
-      util::setColor(util::ROLLING_EDGE, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::MIRROR:
-      // bite
-      util::setColor(util::MIRROR, &m_bite_color_buffer[0], 8);
-      util::setColor(util::MIRROR_EDGE, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
-      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
-      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::PROTECT:
-      // bite
-      util::setColor(util::TITAN, &m_bite_color_buffer[0], 8);
-      util::setColor(util::TITAN_EDGE, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
-      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
-      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::RANDOM:
-      // bite
-      util::setColor(util::MAGENTA, &m_bite_color_buffer[0], 8);
-      util::setColor(util::PURPLE, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
-      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
-      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
-      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::UPGRADE:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::GREEN, &m_ball_color_buffer[0], 4);
-      util::setColor(util::ZYGOTE_SPAWN, &m_ball_color_buffer[4], 16);
-      util::setColor(util::NETWORK, &m_ball_color_buffer[20], 4);
-      util::setColor(util::ZYGOTE_EDGE, &m_ball_color_buffer[24], 12);
-      util::setColor(util::NETWORK, &m_ball_color_buffer[32], 4);
-      break;
-    case BallEffect::DEGRADE:
-      // bite
-      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
-      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
-      // ball
-      util::setColor(util::RED, &m_ball_color_buffer[0], 4);
-      util::setColor(util::ORIGIN, &m_ball_color_buffer[4], 16);
-      util::setColor(util::BRICK, &m_ball_color_buffer[20], 4);
-      util::setColor(util::DESTROY_EDGE, &m_ball_color_buffer[24], 12);
-      util::setColor(util::BRICK, &m_ball_color_buffer[32], 4);
-      break;
-//    case BallEffect::ZYGOTE:
-//      TODO ZYGOTE
-//      break;
+void AsyncContext::changeBackground() {
+  native::Texture* background = m_resources->acquireBackground();
+  if (background != nullptr && background->getID() == 0) {
+    m_texture_loader.decode({background}, [this]() { callback_textureDecoded(); });
   }
+  m_renderer.setBackground(background);
 }
 
 /* GraphicsContext group */
@@ -935,6 +838,9 @@ bool AsyncContext::displayConfig() {
     return false;
   }
   m_aspect = (GLfloat) m_width / m_height;
+  if (m_preloader != nullptr) {
+    m_preloader->setAspect(m_aspect);
+  }
   DBG("Surface width = %i, height = %i, aspect = %lf", m_width, m_height, m_aspect);
 
   /// @see http://android-developers.blogspot.kr/2013_09_01_archive.html
@@ -943,22 +849,11 @@ bool AsyncContext::displayConfig() {
   return true;
 }
 
-void AsyncContext::glOptionsConfig() {
-  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-  glViewport(-4, -4, m_width + 4, m_height + 4);
-
-  m_level_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
-  m_bite_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
-  m_ball_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
-  m_explosion_shader = std::make_shared<shader::ShaderHelper>(shader::ParticleSystemShader());
-  m_sample_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleTextureShader());
-  m_prize_shader = std::make_shared<shader::ShaderHelper>(shader::VerticalFallShader());
-  m_prize_catch_shader = std::make_shared<shader::ShaderHelper>(shader::ParticleMoveShader());
-  m_laser_shader = std::make_shared<shader::ShaderHelper>(shader::VerticalClimbShader());
-}
-
 void AsyncContext::destroyDisplay() {
   if (m_egl_display != EGL_NO_DISPLAY) {
+    if (m_egl_context != EGL_NO_CONTEXT) {
+      m_renderer.release();
+    }
     eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
     if (m_egl_context != EGL_NO_CONTEXT) {
       eglDestroyContext(m_egl_display, m_egl_context);
@@ -975,44 +870,20 @@ void AsyncContext::destroyDisplay() {
 
 void AsyncContext::render() {
   if (m_egl_display != EGL_NO_DISPLAY) {
-    glClear(GL_COLOR_BUFFER_BIT);
-    drawBackground();
-
-    for (int r = 0; r < m_level->numRows(); ++r) {
-      for (int c = 0; c < m_level->numCols(); ++c) {
-        auto block = m_level->getBlock(r, c);
-        switch (block) {
-          case Block::NONE:
-            glEnable(GL_BLEND);
-            break;
-          default:
-            glDisable(GL_BLEND);
-            break;
-        }
-#if USE_TEXTURE
-        auto texture = BlockUtils::getBlockTexture(block);
-        if (texture.empty()) {
-          drawBlock(r, c);
-        } else {
-          drawTexturedBlock(r, c, texture);
-        }
-#else
-        drawBlock(r, c);
+#if ENABLED_ALLOCATION_COUNTER
+    uint64_t heap_allocations = util::getThreadHeapAllocations();
 #endif
-      }
-    }
-    drawBite();
-    drawBall();
-
-    if (m_render_explosion) {
-      for (auto& item : m_explosion_packages) {
-        drawExplosion(
-            item.getX(),
-            item.getY(),
-            item.getColor(),
-            item.getKind());
-      }
-    }
+    util::RenderProfiler& profiler = m_renderer.getProfiler();
+    m_renderer.beginFrame();
+    m_renderer.drawStaticLayer();
+    profiler.endStage(util::RenderStage::STATIC_LAYER);
+    predictBite();
+    m_renderer.drawBite();
+    m_renderer.drawBall();
+    profiler.endStage(util::RenderStage::BITE_BALL);
+
+    m_renderer.drawExplosion();
+    profiler.endStage(util::RenderStage::EXPLOSION);
 
     if (m_render_laser) {
       drawLaser(m_bite.getXPose(), -BiteParams::neg_biteElevation);
@@ -1028,9 +899,18 @@ void AsyncContext::render() {
         drawPrizeCatch(item, -BiteParams::neg_biteElevation, util::MIDAS);
       }
     }
+    profiler.endStage(util::RenderStage::SPRITES);
 
+#if ENABLED_ALLOCATION_COUNTER
+    heap_allocations = util::getThreadHeapAllocations() - heap_allocations;
+    if (heap_allocations > 0) {
+      WRN("Frame has performed %llu heap allocations", (unsigned long long) heap_allocations);
+    }
+#endif
     eglSwapInterval(m_egl_display, 0);
     eglSwapBuffers(m_egl_display, m_egl_surface);
+    profiler.endStage(util::RenderStage::SWAP);
+    m_renderer.endFrame();
   }
 }
 
@@ -1042,346 +922,9 @@ void AsyncContext::delay(int ms) {
   }
 }
 
-void AsyncContext::initParticleSystem() {
-  for (int i = 0; i < particleSystemSize; ++i) {
-    int index = i * particleSize;
-    // Lifetime of particle
-    m_particle_diverge_buffer[index + 0]  = m_particle_distribution(m_generator);
-    m_particle_converge_buffer[index + 0] = m_particle_distribution(m_generator);
-    m_particle_vacuum_buffer[index + 0]   = m_particle_normal_distribution(m_generator);
-    // Start position of particle
-    m_particle_diverge_buffer[index + 3]  = m_particle_distribution(m_generator) * 0.25f - 0.125f;
-    m_particle_diverge_buffer[index + 4]  = (m_particle_distribution(m_generator) * 0.25f - 0.125f) * m_aspect;
-    m_particle_converge_buffer[index + 3] = m_particle_distribution(m_generator) * 0.2f - 0.1f;
-    m_particle_converge_buffer[index + 4] = (m_particle_distribution(m_generator) * 0.1f - 0.05f) * m_aspect;
-    m_particle_vacuum_buffer[index + 3]   = m_particle_normal_distribution(m_generator) * 0.15f - 0.075f;
-    m_particle_vacuum_buffer[index + 4]   = (m_particle_normal_distribution(m_generator) * 0.15f - 0.075f) * m_aspect;
-    // End position of particle
-    m_particle_diverge_buffer[index + 1]  = m_particle_distribution(m_generator) * 2.0f - 1.0f;
-    m_particle_diverge_buffer[index + 2]  = (m_particle_distribution(m_generator) * 2.0f - 1.0f) * m_aspect;
-    m_particle_converge_buffer[index + 1] = m_particle_distribution(m_generator) * 0.1f;
-    m_particle_converge_buffer[index + 2] = m_particle_distribution(m_generator) * 0.05f * m_aspect;
-    m_particle_vacuum_buffer[index + 1]   = m_particle_normal_distribution(m_generator) * 0.025f - 0.0125f;
-    m_particle_vacuum_buffer[index + 2]   = (m_particle_normal_distribution(m_generator) * 0.025f - 0.0125f) * m_aspect;
-  }
-
-  // --------------------------------------------
-  GLfloat step = 0.001f;
-  GLfloat halfStep = 0.5f * step;
-  // branch 0
-  {
-    int bi = 0 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -halfStep * i;
-      m_particle_spiral_buffer[index + 3 + bi] = step * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = step * i;
-      m_particle_spiral_buffer[index + 1 + bi] = halfStep * i;
-    }
-    GLfloat offset = 0;//-halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - (particleSpiralSystemBranchSize >> 1);
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = offset + halfStep * j;
-      m_particle_spiral_buffer[index + 3 + bi] = step * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = step * j;
-      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * j;
-    }
-  }
-  // branch 1
-  {
-    int bi = 1 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = step * i;
-      m_particle_spiral_buffer[index + 3 + bi] = halfStep * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = halfStep * i;
-      m_particle_spiral_buffer[index + 1 + bi] = -step * i;
-    }
-    GLfloat offset = 0;//halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - (particleSpiralSystemBranchSize >> 1);
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = step * j;
-      m_particle_spiral_buffer[index + 3 + bi] = offset - halfStep * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * j;
-      m_particle_spiral_buffer[index + 1 + bi] = -step * j;
-    }
-  }
-  // branch 2
-  {
-    int bi = 2 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = halfStep * i;
-      m_particle_spiral_buffer[index + 3 + bi] = -step * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -step * i;
-      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * i;
-    }
-    GLfloat offset = 0;//halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - (particleSpiralSystemBranchSize >> 1);
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = offset - halfStep * j;
-      m_particle_spiral_buffer[index + 3 + bi] = -step * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -step * j;
-      m_particle_spiral_buffer[index + 1 + bi] = halfStep * j;
-    }
-  }
-  // branch 3
-  {
-    int bi = 3 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -step * i;
-      m_particle_spiral_buffer[index + 3 + bi] = -halfStep * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * i;
-      m_particle_spiral_buffer[index + 1 + bi] = step * i;
-    }
-    GLfloat offset = 0;//-halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - (particleSpiralSystemBranchSize >> 1);
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -step * j;
-      m_particle_spiral_buffer[index + 3 + bi] = offset + halfStep * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = halfStep * j;
-      m_particle_spiral_buffer[index + 1 + bi] = step * j;
-    }
-  }
-}
-
 /* Drawings group */
 // ----------------------------------------------------------------------------
-void AsyncContext::drawLevel() {
-  m_level_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_position");
-  GLuint a_color = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_color");
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[0]);
-  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_level_color_buffer[0]);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_color);
-
-  glDrawElements(GL_TRIANGLES, m_level->size() * 6, GL_UNSIGNED_SHORT, &m_level_index_buffer[0]);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_color);
-}
-
-void AsyncContext::drawBlock(int row, int col) {
-  m_level_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_position");
-  GLuint a_color = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_color");
-
-  int rci = col * 16 + row * m_level->numCols() * 16;
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[rci]);
-  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_level_color_buffer[rci]);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_color);
-
-  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_color);
-}
-
-void AsyncContext::drawTexturedBlock(int row, int col, const std::string& texture) {
-  m_sample_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
-  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
-
-  int rci = col * 16 + row * m_level->numCols() * 16;
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[rci]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
-
-  m_resources->getTexture(texture)->apply();
-  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_texCoord);
-
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_texCoord);
-}
-
-void AsyncContext::drawBite() {
-  m_bite_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_bite_shader->getProgram(), "a_position");
-  GLuint a_color = (GLuint) glGetAttribLocation(m_bite_shader->getProgram(), "a_color");
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_bite_vertex_buffer[0]);
-  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_bite_color_buffer[0]);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_color);
-  glDisable(GL_BLEND);
-
-  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_color);
-}
-
-void AsyncContext::drawBall() {
-  m_ball_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_ball_shader->getProgram(), "a_position");
-  GLuint a_color = (GLuint) glGetAttribLocation(m_ball_shader->getProgram(), "a_color");
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_ball_vertex_buffer[0]);
-  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_ball_color_buffer[0]);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_color);
-  glDisable(GL_BLEND);
-
-  glDrawElements(GL_TRIANGLES, 24, GL_UNSIGNED_SHORT, &m_octagon_index_buffer[0]);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_color);
-}
-
-void AsyncContext::drawExplosion(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, Kind kind) {
-  m_explosion_shader->useProgram();
-
-  if (m_last_time == 0) {
-    m_last_time = clock();
-  }
-  {
-    clock_t currentTime = clock();
-    float delta_elapsed = static_cast<float>(currentTime - m_last_time) / CLOCKS_PER_SEC;
-    m_last_time = currentTime;
-    m_particle_time += delta_elapsed;
-    if (m_particle_time >= 1.0f) {
-      m_particle_time = 0.0f;
-      m_render_explosion = false;
-      m_explosion_packages.clear();
-      return;
-    }
-  }
-
-  GLint u_time = glGetUniformLocation(m_explosion_shader->getProgram(), "u_time");
-  GLint u_centerPosition = glGetUniformLocation(m_explosion_shader->getProgram(), "u_centerPosition");
-  GLint u_color = glGetUniformLocation(m_explosion_shader->getProgram(), "u_color");
-
-  GLfloat* coord = new GLfloat[2]{x, y};
-  GLfloat* color = new GLfloat[4]{bgra.b, bgra.g, bgra.r, 0.5f};
-  glUniform2fv(u_centerPosition, 1, &coord[0]);
-  glUniform4fv(u_color, 1, &color[0]);
-  glUniform1f(u_time, m_particle_time);
-
-  GLuint a_lifetime = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_lifetime");
-  GLuint a_startPosition = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_startPosition");
-  GLuint a_endPosition = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_endPosition");
-
-  {
-    GLfloat* lifetime_buffer = nullptr;
-    GLfloat* start_points_buffer = nullptr;
-    GLfloat* end_points_buffer = nullptr;
-
-    switch (kind) {
-      default:
-      case Kind::DIVERGE:
-        lifetime_buffer = &m_particle_diverge_buffer[0];
-        start_points_buffer = &m_particle_diverge_buffer[3];
-        end_points_buffer = &m_particle_diverge_buffer[1];
-        break;
-      case Kind::CONVERGE:
-        lifetime_buffer = &m_particle_converge_buffer[0];
-        start_points_buffer = &m_particle_converge_buffer[3];
-        end_points_buffer = &m_particle_converge_buffer[1];
-        break;
-      case Kind::VACUUM:
-        lifetime_buffer = &m_particle_vacuum_buffer[0];
-        start_points_buffer = &m_particle_vacuum_buffer[3];
-        end_points_buffer = &m_particle_vacuum_buffer[1];
-        break;
-    }
-    glVertexAttribPointer(a_lifetime, 1, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), lifetime_buffer);
-    glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), start_points_buffer);
-    glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), end_points_buffer);
-  }
-
-  m_resources->getTexture("smoke.png")->apply();
-  GLint sampler = glGetUniformLocation(m_explosion_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_lifetime);
-  glEnableVertexAttribArray(a_startPosition);
-  glEnableVertexAttribArray(a_endPosition);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  glDrawArrays(GL_POINTS, 0, particleSystemSize);
-
-  delete [] coord;
-  delete [] color;
-
-  glDisableVertexAttribArray(a_lifetime);
-  glDisableVertexAttribArray(a_startPosition);
-  glDisableVertexAttribArray(a_endPosition);
-}
-
-void AsyncContext::drawBackground() {
-  m_sample_shader->useProgram();
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
-  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_bg_vertex_buffer[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
-
-  m_bg_texture->apply();
-  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_texCoord);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_texCoord);
-}
-
 void AsyncContext::drawPrize(const PrizePackage& prize) {
-  m_prize_shader->useProgram();
-
   if (m_prize_last_timers.at(prize.getID()) == 0) {
     m_prize_last_timers.at(prize.getID()) = clock();
   }
@@ -1395,7 +938,7 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
       return;
     }
   }
-  int is_visible = 1;  /* true */
+  bool is_visible = true;
   {
     GLfloat Ypath = prize.getY() - m_prize_timers.at(prize.getID()) * PrizeParams::prizeSpeed;
     if (Ypath >= -BiteParams::neg_biteElevation) {
@@ -1405,55 +948,14 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
     } else if (Ypath < -BiteParams::neg_biteElevation && Ypath > -1.0f) {
       prize_gone_event.notifyListeners(prize.getID());
     } else {
-      is_visible = 0;  /* false */
+      is_visible = false;
       addPrizeToRemoved(prize.getID());
     }
   }
-
-  GLint u_time = glGetUniformLocation(m_prize_shader->getProgram(), "u_time");
-  GLint u_velocity = glGetUniformLocation(m_prize_shader->getProgram(), "u_velocity");
-  GLint u_visible = glGetUniformLocation(m_prize_shader->getProgram(), "u_visible");
-  glUniform1f(u_time, m_prize_timers.at(prize.getID()));
-  glUniform1f(u_velocity, PrizeParams::prizeSpeed);
-  glUniform1i(u_visible, is_visible);
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_prize_shader->getProgram(), "a_position");
-  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_prize_shader->getProgram(), "a_texCoord");
-
-  GLfloat* prize_vertices = new GLfloat[16];
-  util::setRectangleVertices(
-      prize_vertices,
-      PrizeParams::prizeWidth,
-      PrizeParams::prizeHeight * m_aspect,
-      prize.getX() - PrizeParams::prizeHalfWidth,
-      prize.getY() - PrizeParams::prizeHalfHeight,
-      1, 1);
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &prize_vertices[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
-
-  m_resources->getPrizeTexture(prize.getPrize())->apply();
-  GLint sampler = glGetUniformLocation(m_prize_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_texCoord);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  delete [] prize_vertices;
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_texCoord);
+  m_renderer.drawPrize(prize, m_prize_timers.at(prize.getID()), is_visible);
 }
 
 void AsyncContext::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra) {
-  m_prize_catch_shader->useProgram();
-
   if (m_prize_catch_last_time == 0) {
     m_prize_catch_last_time = clock();
   }
@@ -1469,46 +971,10 @@ void AsyncContext::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat
       return;
     }
   }
-
-  GLint u_time = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_time");
-  GLint u_centerPosition = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_centerPosition");
-  GLint u_color = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_color");
-
-  GLfloat* coord = new GLfloat[2]{x, y};
-  GLfloat* color = new GLfloat[4]{bgra.b, bgra.g, bgra.r, 0.5f};
-  glUniform2fv(u_centerPosition, 1, &coord[0]);
-  glUniform4fv(u_color, 1, &color[0]);
-  glUniform1f(u_time, m_prize_catch_time);
-
-  GLuint a_startPosition = (GLuint) glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_startPosition");
-  GLuint a_endPosition = (GLuint) glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_endPosition");
-
-  glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[2]);
-  glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[0]);
-
-  m_resources->getTexture("spark.png")->apply();
-  GLint sampler = glGetUniformLocation(m_prize_catch_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_startPosition);
-  glEnableVertexAttribArray(a_endPosition);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  glDrawArrays(GL_POINTS, 0, particleSpiralSystemSize);
-
-  delete [] coord;
-  delete [] color;
-
-  glDisableVertexAttribArray(a_startPosition);
-  glDisableVertexAttribArray(a_endPosition);
+  m_renderer.drawPrizeCatch(x, y, bgra, m_prize_catch_time);
 }
 
 void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
-  m_laser_shader->useProgram();
-
   if (m_laser_last_time == 0) {
     m_laser_last_time = clock();
   }
@@ -1524,55 +990,16 @@ void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
       return;
     }
   }
-  int is_visible = 1;  /* true */
+  bool is_visible = true;
   {
     GLfloat Ypath = y + m_laser_time * LaserParams::laserSpeed;
     if (!m_laser_interruption && Ypath <= 1.0f + LaserParams::laserHalfHeight) {
       laser_beam_event.notifyListeners(LaserPackage(x, Ypath));
     } else {
-      is_visible = 0;  /* false */
+      is_visible = false;
     }
   }
-
-  GLint u_time = glGetUniformLocation(m_laser_shader->getProgram(), "u_time");
-  GLint u_velocity = glGetUniformLocation(m_laser_shader->getProgram(), "u_velocity");
-  GLint u_visible = glGetUniformLocation(m_laser_shader->getProgram(), "u_visible");
-  glUniform1f(u_time, m_laser_time);
-  glUniform1f(u_velocity, LaserParams::laserSpeed);
-  glUniform1i(u_visible, is_visible);
-
-  GLuint a_position = (GLuint) glGetAttribLocation(m_laser_shader->getProgram(), "a_position");
-  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_laser_shader->getProgram(), "a_texCoord");
-
-  GLfloat* laser_vertices = new GLfloat[16];
-  util::setRectangleVertices(
-      laser_vertices,
-      LaserParams::laserWidth,
-      LaserParams::laserHeight * m_aspect,
-      x - LaserParams::laserHalfWidth,
-      y - LaserParams::laserHalfHeight,
-      1, 1);
-
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &laser_vertices[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
-
-  m_resources->getTexture("ef_laser.png")->apply();
-  GLint sampler = glGetUniformLocation(m_laser_shader->getProgram(), "s_texture");
-  glUniform1i(sampler, 0);
-
-  glEnableVertexAttribArray(a_position);
-  glEnableVertexAttribArray(a_texCoord);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  delete [] laser_vertices;
-
-  glDisableVertexAttribArray(a_position);
-  glDisableVertexAttribArray(a_texCoord);
+  m_renderer.drawLaser(x, y, m_laser_time, is_visible);
 }
 
 }  // namespace game
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <string>
+#include <utility>
 
 #include "AsyncContextHelper.h"
 
@@ -21,16 +23,17 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   /* Subscribe on events incoming from outside */
   ptr->acontext->surface_received_listener = ptr->surface_received_event.createListener(&game::AsyncContext::callback_setWindow, ptr->acontext);
   ptr->acontext->load_resources_listener = ptr->load_resources_event.createListener(&game::AsyncContext::callback_loadResources, ptr->acontext);
-  ptr->acontext->shift_gesture_listener = ptr->shift_gesture_event.createListener(&game::AsyncContext::callback_shiftGamepad, ptr->acontext);
+  // touch samples go directly into lock-free ring of render thread, see shiftGamepad()
   ptr->acontext->throw_ball_listener = ptr->throw_ball_event.createListener(&game::AsyncContext::callback_throwBall, ptr->acontext);
+  // GameProcessor receives level first, so that ball placed by AsyncContext never outruns it
+  ptr->processor->load_level_listener = ptr->load_level_event.createListener(&game::GameProcessor::callback_loadLevel, ptr->processor);
   ptr->acontext->load_level_listener = ptr->load_level_event.createListener(&game::AsyncContext::callback_loadLevel, ptr->acontext);
   ptr->acontext->move_ball_listener = ptr->processor->move_ball_event.createListener(&game::AsyncContext::callback_moveBall, ptr->acontext);
   ptr->acontext->lost_ball_listener = ptr->processor->lost_ball_event.createListener(&game::AsyncContext::callback_lostBall, ptr->acontext);
   ptr->acontext->stop_ball_listener = ptr->processor->stop_ball_event.createListener(&game::AsyncContext::callback_stopBall, ptr->acontext);
-  ptr->acontext->block_impact_listener = ptr->processor->block_impact_event.createListener(&game::AsyncContext::callback_blockImpact, ptr->acontext);
+  ptr->acontext->level_changed_listener = ptr->processor->level_changed_event.createListener(&game::AsyncContext::callback_levelChanged, ptr->acontext);
   ptr->acontext->level_finished_listener = ptr->processor->level_finished_event.createListener(&game::AsyncContext::callback_levelFinished, ptr->acontext);
-  ptr->acontext->explosion_listener = ptr->processor->explosion_event.createListener(&game::AsyncContext::callback_explosion, ptr->acontext);
-  ptr->acontext->prize_listener = ptr->processor->prize_event.createListener(&game::AsyncContext::callback_prizeReceived, ptr->acontext);
+  ptr->acontext->block_change_listener = ptr->processor->block_change_event.createListener(&game::AsyncContext::callback_blockChanged, ptr->acontext);
   ptr->acontext->prize_caught_listener = ptr->prize_processor->prize_caught_event.createListener(&game::AsyncContext::callback_prizeCaught, ptr->acontext);
   ptr->acontext->drop_ball_appearance_listener = ptr->processor->drop_ball_appearance_event.createListener(&game::AsyncContext::callback_dropBallAppearance, ptr->acontext);
   ptr->acontext->bite_width_changed_listener = ptr->processor->bite_width_changed_event.createListener(&game::AsyncContext::callback_biteWidthChanged, ptr->acontext);
@@ -39,7 +42,6 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   ptr->acontext->delay_request_listener = ptr->processor->delay_request_event.createListener(&game::AsyncContext::callback_delayRequested, ptr->acontext);
 
   ptr->processor->aspect_ratio_listener = ptr->acontext->aspect_ratio_event.createListener(&game::GameProcessor::callback_aspectMeasured, ptr->processor);
-  ptr->processor->load_level_listener = ptr->load_level_event.createListener(&game::GameProcessor::callback_loadLevel, ptr->processor);
   ptr->processor->throw_ball_listener = ptr->throw_ball_event.createListener(&game::GameProcessor::callback_throwBall, ptr->processor);
   ptr->processor->init_ball_position_listener = ptr->acontext->init_ball_position_event.createListener(&game::GameProcessor::callback_initBall, ptr->processor);
   ptr->processor->init_bite_listener = ptr->acontext->init_bite_event.createListener(&game::GameProcessor::callback_initBite, ptr->processor);
@@ -51,17 +53,18 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   ptr->prize_processor->aspect_ratio_listener = ptr->acontext->aspect_ratio_event.createListener(&game::PrizeProcessor::callback_aspectMeasured, ptr->prize_processor);
   ptr->prize_processor->bite_location_listener = ptr->acontext->bite_location_event.createListener(&game::PrizeProcessor::callback_biteMoved, ptr->prize_processor);
   ptr->prize_processor->init_bite_listener = ptr->acontext->init_bite_event.createListener(&game::PrizeProcessor::callback_initBite, ptr->prize_processor);
-  ptr->prize_processor->prize_listener = ptr->processor->prize_event.createListener(&game::PrizeProcessor::callback_prizeReceived, ptr->prize_processor);
+  ptr->prize_processor->block_change_listener = ptr->processor->block_change_event.createListener(&game::PrizeProcessor::callback_blockChanged, ptr->prize_processor);
   ptr->prize_processor->prize_location_listener = ptr->acontext->prize_location_event.createListener(&game::PrizeProcessor::callback_prizeLocated, ptr->prize_processor);
   ptr->prize_processor->prize_gone_listener = ptr->acontext->prize_gone_event.createListener(&game::PrizeProcessor::callback_prizeHasGone, ptr->prize_processor);
 
   ptr->sound_processor->load_resources_listener = ptr->load_resources_event.createListener(&native::sound::SoundProcessor::callback_loadResources, ptr->sound_processor);
+  ptr->sound_processor->load_level_listener = ptr->load_level_event.createListener(&native::sound::SoundProcessor::callback_loadLevel, ptr->sound_processor);
+  ptr->sound_processor->preload_level_listener = ptr->preload_level_event.createListener(&native::sound::SoundProcessor::callback_preloadLevel, ptr->sound_processor);
   ptr->sound_processor->lost_ball_listener = ptr->processor->lost_ball_event.createListener(&native::sound::SoundProcessor::callback_lostBall, ptr->sound_processor);
   ptr->sound_processor->bite_impact_listener = ptr->processor->bite_impact_event.createListener(&native::sound::SoundProcessor::callback_biteImpact, ptr->sound_processor);
-  ptr->sound_processor->block_impact_listener = ptr->processor->block_impact_event.createListener(&native::sound::SoundProcessor::callback_blockImpact, ptr->sound_processor);
+  ptr->sound_processor->block_change_listener = ptr->processor->block_change_event.createListener(&native::sound::SoundProcessor::callback_blockChanged, ptr->sound_processor);
   ptr->sound_processor->wall_impact_listener = ptr->processor->wall_impact_event.createListener(&native::sound::SoundProcessor::callback_wallImpact, ptr->sound_processor);
   ptr->sound_processor->level_finished_listener = ptr->processor->level_finished_event.createListener(&native::sound::SoundProcessor::callback_levelFinished, ptr->sound_processor);
-  ptr->sound_processor->explosion_listener = ptr->processor->explosion_event.createListener(&native::sound::SoundProcessor::callback_explosion, ptr->sound_processor);
   ptr->sound_processor->prize_caught_listener = ptr->prize_processor->prize_caught_event.createListener(&native::sound::SoundProcessor::callback_prizeCaught, ptr->sound_processor);
   ptr->sound_processor->laser_beam_visibility_listener = ptr->processor->laser_beam_visibility_event.createListener(&native::sound::SoundProcessor::callback_laserBeamVisibility, ptr->sound_processor);
   ptr->sound_processor->laser_block_impact_listener = ptr->processor->laser_block_impact_event.createListener(&native::sound::SoundProcessor::callback_laserBlockImpact, ptr->sound_processor);
@@ -116,6 +119,7 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setResource
   (JNIEnv *, jobject, jlong descriptor, jlong resources) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
   game::Resources* res_ptr = (game::Resources*) resources;
+  ptr->resources = res_ptr;
   ptr->acontext->setResourcesPtr(res_ptr);
   ptr->sound_processor->setResourcesPtr(res_ptr);
 }
@@ -129,9 +133,30 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadResourc
 /* User actions */
 // ----------------------------------------------------------------------------
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_shiftGamepad
-  (JNIEnv *jenv, jobject, jlong descriptor, jfloat position) {
+  (JNIEnv *jenv, jobject, jlong descriptor, jfloatArray positions, jlongArray times, jint count) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+
+  // whole motion event with its history crosses JNI at once, in chunks of stack buffer
+  constexpr jint chunk = 32;
+  jfloat chunk_positions[chunk];
+  jlong chunk_times[chunk];
+  game::TouchSample samples[chunk];
+  for (jint offset = 0; offset < count; offset += chunk) {
+    jint size = std::min(chunk, count - offset);
+    jenv->GetFloatArrayRegion(positions, offset, size, chunk_positions);
+    jenv->GetLongArrayRegion(times, offset, size, chunk_times);
+    for (jint i = 0; i < size; ++i) {
+      samples[i].position = chunk_positions[i];
+      samples[i].time = chunk_times[i];
+    }
+    ptr->acontext->callback_shiftGamepad(samples, size);
+  }
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBitePrediction
+  (JNIEnv *jenv, jobject, jlong descriptor, jboolean enabled) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
-  ptr->shift_gesture_event.notifyListeners(position);
+  ptr->acontext->setBitePrediction(enabled == JNI_TRUE);
 }
 
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_throwBall
@@ -142,10 +167,8 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_throwBall
 
 /* Tools */
 // ----------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
-  (JNIEnv *jenv, jobject, jlong descriptor, jobjectArray in_level_Java) {
-  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
-
+/// @brief Copies strings of level from Java array.
+static std::vector<std::string> getLevelStrings(JNIEnv* jenv, jobjectArray in_level_Java) {
   jsize length = jenv->GetArrayLength(in_level_Java);
   std::vector<std::string> array;
   array.reserve((size_t) length);
@@ -156,11 +179,57 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
     array.emplace_back(raw_str);  // copy chars
     jenv->ReleaseStringUTFChars(java_str, raw_str);
   }
+  return array;
+}
 
-  auto level = game::Level::fromStringArray(array, (size_t) length);
+/// @brief Starts preloading of level, its sounds are prefetched as soon as it's loaded.
+static void preload(AsyncContextHelper* ptr, int index, game::LevelPreloader::Source source) {
+  ptr->level_preloader->preload(index, source, [ptr](game::Level::Ptr level) {
+    ptr->preload_level_event.notifyListeners(level);
+  });
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
+  (JNIEnv *jenv, jobject, jlong descriptor, jobjectArray in_level_Java) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  auto array = getLevelStrings(jenv, in_level_Java);
+  auto level = game::Level::fromStringArray(array, array.size());
   ptr->load_level_event.notifyListeners(level);
 }
 
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevelFromPack
+  (JNIEnv *jenv, jobject, jlong descriptor, jint index) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  // preloaded level comes with geometry built, either from pack or from strings
+  auto level = ptr->level_preloader->takeLevel(index);
+  if (level == nullptr && ptr->resources != nullptr) {
+    level = ptr->resources->loadLevel(index);
+  }
+  if (level == nullptr) {
+    return JNI_FALSE;  // no level pack, level is passed as strings then
+  }
+  ptr->load_level_event.notifyListeners(level);
+  return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_preloadLevel
+  (JNIEnv *jenv, jobject, jlong descriptor, jint index, jobjectArray in_level_Java) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  auto array = getLevelStrings(jenv, in_level_Java);
+  preload(ptr, index, [array]() { return game::Level::fromStringArray(array, array.size()); });
+}
+
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_preloadLevelFromPack
+  (JNIEnv *jenv, jobject, jlong descriptor, jint index) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  game::Resources* resources = ptr->resources;
+  if (resources == nullptr || !resources->hasLevelPack()) {
+    return JNI_FALSE;
+  }
+  preload(ptr, index, [resources, index]() { return resources->loadLevel(index); });
+  return JNI_TRUE;
+}
+
 JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
   (JNIEnv *jenv, jobject, jlong descriptor) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
@@ -185,6 +254,143 @@ JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_sav
   return out_level_Java;
 }
 
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveState
+  (JNIEnv *jenv, jobject, jlong descriptor, jboolean delta) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+
+  std::vector<uint8_t> payload;
+  payload.reserve(ptr->snapshot_base.size());
+  game::SnapshotWriter writer(&payload);
+  if (!ptr->processor->saveState(&writer)) {
+    return nullptr;
+  }
+  ptr->prize_processor->saveState(&writer);
+
+  std::vector<uint8_t> blob;
+  if (delta && !ptr->snapshot_base.empty()) {
+    game::Snapshot::packDelta(ptr->snapshot_base, payload, &blob);
+  } else {
+    game::Snapshot::pack(payload, &blob);
+  }
+  ptr->snapshot_base.swap(payload);
+
+  jbyteArray out_snapshot_Java = jenv->NewByteArray((jsize) blob.size());
+  if (out_snapshot_Java != nullptr) {
+    jenv->SetByteArrayRegion(out_snapshot_Java, 0, (jsize) blob.size(), reinterpret_cast<const jbyte*>(blob.data()));
+  }
+  return out_snapshot_Java;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_restoreState
+  (JNIEnv *jenv, jobject, jlong descriptor, jbyteArray snapshot) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+
+  std::vector<uint8_t> payload;
+  {
+    jsize length = jenv->GetArrayLength(snapshot);
+    void* blob = jenv->GetPrimitiveArrayCritical(snapshot, nullptr);
+    if (blob == nullptr) {
+      return JNI_FALSE;
+    }
+    bool unpacked = game::Snapshot::unpack(reinterpret_cast<const uint8_t*>(blob), (size_t) length, ptr->snapshot_base, &payload);
+    jenv->ReleasePrimitiveArrayCritical(snapshot, blob, JNI_ABORT);
+    if (!unpacked) {
+      return JNI_FALSE;
+    }
+  }
+
+  game::Level::Ptr level = nullptr;
+  game::SnapshotReader game_section;
+  std::vector<game::PrizePackage> prizes;
+  game::SnapshotReader reader(payload.data(), payload.size());
+  game::SnapshotSection section;
+  game::SnapshotReader body;
+  while (reader.nextSection(&section, &body)) {
+    switch (section) {
+      case game::SnapshotSection::LEVEL:
+        level = game::Level::readState(&body);
+        break;
+      case game::SnapshotSection::GAME:
+        game_section = body;
+        break;
+      case game::SnapshotSection::PRIZES:
+        if (!game::PrizeProcessor::readState(&body, &prizes)) {
+          prizes.clear();  // not critical, game goes on without them
+        }
+        break;
+      default:
+        break;  // section of newer version
+    }
+  }
+  if (!reader.isValid() || level == nullptr || !game_section.isValid()) {
+    ERR("Snapshot has no valid level or game section");
+    return JNI_FALSE;
+  }
+
+  // state is applied once GameProcessor has got level and ball has been placed
+  if (!ptr->processor->restoreState(&game_section, std::move(prizes))) {
+    return JNI_FALSE;
+  }
+  ptr->load_level_event.notifyListeners(level);
+  ptr->snapshot_base.swap(payload);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jobject JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getUiState
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  return jenv->NewDirectByteBuffer(ptr->ui_state.getData(), (jlong) ptr->ui_state.getSize());
+}
+
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_startRecording
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  return ptr->processor->startRecording() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_stopRecording
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+
+  std::vector<uint8_t> recording;
+  if (!ptr->processor->stopRecording(&recording)) {
+    return nullptr;
+  }
+  jbyteArray out_recording_Java = jenv->NewByteArray((jsize) recording.size());
+  if (out_recording_Java != nullptr) {
+    jenv->SetByteArrayRegion(out_recording_Java, 0, (jsize) recording.size(), reinterpret_cast<const jbyte*>(recording.data()));
+  }
+  return out_recording_Java;
+}
+
+JNIEXPORT jbyteArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_nativeReplayState
+  (JNIEnv *jenv, jclass, jbyteArray recording, jint tick) {
+  std::vector<uint8_t> data(jenv->GetArrayLength(recording));
+  if (!data.empty()) {
+    jenv->GetByteArrayRegion(recording, 0, (jsize) data.size(), reinterpret_cast<jbyte*>(&data[0]));
+  }
+  game::InputReplay replay(data.data(), data.size());
+  if (!replay.isValid() || tick < 0) {
+    return nullptr;
+  }
+
+  // standalone processor is neither launched nor subscribed, resimulation is headless
+  game::GameProcessor replayer(nullptr, replay.getFrameDelay());
+  std::vector<uint8_t> payload;
+  game::SnapshotWriter writer(&payload);
+  if (!replayer.replay(&replay, static_cast<uint32_t>(tick), &writer)) {
+    return nullptr;
+  }
+
+  std::vector<uint8_t> blob;
+  game::Snapshot::pack(payload, &blob);
+  jbyteArray out_snapshot_Java = jenv->NewByteArray((jsize) blob.size());
+  if (out_snapshot_Java != nullptr) {
+    jenv->SetByteArrayRegion(out_snapshot_Java, 0, (jsize) blob.size(), reinterpret_cast<const jbyte*>(blob.data()));
+  }
+  return out_snapshot_Java;
+}
+
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBonusPrizes
   (JNIEnv *, jobject, jlong descriptor, jint prize_type) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
@@ -206,7 +412,9 @@ JNIEXPORT jint JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getScore
 // ----------------------------------------------------------------------------
 AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object, jint fdn)
   : jenv(jenv)
-  , window(nullptr) {
+  , window(nullptr)
+  , resources(nullptr)
+  , level_preloader(new game::LevelPreloader()) {
 
   DBG("enter AsyncContextHelper ctor");
   acontext = new game::AsyncContext(jvm, fdn);
@@ -221,27 +429,24 @@ AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object, jint fdn)
   jclass class_id = jenv->FindClass("com/orcchg/arkanoid/surface/AsyncContext");
   fireJavaEvent_lostBall_id = jenv->GetMethodID(class_id, "fireJavaEvent_lostBall", "(I)V");
   fireJavaEvent_levelFinished_id = jenv->GetMethodID(class_id, "fireJavaEvent_levelFinished", "()V");
-  fireJavaEvent_scoreUpdated_id = jenv->GetMethodID(class_id, "fireJavaEvent_onScoreUpdated", "(I)V");
-  fireJavaEvent_angleChanged_id = jenv->GetMethodID(class_id, "fireJavaEvent_angleChanged", "(I)V");
-  fireJavaEvent_cardinalityChanged_id = jenv->GetMethodID(class_id, "fireJavaEvent_cardinalityChanged", "(I)V");
-  fireJavaEvent_prizeCatch_id = jenv->GetMethodID(class_id, "fireJavaEvent_prizeCatch", "(I)V");
   fireJavaEvent_errorTextureLoad_id = jenv->GetMethodID(class_id, "fireJavaEvent_errorTextureLoad", "()V");
+  fireJavaEvent_textureLoadProgress_id = jenv->GetMethodID(class_id, "fireJavaEvent_textureLoadProgress", "(II)V");
   fireJavaEvent_errorSoundLoad_id = jenv->GetMethodID(class_id, "fireJavaEvent_errorSoundLoad", "()V");
   fireJavaEvent_debugMessage_id = jenv->GetMethodID(class_id, "fireJavaEvent_debugMessage", "(Ljava/lang/String;)V");
 
   acontext->setMasterObject(global_object);
   acontext->setOnErrorTextureLoadMethodID(fireJavaEvent_errorTextureLoad_id);
+  acontext->setOnTextureLoadProgressMethodID(fireJavaEvent_textureLoadProgress_id);
+  acontext->setLevelPreloader(level_preloader);
 
   processor->setMasterObject(global_object);
   processor->setOnLostBallMethodID(fireJavaEvent_lostBall_id);
   processor->setOnLevelFinishedMethodID(fireJavaEvent_levelFinished_id);
-  processor->setOnScoreUpdatedMethodID(fireJavaEvent_scoreUpdated_id);
-  processor->setOnAngleChangedMethodID(fireJavaEvent_angleChanged_id);
-  processor->setOnCardinalityChangedMethodID(fireJavaEvent_cardinalityChanged_id);
   processor->setOnDebugMessageMethodID(fireJavaEvent_debugMessage_id);
+  processor->setUiState(&ui_state);
 
   prize_processor->setMasterObject(global_object);
-  prize_processor->setOnPrizeCatchMethodID(fireJavaEvent_prizeCatch_id);
+  prize_processor->setUiState(&ui_state);
 
   sound_processor->setMasterObject(global_object);
   sound_processor->setOnErrorSoundLoadMethodID(fireJavaEvent_errorSoundLoad_id);
@@ -250,6 +455,7 @@ AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object, jint fdn)
 
 AsyncContextHelper::~AsyncContextHelper() {
   DBG("enter AsyncContextHelper ~dtor");
+  delete level_preloader; level_preloader = nullptr;  // joins worker, which notifies processors
   delete acontext; acontext = nullptr;
   delete processor; processor = nullptr;
   delete prize_processor; prize_processor = nullptr;
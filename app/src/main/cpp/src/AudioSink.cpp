@@ -0,0 +1,122 @@
+#include <chrono>
+
+#include "AudioSink.h"
+#include "logger.h"
+#include "RiffReader.h"
+
+namespace native {
+namespace sound {
+
+/* NullSink */
+// ----------------------------------------------------------------------------
+NullSink::NullSink(bool realtime)
+  : m_realtime(realtime)
+  , m_is_running(false)
+  , m_rendered_frames(0)
+  , m_buffer(bufferFrames) {
+}
+
+NullSink::~NullSink() {
+  NullSink::stop();
+}
+
+bool NullSink::start(RenderCallback render) {
+  if (m_is_running.load() || render == nullptr) {
+    return false;
+  }
+  m_render = render;
+  m_rendered_frames.store(0);
+  m_is_running.store(true);
+  m_thread = std::thread(&NullSink::loop, this);
+  return true;
+}
+
+void NullSink::stop() {
+  m_is_running.store(false);
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void NullSink::consume(const int16_t* /* buffer */, size_t /* frames */) {
+  // dropped
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void NullSink::loop() {
+  auto period = std::chrono::microseconds(bufferFrames * 1000000 / sampleRate);
+  auto deadline = std::chrono::steady_clock::now();
+  while (m_is_running.load()) {
+    m_render(&m_buffer[0], bufferFrames);
+    consume(&m_buffer[0], bufferFrames);
+    m_rendered_frames.fetch_add(bufferFrames);
+    if (m_realtime) {
+      deadline += period;
+      std::this_thread::sleep_until(deadline);
+    }
+  }
+}
+
+/* WavFileSink */
+// ----------------------------------------------------------------------------
+WavFileSink::WavFileSink(const char* filepath, bool realtime)
+  : NullSink(realtime)
+  , m_filepath(filepath)
+  , m_file(nullptr)
+  , m_data_size(0) {
+}
+
+WavFileSink::~WavFileSink() {
+  WavFileSink::stop();
+}
+
+bool WavFileSink::start(RenderCallback render) {
+  if (m_file != nullptr) {
+    return false;
+  }
+  m_file = std::fopen(m_filepath.c_str(), "wb");
+  if (m_file == nullptr) {
+    ERR("Failed to create %s", m_filepath.c_str());
+    return false;
+  }
+  // header is completed once the size of samples is known
+  uint8_t header[WAV_HEADER_SIZE] {};
+  m_data_size = 0;
+  if (std::fwrite(header, 1, WAV_HEADER_SIZE, m_file) != WAV_HEADER_SIZE || !NullSink::start(render)) {
+    std::fclose(m_file);
+    m_file = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void WavFileSink::stop() {
+  NullSink::stop();
+  if (m_file == nullptr) {
+    return;
+  }
+  PCMFormat format;
+  format.audio_format = WAVE_FORMAT_PCM;
+  format.channels = 1;
+  format.sample_rate = sampleRate;
+  format.block_align = sizeof(int16_t);
+  format.bits_per_sample = 16;
+  uint8_t header[WAV_HEADER_SIZE];
+  writeWAVHeader(format, m_data_size, header);
+  std::fseek(m_file, 0, SEEK_SET);
+  if (std::fwrite(header, 1, WAV_HEADER_SIZE, m_file) != WAV_HEADER_SIZE) {
+    ERR("Failed to write header of %s", m_filepath.c_str());
+  }
+  std::fclose(m_file);
+  m_file = nullptr;
+}
+
+void WavFileSink::consume(const int16_t* buffer, size_t frames) {
+  // samples are written as is, little-endian host is assumed
+  size_t written = std::fwrite(buffer, sizeof(int16_t), frames, m_file);
+  m_data_size += static_cast<uint32_t>(written * sizeof(int16_t));
+}
+
+}  // namespace sound
+}  // namespace native
@@ -1,622 +1,184 @@
 #include <chrono>
 #include "Block.h"
+#include "Snapshot.h"
 
 namespace game {
 
+/* Properties table */
+// ----------------------------------------------------------------------------
+enum BlockFlag : int {
+  ORDINARY = 1,  //!< Could be produced by BlockGenerator.
+  COUNTED = 2,   //!< Affects cardinality of level.
+  VISIBLE = 4    //!< Drawn and collides with ball.
+};
+
+/// @brief Single definition of all properties of blocks, one row per block
+/// in order of Block values: block, char in level file, cardinality cost,
+/// score, color, edge color, texture, impact sound and flags.
+/// @note Lowercase letters in level file are read as their uppercase blocks.
+#define BLOCK_TABLE(X) \
+  X(NONE,             ' ', 0,   0, TRANSPARENT,  TRANSPARENT,       nullptr,               NONE,     0)                          \
+  X(DESTROY,          'D', 0,   0, DESTROY,      DESTROY_EDGE,      "bl_destroy.png",      DESTROY,  VISIBLE)                    \
+  X(ELECTRO,          'E', 1,   9, ELECTRO,      ELECTRO_EDGE,      "bl_electro.png",      BOOM,     VISIBLE | COUNTED)          \
+  X(HYPER,            'H', 1,  11, HYPER,        HYPER_EDGE,        "bl_hyper.png",        HYPER,    VISIBLE | COUNTED)          \
+  X(KNOCK_VERTICAL,   'K', 1,  15, KNOCK,        KNOCK_EDGE,        "bl_knock.png",        EXPLODE,  VISIBLE | COUNTED)          \
+  X(KNOCK_HORIZONTAL, '#', 1,  15, KNOCK,        KNOCK_EDGE,        "bl_knock.png",        EXPLODE,  VISIBLE | COUNTED)          \
+  X(MAGIC,            'M', 1,  10, MAGIC,        MAGIC_EDGE,        "bl_magic.png",        CHANGE,   VISIBLE | COUNTED)          \
+  X(NETWORK,          'N', 1,  20, NETWORK,      NETWORK_EDGE,      "bl_network.png",      HYPER,    VISIBLE | COUNTED)          \
+  X(ORIGIN,           'O', 1,   2, ORIGIN,       ORIGIN_EDGE,       "bl_origin.png",       HYPER,    VISIBLE | COUNTED)          \
+  X(QUICK,            'Q', 3,  79, QUICK,        QUICK_EDGE,        "bl_quick.png",        PREQUICK, VISIBLE | COUNTED)          \
+  X(ULTRA,            'U', 5, 585, ULTRA,        ULTRA_EDGE,        "bl_ultra.png",        ULTRA,    VISIBLE | COUNTED)          \
+  X(YOGURT,           'Y', 1,   9, YOGURT,       YOGURT_EDGE,       "bl_yogurt.png",       WATER,    VISIBLE | COUNTED)          \
+  X(ZYGOTE,           'Z', 2,  14, ZYGOTE,       ZYGOTE_EDGE,       "bl_zygote.png",       ZYGOTE,   VISIBLE | COUNTED)          \
+  X(TITAN,            'T', 0,   0, TITAN,        TITAN_EDGE,        "bl_titan.png",        INVUL,    VISIBLE)                    \
+  X(INVUL,            'V', 0,   0, INVUL,        INVUL_EDGE,        "bl_invul.png",        INVUL,    VISIBLE)                    \
+  X(EXTRA,            'X', 0,   0, EXTRA,        EXTRA_EDGE,        "bl_extra.png",        INVUL,    VISIBLE)                    \
+  X(MIDAS,            '$', 0,   0, MIDAS,        MIDAS_EDGE,        "bl_midas.png",        MIDAS,    VISIBLE)                    \
+  X(GLASS_1,          '[', 1,   2, GLASS,        GLASS_EDGE,        "bl_glass.png",        GLASS,    VISIBLE | COUNTED)          \
+  X(ARTIFICAL,        ']', 0,   0, ARTIFICAL,    ARTIFICAL_EDGE,    nullptr,               MAGIC,    VISIBLE)                    \
+  X(QUICK_2,          '{', 2,  51, QUICK,        QUICK_EDGE,        "bl_quick.png",        PREQUICK, VISIBLE | COUNTED)          \
+  X(QUICK_1,          '}', 1,  24, QUICK,        QUICK_EDGE,        "bl_quick.png",        QUICK,    VISIBLE | COUNTED)          \
+  X(ULTRA_4,          '%', 4, 458, ULTRA,        ULTRA_EDGE,        "bl_ultra.png",        ULTRA,    VISIBLE | COUNTED)          \
+  X(ULTRA_3,          '^', 3, 333, ULTRA,        ULTRA_EDGE,        "bl_ultra.png",        ULTRA,    VISIBLE | COUNTED)          \
+  X(ULTRA_2,          '&', 2, 211, ULTRA,        ULTRA_EDGE,        "bl_ultra.png",        ULTRA,    VISIBLE | COUNTED)          \
+  X(ULTRA_1,          '*', 1, 100, ULTRA,        ULTRA_EDGE,        "bl_ultra.png",        ULTRA,    VISIBLE | COUNTED)          \
+  X(YOGURT_1,         '(', 1,   2, YOGURT,       YOGURT_EDGE,       "bl_yogurt.png",       WATER,    VISIBLE | COUNTED)          \
+  X(ZYGOTE_1,         ')', 1,  11, ZYGOTE,       ZYGOTE_EDGE,       "bl_zygote.png",       ZYGOTE,   VISIBLE | COUNTED)          \
+  X(ALUMINIUM,        'A', 1,  25, ALUMINIUM,    ALUMINIUM_EDGE,    "bl_aluminium.png",    BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(BRICK,            'B', 2,  24, BRICK,        BRICK_EDGE,        "bl_brick.png",        BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(CLAY,             'C', 1,  12, CLAY,         CLAY_EDGE,         "bl_clay.png",         BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(FOG,              'F', 1,   1, FOG,          FOG_EDGE,          "bl_fog.png",          FOG,      VISIBLE | COUNTED | ORDINARY) \
+  X(GLASS,            'G', 2,   3, GLASS,        GLASS_EDGE,        "bl_glass.png",        GLASS,    VISIBLE | COUNTED | ORDINARY) \
+  X(IRON,             'I', 3,  62, IRON,         IRON_EDGE,         "bl_iron.png",         IRON,     VISIBLE | COUNTED | ORDINARY) \
+  X(JELLY,            'J', 1,  23, JELLY,        JELLY_EDGE,        "bl_jelly.png",        BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(STEEL,            'L', 3, 101, STEEL,        STEEL_EDGE,        "bl_steel.png",        IRON,     VISIBLE | COUNTED | ORDINARY) \
+  X(PLUMBUM,          'P', 4, 148, PLUMBUM,      PLUMBUM_EDGE,      "bl_plumbum.png",      IRON,     VISIBLE | COUNTED | ORDINARY) \
+  X(ROLLING,          'R', 1,  28, ROLLING,      ROLLING_EDGE,      "bl_rolling.png",      BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(SIMPLE,           'S', 1,   4, SIMPLE,       SIMPLE_EDGE,       "bl_simple.png",       BLOCK,    VISIBLE | COUNTED | ORDINARY) \
+  X(WATER,            'W', 1,   9, WATER,        WATER_EDGE,        "bl_water.png",        WATER,    VISIBLE | COUNTED | ORDINARY) \
+  X(ZYGOTE_SPAWN,     '@', 1,   1, ZYGOTE_SPAWN, ZYGOTE_SPAWN_EDGE, "bl_zygote_spawn.png", ZYGOTE,   VISIBLE | COUNTED | ORDINARY)
+
+struct BlockProperties {
+  Block block;
+  char symbol;
+  int cardinality_cost;
+  int score;
+  const GLfloat* color;
+  const GLfloat* edge_color;
+  const char* texture;  //!< nullptr if block is not textured
+  SoundGroup sound;
+  int flags;  //!< See BlockFlag.
+};
+
+#define BLOCK_PROPERTIES(block, symbol, cost, score, color, edge_color, texture, sound, flags) \
+  { Block::block, symbol, cost, score, util::color, util::edge_color, texture, SoundGroup::sound, flags },
+
+constexpr static BlockProperties blockProperties[] = { BLOCK_TABLE(BLOCK_PROPERTIES) };
+
+#undef BLOCK_PROPERTIES
+
+/// @brief Checks that rows of table follow Block values without gaps.
+constexpr static bool isTableOrdered(int i = 0) {
+  return i == BlockUtils::totalBlocks ||
+      (static_cast<int>(blockProperties[i].block) == i && isTableOrdered(i + 1));
+}
+
+/// @brief Checks that ORDINARY flag is set on the contiguous range used by BlockGenerator.
+constexpr static bool isOrdinaryRange(int i = 0) {
+  return i == BlockUtils::totalBlocks ||
+      (((blockProperties[i].flags & ORDINARY) != 0) ==
+          (i >= BlockUtils::ordinaryBlockOffset && i < BlockUtils::ordinaryBlockOffset + BlockUtils::totalOrdinaryBlocks) &&
+       isOrdinaryRange(i + 1));
+}
+
+static_assert(sizeof(blockProperties) / sizeof(blockProperties[0]) == BlockUtils::totalBlocks,
+              "Table of block properties must have row for every block");
+static_assert(isTableOrdered(), "Rows of block properties must follow order of Block values");
+static_assert(isOrdinaryRange(), "Ordinary blocks must match BlockUtils::ordinaryBlockOffset");
+
+/* Char to block table */
+// ----------------------------------------------------------------------------
+constexpr static int toUpper(int ch) {
+  return ch >= 'a' && ch <= 'z' ? ch - 'a' + 'A' : ch;
+}
+
+/// @brief Linear search, evaluated only at compile time to fill charToBlockTable.
+constexpr static Block findBlock(int ch, int i = 1) {
+  return i == BlockUtils::totalBlocks ? Block::NONE :
+      (blockProperties[i].symbol == toUpper(ch) ? blockProperties[i].block : findBlock(ch, i + 1));
+}
+
+#define CHAR_1(ch)   findBlock(ch),
+#define CHAR_4(ch)   CHAR_1(ch)   CHAR_1(ch + 1)   CHAR_1(ch + 2)   CHAR_1(ch + 3)
+#define CHAR_16(ch)  CHAR_4(ch)   CHAR_4(ch + 4)   CHAR_4(ch + 8)   CHAR_4(ch + 12)
+#define CHAR_64(ch)  CHAR_16(ch)  CHAR_16(ch + 16) CHAR_16(ch + 32) CHAR_16(ch + 48)
+#define CHAR_256(ch) CHAR_64(ch)  CHAR_64(ch + 64) CHAR_64(ch + 128) CHAR_64(ch + 192)
+
+constexpr static Block charToBlockTable[256] = { CHAR_256(0) };
+
+#undef CHAR_256
+#undef CHAR_64
+#undef CHAR_16
+#undef CHAR_4
+#undef CHAR_1
+
+/// @brief Checks that every block is read back from its own char, so chars are unique.
+constexpr static bool isCharsBijective(int i = 0) {
+  return i == BlockUtils::totalBlocks ||
+      (charToBlockTable[static_cast<unsigned char>(blockProperties[i].symbol)] == blockProperties[i].block &&
+       isCharsBijective(i + 1));
+}
+
+static_assert(isCharsBijective(), "Chars of blocks must be unique");
+
+/* Lookups */
+// ----------------------------------------------------------------------------
+static inline const BlockProperties& properties(Block block) {
+  return blockProperties[static_cast<int>(block)];
+}
+
 Block BlockUtils::charToBlock(char ch) {
-  switch (ch) {
-    case 'a':
-    case 'A':
-      return Block::ALUMINIUM;
-    case 'b':
-    case 'B':
-      return Block::BRICK;
-    case 'c':
-    case 'C':
-      return Block::CLAY;
-    case 'd':
-    case 'D':
-      return Block::DESTROY;
-    case 'e':
-    case 'E':
-      return Block::ELECTRO;
-    case 'f':
-    case 'F':
-      return Block::FOG;
-    case 'g':
-    case 'G':
-      return Block::GLASS;
-    case 'h':
-    case 'H':
-      return Block::HYPER;
-    case 'i':
-    case 'I':
-      return Block::IRON;
-    case 'j':
-    case 'J':
-      return Block::JELLY;
-    case 'k':
-    case 'K':
-      return Block::KNOCK_VERTICAL;
-    case '#':
-      return Block::KNOCK_HORIZONTAL;
-    case 'l':
-    case 'L':
-      return Block::STEEL;
-    case 'm':
-    case 'M':
-      return Block::MAGIC;
-    case '$':
-      return Block::MIDAS;
-    case 'n':
-    case 'N':
-      return Block::NETWORK;
-    case 'o':
-    case 'O':
-      return Block::ORIGIN;
-    case 'p':
-    case 'P':
-      return Block::PLUMBUM;
-    case 'q':
-    case 'Q':
-      return Block::QUICK;
-    case 'r':
-    case 'R':
-      return Block::ROLLING;
-    case 's':
-    case 'S':
-      return Block::SIMPLE;
-    case 't':
-    case 'T':
-      return Block::TITAN;
-    case 'u':
-    case 'U':
-      return Block::ULTRA;
-    case 'v':
-    case 'V':
-      return Block::INVUL;
-    case 'w':
-    case 'W':
-      return Block::WATER;
-    case 'x':
-    case 'X':
-      return Block::EXTRA;
-    case 'y':
-    case 'Y':
-      return Block::YOGURT;
-    case 'z':
-    case 'Z':
-      return Block::ZYGOTE;
-    case '@':
-      return Block::ZYGOTE_SPAWN;
-
-    // ------------------------------------------
-    case '[':
-      return Block::GLASS_1;
-    case ']':
-      return Block::ARTIFICAL;
-    case '{':
-      return Block::QUICK_2;
-    case '}':
-      return Block::QUICK_1;
-    case '%':
-      return Block::ULTRA_4;
-    case '^':
-      return Block::ULTRA_3;
-    case '&':
-      return Block::ULTRA_2;
-    case '*':
-      return Block::ULTRA_1;
-    case '(':
-      return Block::YOGURT_1;
-    case ')':
-      return Block::ZYGOTE_1;
-
-    case ' ':
-    default:
-      return Block::NONE;
-  }
+  return charToBlockTable[static_cast<unsigned char>(ch)];
 }
 
 char BlockUtils::blockToChar(Block block) {
-  switch (block) {
-    case Block::ALUMINIUM:
-      return 'A';
-    case Block::BRICK:
-      return 'B';
-    case Block::CLAY:
-      return 'C';
-    case Block::DESTROY:
-      return 'D';
-    case Block::ELECTRO:
-      return 'E';
-    case Block::FOG:
-      return 'F';
-    case Block::GLASS:
-      return 'G';
-    case Block::HYPER:
-      return 'H';
-    case Block::IRON:
-      return 'I';
-    case Block::JELLY:
-      return 'J';
-    case Block::KNOCK_VERTICAL:
-      return 'K';
-    case Block::KNOCK_HORIZONTAL:
-      return '#';
-    case Block::STEEL:
-      return 'L';
-    case Block::MAGIC:
-      return 'M';
-    case Block::MIDAS:
-      return '$';
-    case Block::NETWORK:
-      return 'N';
-    case Block::ORIGIN:
-      return 'O';
-    case Block::PLUMBUM:
-      return 'P';
-    case Block::QUICK:
-      return 'Q';
-    case Block::ROLLING:
-      return 'R';
-    case Block::SIMPLE:
-      return 'S';
-    case Block::TITAN:
-      return 'T';
-    case Block::ULTRA:
-      return 'U';
-    case Block::INVUL:
-      return 'V';
-    case Block::WATER:
-      return 'W';
-    case Block::EXTRA:
-      return 'X';
-    case Block::YOGURT:
-      return 'Y';
-    case Block::ZYGOTE:
-      return 'Z';
-    case Block::ZYGOTE_SPAWN:
-      return '@';
-
-    // ------------------------------------------
-    case Block::GLASS_1:
-      return '[';
-    case Block::ARTIFICAL:
-      return ']';
-    case Block::QUICK_2:
-      return '{';
-    case Block::QUICK_1:
-      return '}';
-    case Block::ULTRA_4:
-      return '%';
-    case Block::ULTRA_3:
-      return '^';
-    case Block::ULTRA_2:
-      return '&';
-    case Block::ULTRA_1:
-      return '*';
-    case Block::YOGURT_1:
-      return '(';
-    case Block::ZYGOTE_1:
-      return ')';
-
-    case Block::NONE:
-    default:
-      return ' ';
-  }
+  return properties(block).symbol;
 }
 
 bool BlockUtils::isOrdinaryBlock(Block block) {
-  return block == Block::ALUMINIUM ||
-      block == Block::BRICK ||
-      block == Block::CLAY ||
-      block == Block::FOG ||
-      block == Block::GLASS ||
-      block == Block::IRON ||
-      block == Block::JELLY ||
-      block == Block::STEEL ||
-      block == Block::PLUMBUM ||
-      block == Block::ROLLING ||
-      block == Block::SIMPLE ||
-      block == Block::WATER ||
-      block == Block::ZYGOTE_SPAWN;
+  return (properties(block).flags & ORDINARY) != 0;
 }
 
 int BlockUtils::getCardinalityCost(Block block) {
-  switch (block) {
-    case Block::ULTRA:
-      return 5;
-    case Block::PLUMBUM:
-    case Block::ULTRA_4:
-      return 4;
-    case Block::IRON:
-    case Block::STEEL:
-    case Block::QUICK:
-    case Block::ULTRA_3:
-      return 3;
-    case Block::BRICK:
-    case Block::GLASS:
-    case Block::ZYGOTE:
-    case Block::QUICK_2:
-    case Block::ULTRA_2:
-      return 2;
-    case Block::ALUMINIUM:
-    case Block::CLAY:
-    case Block::ELECTRO:
-    case Block::FOG:
-    case Block::GLASS_1:
-    case Block::HYPER:
-    case Block::JELLY:
-    case Block::KNOCK_VERTICAL:
-    case Block::KNOCK_HORIZONTAL:
-    case Block::MAGIC:
-    case Block::ORIGIN:
-    case Block::ROLLING:
-    case Block::SIMPLE:
-    case Block::WATER:
-    case Block::YOGURT:
-    case Block::YOGURT_1:
-    case Block::NETWORK:
-    case Block::QUICK_1:
-    case Block::ULTRA_1:
-    case Block::ZYGOTE_1:
-    case Block::ZYGOTE_SPAWN:
-      return 1;
-
-    default:
-    case Block::DESTROY:
-    case Block::MIDAS:
-    case Block::TITAN:
-    case Block::INVUL:
-    case Block::EXTRA:
-    case Block::NONE:
-    case Block::ARTIFICAL:
-      return 0;
-  }
+  return properties(block).cardinality_cost;
 }
 
 int BlockUtils::getBlockScore(Block block) {
-  int score = 0;
-  switch (block) {
-    case Block::ULTRA:     score += 127;
-    case Block::ULTRA_4:   score += 125;
-    case Block::ULTRA_3:   score += 122;
-    case Block::ULTRA_2:   score += 111;
-    case Block::ULTRA_1:   score += 100;
-      break;
-    case Block::PLUMBUM:   score += 47;
-    case Block::STEEL:     score += 39;
-    case Block::IRON:      score += 37;
-    case Block::ALUMINIUM: score += 25;
-      break;
-    case Block::QUICK:     score += 28;
-    case Block::QUICK_2:   score += 27;
-    case Block::QUICK_1:   score += 24;
-      break;
-    case Block::BRICK:     score += 24;
-      break;
-    case Block::ROLLING:   score += 5;
-    case Block::JELLY:     score += 11;
-    case Block::CLAY:      score += 12;
-      break;
-    case Block::WATER:     score += 5;
-    case Block::SIMPLE:    score += 4;
-      break;
-    case Block::KNOCK_VERTICAL:
-    case Block::KNOCK_HORIZONTAL:
-      score += 15;
-      break;
-    case Block::ZYGOTE:    score += 3;
-    case Block::ZYGOTE_1:  score += 2;
-    case Block::YOGURT:    score += 7;
-    case Block::YOGURT_1:  score += 1;
-    case Block::ZYGOTE_SPAWN: score += 1;
-      break;
-    case Block::GLASS:     score += 1;
-    case Block::GLASS_1:   score += 1;
-    case Block::FOG:       score += 1;
-      break;
-    case Block::NETWORK:   score += 11;
-    case Block::ELECTRO:   score += 9;
-      break;
-    case Block::HYPER:     score += 1;
-    case Block::MAGIC:     score += 8;
-    case Block::ORIGIN:    score += 2;
-      break;
-
-    default:
-    case Block::DESTROY:
-    case Block::MIDAS:
-    case Block::TITAN:
-    case Block::INVUL:
-    case Block::EXTRA:
-    case Block::NONE:
-    case Block::ARTIFICAL:
-      break;
-  }
-  return score;
+  return properties(block).score;
 }
 
 util::BGRA<GLfloat> BlockUtils::getBlockColor(Block block) {
-  util::BGRA<GLfloat> bgra;
-  switch (block) {
-    default:
-    case Block::NONE:
-      bgra = util::BGRA<GLfloat>(util::TRANSPARENT);
-      break;
-    case Block::ALUMINIUM:
-      bgra = util::BGRA<GLfloat>(util::ALUMINIUM);
-      break;
-    case Block::ARTIFICAL:
-      bgra = util::BGRA<GLfloat>(util::ARTIFICAL);
-      break;
-    case Block::BRICK:
-      bgra = util::BGRA<GLfloat>(util::BRICK);
-      break;
-    case Block::CLAY:
-      bgra = util::BGRA<GLfloat>(util::CLAY);
-      break;
-    case Block::DESTROY:
-      bgra = util::BGRA<GLfloat>(util::DESTROY);
-      break;
-    case Block::ELECTRO:
-      bgra = util::BGRA<GLfloat>(util::ELECTRO);
-      break;
-    case Block::FOG:
-      bgra = util::BGRA<GLfloat>(util::FOG);
-      break;
-    case Block::GLASS:
-    case Block::GLASS_1:
-      bgra = util::BGRA<GLfloat>(util::GLASS);
-      break;
-    case Block::HYPER:
-      bgra = util::BGRA<GLfloat>(util::HYPER);
-      break;
-    case Block::IRON:
-      bgra = util::BGRA<GLfloat>(util::IRON);
-      break;
-    case Block::JELLY:
-      bgra = util::BGRA<GLfloat>(util::JELLY);
-      break;
-    case Block::KNOCK_VERTICAL:
-    case Block::KNOCK_HORIZONTAL:
-      bgra = util::BGRA<GLfloat>(util::KNOCK);
-      break;
-    case Block::STEEL:
-      bgra = util::BGRA<GLfloat>(util::STEEL);
-      break;
-    case Block::MAGIC:
-      bgra = util::BGRA<GLfloat>(util::MAGIC);
-      break;
-    case Block::MIDAS:
-      bgra = util::BGRA<GLfloat>(util::MIDAS);
-      break;
-    case Block::NETWORK:
-      bgra = util::BGRA<GLfloat>(util::NETWORK);
-      break;
-    case Block::ORIGIN:
-      bgra = util::BGRA<GLfloat>(util::ORIGIN);
-      break;
-    case Block::PLUMBUM:
-      bgra = util::BGRA<GLfloat>(util::PLUMBUM);
-      break;
-    case Block::QUICK:
-    case Block::QUICK_1:
-    case Block::QUICK_2:
-      bgra = util::BGRA<GLfloat>(util::QUICK);
-      break;
-    case Block::ROLLING:
-      bgra = util::BGRA<GLfloat>(util::ROLLING);
-      break;
-    case Block::SIMPLE:
-      bgra = util::BGRA<GLfloat>(util::SIMPLE);
-      break;
-    case Block::TITAN:
-      bgra = util::BGRA<GLfloat>(util::TITAN);
-      break;
-    case Block::ULTRA:
-    case Block::ULTRA_1:
-    case Block::ULTRA_2:
-    case Block::ULTRA_3:
-    case Block::ULTRA_4:
-      bgra = util::BGRA<GLfloat>(util::ULTRA);
-      break;
-    case Block::INVUL:
-      bgra = util::BGRA<GLfloat>(util::INVUL);
-      break;
-    case Block::WATER:
-      bgra = util::BGRA<GLfloat>(util::WATER);
-      break;
-    case Block::EXTRA:
-      bgra = util::BGRA<GLfloat>(util::EXTRA);
-      break;
-    case Block::YOGURT:
-    case Block::YOGURT_1:
-      bgra = util::BGRA<GLfloat>(util::YOGURT);
-      break;
-    case Block::ZYGOTE:
-    case Block::ZYGOTE_1:
-      bgra = util::BGRA<GLfloat>(util::ZYGOTE);
-      break;
-    case Block::ZYGOTE_SPAWN:
-      bgra = util::BGRA<GLfloat>(util::ZYGOTE_SPAWN);
-      break;
-  }
-  return bgra;
+  return util::BGRA<GLfloat>(properties(block).color);
 }
 
 util::BGRA<GLfloat> BlockUtils::getBlockEdgeColor(Block block) {
-  util::BGRA<GLfloat> bgra_edge;
-  switch (block) {
-    default:
-    case Block::NONE:
-      bgra_edge = util::BGRA<GLfloat>(util::TRANSPARENT);
-      break;
-    case Block::ALUMINIUM:
-      bgra_edge = util::BGRA<GLfloat>(util::ALUMINIUM_EDGE);
-      break;
-    case Block::ARTIFICAL:
-      bgra_edge = util::BGRA<GLfloat>(util::ARTIFICAL_EDGE);
-      break;
-    case Block::BRICK:
-      bgra_edge = util::BGRA<GLfloat>(util::BRICK_EDGE);
-      break;
-    case Block::CLAY:
-      bgra_edge = util::BGRA<GLfloat>(util::CLAY_EDGE);
-      break;
-    case Block::DESTROY:
-      bgra_edge = util::BGRA<GLfloat>(util::DESTROY_EDGE);
-      break;
-    case Block::ELECTRO:
-      bgra_edge = util::BGRA<GLfloat>(util::ELECTRO_EDGE);
-      break;
-    case Block::FOG:
-      bgra_edge = util::BGRA<GLfloat>(util::FOG_EDGE);
-      break;
-    case Block::GLASS:
-    case Block::GLASS_1:
-      bgra_edge = util::BGRA<GLfloat>(util::GLASS_EDGE);
-      break;
-    case Block::HYPER:
-      bgra_edge = util::BGRA<GLfloat>(util::HYPER_EDGE);
-      break;
-    case Block::IRON:
-      bgra_edge = util::BGRA<GLfloat>(util::IRON_EDGE);
-      break;
-    case Block::JELLY:
-      bgra_edge = util::BGRA<GLfloat>(util::JELLY_EDGE);
-      break;
-    case Block::KNOCK_VERTICAL:
-    case Block::KNOCK_HORIZONTAL:
-      bgra_edge = util::BGRA<GLfloat>(util::KNOCK_EDGE);
-      break;
-    case Block::STEEL:
-      bgra_edge = util::BGRA<GLfloat>(util::STEEL_EDGE);
-      break;
-    case Block::MAGIC:
-      bgra_edge = util::BGRA<GLfloat>(util::MAGIC_EDGE);
-      break;
-    case Block::MIDAS:
-      bgra_edge = util::BGRA<GLfloat>(util::MIDAS_EDGE);
-      break;
-    case Block::NETWORK:
-      bgra_edge = util::BGRA<GLfloat>(util::NETWORK_EDGE);
-      break;
-    case Block::ORIGIN:
-      bgra_edge = util::BGRA<GLfloat>(util::ORIGIN_EDGE);
-      break;
-    case Block::PLUMBUM:
-      bgra_edge = util::BGRA<GLfloat>(util::PLUMBUM_EDGE);
-      break;
-    case Block::QUICK:
-    case Block::QUICK_1:
-    case Block::QUICK_2:
-      bgra_edge = util::BGRA<GLfloat>(util::QUICK_EDGE);
-      break;
-    case Block::ROLLING:
-      bgra_edge = util::BGRA<GLfloat>(util::ROLLING_EDGE);
-      break;
-    case Block::SIMPLE:
-      bgra_edge = util::BGRA<GLfloat>(util::SIMPLE_EDGE);
-      break;
-    case Block::TITAN:
-      bgra_edge = util::BGRA<GLfloat>(util::TITAN_EDGE);
-      break;
-    case Block::ULTRA:
-    case Block::ULTRA_1:
-    case Block::ULTRA_2:
-    case Block::ULTRA_3:
-    case Block::ULTRA_4:
-      bgra_edge = util::BGRA<GLfloat>(util::ULTRA_EDGE);
-      break;
-    case Block::INVUL:
-      bgra_edge = util::BGRA<GLfloat>(util::INVUL_EDGE);
-      break;
-    case Block::WATER:
-      bgra_edge = util::BGRA<GLfloat>(util::WATER_EDGE);
-      break;
-    case Block::EXTRA:
-      bgra_edge = util::BGRA<GLfloat>(util::EXTRA_EDGE);
-      break;
-    case Block::YOGURT:
-    case Block::YOGURT_1:
-      bgra_edge = util::BGRA<GLfloat>(util::YOGURT_EDGE);
-      break;
-    case Block::ZYGOTE:
-    case Block::ZYGOTE_1:
-      bgra_edge = util::BGRA<GLfloat>(util::ZYGOTE_EDGE);
-      break;
-    case Block::ZYGOTE_SPAWN:
-      bgra_edge = util::BGRA<GLfloat>(util::ZYGOTE_SPAWN_EDGE);
-      break;
-  }
-  return bgra_edge;
+  return util::BGRA<GLfloat>(properties(block).edge_color);
+}
+
+const char* BlockUtils::getBlockTexture(Block block) {
+  return properties(block).texture;
 }
 
-std::string BlockUtils::getBlockTexture(Block block) {
-  switch (block) {
-    case Block::DESTROY:    return "bl_destroy.png";
-    case Block::ELECTRO:    return "bl_electro.png";
-    case Block::HYPER:      return "bl_hyper.png";
-    case Block::KNOCK_VERTICAL:
-    case Block::KNOCK_HORIZONTAL:  return "bl_knock.png";
-    case Block::MAGIC:      return "bl_magic.png";
-    case Block::NETWORK:    return "bl_network.png";
-    case Block::ORIGIN:     return "bl_origin.png";
-    case Block::QUICK_1:
-    case Block::QUICK_2:
-    case Block::QUICK:      return "bl_quick.png";
-    case Block::ULTRA_1:
-    case Block::ULTRA_2:
-    case Block::ULTRA_3:
-    case Block::ULTRA_4:
-    case Block::ULTRA:      return "bl_ultra.png";
-    case Block::TITAN:      return "bl_titan.png";
-    case Block::INVUL:      return "bl_invul.png";
-    case Block::EXTRA:      return "bl_extra.png";
-    case Block::MIDAS:      return "bl_midas.png";
-    case Block::ALUMINIUM:  return "bl_aluminium.png";
-    case Block::BRICK:      return "bl_brick.png";
-    case Block::CLAY:       return "bl_clay.png";
-    case Block::FOG:        return "bl_fog.png";
-    case Block::GLASS_1:
-    case Block::GLASS:      return "bl_glass.png";
-    case Block::IRON:       return "bl_iron.png";
-    case Block::JELLY:      return "bl_jelly.png";
-    case Block::STEEL:      return "bl_steel.png";
-    case Block::PLUMBUM:    return "bl_plumbum.png";
-    case Block::ROLLING:    return "bl_rolling.png";
-    case Block::SIMPLE:     return "bl_simple.png";
-    case Block::WATER:      return "bl_water.png";
-    case Block::YOGURT_1:
-    case Block::YOGURT:     return "bl_yogurt.png";
-    case Block::ZYGOTE_1:
-    case Block::ZYGOTE:     return "bl_zygote.png";
-    case Block::ZYGOTE_SPAWN:  return "bl_zygote_spawn.png";
-    default:
-      break;
-  }
-  return "";
+SoundGroup BlockUtils::getBlockSound(Block block) {
+  return properties(block).sound;
 }
 
 bool BlockUtils::cardinalityAffectingBlock(Block block) {
-  return block != Block::ARTIFICAL &&
-      block != Block::NONE &&
-      block != Block::DESTROY &&
-      block != Block::MIDAS &&
-      block != Block::TITAN &&
-      block != Block::INVUL &&
-      block != Block::EXTRA;
+  return (properties(block).flags & COUNTED) != 0;
 }
 
 bool BlockUtils::cardinalityNotAffectingVisibleBlock(Block block) {
-  return block == Block::ARTIFICAL ||
-      block == Block::DESTROY ||
-      block == Block::MIDAS ||
-      block == Block::TITAN ||
-      block == Block::INVUL ||
-      block == Block::EXTRA;
+  return (properties(block).flags & (COUNTED | VISIBLE)) == VISIBLE;
 }
 
 BlockGenerator::BlockGenerator()
@@ -629,4 +191,12 @@ Block BlockGenerator::generateBlock() {
   return static_cast<Block>(value);
 }
 
+void BlockGenerator::writeState(SnapshotWriter* writer) const {
+  writer->putRandom(m_generator);
+}
+
+bool BlockGenerator::readState(SnapshotReader* reader) {
+  return reader->getRandom(&m_generator);
+}
+
 }
@@ -0,0 +1,99 @@
+#include <cstdlib>
+#include <new>
+
+#include "FrameArena.h"
+#include "logger.h"
+
+namespace util {
+
+FrameArena::FrameArena(size_t capacity)
+  : m_memory(new uint8_t[capacity])
+  , m_capacity(capacity)
+  , m_offset(0)
+  , m_peak_usage(0)
+  , m_overflow_count(0)
+  , m_overflow_blocks() {
+}
+
+FrameArena::~FrameArena() noexcept {
+  reset();
+  delete [] m_memory;
+  m_memory = nullptr;
+}
+
+void FrameArena::reset() {
+  if (!m_overflow_blocks.empty()) {
+    for (auto& item : m_overflow_blocks) {
+      delete [] item;
+    }
+    m_overflow_blocks.clear();
+
+    // grow once to fit the largest frame, further frames won't overflow
+    size_t capacity = m_capacity;
+    while (capacity < m_peak_usage) {
+      capacity <<= 1;
+    }
+    DBG("FrameArena grows from %zu to %zu bytes", m_capacity, capacity);
+    delete [] m_memory;
+    m_memory = new uint8_t[capacity];
+    m_capacity = capacity;
+  }
+  m_offset = 0;
+}
+
+void* FrameArena::allocateBytes(size_t size, size_t alignment) {
+  size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+  if (offset + size > m_peak_usage) {
+    m_peak_usage = offset + size;
+  }
+  if (offset + size > m_capacity) {
+    ++m_overflow_count;
+    WRN("FrameArena overflow: %zu bytes requested, %zu available", size,
+        m_offset > m_capacity ? 0 : m_capacity - m_offset);
+    uint8_t* block = new uint8_t[size];
+    m_overflow_blocks.push_back(block);
+    m_offset = offset + size;
+    return block;
+  }
+  m_offset = offset + size;
+  return m_memory + offset;
+}
+
+/* Allocation counter */
+// ----------------------------------------------------------------------------
+#if ENABLED_ALLOCATION_COUNTER
+static thread_local uint64_t heap_allocations = 0;
+
+uint64_t getThreadHeapAllocations() {
+  return heap_allocations;
+}
+
+}  // namespace util
+
+void* operator new(size_t size) {
+  ++util::heap_allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+#else
+uint64_t getThreadHeapAllocations() {
+  return 0;
+}
+
+}  // namespace util
+#endif
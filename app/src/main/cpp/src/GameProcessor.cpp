@@ -14,16 +14,15 @@ GameProcessor::GameProcessor(JavaVM* jvm, jint fdn)
   , master_object(nullptr)
   , fireJavaEvent_lostBall_id(nullptr)
   , fireJavaEvent_levelFinished_id(nullptr)
-  , fireJavaEvent_scoreUpdated_id(nullptr)
-  , fireJavaEvent_angleChanged_id(nullptr)
-  , fireJavaEvent_cardinalityChanged_id(nullptr)
   , fireJavaEvent_debugMessage_id(nullptr)
+  , m_ui_state(nullptr)
   , m_fdn(fdn > 0 ? fdn : ProcessorParams::moveDelay)
   , m_internalTimerThreshold        (adjustValue(fdn, GameProcessor::internalTimerThreshold,         util::div))
   , m_internalTimerForSpeedThreshold(adjustValue(fdn, GameProcessor::internalTimerForSpeedThreshold, util::div))
   , m_internalTimerForWidthThreshold(adjustValue(fdn, GameProcessor::internalTimerForWidthThreshold, util::div))
   , m_internalTimerForLaserThreshold(adjustValue(fdn, GameProcessor::internalTimerForLaserThreshold, util::div))
   , m_level(nullptr)
+  , m_level_origin(nullptr)
   , m_throw_angle(60.0f)
   , m_aspect(1.0f)
   , m_level_finished(false)
@@ -41,14 +40,23 @@ GameProcessor::GameProcessor(JavaVM* jvm, jint fdn)
   , m_internal_timer_for_speed(0)
   , m_internal_timer_for_width(0)
   , m_internal_timer_for_laser(0)
+  , m_bite_effect(BiteEffect::NONE)
+  , m_laser_visible(false)
   , explosionID(0)
   , prizeID(0)
+  , m_block_changes(std::make_shared<BlockChangeBatch>())
   , m_next_move_iteration(0)
   , m_prev_move_iteration(0)
   , m_generator(std::chrono::system_clock::now().time_since_epoch().count())
   , m_angle_distribution(util::PI12, util::PI30)
   , m_direction_distribution(0.25f)
-  , m_viscosity_distribution(0, 100) {
+  , m_viscosity_distribution(0, 100)
+  , m_restored()
+  , m_restore_armed(false)
+  , m_tick(0)
+  , m_recorder(nullptr)
+  , m_keyframe_requested(false)
+  , m_realtime(true) {
 
   DBG("enter GameProcessor ctor");
   INF("Frame delay is %i (nanos)", m_fdn);
@@ -61,6 +69,7 @@ GameProcessor::GameProcessor(JavaVM* jvm, jint fdn)
   m_bite_location_received.store(false);
   m_prize_caught_received.store(false);
   m_laser_beam_received.store(false);
+  m_restore_state_received.store(false);
   DBG("exit GameProcessor ctor");
 }
 
@@ -83,7 +92,8 @@ void GameProcessor::callback_aspectMeasured(float aspect) {
 void GameProcessor::callback_loadLevel(Level::Ptr level) {
   std::lock_guard<std::mutex> lock(m_load_level_mutex);
   DBG("EVENT CALLBACK: callback_loadLevel");
-  m_level = level;
+  m_level_origin = level;
+  m_level = level->clone();
   INF("New level loaded, initial cardinality: %i", m_level->getCardinality());
   m_load_level_received.store(true);
   interrupt();
@@ -125,7 +135,7 @@ void GameProcessor::callback_levelDimens(LevelDimens level_dimens) {
 void GameProcessor::callback_biteMoved(Bite moved_bite) {
   std::lock_guard<std::mutex> lock(m_bite_location_mutex);
   DBG("EVENT CALLBACK: callback_biteMoved");
-  m_bite = moved_bite;
+  m_moved_bite = moved_bite;
   m_bite_location_received.store(true);
   interrupt();
 }
@@ -205,6 +215,7 @@ bool GameProcessor::checkForWakeUp() {
 }
 
 void GameProcessor::eventHandler() {
+  std::lock_guard<std::mutex> lock(m_state_mutex);
   if (m_aspect_ratio_received.load()) {
     m_aspect_ratio_received.store(false);
     process_aspectMeasured();
@@ -243,12 +254,26 @@ void GameProcessor::eventHandler() {
   }
 
   // internal events
+  advance();
+  publishLevel();
+  publishBlockChanges();
+
+  if (m_recorder != nullptr && (m_keyframe_requested || m_recorder->needsKeyframe(m_tick))) {
+    recordKeyframe();
+  }
+  if (m_ui_state != nullptr) {
+    m_ui_state->setFlags((m_ball_is_flying ? UiState::BALL_FLYING : 0) | (m_laser_visible ? UiState::LASER_VISIBLE : 0));
+  }
+}
+
+void GameProcessor::advance() {
   if (m_ball_is_flying) {
     moveBall();
     incrementInternalTimer();
     incrementInternalTimerForSpeed();
     incrementInternalTimerForWidth();
     incrementInternalTimerForLaser();
+    ++m_tick;
   }
   if (checkInternalTimer(m_internalTimerThreshold)) {
     dropTimedEffectForBall();
@@ -259,10 +284,12 @@ void GameProcessor::eventHandler() {
     dropInternalTimerForSpeed();
   }
   if (checkInternalTimerForWidth(m_internalTimerForWidthThreshold)) {
+    m_bite_effect = BiteEffect::NONE;
     bite_width_changed_event.notifyListeners(BiteEffect::NONE);
     dropInternalTimerForWidth();
   }
   if (checkInternalTimerForLaser(m_internalTimerForLaserThreshold)) {
+    m_laser_visible = false;
     laser_beam_visibility_event.notifyListeners(false);
     dropInternalTimerForLaser();
   }
@@ -273,6 +300,8 @@ void GameProcessor::eventHandler() {
 void GameProcessor::process_aspectMeasured() {
   std::lock_guard<std::mutex> lock(m_aspect_ratio_mutex);
   DBG("EVENT PROCESS: process_aspectMeasured");
+  uint32_t words[] = { InputRecorder::toWord(m_aspect) };
+  record(InputType::ASPECT, words);
 }
 
 void GameProcessor::process_loadLevel() {
@@ -280,11 +309,15 @@ void GameProcessor::process_loadLevel() {
   DBG("EVENT PROCESS: process_loadLevel");
   onCardinalityChanged(m_level->getCardinality());
   stopBall();
+  m_restore_armed = m_restore_state_received.exchange(false);
+  m_keyframe_requested = true;  // new level isn't an input
 }
 
 void GameProcessor::process_throwBall() {
   std::lock_guard<std::mutex> lock(m_throw_ball_mutex);
   DBG("EVENT PROCESS: process_throwBall");
+  uint32_t words[] = { InputRecorder::toWord(m_throw_angle) };
+  record(InputType::THROW_BALL, words);
   if (!m_ball_is_flying) {
     m_ball.setAngle(m_throw_angle);
     m_level_finished = false;
@@ -300,23 +333,45 @@ void GameProcessor::process_throwBall() {
 void GameProcessor::process_initBall() {
   std::lock_guard<std::mutex> lock(m_init_ball_position_mutex);
   DBG("EVENT PROCESS: process_initBall(%f, %f)", m_ball.getPose().getX(), m_ball.getPose().getY());
+  if (m_restore_armed) {
+    m_restore_armed = false;
+    applyRestoredState();
+    m_keyframe_requested = true;
+    return;
+  }
+  uint32_t words[] = {
+      InputRecorder::toWord(m_ball.getDimens().width()), InputRecorder::toWord(m_ball.getDimens().height()),
+      InputRecorder::toWord(m_ball.getPose().getX()), InputRecorder::toWord(m_ball.getPose().getY()) };
+  record(InputType::INIT_BALL, words);
+  m_bite_effect = BiteEffect::NONE;  // bite and laser are reset along with ball
+  m_laser_visible = false;
   stopBall();
 }
 
 void GameProcessor::process_initBite() {
   std::lock_guard<std::mutex> lock(m_init_bite_mutex);
   DBG("EVENT PROCESS: process_initBite");
+  uint32_t words[] = { InputRecorder::toWord(m_bite.getDimens().width()), InputRecorder::toWord(m_bite.getDimens().height()), InputRecorder::toWord(m_bite.getXPose()) };
+  record(InputType::INIT_BITE, words);
   m_bite_upper_border = -BiteParams::neg_biteElevation;
 }
 
 void GameProcessor::process_levelDimens() {
   std::lock_guard<std::mutex> lock(m_level_dimens_mutex);
   DBG("EVENT PROCESS: process_levelDimens");
+  uint32_t words[] = {
+      InputRecorder::toWord(m_level_dimens.getRows()), InputRecorder::toWord(m_level_dimens.getCols()),
+      InputRecorder::toWord(m_level_dimens.getWidth()), InputRecorder::toWord(m_level_dimens.getHeight()),
+      InputRecorder::toWord(m_level_dimens.getBlockWidth()), InputRecorder::toWord(m_level_dimens.getBlockHeight()) };
+  record(InputType::LEVEL_DIMENS, words);
 }
 
 void GameProcessor::process_biteMoved() {
   std::lock_guard<std::mutex> lock(m_bite_location_mutex);
   DBG("EVENT PROCESS: process_biteMoved");
+  m_bite = m_moved_bite;  // applied between ball moves, the same way in replay
+  uint32_t words[] = { InputRecorder::toWord(m_bite.getDimens().width()), InputRecorder::toWord(m_bite.getDimens().height()), InputRecorder::toWord(m_bite.getXPose()) };
+  record(InputType::BITE_MOVED, words);
   if (!m_ball_is_flying) {  // move ball following the bite
     shiftBall(m_bite.getXPose(), m_ball.getPose().getY() /* unchanged */);
   }
@@ -325,17 +380,19 @@ void GameProcessor::process_biteMoved() {
 void GameProcessor::process_prizeCaught() {
   std::lock_guard<std::mutex> lock(m_prize_caught_mutex);
   DBG("EVENT PROCESS: process_prizeCaught");
+  uint32_t words[] = { InputRecorder::toWord(static_cast<int>(m_prize_caught)) };
+  record(InputType::PRIZE_CAUGHT, words);
   switch (m_prize_caught) {
     case Prize::BLOCK:
       {
         std::vector<RowCol> none_blocks;
         m_level->findBlocksBackwardAllowNone(Block::NONE, &none_blocks);
         if (!none_blocks.empty()) {
-          size_t random_index = util::getRandomElement(none_blocks);
+          size_t random_index = util::getRandomElement(none_blocks, m_generator);
           RowCol rowcol(none_blocks[random_index].row, none_blocks[random_index].col, Block::ARTIFICAL);
           explodeBlock(rowcol.row, rowcol.col, BlockUtils::getBlockEdgeColor(Block::ARTIFICAL), Kind::CONVERGE);
           m_level->setVulnerableBlock(rowcol.row, rowcol.col, Block::ARTIFICAL);
-          block_impact_event.notifyListeners(rowcol);
+          onBlockChanged(rowcol.row, rowcol.col, Block::NONE, true);
         }
       }
       break;
@@ -353,6 +410,7 @@ void GameProcessor::process_prizeCaught() {
       m_ball.setEffect(BallEffect::EXPLODE);
       break;
     case Prize::EXTEND:  // timed effect
+      m_bite_effect = BiteEffect::EXTEND;
       bite_width_changed_event.notifyListeners(BiteEffect::EXTEND);
       dropInternalTimerForWidth();
       break;
@@ -373,6 +431,7 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimer();
       break;
     case Prize::LASER:
+      m_laser_visible = true;
       laser_beam_visibility_event.notifyListeners(true);
       dropInternalTimerForLaser();
       break;
@@ -385,6 +444,7 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimer();
       break;
     case Prize::PROTECT:  // timed effect
+      m_bite_effect = BiteEffect::FULL;
       bite_width_changed_event.notifyListeners(BiteEffect::FULL);
       dropInternalTimerForWidth();
       break;
@@ -393,6 +453,7 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimer();
       break;
     case Prize::SHORT:  // timed effect
+      m_bite_effect = BiteEffect::SHORT;
       bite_width_changed_event.notifyListeners(BiteEffect::SHORT);
       dropInternalTimerForWidth();
       break;
@@ -424,6 +485,8 @@ void GameProcessor::process_prizeCaught() {
 void GameProcessor::process_laserBeam() {
   std::lock_guard<std::mutex> lock(m_laser_beam_mutex);
   DBG("EVENT PROCESS: process_laserBeam");
+  uint32_t words[] = { InputRecorder::toWord(m_laser_beam.getX()), InputRecorder::toWord(m_laser_beam.getY()) };
+  record(InputType::LASER_BEAM, words);
   int row = 0, col = 0;
   if (!getImpactedBlock(m_laser_beam.getX(), m_laser_beam.getY() - LaserParams::laserHalfHeight, &row, &col)) {
     return;  // laser beam has left level boundaries
@@ -439,11 +502,380 @@ void GameProcessor::process_laserBeam() {
       onScoreUpdated(score);
     }
     m_level->setBlockImpacted(row, col);
-    block_impact_event.notifyListeners(RowCol(row, col, block));
+    onBlockChanged(row, col, block, true);
     laser_block_impact_event.notifyListeners(true);
   }
 }
 
+/* Snapshot group */
+// ----------------------------------------------------------------------------
+bool GameProcessor::saveState(SnapshotWriter* writer) {
+  std::lock_guard<std::mutex> lock(m_state_mutex);
+  std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+  if (m_level == nullptr) {
+    ERR("Unable to save state: level has not been loaded before!");
+    return false;
+  }
+  writeState(writer);
+  return true;
+}
+
+bool GameProcessor::restoreState(SnapshotReader* reader, std::vector<PrizePackage>&& prizes) {
+  std::lock_guard<std::mutex> lock(m_restore_state_mutex);
+  DBG("EVENT CALLBACK: restoreState");
+  if (!readGameState(reader, &m_restored)) {
+    ERR("Game section of snapshot is corrupted");
+    return false;
+  }
+  m_restored.prizes = std::move(prizes);
+  m_restore_state_received.store(true);  // armed by the next loaded level
+  return true;
+}
+
+void GameProcessor::writeState(SnapshotWriter* writer) {
+  writer->beginSection(SnapshotSection::LEVEL);
+  m_level->writeState(writer);
+  writer->endSection();
+
+  writer->beginSection(SnapshotSection::GAME);
+  writer->put(static_cast<uint8_t>(m_ball_is_flying));
+  writer->put(m_throw_angle);
+  writer->put(m_ball.getPose().getX());
+  writer->put(m_ball.getPose().getY());
+  writer->put(m_ball.getAngle());
+  writer->put(m_ball.getVelocity());
+  writer->put(static_cast<int32_t>(m_ball.getEffect()));
+  writer->put(static_cast<int32_t>(m_bite_effect));
+  writer->put(static_cast<uint8_t>(m_laser_visible));
+  writer->put(static_cast<int32_t>(m_internal_timer));
+  writer->put(static_cast<int32_t>(m_internal_timer_for_speed));
+  writer->put(static_cast<int32_t>(m_internal_timer_for_width));
+  writer->put(static_cast<int32_t>(m_internal_timer_for_laser));
+  writer->putRandom(m_generator);
+  writer->putRandom(m_angle_distribution);
+  uint8_t flags = (m_level_finished ? 1 : 0) | (m_is_ball_lost ? 2 : 0) | (m_is_ball_death ? 4 : 0);
+  writer->put(flags);
+  writer->endSection();
+}
+
+bool GameProcessor::readGameState(SnapshotReader* reader, RestoredState* state) {
+  uint8_t ball_is_flying = 0, laser_visible = 0, flags = 0;
+  int32_t ball_effect = 0, bite_effect = 0;
+  int32_t timers[4] = { 0, 0, 0, 0 };
+
+  reader->get(&ball_is_flying);
+  reader->get(&state->throw_angle);
+  reader->get(&state->x);
+  reader->get(&state->y);
+  reader->get(&state->angle);
+  reader->get(&state->velocity);
+  reader->get(&ball_effect);
+  reader->get(&bite_effect);
+  reader->get(&laser_visible);
+  for (int i = 0; i < 4; ++i) {
+    reader->get(&timers[i]);
+  }
+  reader->getRandom(&state->generator);
+  reader->getRandom(&state->angle_distribution);
+  if (!reader->atEnd()) {  // absent in snapshots of earlier builds
+    reader->get(&flags);
+  }
+  if (!reader->isValid()) {
+    return false;
+  }
+  if (ball_effect < 0 || ball_effect >= totalBallEffects) {
+    ERR("Unknown ball effect %i in snapshot", ball_effect);
+    return false;
+  }
+  if (bite_effect < 0 || bite_effect >= totalBiteEffects) {
+    ERR("Unknown bite effect %i in snapshot", bite_effect);
+    return false;
+  }
+
+  state->ball_is_flying = ball_is_flying != 0;
+  state->ball_effect = static_cast<BallEffect>(ball_effect);
+  state->bite_effect = static_cast<BiteEffect>(bite_effect);
+  state->laser_visible = laser_visible != 0;
+  state->level_finished = (flags & 1) != 0;
+  state->is_ball_lost = (flags & 2) != 0;
+  state->is_ball_death = (flags & 4) != 0;
+  state->timer = timers[0];
+  state->timer_for_speed = timers[1];
+  state->timer_for_width = timers[2];
+  state->timer_for_laser = timers[3];
+  return true;
+}
+
+void GameProcessor::applyRestoredState() {
+  std::lock_guard<std::mutex> lock(m_restore_state_mutex);
+  DBG("EVENT PROCESS: applyRestoredState");
+  m_throw_angle = m_restored.throw_angle;
+  m_ball.setAngle(m_restored.angle);
+  m_ball.setVelocity(m_restored.velocity);
+  m_ball.setEffect(m_restored.ball_effect);
+  m_internal_timer = m_restored.timer;
+  m_internal_timer_for_speed = m_restored.timer_for_speed;
+  m_internal_timer_for_width = m_restored.timer_for_width;
+  m_internal_timer_for_laser = m_restored.timer_for_laser;
+  m_generator = m_restored.generator;
+  m_angle_distribution = m_restored.angle_distribution;
+
+  m_level_finished = m_restored.level_finished;
+  m_is_ball_lost = m_restored.is_ball_lost;
+  m_is_ball_death = m_restored.is_ball_death;
+  m_ball_pose_corrected = false;
+  m_ball_is_flying = m_restored.ball_is_flying;
+  if (m_ball_is_flying) {  // otherwise ball stays on the bite
+    shiftBall(m_restored.x, m_restored.y);
+  }
+
+  m_bite_effect = m_restored.bite_effect;
+  if (m_bite_effect != BiteEffect::NONE) {
+    bite_width_changed_event.notifyListeners(m_bite_effect);
+  }
+  m_laser_visible = m_restored.laser_visible;
+  if (m_laser_visible) {
+    laser_beam_visibility_event.notifyListeners(true);
+  }
+  for (auto& prize : m_restored.prizes) {
+    spawnPrize(prize.getX(), prize.getY(), prize.getPrize());
+  }
+  m_restored.prizes.clear();
+}
+
+/* Recording group */
+// ----------------------------------------------------------------------------
+bool GameProcessor::startRecording() {
+  std::lock_guard<std::mutex> lock(m_state_mutex);
+  {
+    std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+    if (m_level == nullptr) {
+      ERR("Unable to start recording: level has not been loaded before!");
+      return false;
+    }
+  }
+  m_recorder.reset(new InputRecorder(m_fdn));
+  m_tick = 0;
+  recordKeyframe();
+  INF("Recording has been started");
+  return true;
+}
+
+bool GameProcessor::stopRecording(std::vector<uint8_t>* recording) {
+  std::lock_guard<std::mutex> lock(m_state_mutex);
+  if (m_recorder == nullptr) {
+    ERR("Unable to stop recording: recording has not been started before!");
+    return false;
+  }
+  recording->swap(m_recorder->getData());
+  m_recorder.reset();
+  INF("Recording has been stopped at tick %u, size %zu", m_tick, recording->size());
+  return true;
+}
+
+bool GameProcessor::replay(InputReplay* replay, uint32_t tick, SnapshotWriter* writer) {
+  std::lock_guard<std::mutex> lock(m_state_mutex);
+  InputEvent event;
+  if (!replay->seek(tick) || !replay->next(&event) || event.type != InputType::KEYFRAME ||
+      !readKeyframe(event.keyframe, event.keyframe_size)) {
+    ERR("Unable to replay: no keyframe before tick %u", tick);
+    return false;
+  }
+  m_tick = event.tick;
+  m_realtime = false;
+
+  // inputs are applied between ball moves exactly as they have been processed,
+  // nothing is published, though journal and changes of tick are drained
+  while (replay->next(&event) && event.tick <= tick) {
+    while (m_tick < event.tick && m_ball_is_flying) {
+      advance();
+      publishLevel();
+      publishBlockChanges();
+    }
+    if (m_tick != event.tick) {
+      WRN("Replay has diverged at tick %u, expected %u", m_tick, event.tick);
+      m_tick = event.tick;
+    }
+    if (event.type == InputType::KEYFRAME) {
+      readKeyframe(event.keyframe, event.keyframe_size);
+    } else {
+      applyInput(event);
+      publishLevel();
+      publishBlockChanges();
+    }
+  }
+  while (m_tick < tick && m_ball_is_flying) {
+    advance();
+    publishLevel();
+    publishBlockChanges();
+  }
+
+  std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+  writeState(writer);
+  return true;
+}
+
+void GameProcessor::publishLevel() {
+  std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+  if (m_level == nullptr || !m_level->hasChanges()) {
+    return;
+  }
+  LevelVersion version;
+  version.version = m_level->commit(&version.changes);
+  if (!level_changed_event.hasListeners()) {
+    return;  // journal is drained, no snapshot is needed, e.g. in replay
+  }
+  version.origin = m_level_origin;
+  version.snapshot = m_level->clone();
+  level_changed_event.notifyListeners(version);
+}
+
+void GameProcessor::publishBlockChanges() {
+  if (m_block_changes->empty()) {
+    return;
+  }
+  if (!block_change_event.hasListeners()) {
+    m_block_changes->clear();  // e.g. in replay, memory is kept for the next tick
+    return;
+  }
+  // listeners share published batch, the next tick is collected into a new one
+  block_change_event.notifyListeners(m_block_changes);
+  m_block_changes = std::make_shared<BlockChangeBatch>();
+}
+
+void GameProcessor::recordKeyframe() {
+  std::lock_guard<std::mutex> level_lock(m_load_level_mutex);
+  if (m_level == nullptr || m_restore_armed) {
+    return;  // state isn't complete yet
+  }
+  std::vector<uint8_t> payload;
+  SnapshotWriter writer(&payload);
+  writeState(&writer);
+
+  writer.beginSection(SnapshotSection::ENVIRONMENT);
+  writer.put(m_aspect);
+  writer.put(m_ball.getDimens().width());
+  writer.put(m_ball.getDimens().height());
+  writer.put(m_bite.getDimens().width());
+  writer.put(m_bite.getDimens().height());
+  writer.put(m_bite.getXPose());
+  writer.put(m_bite_upper_border);
+  writer.put(static_cast<int32_t>(m_level_dimens.getRows()));
+  writer.put(static_cast<int32_t>(m_level_dimens.getCols()));
+  writer.put(m_level_dimens.getWidth());
+  writer.put(m_level_dimens.getHeight());
+  writer.put(m_level_dimens.getBlockWidth());
+  writer.put(m_level_dimens.getBlockHeight());
+  writer.endSection();
+
+  m_recorder->recordKeyframe(m_tick, payload);
+  m_keyframe_requested = false;
+}
+
+bool GameProcessor::readKeyframe(const uint8_t* data, size_t size) {
+  SnapshotReader reader(data, size);
+  SnapshotSection section;
+  SnapshotReader body;
+  Level::Ptr level = nullptr;
+  bool has_game = false, has_environment = false;
+  GLfloat ball_width = 0.f, ball_height = 0.f, bite_width = 0.f, bite_height = 0.f, bite_x = 0.f;
+  GLfloat width = 0.f, height = 0.f, block_width = 0.f, block_height = 0.f;
+  int32_t rows = 0, cols = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(m_restore_state_mutex);
+    while (reader.nextSection(&section, &body)) {
+      switch (section) {
+        case SnapshotSection::LEVEL:
+          level = Level::readState(&body);
+          break;
+        case SnapshotSection::GAME:
+          has_game = readGameState(&body, &m_restored);
+          break;
+        case SnapshotSection::ENVIRONMENT:
+          body.get(&m_aspect);
+          body.get(&ball_width);
+          body.get(&ball_height);
+          body.get(&bite_width);
+          body.get(&bite_height);
+          body.get(&bite_x);
+          body.get(&m_bite_upper_border);
+          body.get(&rows);
+          body.get(&cols);
+          body.get(&width);
+          body.get(&height);
+          body.get(&block_width);
+          body.get(&block_height);
+          has_environment = body.isValid();
+          break;
+        default:
+          break;
+      }
+    }
+    if (level == nullptr || !has_game || !has_environment) {
+      ERR("Keyframe of recording is corrupted");
+      return false;
+    }
+
+    m_level_origin = level;
+    m_level = level->clone();
+    m_level_dimens = LevelDimens(rows, cols, width, height, block_width, block_height);
+    m_ball = Ball(ball_width, ball_height);
+    m_ball.setXPose(m_restored.x);
+    m_ball.setYPose(m_restored.y);
+    m_bite = Bite(bite_width, bite_height);
+    m_bite.setXPose(bite_x);
+    m_restored.prizes.clear();  // falling prizes are caught as recorded inputs
+  }
+  applyRestoredState();
+  return true;
+}
+
+void GameProcessor::applyInput(const InputEvent& event) {
+  switch (event.type) {
+    case InputType::ASPECT:
+      m_aspect = event.getFloat(0);
+      process_aspectMeasured();
+      break;
+    case InputType::INIT_BALL:
+      m_ball_is_flying = false;
+      m_ball = Ball(event.getFloat(0), event.getFloat(1));
+      m_ball.setXPose(event.getFloat(2));
+      m_ball.setYPose(event.getFloat(3));
+      process_initBall();
+      break;
+    case InputType::INIT_BITE:
+      m_bite = Bite(event.getFloat(0), event.getFloat(1));
+      m_bite.setXPose(event.getFloat(2));
+      process_initBite();
+      break;
+    case InputType::LEVEL_DIMENS:
+      m_level_dimens = LevelDimens(event.getInt(0), event.getInt(1),
+          event.getFloat(2), event.getFloat(3), event.getFloat(4), event.getFloat(5));
+      process_levelDimens();
+      break;
+    case InputType::BITE_MOVED:
+      m_moved_bite = Bite(event.getFloat(0), event.getFloat(1));
+      m_moved_bite.setXPose(event.getFloat(2));
+      process_biteMoved();
+      break;
+    case InputType::THROW_BALL:
+      m_throw_angle = event.getFloat(0);
+      process_throwBall();
+      break;
+    case InputType::PRIZE_CAUGHT:
+      m_prize_caught = static_cast<Prize>(event.getInt(0));
+      process_prizeCaught();
+      break;
+    case InputType::LASER_BEAM:
+      m_laser_beam = LaserPackage(event.getFloat(0), event.getFloat(1));
+      process_laserBeam();
+      break;
+    default:
+      break;
+  }
+}
+
 /* LogicFunc group */
 // ----------------------------------------------------------------------------
 void GameProcessor::setBonusPrizes(Prize prize_type) {
@@ -516,8 +948,10 @@ void GameProcessor::moveBall() {
     new_y = old_y + adjustSpeed(m_fdn, m_ball.getVelocity()) * sinf(m_ball.getAngle());
     if (m_ball_is_flying) shiftBall(new_x, new_y);
   }
-  uint64_t delay = m_fdn;
-  std::this_thread::sleep_for (std::chrono::nanoseconds(delay));
+  if (m_realtime) {
+    uint64_t delay = m_fdn;
+    std::this_thread::sleep_for (std::chrono::nanoseconds(delay));
+  }
   DBG("exit GameProcessor::moveBall(%f, %f)", m_ball.getPose().getX(), m_ball.getPose().getY());
 }
 
@@ -538,7 +972,7 @@ void GameProcessor::teleportBallIntoRandomBlock() {
   network_blocks.reserve(12);
   m_level->findBlocks(m_level->generatePresentBlock(), &network_blocks);
   if (!network_blocks.empty()) {
-    size_t random_index = util::getRandomElement(network_blocks);
+    size_t random_index = util::getRandomElement(network_blocks, m_generator);
     shiftBallIntoBlock(network_blocks[random_index].row, network_blocks[random_index].col);
   }
 }
@@ -551,30 +985,37 @@ void GameProcessor::stopBall() {
 void GameProcessor::onLostBall(BallLost ball_lost) {
   m_is_ball_lost = false;
   m_is_ball_death = false;
+  if (m_jenv == nullptr) return;  // replayed
   m_jenv->CallVoidMethod(master_object, fireJavaEvent_lostBall_id, static_cast<int>(ball_lost));
 }
 
 void GameProcessor::onLevelFinished(bool /* dummy */) {
   m_level_finished = false;
+  if (m_jenv == nullptr) return;  // replayed
   m_jenv->CallVoidMethod(master_object, fireJavaEvent_levelFinished_id);
 }
 
 void GameProcessor::onScoreUpdated(int score) {
-  m_jenv->CallVoidMethod(master_object, fireJavaEvent_scoreUpdated_id, score);
+  if (m_ui_state == nullptr) return;  // replayed
+  m_ui_state->addScore(score);
 }
 
 void GameProcessor::onAngleChanged() {
-//  int angle = static_cast<int>(m_ball.getAngle() / util::PI * 180);
-//  m_jenv->CallVoidMethod(master_object, fireJavaEvent_angleChanged_id, angle);
+  if (m_ui_state == nullptr) return;  // replayed
+  m_ui_state->setAngle(static_cast<int>(m_ball.getAngle() / util::PI * 180));
 }
 
 void GameProcessor::onCardinalityChanged(int new_cardinality) {
-  m_jenv->CallVoidMethod(master_object, fireJavaEvent_cardinalityChanged_id, new_cardinality);
+  if (m_ui_state == nullptr) return;  // replayed
+  m_ui_state->setCardinality(new_cardinality);
+}
+
+void GameProcessor::onBlockChanged(int row, int col, Block old_block, bool impacted) {
+  m_block_changes->changes.emplace_back(row, col, old_block, m_level->getBlock(row, col), impacted);
 }
 
 void GameProcessor::explode(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& color, Kind kind) {
-  ExplosionPackage package(explosionID++, x, y, color, kind);
-  explosion_event.notifyListeners(package);
+  m_block_changes->explosions.emplace_back(ExplosionPackage(explosionID++, x, y, color, kind));
 }
 
 void GameProcessor::explodeBlock(int row, int col, Kind kind) {
@@ -592,8 +1033,7 @@ void GameProcessor::explodeBlock(int row, int col, const util::BGRA<GLfloat>& co
 
 void GameProcessor::spawnPrize(GLfloat x, GLfloat y, Prize prize) {
   if (prize != Prize::NONE) {
-    PrizePackage package(prizeID++, x, y, prize);
-    prize_event.notifyListeners(package);
+    m_block_changes->prizes.emplace_back(PrizePackage(prizeID++, x, y, prize));
   }
 }
 
@@ -623,7 +1063,7 @@ int GameProcessor::performBallEffectAtBlock(int row, int col) {
       for (auto& item : affected_blocks_effect) {
         spawned_prize = m_level->getPrizeGenerator().generatePrize();
         spawnPrizeAtBlock(item.row, item.col, spawned_prize);
-        block_impact_event.notifyListeners(item);
+        onBlockChanged(item.row, item.col, item.block, false);
       }
       break;
     case BallEffect::PIERCE:
@@ -641,7 +1081,7 @@ int GameProcessor::performBallEffectAtBlock(int row, int col) {
         if (rowcol.row != -1 && rowcol.col != -1) {
           spawned_prize = m_level->getPrizeGenerator().generatePrize();
           spawnPrizeAtBlock(rowcol.row, rowcol.col, spawned_prize);
-          block_impact_event.notifyListeners(rowcol);
+          onBlockChanged(rowcol.row, rowcol.col, rowcol.block, false);
         }
       }
       break;
@@ -649,14 +1089,14 @@ int GameProcessor::performBallEffectAtBlock(int row, int col) {
       score += m_level->changeBlocksAround(row, col, Mode::UPGRADE, &affected_blocks_effect);
       explodeBlock(row, col, util::GREEN, Kind::DIVERGE);
       for (auto& item : affected_blocks_effect) {
-        block_impact_event.notifyListeners(item);
+        onBlockChanged(item.row, item.col, item.block, false);
       }
       break;
     case BallEffect::DEGRADE:
       score += m_level->changeBlocksAround(row, col, Mode::DEGRADE, &affected_blocks_effect);
       explodeBlock(row, col, util::RED, Kind::DIVERGE);
       for (auto& item : affected_blocks_effect) {
-        block_impact_event.notifyListeners(item);
+        onBlockChanged(item.row, item.col, item.block, false);
       }
       break;
     default:
@@ -933,7 +1373,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         for (auto& item : affected_blocks) {
           spawned_prize = m_level->getPrizeGenerator().generatePrize();
           spawnPrizeAtBlock(item.row, item.col, spawned_prize);
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::KNOCK_VERTICAL:
@@ -946,7 +1386,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
           explodeBlock(item.row, item.col, BlockUtils::getBlockColor(Block::KNOCK_VERTICAL), Kind::DIVERGE);
           spawned_prize = m_level->getPrizeGenerator().generatePrize();
           spawnPrizeAtBlock(item.row, item.col, spawned_prize);
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::KNOCK_HORIZONTAL:
@@ -959,7 +1399,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
           explodeBlock(item.row, item.col, BlockUtils::getBlockColor(Block::KNOCK_HORIZONTAL), Kind::DIVERGE);
           spawned_prize = m_level->getPrizeGenerator().generatePrize();
           spawnPrizeAtBlock(item.row, item.col, spawned_prize);
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::MIDAS:
@@ -968,7 +1408,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::MIDAS), Kind::DIVERGE);
         for (auto& item : affected_blocks) {
           explodeBlock(item.row, item.col, BlockUtils::getBlockColor(Block::TITAN), Kind::DIVERGE);
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         m_is_ball_death = true;
         break;
@@ -978,7 +1418,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::NETWORK), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
         if (!network_blocks.empty()) {
-          random_index = util::getRandomElement(network_blocks);
+          random_index = util::getRandomElement(network_blocks, m_generator);
           shiftBallIntoBlock(network_blocks[random_index].row, network_blocks[random_index].col);
         }
         break;
@@ -1025,7 +1465,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         score += m_level->modifyBlocksAround(row, col, generated_block, false, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(generated_block), Kind::DIVERGE);
         for (auto& item : affected_blocks) {
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::QUICK:
@@ -1039,7 +1479,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::QUICK_1), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
         for (auto& item : affected_blocks) {
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::YOGURT:
@@ -1048,7 +1488,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::YOGURT), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
         for (auto& item : affected_blocks) {
-          block_impact_event.notifyListeners(item);
+          onBlockChanged(item.row, item.col, item.block, false);
         }
         break;
       case Block::ZYGOTE:
@@ -1060,7 +1500,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         if (m_level->modifyBlockNear(row, col, Block::ZYGOTE_SPAWN, &single_affected)) {
           explodeBlock(single_affected.row, single_affected.col, BlockUtils::getBlockColor(Block::ZYGOTE_SPAWN), Kind::CONVERGE);
           spawnPrizeAtBlock(row, col, spawned_prize);
-          block_impact_event.notifyListeners(single_affected);
+          onBlockChanged(single_affected.row, single_affected.col, single_affected.block, false);
         }
         break;
       // --------------------
@@ -1077,7 +1517,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
 #if DEBUG
     debugCollision(new_x, new_y, row, col, block);
 #endif  // DEBUG
-    block_impact_event.notifyListeners(RowCol(row, col, block));
+    onBlockChanged(row, col, block, true);
     onScoreUpdated(score);
     return (external_collision && BlockUtils::cardinalityAffectingBlock(block));
 
@@ -1189,7 +1629,7 @@ void GameProcessor::debugCollision(GLfloat new_x, GLfloat new_y, int row, int co
       left_border, left_border - m_ball.getDimens().halfWidth(),
       right_border, right_border + m_ball.getDimens().halfWidth());
 
-  if (collided) {
+  if (collided && m_jenv != nullptr) {
     std::ostringstream oss;
     oss << "Ball pose (" << m_ball.getPose().getX() + 1.0f << ", " << m_ball.getPose().getY() + 1.0f << ") ; Next pose ("
         << new_x + 1.0f << ", " << new_y + 1.0f << ") ; W2=" << m_ball.getDimens().halfWidth() << ", H2=" << m_ball.getDimens().halfHeight()
@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "ImaAdpcm.h"
+
+namespace native {
+
+static const int32_t stepTable[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+};
+
+static const int indexTable[16] = {
+  -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/// @brief Differences and next step indices for every step index and code,
+/// so that each sample is decoded by two lookups, an addition and a clamp.
+struct DecodeTable {
+  int32_t diff[89][16];
+  uint8_t next[89][16];
+
+  DecodeTable() {
+    for (int index = 0; index < 89; ++index) {
+      int32_t step = stepTable[index];
+      for (int code = 0; code < 16; ++code) {
+        int32_t delta = step >> 3;
+        if (code & 4) delta += step;
+        if (code & 2) delta += step >> 1;
+        if (code & 1) delta += step >> 2;
+        diff[index][code] = (code & 8) ? -delta : delta;
+        next[index][code] = static_cast<uint8_t>(std::min(88, std::max(0, index + indexTable[code])));
+      }
+    }
+  }
+};
+
+static const DecodeTable& getTable() {
+  static const DecodeTable table;
+  return table;
+}
+
+static inline int32_t clamp16(int32_t value) {
+  return std::min(32767, std::max(-32768, value));
+}
+
+/* Public */
+// ----------------------------------------------------------------------------
+size_t ImaAdpcm::getSamplesPerBlock(size_t block_align) {
+  return block_align > headerSize ? (block_align - headerSize) * 2 + 1 : 0;
+}
+
+size_t ImaAdpcm::getSamplesCount(size_t size, size_t block_align) {
+  size_t samples = (size / block_align) * getSamplesPerBlock(block_align);
+  size_t tail = size % block_align;
+  if (tail > headerSize) {
+    samples += getSamplesPerBlock(tail);
+  } else if (tail > 0) {
+    samples += 1;  // header only
+  }
+  return samples;
+}
+
+size_t ImaAdpcm::getEncodedSize(size_t samples, size_t block_align) {
+  size_t samples_per_block = getSamplesPerBlock(block_align);
+  size_t size = (samples / samples_per_block) * block_align;
+  size_t tail = samples % samples_per_block;
+  if (tail > 0) {
+    size += headerSize + tail / 2;  // first sample is stored in header
+  }
+  return size;
+}
+
+size_t ImaAdpcm::decodeBlock(const uint8_t* block, size_t size, int16_t* output, size_t max_samples) {
+  if (size < headerSize || max_samples == 0) {
+    return 0;
+  }
+  const DecodeTable& table = getTable();
+  int32_t predictor = static_cast<int16_t>(block[0] | (block[1] << 8));
+  int index = std::min<int>(88, block[2]);
+  size_t samples = std::min(max_samples, size > headerSize ? getSamplesPerBlock(size) : 1);
+
+  output[0] = static_cast<int16_t>(predictor);
+  const uint8_t* codes = block + headerSize;
+  size_t i = 1;
+  for (; i + 1 < samples; i += 2, ++codes) {
+    int low = *codes & 0x0F;
+    predictor = clamp16(predictor + table.diff[index][low]);
+    index = table.next[index][low];
+    output[i] = static_cast<int16_t>(predictor);
+
+    int high = *codes >> 4;
+    predictor = clamp16(predictor + table.diff[index][high]);
+    index = table.next[index][high];
+    output[i + 1] = static_cast<int16_t>(predictor);
+  }
+  if (i < samples) {
+    int low = *codes & 0x0F;
+    output[i] = static_cast<int16_t>(clamp16(predictor + table.diff[index][low]));
+  }
+  return samples;
+}
+
+size_t ImaAdpcm::encode(const int16_t* input, size_t samples, size_t block_align, uint8_t* output) {
+  const DecodeTable& table = getTable();
+  const size_t samples_per_block = getSamplesPerBlock(block_align);
+  int index = 0;  // carried over blocks, so that each block starts adapted
+  uint8_t* out = output;
+
+  for (size_t start = 0; start < samples; start += samples_per_block) {
+    size_t count = std::min(samples_per_block, samples - start);
+    int32_t predictor = input[start];
+    out[0] = static_cast<uint8_t>(predictor & 0xFF);
+    out[1] = static_cast<uint8_t>((predictor >> 8) & 0xFF);
+    out[2] = static_cast<uint8_t>(index);
+    out[3] = 0;
+    out += headerSize;
+
+    for (size_t i = 1; i < count; ++i) {
+      int32_t step = stepTable[index];
+      int32_t delta = input[start + i] - predictor;
+      int code = 0;
+      if (delta < 0) { code = 8; delta = -delta; }
+      if (delta >= step) { code |= 4; delta -= step; }
+      if (delta >= step >> 1) { code |= 2; delta -= step >> 1; }
+      if (delta >= step >> 2) { code |= 1; }
+
+      // track decoder state exactly, so that errors don't accumulate
+      predictor = clamp16(predictor + table.diff[index][code]);
+      index = table.next[index][code];
+      if (i & 1) {
+        *out = static_cast<uint8_t>(code);
+      } else {
+        *out++ |= static_cast<uint8_t>(code << 4);
+      }
+    }
+    if (count % 2 == 0) {
+      ++out;  // last code is in low nibble only
+    }
+  }
+  return static_cast<size_t>(out - output);
+}
+
+}
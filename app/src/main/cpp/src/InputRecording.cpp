@@ -0,0 +1,173 @@
+#include <algorithm>
+
+#include "byteutils.h"
+#include "InputRecording.h"
+#include "logger.h"
+
+namespace game {
+
+static const char recordingMagic[4] = { 'A', 'R', 'K', 'R' };
+
+/// @brief Maps small negative deltas to small unsigned values.
+static inline uint32_t zigzag(uint32_t delta) {
+  return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+}
+
+static inline uint32_t unzigzag(uint32_t value) {
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+/* Recorder */
+// ----------------------------------------------------------------------------
+InputRecorder::InputRecorder(int32_t frame_delay)
+  : m_tick(0)
+  , m_keyframe_tick(0) {
+  InputRecordingHeader header;
+  std::memcpy(header.magic, recordingMagic, 4);
+  header.version = InputRecorder::version;
+  header.frame_delay = frame_delay;
+  m_data.resize(sizeof(InputRecordingHeader));
+  std::memcpy(&m_data[0], &header, sizeof(InputRecordingHeader));
+  m_data.reserve(64 * 1024);
+  std::fill(m_last, m_last + InputEvent::maxWords * totalInputTypes, 0);
+}
+
+void InputRecorder::record(uint32_t tick, InputType type, const uint32_t* words) {
+  int count = InputReplay::getWordsCount(type);
+  uint32_t* last = &m_last[static_cast<int>(type) * InputEvent::maxWords];
+  m_data.push_back(static_cast<uint8_t>(type));
+  util::putVarint(&m_data, tick - m_tick);
+  for (int i = 0; i < count; ++i) {
+    util::putVarint(&m_data, zigzag(words[i] - last[i]));
+    last[i] = words[i];
+  }
+  m_tick = tick;
+}
+
+void InputRecorder::recordKeyframe(uint32_t tick, const std::vector<uint8_t>& payload) {
+  m_data.push_back(static_cast<uint8_t>(InputType::KEYFRAME));
+  util::putVarint(&m_data, tick);
+  util::putVarint(&m_data, static_cast<uint32_t>(payload.size()));
+  m_data.insert(m_data.end(), payload.begin(), payload.end());
+  std::fill(m_last, m_last + InputEvent::maxWords * totalInputTypes, 0);
+  m_tick = tick;
+  m_keyframe_tick = tick;
+}
+
+/* Replay */
+// ----------------------------------------------------------------------------
+InputReplay::InputReplay(const uint8_t* data, size_t size)
+  : m_data(data)
+  , m_size(size)
+  , m_offset(sizeof(InputRecordingHeader))
+  , m_tick(0)
+  , m_frame_delay(0)
+  , m_duration(0)
+  , m_is_valid(false) {
+  InputRecordingHeader header;
+  if (data == nullptr || size < sizeof(InputRecordingHeader)) {
+    ERR("Recording is truncated");
+    return;
+  }
+  std::memcpy(&header, data, sizeof(InputRecordingHeader));
+  if (std::memcmp(header.magic, recordingMagic, 4) != 0 || header.version != InputRecorder::version) {
+    ERR("Recording is of unknown format or version");
+    return;
+  }
+  m_frame_delay = header.frame_delay;
+  std::fill(m_last, m_last + InputEvent::maxWords * totalInputTypes, 0);
+
+  // single pass validates records and indexes keyframes
+  m_is_valid = true;
+  InputEvent event;
+  size_t offset = m_offset;
+  while (next(&event)) {
+    if (event.type == InputType::KEYFRAME) {
+      m_keyframes.emplace_back(event.tick, offset);
+    }
+    m_duration = event.tick;
+    offset = m_offset;
+  }
+  m_is_valid = m_offset == m_size && !m_keyframes.empty();
+  if (!m_is_valid) {
+    ERR("Recording is corrupted at %zu of %zu", m_offset, m_size);
+  }
+  m_offset = sizeof(InputRecordingHeader);
+  m_tick = 0;
+  std::fill(m_last, m_last + InputEvent::maxWords * totalInputTypes, 0);
+}
+
+bool InputReplay::seek(uint32_t tick) {
+  if (!m_is_valid) {
+    return false;
+  }
+  auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), std::make_pair(tick, m_size));
+  if (it == m_keyframes.begin()) {
+    return false;
+  }
+  m_offset = (--it)->second;
+  return true;
+}
+
+bool InputReplay::next(InputEvent* event) {
+  if (!m_is_valid || m_offset >= m_size) {
+    return false;
+  }
+  size_t offset = m_offset;
+  uint8_t type = m_data[offset++];
+  int count = type < totalInputTypes ? getWordsCount(static_cast<InputType>(type)) : -1;
+  if (count < 0) {
+    return false;
+  }
+  event->type = static_cast<InputType>(type);
+  event->keyframe = nullptr;
+  event->keyframe_size = 0;
+
+  uint32_t value = 0;
+  if (event->type == InputType::KEYFRAME) {
+    uint32_t size = 0;
+    if (!util::getVarint(m_data, m_size, &offset, &value) ||
+        !util::getVarint(m_data, m_size, &offset, &size) ||
+        size > m_size - offset) {
+      return false;
+    }
+    event->tick = value;
+    event->keyframe = m_data + offset;
+    event->keyframe_size = size;
+    offset += size;
+    std::fill(m_last, m_last + InputEvent::maxWords * totalInputTypes, 0);
+  } else {
+    if (!util::getVarint(m_data, m_size, &offset, &value)) {
+      return false;
+    }
+    event->tick = m_tick + value;
+    uint32_t* last = &m_last[type * InputEvent::maxWords];
+    for (int i = 0; i < count; ++i) {
+      if (!util::getVarint(m_data, m_size, &offset, &value)) {
+        return false;
+      }
+      last[i] += unzigzag(value);
+      event->words[i] = last[i];
+    }
+  }
+  m_tick = event->tick;
+  m_offset = offset;
+  return true;
+}
+
+int InputReplay::getWordsCount(InputType type) {
+  switch (type) {
+    case InputType::KEYFRAME:     return 0;
+    case InputType::ASPECT:       return 1;
+    case InputType::INIT_BALL:    return 4;
+    case InputType::INIT_BITE:    return 3;
+    case InputType::LEVEL_DIMENS: return 6;
+    case InputType::BITE_MOVED:   return 3;
+    case InputType::THROW_BALL:   return 1;
+    case InputType::PRIZE_CAUGHT: return 1;
+    case InputType::LASER_BEAM:   return 2;
+  }
+  return -1;
+}
+
+}
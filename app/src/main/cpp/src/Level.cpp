@@ -6,14 +6,35 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <sstream>
 
 #include "Level.h"
+#include "Snapshot.h"
 #include "utils.h"
 
 namespace game {
 
+/// @brief Colors of all four vertices of each block, so that filling
+/// color array is a single 16-byte copy per block.
+struct ColorPatterns {
+  GLubyte bytes[BlockUtils::totalBlocks][16];
+
+  ColorPatterns() {
+    for (int i = 0; i < BlockUtils::totalBlocks; ++i) {
+      Block block = static_cast<Block>(i);
+      util::setColor(BlockUtils::getBlockColor(block), &bytes[i][0], 4);
+      util::setColor(BlockUtils::getBlockEdgeColor(block), &bytes[i][4], 12);
+    }
+  }
+};
+
+static const ColorPatterns& getColorPatterns() {
+  static const ColorPatterns patterns;
+  return patterns;
+}
+
 Level::Ptr Level::fromStringArray(const std::vector<std::string>& array, size_t length) {
   size_t* widths = new size_t[length];
   for (size_t i = 0; i < length; ++i) {
@@ -41,6 +62,27 @@ Level::Ptr Level::fromStringArray(const std::vector<std::string>& array, size_t
   return level;
 }
 
+Level::Ptr Level::fromCells(const char* cells, int rows, int cols) {
+  // characters are mapped to blocks by lookup rather than by switch
+  static const std::vector<Block> table = [] {
+    std::vector<Block> table(256);
+    for (int ch = 0; ch < 256; ++ch) {
+      table[ch] = BlockUtils::charToBlock(static_cast<char>(ch));
+    }
+    return table;
+  }();
+
+  Level::Ptr level = std::shared_ptr<Level>(new Level(rows, cols));
+  for (int r = 0; r < rows; ++r) {
+    const uint8_t* row = reinterpret_cast<const uint8_t*>(cells) + r * cols;
+    for (int c = 0; c < cols; ++c) {
+      level->blocks[r][c] = table[row[c]];
+    }
+  }
+  level->initial_cardinality = level->calculateCardinality();
+  return level;
+}
+
 size_t Level::toStringArray(std::vector<std::string>* array) const {
   for (int r = 0; r < rows; ++r) {
     std::string line = "";
@@ -52,6 +94,48 @@ size_t Level::toStringArray(std::vector<std::string>* array) const {
   return rows;
 }
 
+void Level::writeState(SnapshotWriter* writer) const {
+  writer->put(static_cast<uint16_t>(rows));
+  writer->put(static_cast<uint16_t>(cols));
+  writer->put(static_cast<int32_t>(initial_cardinality));
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      writer->put(static_cast<uint8_t>(blocks[r][c]));
+    }
+  }
+  generator.writeState(writer);
+  prize_generator.writeState(writer);
+}
+
+Level::Ptr Level::readState(SnapshotReader* reader) {
+  uint16_t rows = 0, cols = 0;
+  int32_t cardinality = 0;
+  if (!reader->get(&rows) || !reader->get(&cols) || !reader->get(&cardinality)) {
+    return nullptr;
+  }
+  std::vector<uint8_t> cells(rows * cols);
+  if (cells.empty() || !reader->getBytes(&cells[0], cells.size())) {
+    return nullptr;
+  }
+
+  Level::Ptr level = std::shared_ptr<Level>(new Level(rows, cols));
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      uint8_t cell = cells[r * cols + c];
+      if (cell >= BlockUtils::totalBlocks) {
+        ERR("Unknown block %i in snapshot", cell);
+        return nullptr;
+      }
+      level->blocks[r][c] = static_cast<Block>(cell);
+    }
+  }
+  level->initial_cardinality = cardinality;
+  if (!level->generator.readState(reader) || !level->prize_generator.readState(reader)) {
+    return nullptr;
+  }
+  return level;
+}
+
 void Level::toVertexArray(
     GLfloat width,
     GLfloat height,
@@ -62,27 +146,19 @@ void Level::toVertexArray(
   util::setRectangleVertices(array, width, height, x_offset, y_offset, cols, rows);
 }
 
-void Level::fillColorArray(GLfloat* const array) const {
+void Level::fillColorArray(GLubyte* const array) const {
+  const ColorPatterns& patterns = getColorPatterns();
+  GLubyte* output = array;
   for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      fillColorArrayAtBlock(array, r, c);
+    for (int c = 0; c < cols; ++c, output += 16) {
+      std::memcpy(output, patterns.bytes[static_cast<int>(blocks[r][c])], 16);
     }
   }
 }
 
-void Level::fillColorArrayAtBlock(GLfloat* const array, int row, int col) const {
-  int upper_left_i  = 0  + 16 * (row * cols + col);
-  int upper_right_i = 4  + 16 * (row * cols + col);
-  int lower_left_i  = 8  + 16 * (row * cols + col);
-  int lower_right_i = 12 + 16 * (row * cols + col);
-
-  util::BGRA<GLfloat> bgra = BlockUtils::getBlockColor(blocks[row][col]);
-  util::BGRA<GLfloat> bgra_edge = BlockUtils::getBlockEdgeColor(blocks[row][col]);
-
-  util::setColor(bgra, &array[upper_left_i], 4);
-  util::setColor(bgra_edge, &array[upper_right_i], 4);
-  util::setColor(bgra_edge, &array[lower_left_i], 4);
-  util::setColor(bgra_edge, &array[lower_right_i], 4);
+void Level::fillColorArrayAtBlock(GLubyte* const array, int row, int col) const {
+  // upper left corner has color of block, the rest have color of its edge
+  std::memcpy(&array[16 * (row * cols + col)], getColorPatterns().bytes[static_cast<int>(blocks[row][col])], 16);
 }
 
 void Level::setVulnerableBlock(int row, int col, Block value) {
@@ -314,7 +390,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row - 2, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row - 2, col);
+      output->emplace_back(row - 2, col, block);
     }
   }
 
@@ -324,7 +400,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row - 1, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row - 1, col);
+      output->emplace_back(row - 1, col, block);
     }
     if (col - 1 >= 0) {
       Block block = getBlock(row - 1, col - 1);
@@ -332,7 +408,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row - 1, col - 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-        output->emplace_back(row - 1, col - 1);
+        output->emplace_back(row - 1, col - 1, block);
       }
     }
     if (col + 1 < cols) {
@@ -341,7 +417,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row - 1, col + 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-        output->emplace_back(row - 1, col + 1);
+        output->emplace_back(row - 1, col + 1, block);
       }
     }
   }
@@ -352,7 +428,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row + 1, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row + 1, col);
+      output->emplace_back(row + 1, col, block);
     }
     if (col - 1 >= 0) {
       Block block = getBlock(row + 1, col - 1);
@@ -360,7 +436,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row + 1, col - 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-        output->emplace_back(row + 1, col - 1);
+        output->emplace_back(row + 1, col - 1, block);
       }
     }
     if (col + 1 < cols) {
@@ -369,7 +445,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row + 1, col + 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-        output->emplace_back(row + 1, col + 1);
+        output->emplace_back(row + 1, col + 1, block);
       }
     }
   }
@@ -380,7 +456,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row + 2, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row + 2, col);
+      output->emplace_back(row + 2, col, block);
     }
   }
 
@@ -391,7 +467,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col - 2, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row, col - 2);
+      output->emplace_back(row, col - 2, block);
     }
   }
   if (col - 1 >= 0) {
@@ -400,7 +476,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col - 1, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row, col - 1);
+      output->emplace_back(row, col - 1, block);
     }
   }
   if (col + 1 < cols) {
@@ -409,7 +485,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col + 1, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row, col + 1);
+      output->emplace_back(row, col + 1, block);
     }
   }
   if (col + 2 < cols) {
@@ -418,7 +494,7 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col + 2, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-      output->emplace_back(row, col + 2);
+      output->emplace_back(row, col + 2, block);
     }
   }
   return score;
@@ -431,7 +507,7 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row - 2, col);
-    output->emplace_back(row - 2, col);
+    output->emplace_back(row - 2, col, block);
   }
 
   if (row - 1 >= 0) {
@@ -439,20 +515,20 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row - 1, col);
-    output->emplace_back(row - 1, col);
+    output->emplace_back(row - 1, col, block);
     if (col - 1 >= 0) {
       Block block = getBlock(row - 1, col - 1);
       initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row - 1, col - 1);
-      output->emplace_back(row - 1, col - 1);
+      output->emplace_back(row - 1, col - 1, block);
     }
     if (col + 1 < cols) {
       Block block = getBlock(row - 1, col + 1);
       initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row - 1, col + 1);
-      output->emplace_back(row - 1, col + 1);
+      output->emplace_back(row - 1, col + 1, block);
     }
   }
 
@@ -461,20 +537,20 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row + 1, col);
-    output->emplace_back(row + 1, col);
+    output->emplace_back(row + 1, col, block);
     if (col - 1 >= 0) {
       Block block = getBlock(row + 1, col - 1);
       initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row + 1, col - 1);
-      output->emplace_back(row + 1, col - 1);
+      output->emplace_back(row + 1, col - 1, block);
     }
     if (col + 1 < cols) {
       Block block = getBlock(row + 1, col + 1);
       initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row + 1, col + 1);
-      output->emplace_back(row + 1, col + 1);
+      output->emplace_back(row + 1, col + 1, block);
     }
   }
 
@@ -483,7 +559,7 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row + 2, col);
-    output->emplace_back(row + 2, col);
+    output->emplace_back(row + 2, col, block);
   }
 
   // ------------------------
@@ -492,28 +568,28 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col - 2);
-    output->emplace_back(row, col - 2);
+    output->emplace_back(row, col - 2, block);
   }
   if (col - 1 >= 0) {
     Block block = getBlock(row, col - 1);
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col - 1);
-    output->emplace_back(row, col - 1);
+    output->emplace_back(row, col - 1, block);
   }
   if (col + 1 < cols) {
     Block block = getBlock(row, col + 1);
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col + 1);
-    output->emplace_back(row, col + 1);
+    output->emplace_back(row, col + 1, block);
   }
   if (col + 2 < cols) {
     Block block = getBlock(row, col + 2);
     initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col + 2);
-    output->emplace_back(row, col + 2);
+    output->emplace_back(row, col + 2, block);
   }
   return score;
 }
@@ -533,7 +609,7 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          output->emplace_back(row, col);
+          output->emplace_back(row, col, block);
         }
         --row;
       }
@@ -546,7 +622,7 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          output->emplace_back(row, col);
+          output->emplace_back(row, col, block);
         }
         ++row;
       }
@@ -559,7 +635,7 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          output->emplace_back(row, col);
+          output->emplace_back(row, col, block);
         }
         ++col;
       }
@@ -572,7 +648,7 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          output->emplace_back(row, col);
+          output->emplace_back(row, col, block);
         }
         --col;
       }
@@ -595,7 +671,7 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          *output = RowCol(row, col);
+          *output = RowCol(row, col, block);
         }
       }
       break;
@@ -607,7 +683,7 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          *output = RowCol(row, col);
+          *output = RowCol(row, col, block);
         }
       }
       break;
@@ -619,7 +695,7 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          *output = RowCol(row, col);
+          *output = RowCol(row, col, block);
         }
       }
       break;
@@ -631,7 +707,7 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
-          *output = RowCol(row, col);
+          *output = RowCol(row, col, block);
         }
       }
       break;
@@ -656,7 +732,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
       auto block = getBlock(row - 1, col - 1);
       if (block == Block::NONE) {
         setVulnerableBlock(row - 1, col - 1, type);
-        *output = RowCol(row - 1, col - 1);
+        *output = RowCol(row - 1, col - 1, block);
         return true;
       }
     }
@@ -664,7 +740,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
       auto block = getBlock(row - 1, col + 1);
       if (block == Block::NONE) {
         setVulnerableBlock(row - 1, col + 1, type);
-        *output = RowCol(row - 1, col + 1);
+        *output = RowCol(row - 1, col + 1, block);
         return true;
       }
     }
@@ -674,7 +750,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
       auto block = getBlock(row + 1, col - 1);
       if (block == Block::NONE) {
         setVulnerableBlock(row + 1, col - 1, type);
-        *output = RowCol(row + 1, col - 1);
+        *output = RowCol(row + 1, col - 1, block);
         return true;
       }
     }
@@ -682,7 +758,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
       auto block = getBlock(row + 1, col + 1);
       if (block == Block::NONE) {
         setVulnerableBlock(row + 1, col + 1, type);
-        *output = RowCol(row + 1, col + 1);
+        *output = RowCol(row + 1, col + 1, block);
         return true;
       }
     }
@@ -691,7 +767,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
     auto block = getBlock(row - 1, col);
     if (block == Block::NONE) {
       setVulnerableBlock(row - 1, col, type);
-      *output = RowCol(row - 1, col);
+      *output = RowCol(row - 1, col, block);
       return true;
     }
   }
@@ -699,7 +775,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
     auto block = getBlock(row + 1, col);
     if (block == Block::NONE) {
       setVulnerableBlock(row + 1, col, type);
-      *output = RowCol(row + 1, col);
+      *output = RowCol(row + 1, col, block);
       return true;
     }
   }
@@ -707,7 +783,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
     auto block = getBlock(row, col - 1);
     if (block == Block::NONE) {
       setVulnerableBlock(row, col - 1, type);
-      *output = RowCol(row, col - 1);
+      *output = RowCol(row, col - 1, block);
       return true;
     }
   }
@@ -715,7 +791,7 @@ bool Level::modifyBlockNear(int row, int col, Block type, RowCol* output) {
     auto block = getBlock(row, col + 1);
     if (block == Block::NONE) {
       setVulnerableBlock(row, col + 1, type);
-      *output = RowCol(row, col + 1);
+      *output = RowCol(row, col + 1, block);
       return true;
     }
   }
@@ -774,6 +850,22 @@ Block Level::generatePresentBlock() {
   return block;
 }
 
+Level::Ptr Level::clone() const {
+  clones.fetch_add(1, std::memory_order_acq_rel);  // every row of this level becomes shared
+  Level::Ptr level = std::shared_ptr<Level>(new Level(rows, cols, row_pages));
+  level->initial_cardinality = initial_cardinality;
+  level->generator = generator;
+  level->prize_generator = prize_generator;
+  level->version = version;
+  return level;
+}
+
+uint32_t Level::commit(std::vector<RowCol>* changes) {
+  changes->clear();
+  changes->swap(journal);
+  return ++version;
+}
+
 void Level::print() const {
   std::vector<std::string> array;
   array.reserve((size_t) rows);
@@ -790,22 +882,47 @@ Level::Level(int rows, int cols)
   , cols(cols)
   , initial_cardinality(0)
   , blocks(new Block*[rows])
+  , row_pages(rows)
+  , clones(0)
+  , row_clones(rows, 0)
   , generator()
-  , prize_generator() {
+  , prize_generator()
+  , version(0) {
   for (int r = 0; r < rows; ++r) {
-    blocks[r] = new Block[cols];
+    row_pages[r] = std::shared_ptr<Block>(new Block[cols], std::default_delete<Block[]>());
+    blocks[r] = row_pages[r].get();
   }
 }
 
-Level::~Level() noexcept {
+Level::Level(int rows, int cols, const std::vector<std::shared_ptr<Block>>& row_pages)
+  : rows(rows)
+  , cols(cols)
+  , initial_cardinality(0)
+  , blocks(new Block*[rows])
+  , row_pages(row_pages)
+  , clones(1)
+  , row_clones(rows, 0)  // shared with source level
+  , generator()
+  , prize_generator()
+  , version(0) {
   for (int r = 0; r < rows; ++r) {
-    delete [] blocks[r];
-    blocks[r] = nullptr;
+    blocks[r] = this->row_pages[r].get();
   }
+}
+
+Level::~Level() noexcept {
   delete [] blocks;
   blocks = nullptr;
 }
 
+void Level::detachRow(int row) {
+  std::shared_ptr<Block> page(new Block[cols], std::default_delete<Block[]>());
+  std::memcpy(page.get(), blocks[row], cols * sizeof(Block));
+  row_pages[row] = page;
+  row_clones[row] = clones.load(std::memory_order_acquire);
+  blocks[row] = page.get();
+}
+
 int Level::calculateCardinality() const {
   int cardinality = 0;
   for (int r = 0; r < rows; ++r) {
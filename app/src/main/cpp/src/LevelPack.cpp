@@ -0,0 +1,88 @@
+#include <cstring>
+#include <vector>
+
+#include "Level.h"
+#include "LevelPack.h"
+#include "logger.h"
+
+namespace game {
+
+LevelPack::LevelPack(const void* data, size_t size, Release release)
+  : m_data(static_cast<const uint8_t*>(data))
+  , m_size(size)
+  , m_release(release)
+  , m_header(nullptr)
+  , m_table(nullptr)
+  , m_is_valid(false) {
+  if (m_data == nullptr || m_size < sizeof(LevelPackHeader)) {
+    return;
+  }
+  m_header = reinterpret_cast<const LevelPackHeader*>(m_data);
+  if (std::memcmp(m_header->magic, "ARKL", 4) != 0 ||
+      m_header->version != LevelPack::version ||
+      m_header->table_offset > m_size ||
+      m_header->count >= (m_size - m_header->table_offset) / sizeof(uint32_t)) {
+    return;
+  }
+  m_table = reinterpret_cast<const uint32_t*>(m_data + m_header->table_offset);
+  for (uint32_t i = 0; i < m_header->count; ++i) {
+    if (m_table[i] > m_table[i + 1] || m_table[i + 1] > m_size ||
+        m_table[i + 1] - m_table[i] < sizeof(LevelRecord)) {
+      return;
+    }
+  }
+  m_is_valid = true;
+}
+
+LevelPack::~LevelPack() noexcept {
+  if (m_release) {
+    m_release();
+  }
+}
+
+bool LevelPack::isValid() const { return m_is_valid; }
+int LevelPack::getCount() const { return m_is_valid ? static_cast<int>(m_header->count) : 0; }
+
+std::shared_ptr<Level> LevelPack::load(int index) const {
+  if (index < 0 || index >= getCount()) {
+    return nullptr;
+  }
+  const uint8_t* begin = m_data + m_table[index];
+  const uint8_t* end = m_data + m_table[index + 1];
+  LevelRecord record;
+  std::memcpy(&record, begin, sizeof(LevelRecord));
+  const uint8_t* payload = begin + sizeof(LevelRecord);
+  size_t total = static_cast<size_t>(record.rows) * record.cols;
+
+  const uint8_t* cells = payload;  // raw cells are used right from the pack
+  std::vector<uint8_t> decoded;
+  switch (static_cast<LevelEncoding>(record.encoding)) {
+    case LevelEncoding::RAW:
+      if (static_cast<size_t>(end - payload) != total) {
+        ERR("Level %i is truncated", index);
+        return nullptr;
+      }
+      break;
+    case LevelEncoding::RLE:
+      decoded.reserve(total);
+      for (const uint8_t* run = payload; run + 1 < end && decoded.size() <= total; run += 2) {
+        decoded.insert(decoded.end(), run[0], run[1]);
+      }
+      if (decoded.size() != total) {
+        ERR("Level %i is corrupted", index);
+        return nullptr;
+      }
+      cells = decoded.data();
+      break;
+    default:
+      ERR("Level %i has unknown encoding %i", index, record.encoding);
+      return nullptr;
+  }
+  if (checksum(cells, total) != record.checksum) {
+    ERR("Level %i checksum mismatch", index);
+    return nullptr;
+  }
+  return Level::fromCells(reinterpret_cast<const char*>(cells), record.rows, record.cols);
+}
+
+}
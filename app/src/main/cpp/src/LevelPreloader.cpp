@@ -0,0 +1,130 @@
+#include <chrono>
+
+#include "LevelPreloader.h"
+#include "logger.h"
+#include "utils.h"
+
+namespace game {
+
+PreparedLevel::PreparedLevel()
+  : aspect(0.0f)
+  , dimens(0, 0, 0.0f, 0.0f, 0.0f, 0.0f) {
+}
+
+LevelPreloader::LevelPreloader()
+  : m_index(-1)
+  , m_aspect(0.0f) {
+}
+
+LevelPreloader::~LevelPreloader() noexcept {
+  join();
+}
+
+void LevelPreloader::setAspect(GLfloat aspect) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_aspect = aspect;
+}
+
+void LevelPreloader::preload(int index, Source source, LoadedCallback on_loaded) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_index == index) {
+      DBG("Level %i is being preloaded already", index);
+      return;
+    }
+  }
+  join();  // worker of level dropped before is done soon, it's not published
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index = index;
+    m_prepared = PreparedLevel();
+  }
+  m_worker = std::thread([this, index, source, on_loaded]() {
+    auto start = std::chrono::steady_clock::now();
+    PreparedLevel prepared;
+    prepared.level = source();
+    if (prepared.level == nullptr) {
+      WRN("Level %i has failed to preload", index);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_index == index) {
+        m_index = -1;  // could be preloaded again
+      }
+      return;
+    }
+    if (on_loaded != nullptr) {
+      on_loaded(prepared.level);
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      prepared.aspect = m_aspect;
+    }
+    buildGeometry(prepared.aspect, &prepared);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_index == index) {
+      m_prepared = std::move(prepared);
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+      DBG("Level %i has been preloaded in %lli us", index, (long long) elapsed.count());
+    }
+  });
+}
+
+bool LevelPreloader::isPreloaded(int index) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_index == index && m_prepared.level != nullptr;
+}
+
+Level::Ptr LevelPreloader::takeLevel(int index) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_index != index) {
+    return nullptr;
+  }
+  if (m_prepared.level == nullptr) {
+    // worker is still running, caller loads level itself and worker's result is dropped
+    DBG("Level %i hasn't been preloaded in time", index);
+    m_index = -1;
+    return nullptr;
+  }
+  m_taken = std::move(m_prepared);
+  m_prepared = PreparedLevel();
+  m_index = -1;
+  return m_taken.level;
+}
+
+bool LevelPreloader::takeGeometry(const Level::Ptr& level, GLfloat aspect, PreparedLevel* prepared) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_taken.level == nullptr || m_taken.level != level || m_taken.aspect != aspect) {
+    m_taken = PreparedLevel();  // stale, renderer builds geometry itself
+    return false;
+  }
+  *prepared = std::move(m_taken);
+  m_taken = PreparedLevel();
+  return true;
+}
+
+void LevelPreloader::buildGeometry(GLfloat aspect, PreparedLevel* prepared) {
+  const Level& level = *prepared->level;
+  prepared->aspect = aspect;
+  prepared->dimens = LevelDimens(
+      level.numRows(),
+      level.numCols(),
+      level.numCols() * LevelDimens::blockWidth,
+      level.numRows() * LevelDimens::blockHeight * aspect,
+      LevelDimens::blockWidth,
+      LevelDimens::blockHeight * aspect);
+
+  prepared->vertices.resize(level.size() * 8);
+  prepared->colors.resize(level.size() * 16);
+  prepared->indices.resize(level.size() * 6);
+  level.toVertexArray(prepared->dimens.getBlockWidth(), prepared->dimens.getBlockHeight(), -1.0f, 1.0f, &prepared->vertices[0]);
+  level.fillColorArray(&prepared->colors[0]);
+  util::rectangleIndices(&prepared->indices[0], prepared->indices.size());
+}
+
+void LevelPreloader::join() {
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+}
+
+}
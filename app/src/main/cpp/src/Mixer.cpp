@@ -0,0 +1,204 @@
+#include <algorithm>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define MIXER_NEON 1
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define MIXER_SSE2 1
+#endif
+
+#include "ImaAdpcm.h"
+#include "logger.h"
+#include "Mixer.h"
+
+namespace native {
+namespace sound {
+
+/// @brief Fractional bits of fixed point gain.
+static const int gainShift = 14;
+
+/* Kernels */
+// ----------------------------------------------------------------------------
+/// @brief Adds samples scaled by gain (Q14) to accumulator.
+static void accumulate(const int16_t* src, int16_t gain, int32_t* acc, size_t count) {
+  size_t i = 0;
+#if MIXER_NEON
+  const int16x4_t g = vdup_n_s16(gain);
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t s = vld1q_s16(src + i);
+    int32x4_t lo = vshrq_n_s32(vmull_s16(vget_low_s16(s), g), gainShift);
+    int32x4_t hi = vshrq_n_s32(vmull_s16(vget_high_s16(s), g), gainShift);
+    vst1q_s32(acc + i, vaddq_s32(vld1q_s32(acc + i), lo));
+    vst1q_s32(acc + i + 4, vaddq_s32(vld1q_s32(acc + i + 4), hi));
+  }
+#elif MIXER_SSE2
+  const __m128i g = _mm_set1_epi16(gain);
+  for (; i + 8 <= count; i += 8) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // full 32-bit products are interleaved from low and high halves
+    __m128i product_lo = _mm_mullo_epi16(s, g);
+    __m128i product_hi = _mm_mulhi_epi16(s, g);
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(product_lo, product_hi), gainShift);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(product_lo, product_hi), gainShift);
+    __m128i* dst = reinterpret_cast<__m128i*>(acc + i);
+    _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), lo));
+    _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    acc[i] += (static_cast<int32_t>(src[i]) * gain) >> gainShift;
+  }
+}
+
+/// @brief Saturates accumulated samples to 16 bits.
+static void saturate(const int32_t* acc, int16_t* dst, size_t count) {
+  size_t i = 0;
+#if MIXER_NEON
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t s = vcombine_s16(vqmovn_s32(vld1q_s32(acc + i)), vqmovn_s32(vld1q_s32(acc + i + 4)));
+    vst1q_s16(dst + i, s);
+  }
+#elif MIXER_SSE2
+  for (; i + 8 <= count; i += 8) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = static_cast<int16_t>(std::min(32767, std::max(-32768, acc[i])));
+  }
+}
+
+/* Mixer */
+// ----------------------------------------------------------------------------
+Mixer::Mixer() {
+  for (auto& voice : m_voices) {
+    voice.sound = nullptr;
+    voice.decoded.resize(ImaAdpcm::getSamplesPerBlock(ImaAdpcm::defaultBlockAlign));
+  }
+  m_accumulator.resize(maxChunkFrames);
+}
+
+Mixer::~Mixer() noexcept {
+}
+
+bool Mixer::play(const SoundBuffer* sound, float gain, int priority) {
+  if (sound == nullptr || sound->getData() == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_voices_mutex);
+  int slot = -1;
+  for (int i = 0; i < maxVoices; ++i) {
+    if (m_voices[i].sound == nullptr) {
+      slot = i;
+      break;
+    }
+    // steal voice of the lowest priority, the longest played among equal ones
+    if (slot < 0 ||
+        m_voices[i].priority < m_voices[slot].priority ||
+        (m_voices[i].priority == m_voices[slot].priority && m_voices[i].position > m_voices[slot].position)) {
+      slot = i;
+    }
+  }
+  Voice& voice = m_voices[slot];
+  if (voice.sound != nullptr) {
+    if (voice.priority > priority) {
+      DBG("All voices are busy with higher priority sounds, %s is dropped", sound->getFilename());
+      return false;
+    }
+    DBG("Voice %i is stolen by %s", slot, sound->getFilename());
+  }
+
+  int fixed_gain = static_cast<int>(gain * (1 << gainShift) + 0.5f);
+  voice.sound = sound;
+  voice.length = sound->getFrames();
+  voice.position = 0;
+  voice.decoded_block = noBlock;
+  voice.decoded_count = 0;
+  if (sound->getEncoding() == SoundBuffer::Encoding::PCM16) {
+    voice.samples = reinterpret_cast<const int16_t*>(sound->getData());
+  } else {
+    voice.samples = nullptr;
+    if (voice.decoded.size() < sound->getSamplesPerBlock()) {
+      voice.decoded.resize(sound->getSamplesPerBlock());  // not to allocate in mix()
+    }
+  }
+  voice.gain = static_cast<int16_t>(std::min(32767, std::max(0, fixed_gain)));
+  voice.priority = priority;
+  return true;
+}
+
+void Mixer::stopAll() {
+  std::lock_guard<std::mutex> lock(m_voices_mutex);
+  for (auto& voice : m_voices) {
+    voice.sound = nullptr;
+  }
+}
+
+bool Mixer::isPlaying(const SoundBuffer* sound) {
+  std::lock_guard<std::mutex> lock(m_voices_mutex);
+  for (auto& voice : m_voices) {
+    if (voice.sound == sound) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Mixer::mix(int16_t* output, size_t frames) {
+  std::lock_guard<std::mutex> lock(m_voices_mutex);
+  for (size_t offset = 0; offset < frames; offset += maxChunkFrames) {
+    size_t count = frames - offset;
+    mixChunk(output + offset, count < maxChunkFrames ? count : maxChunkFrames);
+  }
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void Mixer::mixChunk(int16_t* output, size_t frames) {
+  std::fill(m_accumulator.begin(), m_accumulator.begin() + frames, 0);
+  for (auto& voice : m_voices) {
+    if (voice.sound == nullptr) {
+      continue;
+    }
+    size_t mixed = 0;
+    while (mixed < frames && voice.position < voice.length) {
+      size_t count = 0;
+      const int16_t* samples = fetch(voice, frames - mixed, &count);
+      if (count == 0) {
+        voice.position = voice.length;  // broken block
+        break;
+      }
+      accumulate(samples, voice.gain, &m_accumulator[mixed], count);
+      voice.position += count;
+      mixed += count;
+    }
+    if (voice.position >= voice.length) {
+      voice.sound = nullptr;  // voice is free
+    }
+  }
+  saturate(&m_accumulator[0], output, frames);
+}
+
+const int16_t* Mixer::fetch(Voice& voice, size_t frames, size_t* count) {
+  if (voice.samples != nullptr) {
+    *count = std::min(frames, voice.length - voice.position);
+    return voice.samples + voice.position;
+  }
+
+  size_t samples_per_block = voice.sound->getSamplesPerBlock();
+  size_t block = voice.position / samples_per_block;
+  size_t offset = voice.position % samples_per_block;
+  if (voice.decoded_block != block) {
+    voice.decoded_count = voice.sound->decodeBlock(block, &voice.decoded[0]);
+    voice.decoded_block = block;
+  }
+  *count = offset < voice.decoded_count ? std::min(frames, voice.decoded_count - offset) : 0;
+  return &voice.decoded[offset];
+}
+
+}  // namespace sound
+}  // namespace native
@@ -0,0 +1,173 @@
+#include <random>
+
+#include "logger.h"
+#include "ParticleSystem.h"
+
+namespace game {
+
+ParticleSystem::ParticleSystem()
+  : m_aspect(1.0f)
+  , m_diverge_seeds(new GLfloat[particleSize * particleSystemSize])
+  , m_converge_seeds(new GLfloat[particleSize * particleSystemSize])
+  , m_vacuum_seeds(new GLfloat[particleSize * particleSystemSize])
+  , m_vertex_buffer(new GLfloat[vertexSize * particleSystemSize * emitterCapacity])
+  , m_live_emitters(0)
+  , m_used_slots(0)
+  , m_dirty_begin(emitterCapacity)
+  , m_dirty_end(0)
+  , m_epoch(std::chrono::steady_clock::now()) {
+
+  for (int slot = 0; slot < emitterCapacity; ++slot) {
+    m_emitters[slot].start_time = 0.0f;
+    m_emitters[slot].is_alive = false;
+  }
+  generateSeeds();
+}
+
+ParticleSystem::~ParticleSystem() noexcept {
+  delete [] m_diverge_seeds; m_diverge_seeds = nullptr;
+  delete [] m_converge_seeds; m_converge_seeds = nullptr;
+  delete [] m_vacuum_seeds; m_vacuum_seeds = nullptr;
+  delete [] m_vertex_buffer; m_vertex_buffer = nullptr;
+}
+
+void ParticleSystem::spawn(const ExplosionPackage& package) {
+  if (m_live_emitters == 0) {
+    m_epoch = std::chrono::steady_clock::now();
+  }
+  float now = getTime();
+
+  int slot = 0;
+  for (; slot < emitterCapacity; ++slot) {
+    if (!m_emitters[slot].is_alive) {
+      break;
+    }
+  }
+  if (slot == emitterCapacity) {
+    // pool exhausted: steal the oldest emitter
+    slot = 0;
+    for (int i = 1; i < emitterCapacity; ++i) {
+      if (m_emitters[i].start_time < m_emitters[slot].start_time) {
+        slot = i;
+      }
+    }
+    WRN("Particle system pool exhausted, emitter %i has been stolen", slot);
+  } else {
+    ++m_live_emitters;
+  }
+  m_emitters[slot].start_time = now;
+  m_emitters[slot].is_alive = true;
+  if (slot >= m_used_slots) {
+    m_used_slots = slot + 1;
+  }
+  if (slot < m_dirty_begin) {
+    m_dirty_begin = slot;
+  }
+  if (slot >= m_dirty_end) {
+    m_dirty_end = slot + 1;
+  }
+
+  const GLfloat* seeds = getSeeds(package.getKind());
+  const util::BGRA<GLfloat>& bgra = package.getColor();
+  GLfloat* vertex = &m_vertex_buffer[slot * particleSystemSize * vertexSize];
+  for (int i = 0; i < particleSystemSize; ++i, seeds += particleSize, vertex += vertexSize) {
+    vertex[lifetimeOffset] = seeds[0];
+    vertex[endOffset + 0] = seeds[1];
+    vertex[endOffset + 1] = seeds[2] * m_aspect;
+    vertex[startOffset + 0] = seeds[3];
+    vertex[startOffset + 1] = seeds[4] * m_aspect;
+    vertex[centerOffset + 0] = package.getX();
+    vertex[centerOffset + 1] = package.getY();
+    vertex[startTimeOffset] = now;
+    vertex[colorOffset + 0] = bgra.b;
+    vertex[colorOffset + 1] = bgra.g;
+    vertex[colorOffset + 2] = bgra.r;
+  }
+}
+
+void ParticleSystem::update() {
+  if (m_live_emitters == 0) {
+    return;
+  }
+  float now = getTime();
+  for (int slot = 0; slot < m_used_slots; ++slot) {
+    if (m_emitters[slot].is_alive && now - m_emitters[slot].start_time >= emitterDuration) {
+      retire(slot);
+    }
+  }
+}
+
+void ParticleSystem::clear() {
+  for (int slot = 0; slot < emitterCapacity; ++slot) {
+    m_emitters[slot].is_alive = false;
+  }
+  m_live_emitters = 0;
+  m_used_slots = 0;
+}
+
+void ParticleSystem::markClean() {
+  m_dirty_begin = emitterCapacity;
+  m_dirty_end = 0;
+}
+
+void ParticleSystem::markDirty() {
+  m_dirty_begin = 0;
+  m_dirty_end = m_used_slots;
+}
+
+float ParticleSystem::getTime() const {
+  return std::chrono::duration<float>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void ParticleSystem::generateSeeds() {
+  std::default_random_engine generator(std::chrono::system_clock::now().time_since_epoch().count());
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+  std::normal_distribution<float> normal_distribution(0.0f, 1.0f);
+
+  // y-coordinates are scaled by aspect ratio when emitter is spawned
+  for (int i = 0; i < particleSystemSize; ++i) {
+    int index = i * particleSize;
+    // Lifetime of particle
+    m_diverge_seeds[index + 0]  = distribution(generator);
+    m_converge_seeds[index + 0] = distribution(generator);
+    m_vacuum_seeds[index + 0]   = normal_distribution(generator);
+    // Start position of particle
+    m_diverge_seeds[index + 3]  = distribution(generator) * 0.25f - 0.125f;
+    m_diverge_seeds[index + 4]  = distribution(generator) * 0.25f - 0.125f;
+    m_converge_seeds[index + 3] = distribution(generator) * 0.2f - 0.1f;
+    m_converge_seeds[index + 4] = distribution(generator) * 0.1f - 0.05f;
+    m_vacuum_seeds[index + 3]   = normal_distribution(generator) * 0.15f - 0.075f;
+    m_vacuum_seeds[index + 4]   = normal_distribution(generator) * 0.15f - 0.075f;
+    // End position of particle
+    m_diverge_seeds[index + 1]  = distribution(generator) * 2.0f - 1.0f;
+    m_diverge_seeds[index + 2]  = distribution(generator) * 2.0f - 1.0f;
+    m_converge_seeds[index + 1] = distribution(generator) * 0.1f;
+    m_converge_seeds[index + 2] = distribution(generator) * 0.05f;
+    m_vacuum_seeds[index + 1]   = normal_distribution(generator) * 0.025f - 0.0125f;
+    m_vacuum_seeds[index + 2]   = normal_distribution(generator) * 0.025f - 0.0125f;
+  }
+}
+
+void ParticleSystem::retire(int slot) {
+  m_emitters[slot].is_alive = false;
+  --m_live_emitters;
+  while (m_used_slots > 0 && !m_emitters[m_used_slots - 1].is_alive) {
+    --m_used_slots;
+  }
+}
+
+const GLfloat* ParticleSystem::getSeeds(Kind kind) const {
+  switch (kind) {
+    default:
+    case Kind::DIVERGE:
+      return m_diverge_seeds;
+    case Kind::CONVERGE:
+      return m_converge_seeds;
+    case Kind::VACUUM:
+      return m_vacuum_seeds;
+  }
+}
+
+}  // namespace game
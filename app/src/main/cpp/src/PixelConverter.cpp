@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cstring>
+
+// PIXEL_CONVERTER_SCALAR forces scalar conversions, so that host tests compare them with vector ones.
+#if defined(PIXEL_CONVERTER_SCALAR)
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define PIXEL_CONVERTER_NEON 1
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define PIXEL_CONVERTER_SSE2 1
+#endif
+
+#include "PixelConverter.h"
+
+namespace native {
+
+/// @brief 4x4 Bayer matrix, values in [0, 15].
+static const uint8_t bayer[4][4] = {
+  { 0,  8,  2, 10},
+  {12,  4, 14,  6},
+  { 3, 11,  1,  9},
+  {15,  7, 13,  5}
+};
+
+/// @brief Dithering offset for truncation to specified number of bits.
+static inline uint32_t offset(uint32_t threshold, int bits) {
+  return (threshold << (8 - bits)) >> 4;
+}
+
+/// @brief Adds dithering offset for truncation to specified number of bits.
+static inline uint32_t dither(uint32_t value, uint32_t threshold, int bits) {
+  return std::min(255u, value + offset(threshold, bits));
+}
+
+/// @brief Exact (value * alpha + 127) / 255.
+static inline uint32_t premultiplied(uint32_t value, uint32_t alpha) {
+  return (value * alpha + 127) / 255;
+}
+
+/// @brief Dithering offsets of one row, for each of RGBA channels.
+/// @details Offsets repeat every 4 pixels, vector kernels start rows
+/// at pixel 0 and advance by multiples of 4, so one row of offsets
+/// is added to every vector of pixels of that row.
+struct RowDither {
+  uint8_t offsets[4][4];  //!< [pixel % 4][channel]
+
+  RowDither(uint32_t row, int bits_r, int bits_g, int bits_b) {
+    for (int x = 0; x < 4; ++x) {
+      uint32_t threshold = bayer[row & 3][x];
+      offsets[x][0] = static_cast<uint8_t>(offset(threshold, bits_r));
+      offsets[x][1] = static_cast<uint8_t>(offset(threshold, bits_g));
+      offsets[x][2] = static_cast<uint8_t>(offset(threshold, bits_b));
+      offsets[x][3] = 0;  // alpha is never dithered
+    }
+  }
+};
+
+/* Vectorized kernels */
+// ----------------------------------------------------------------------------
+// Each kernel converts leading pixels of a row and returns their number,
+// the rest is left for scalar code. Results are the same bit for bit:
+// dithering is saturating addition and premultiplication divides exactly.
+#if PIXEL_CONVERTER_NEON
+
+/// @brief Loads 16 pixels deinterleaved, alpha of RGB source is 255.
+static inline uint8x16x4_t loadRGBA(const uint8_t* src, int channels) {
+  if (channels == 4) {
+    return vld4q_u8(src);
+  }
+  uint8x16x3_t rgb = vld3q_u8(src);
+  uint8x16x4_t rgba;
+  rgba.val[0] = rgb.val[0];
+  rgba.val[1] = rgb.val[1];
+  rgba.val[2] = rgb.val[2];
+  rgba.val[3] = vdupq_n_u8(255);
+  return rgba;
+}
+
+/// @brief (x + (x >> 8) + 1) >> 8 equals x / 255 for x = value * alpha + 127.
+static inline uint8x8_t div255(uint16x8_t x) {
+  x = vaddq_u16(x, vdupq_n_u16(127));
+  return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), vdupq_n_u16(1)), 8);
+}
+
+static inline uint8x16_t premultiply(uint8x16_t value, uint8x16_t alpha) {
+  return vcombine_u8(div255(vmull_u8(vget_low_u8(value), vget_low_u8(alpha))),
+                     div255(vmull_u8(vget_high_u8(value), vget_high_u8(alpha))));
+}
+
+/// @brief Offsets of 16 pixels for each of RGB channels, zero without dithering.
+static inline void channelOffsets(const RowDither* dither, uint8x16_t (&offsets)[3]) {
+  for (int c = 0; c < 3; ++c) {
+    uint8_t lanes[16] = {};
+    for (int x = 0; x < 16 && dither != nullptr; ++x) {
+      lanes[x] = dither->offsets[x & 3][c];
+    }
+    offsets[c] = vld1q_u8(lanes);
+  }
+}
+
+static inline void addDither(uint8x16x4_t* rgba, const uint8x16_t (&offsets)[3]) {
+  for (int c = 0; c < 3; ++c) {
+    rgba->val[c] = vqaddq_u8(rgba->val[c], offsets[c]);
+  }
+}
+
+static uint32_t convertRowToRGB565_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                        uint32_t width, bool premultiply_alpha, const RowDither* dither) {
+  uint8x16_t offsets[3];
+  channelOffsets(dither, offsets);
+  uint32_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x4_t rgba = loadRGBA(src + x * channels, channels);
+    if (premultiply_alpha) {
+      for (int c = 0; c < 3; ++c) {
+        rgba.val[c] = premultiply(rgba.val[c], rgba.val[3]);
+      }
+    }
+    addDither(&rgba, offsets);
+    uint8x16x2_t out;
+    // little-endian: low byte is GGGBBBBB, high byte is RRRRRGGG
+    out.val[0] = vorrq_u8(vandq_u8(vshlq_n_u8(rgba.val[1], 3), vdupq_n_u8(0xE0)), vshrq_n_u8(rgba.val[2], 3));
+    out.val[1] = vorrq_u8(vandq_u8(rgba.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(rgba.val[1], 5));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + x), out);
+  }
+  return x;
+}
+
+static uint32_t convertRowToRGBA4444_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                          uint32_t width, const RowDither* dither) {
+  uint8x16_t offsets[3];
+  channelOffsets(dither, offsets);
+  const uint8x16_t mask = vdupq_n_u8(0xF0);
+  uint32_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x4_t rgba = loadRGBA(src + x * channels, channels);
+    addDither(&rgba, offsets);
+    uint8x16x2_t out;
+    // little-endian: low byte is BBBBAAAA, high byte is RRRRGGGG
+    out.val[0] = vorrq_u8(vandq_u8(rgba.val[2], mask), vshrq_n_u8(rgba.val[3], 4));
+    out.val[1] = vorrq_u8(vandq_u8(rgba.val[0], mask), vshrq_n_u8(rgba.val[1], 4));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + x), out);
+  }
+  return x;
+}
+
+static uint32_t convertRowToRGBA5551_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                          uint32_t width, const RowDither* dither) {
+  uint8x16_t offsets[3];
+  channelOffsets(dither, offsets);
+  uint32_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x4_t rgba = loadRGBA(src + x * channels, channels);
+    addDither(&rgba, offsets);
+    uint8x16x2_t out;
+    // little-endian: low byte is GGBBBBBA, high byte is RRRRRGGG
+    out.val[0] = vorrq_u8(vorrq_u8(vandq_u8(vshlq_n_u8(rgba.val[1], 3), vdupq_n_u8(0xC0)),
+                                   vandq_u8(vshrq_n_u8(rgba.val[2], 2), vdupq_n_u8(0x3E))),
+                          vshrq_n_u8(rgba.val[3], 7));
+    out.val[1] = vorrq_u8(vandq_u8(rgba.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(rgba.val[1], 5));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + x), out);
+  }
+  return x;
+}
+
+static inline uint8x8_t luminance(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+  uint16x8_t sum = vmull_u8(r, vdup_n_u8(77));
+  sum = vmlal_u8(sum, g, vdup_n_u8(150));
+  sum = vmlal_u8(sum, b, vdup_n_u8(29));
+  return vshrn_n_u16(vaddq_u16(sum, vdupq_n_u16(128)), 8);
+}
+
+static uint32_t convertRowToLA88_simd(const uint8_t* src, int channels, uint8_t* dst, uint32_t width) {
+  uint32_t x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x4_t rgba = loadRGBA(src + x * channels, channels);
+    uint8x16x2_t out;
+    out.val[0] = vcombine_u8(
+        luminance(vget_low_u8(rgba.val[0]), vget_low_u8(rgba.val[1]), vget_low_u8(rgba.val[2])),
+        luminance(vget_high_u8(rgba.val[0]), vget_high_u8(rgba.val[1]), vget_high_u8(rgba.val[2])));
+    out.val[1] = rgba.val[3];
+    vst2q_u8(dst + x * 2, out);
+  }
+  return x;
+}
+
+#elif PIXEL_CONVERTER_SSE2
+
+/// @brief Loads 4 pixels as 32-bit RGBA lanes, alpha of RGB source is 255.
+static inline __m128i loadRGBA(const uint8_t* src, int channels) {
+  if (channels == 4) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  }
+  // 12 bytes exactly, so that the last pixel of image is not overread
+  int32_t tail;
+  std::memcpy(&tail, src + 8, sizeof(tail));
+  __m128i rgb = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)), _mm_cvtsi32_si128(tail));
+  __m128i p01 = _mm_unpacklo_epi32(rgb, _mm_srli_si128(rgb, 3));
+  __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(rgb, 6), _mm_srli_si128(rgb, 9));
+  return _mm_or_si128(_mm_unpacklo_epi64(p01, p23), _mm_set1_epi32(0xFF000000));
+}
+
+/// @brief (x + (x >> 8) + 1) >> 8 equals x / 255 for x = value * alpha + 127.
+static inline __m128i div255(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(127));
+  return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(1)), 8);
+}
+
+/// @brief Multiplies every channel, alpha included, by alpha.
+static inline __m128i premultiply(__m128i px) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i alpha = _mm_srli_epi32(px, 24);
+  alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+  alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+  __m128i lo = div255(_mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(alpha, zero)));
+  __m128i hi = div255(_mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(alpha, zero)));
+  return _mm_packus_epi16(lo, hi);
+}
+
+/// @brief Offsets of 4 pixels, as they lie in RGBA lanes.
+static inline __m128i pixelOffsets(const RowDither* dither) {
+  return dither != nullptr ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->offsets))
+                           : _mm_setzero_si128();
+}
+
+/// @brief Packs two vectors of 32-bit lanes holding 16-bit values.
+static inline __m128i pack(__m128i lo, __m128i hi) {
+  // sign-extend lower halves, so that signed saturating pack keeps all bits
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+static uint32_t convertRowToRGB565_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                        uint32_t width, bool premultiply_alpha, const RowDither* dither) {
+  const __m128i offsets = pixelOffsets(dither);
+  const __m128i mask_r = _mm_set1_epi32(0xF8);
+  const __m128i mask_g = _mm_set1_epi32(0xFC00);
+  const __m128i mask_b = _mm_set1_epi32(0xF80000);
+  uint32_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i converted[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i px = loadRGBA(src + (x + k * 4) * channels, channels);
+      if (premultiply_alpha) {
+        px = premultiply(px);
+      }
+      px = _mm_adds_epu8(px, offsets);
+      __m128i r = _mm_slli_epi32(_mm_and_si128(px, mask_r), 8);
+      __m128i g = _mm_srli_epi32(_mm_and_si128(px, mask_g), 5);
+      __m128i b = _mm_srli_epi32(_mm_and_si128(px, mask_b), 19);
+      converted[k] = _mm_or_si128(r, _mm_or_si128(g, b));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), pack(converted[0], converted[1]));
+  }
+  return x;
+}
+
+static uint32_t convertRowToRGBA4444_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                          uint32_t width, const RowDither* dither) {
+  const __m128i offsets = pixelOffsets(dither);
+  const __m128i mask_r = _mm_set1_epi32(0xF0);
+  const __m128i mask_g = _mm_set1_epi32(0xF000);
+  const __m128i mask_b = _mm_set1_epi32(0xF00000);
+  uint32_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i converted[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i px = _mm_adds_epu8(loadRGBA(src + (x + k * 4) * channels, channels), offsets);
+      __m128i r = _mm_slli_epi32(_mm_and_si128(px, mask_r), 8);
+      __m128i g = _mm_srli_epi32(_mm_and_si128(px, mask_g), 4);
+      __m128i b = _mm_srli_epi32(_mm_and_si128(px, mask_b), 16);
+      __m128i a = _mm_srli_epi32(px, 28);
+      converted[k] = _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), pack(converted[0], converted[1]));
+  }
+  return x;
+}
+
+static uint32_t convertRowToRGBA5551_simd(const uint8_t* src, int channels, uint16_t* dst,
+                                          uint32_t width, const RowDither* dither) {
+  const __m128i offsets = pixelOffsets(dither);
+  const __m128i mask_r = _mm_set1_epi32(0xF8);
+  const __m128i mask_g = _mm_set1_epi32(0xF800);
+  const __m128i mask_b = _mm_set1_epi32(0xF80000);
+  uint32_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i converted[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i px = _mm_adds_epu8(loadRGBA(src + (x + k * 4) * channels, channels), offsets);
+      __m128i r = _mm_slli_epi32(_mm_and_si128(px, mask_r), 8);
+      __m128i g = _mm_srli_epi32(_mm_and_si128(px, mask_g), 5);
+      __m128i b = _mm_srli_epi32(_mm_and_si128(px, mask_b), 18);
+      __m128i a = _mm_srli_epi32(px, 31);
+      converted[k] = _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), pack(converted[0], converted[1]));
+  }
+  return x;
+}
+
+static uint32_t convertRowToLA88_simd(const uint8_t* src, int channels, uint8_t* dst, uint32_t width) {
+  const __m128i mask = _mm_set1_epi32(0xFF);
+  uint32_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i converted[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i px = loadRGBA(src + (x + k * 4) * channels, channels);
+      // products fit in lower 16 bits of each lane, upper ones are zero
+      __m128i r = _mm_mullo_epi16(_mm_and_si128(px, mask), _mm_set1_epi32(77));
+      __m128i g = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(px, 8), mask), _mm_set1_epi32(150));
+      __m128i b = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(px, 16), mask), _mm_set1_epi32(29));
+      __m128i sum = _mm_add_epi32(_mm_add_epi32(r, g), _mm_add_epi32(b, _mm_set1_epi32(128)));
+      // little-endian: low byte is luminance, high byte is alpha
+      converted[k] = _mm_or_si128(_mm_srli_epi32(sum, 8), _mm_slli_epi32(_mm_srli_epi32(px, 24), 8));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), pack(converted[0], converted[1]));
+  }
+  return x;
+}
+
+#else
+
+static uint32_t convertRowToRGB565_simd(const uint8_t*, int, uint16_t*, uint32_t, bool, const RowDither*) {
+  return 0;
+}
+
+static uint32_t convertRowToRGBA4444_simd(const uint8_t*, int, uint16_t*, uint32_t, const RowDither*) {
+  return 0;
+}
+
+static uint32_t convertRowToRGBA5551_simd(const uint8_t*, int, uint16_t*, uint32_t, const RowDither*) {
+  return 0;
+}
+
+static uint32_t convertRowToLA88_simd(const uint8_t*, int, uint8_t*, uint32_t) {
+  return 0;
+}
+
+#endif
+
+/* Public */
+// ----------------------------------------------------------------------------
+void convertToRGB565(const uint8_t* src, int channels, uint16_t* dst,
+                     uint32_t width, uint32_t height, bool premultiply_alpha, bool use_dither) {
+  premultiply_alpha = premultiply_alpha && channels == 4;
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* row = src + (size_t) y * width * channels;
+    uint16_t* out = dst + (size_t) y * width;
+    RowDither row_dither(y, 5, 6, 5);
+    uint32_t x = convertRowToRGB565_simd(row, channels, out, width, premultiply_alpha, use_dither ? &row_dither : nullptr);
+    for (; x < width; ++x) {
+      const uint8_t* px = row + x * channels;
+      uint32_t r = px[0], g = px[1], b = px[2];
+      if (premultiply_alpha) {
+        r = premultiplied(r, px[3]);
+        g = premultiplied(g, px[3]);
+        b = premultiplied(b, px[3]);
+      }
+      if (use_dither) {
+        uint32_t threshold = bayer[y & 3][x & 3];
+        r = dither(r, threshold, 5);
+        g = dither(g, threshold, 6);
+        b = dither(b, threshold, 5);
+      }
+      out[x] = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+  }
+}
+
+void convertToRGBA4444(const uint8_t* src, int channels, uint16_t* dst,
+                       uint32_t width, uint32_t height, bool use_dither) {
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* row = src + (size_t) y * width * channels;
+    uint16_t* out = dst + (size_t) y * width;
+    RowDither row_dither(y, 4, 4, 4);
+    uint32_t x = convertRowToRGBA4444_simd(row, channels, out, width, use_dither ? &row_dither : nullptr);
+    for (; x < width; ++x) {
+      const uint8_t* px = row + x * channels;
+      uint32_t r = px[0], g = px[1], b = px[2];
+      uint32_t a = channels == 4 ? px[3] : 255;
+      if (use_dither) {
+        uint32_t threshold = bayer[y & 3][x & 3];
+        r = dither(r, threshold, 4);
+        g = dither(g, threshold, 4);
+        b = dither(b, threshold, 4);
+      }
+      out[x] = static_cast<uint16_t>(((r >> 4) << 12) | ((g >> 4) << 8) | ((b >> 4) << 4) | (a >> 4));
+    }
+  }
+}
+
+void convertToRGBA5551(const uint8_t* src, int channels, uint16_t* dst,
+                       uint32_t width, uint32_t height, bool use_dither) {
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* row = src + (size_t) y * width * channels;
+    uint16_t* out = dst + (size_t) y * width;
+    RowDither row_dither(y, 5, 5, 5);
+    uint32_t x = convertRowToRGBA5551_simd(row, channels, out, width, use_dither ? &row_dither : nullptr);
+    for (; x < width; ++x) {
+      const uint8_t* px = row + x * channels;
+      uint32_t r = px[0], g = px[1], b = px[2];
+      uint32_t a = channels == 4 ? px[3] : 255;
+      if (use_dither) {
+        uint32_t threshold = bayer[y & 3][x & 3];
+        r = dither(r, threshold, 5);
+        g = dither(g, threshold, 5);
+        b = dither(b, threshold, 5);
+      }
+      out[x] = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 3) << 6) | ((b >> 3) << 1) | (a >> 7));
+    }
+  }
+}
+
+void convertToLA88(const uint8_t* src, int channels, uint8_t* dst,
+                   uint32_t width, uint32_t height) {
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* row = src + (size_t) y * width * channels;
+    uint8_t* out = dst + (size_t) y * width * 2;
+    uint32_t x = convertRowToLA88_simd(row, channels, out, width);
+    for (; x < width; ++x) {
+      const uint8_t* px = row + x * channels;
+      out[x * 2 + 0] = static_cast<uint8_t>((px[0] * 77 + px[1] * 150 + px[2] * 29 + 128) >> 8);
+      out[x * 2 + 1] = channels == 4 ? px[3] : 255;
+    }
+  }
+}
+
+}  // namespace native
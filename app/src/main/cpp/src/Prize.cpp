@@ -1,5 +1,7 @@
 #include <chrono>
+#include "logger.h"
 #include "Prize.h"
+#include "Snapshot.h"
 
 namespace game {
 
@@ -26,4 +28,80 @@ Prize PrizeGenerator::generatePrize() {
   return static_cast<Prize>(value);
 }
 
+void PrizeGenerator::writeState(SnapshotWriter* writer) const {
+  writer->put(static_cast<int32_t>(m_bonus_prize));
+  writer->putRandom(m_generator);
+}
+
+bool PrizeGenerator::readState(SnapshotReader* reader) {
+  int32_t bonus_prize = 0;
+  if (!reader->get(&bonus_prize) || !reader->getRandom(&m_generator)) {
+    return false;
+  }
+  if (bonus_prize < 0 || bonus_prize > static_cast<int>(Prize::WIN)) {
+    ERR("Unknown bonus prize %i in snapshot", bonus_prize);
+    return false;
+  }
+  m_bonus_prize = static_cast<Prize>(bonus_prize);
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+const char* PrizeUtils::getPrizeTexture(Prize prize) {
+  switch (prize) {
+    case Prize::BLOCK:     return "pr_brick.png";
+    case Prize::CLIMB:     return "pr_earth.png";
+    case Prize::DESTROY:   return "pr_skull.png";
+    case Prize::DRAGON:    return "pr_egg.png";
+    case Prize::EASY:      return "pr_fire.png";
+    case Prize::EASY_T:    return "pr_fire_t.png";
+    case Prize::EVAPORATE: return "pr_waterdrop.png";
+    case Prize::EXPLODE:   return "pr_explode.png";
+    case Prize::EXTEND:    return "pr_extend.png";
+    case Prize::FAST:      return "pr_clock.png";
+    case Prize::FOG:       return "pr_fog.png";
+    case Prize::GOO:       return "pr_glue.png";
+    case Prize::HYPER:     return "pr_hyper.png";
+    case Prize::INIT:      return "pr_radar.png";
+    case Prize::JUMP:      return "pr_jump.png";
+    case Prize::LASER:     return "pr_laser.png";
+    case Prize::MIRROR:    return "pr_mirror.png";
+    case Prize::PIERCE:    return "pr_pierce.png";
+    case Prize::PROTECT:   return "pr_protect.png";
+    case Prize::RANDOM:    return "pr_dice.png";
+    case Prize::SHORT:     return "pr_short.png";
+    case Prize::SLOW:      return "pr_frozen_clock.png";
+    case Prize::UPGRADE:   return "pr_arrow.png";
+    case Prize::DEGRADE:   return "pr_down.png";
+    case Prize::VITALITY:  return "pr_ball.png";
+    case Prize::WIN:       return "pr_diamond.png";
+    case Prize::ZYGOTE:    return "pr_zygote.png";
+    case Prize::SCORE_1:   return "pr_candy.png";
+    case Prize::SCORE_2:   return "pr_coin.png";
+    case Prize::SCORE_3:   return "pr_star.png";
+    case Prize::SCORE_4:   return "pr_newyear.png";
+    case Prize::SCORE_5:   return "pr_butterfly.png";
+    default:
+    case Prize::NONE:  // NONE prize is ignored by GameProcessor
+      break;
+  }
+  return nullptr;
+}
+
+SoundGroup PrizeUtils::getPrizeSound(Prize prize) {
+  switch (prize) {
+    case Prize::DESTROY:   return SoundGroup::SKULL;
+    case Prize::HYPER:     return SoundGroup::HYPER;
+    case Prize::INIT:      return SoundGroup::INIT;
+    case Prize::PROTECT:   return SoundGroup::PROTECT;
+    case Prize::EXTEND:
+    case Prize::SHORT:     return SoundGroup::SHORT;
+    case Prize::VITALITY:  return SoundGroup::VITALITY;
+    case Prize::WIN:       return SoundGroup::WIN;
+    default:
+      break;
+  }
+  return SoundGroup::PRIZE;
+}
+
 }
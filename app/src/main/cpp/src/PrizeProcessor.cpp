@@ -8,6 +8,7 @@ namespace game {
 PrizeProcessor::PrizeProcessor(JavaVM* jvm)
   : m_jvm(jvm), m_jenv(nullptr)
   , master_object(nullptr)
+  , m_ui_state(nullptr)
   , m_aspect(1.0f)
   , m_bite()
   , m_bite_upper_border(-BiteParams::neg_biteElevation)
@@ -58,10 +59,15 @@ void PrizeProcessor::callback_biteMoved(Bite moved_bite) {
   interrupt();
 }
 
-void PrizeProcessor::callback_prizeReceived(PrizePackage package) {
+void PrizeProcessor::callback_blockChanged(BlockChangeBatch::Ptr batch) {
+  if (batch->prizes.empty()) {
+    return;
+  }
   std::lock_guard<std::mutex> lock(m_prize_mutex);
-  DBG("EVENT CALLBACK: callback_prizeReceived");
-  m_prize_packages[package.getID()] = package;
+  DBG("EVENT CALLBACK: callback_blockChanged(%zu)", batch->prizes.size());
+  for (auto& package : batch->prizes) {
+    m_prize_packages[package.getID()] = package;
+  }
   m_prize_received.store(true);
   interrupt();
 }
@@ -191,6 +197,51 @@ void PrizeProcessor::process_prizeHasGone() {
   m_removed_prizes.clear();
 }
 
+/* Snapshot group */
+// ----------------------------------------------------------------------------
+void PrizeProcessor::saveState(SnapshotWriter* writer) {
+  std::lock_guard<std::mutex> lock(m_prize_mutex);
+  std::lock_guard<std::mutex> location_lock(m_prize_location_mutex);
+  std::lock_guard<std::mutex> gone_lock(m_prize_gone_mutex);
+  std::vector<const PrizePackage*> falling;
+  falling.reserve(m_prize_packages.size());
+  for (auto& item : m_prize_packages) {
+    if (!item.second.hasGone() && !item.second.hasCaught() &&
+        m_removed_prizes.find(item.first) == m_removed_prizes.end()) {
+      falling.push_back(&item.second);
+    }
+  }
+
+  writer->beginSection(SnapshotSection::PRIZES);
+  writer->put(static_cast<uint32_t>(falling.size()));
+  for (auto package : falling) {
+    writer->put(package->getX());
+    writer->put(package->getY());
+    writer->put(static_cast<int32_t>(package->getPrize()));
+  }
+  writer->endSection();
+}
+
+bool PrizeProcessor::readState(SnapshotReader* reader, std::vector<PrizePackage>* prizes) {
+  uint32_t count = 0;
+  if (!reader->get(&count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    GLfloat x = 0.0f, y = 0.0f;
+    int32_t prize = 0;
+    if (!reader->get(&x) || !reader->get(&y) || !reader->get(&prize)) {
+      return false;
+    }
+    if (prize < 0 || prize > static_cast<int>(Prize::WIN)) {
+      ERR("Unknown prize %i in snapshot", prize);
+      return false;
+    }
+    prizes->emplace_back(x, y, static_cast<Prize>(prize));
+  }
+  return true;
+}
+
 /* LogicFunc group */
 // ----------------------------------------------------------------------------
 void PrizeProcessor::addPrizeToRemoved(int prize_id) {
@@ -210,7 +261,9 @@ void PrizeProcessor::onPrizeCatch(int prize_id) {
   if (it != m_prize_packages.end()) {
     prize = static_cast<int>(m_prize_packages.at(prize_id).getPrize());
   }
-  m_jenv->CallVoidMethod(master_object, fireJavaEvent_prizeCatch_id, prize);
+  if (m_ui_state != nullptr) {
+    m_ui_state->pushPrize(prize);
+  }
 }
 
 }
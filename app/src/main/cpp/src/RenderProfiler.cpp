@@ -0,0 +1,98 @@
+#include <algorithm>
+
+#include "logger.h"
+#include "RenderProfiler.h"
+
+namespace util {
+
+static const char* stageNames[RenderProfiler::totalStages] = {
+  "static layer",
+  "bite & ball",
+  "explosion",
+  "sprites",
+  "swap"
+};
+
+RenderProfiler::RenderProfiler(int report_interval)
+  : m_report_interval(report_interval)
+  , m_stage_draw_calls(0) {
+  for (int i = 0; i < totalStages; ++i) {
+    m_stage_time[i] = 0.0;
+    m_draw_calls[i] = 0;
+  }
+  if (enabled) {
+    m_frame_times.reserve(m_report_interval);
+    m_input_latencies.reserve(m_report_interval);
+  }
+}
+
+RenderProfiler::~RenderProfiler() noexcept {
+}
+
+void RenderProfiler::endFrame() {
+  if (!enabled) return;
+  auto now = std::chrono::steady_clock::now();
+  m_frame_times.push_back(std::chrono::duration<float, std::milli>(now - m_frame_start).count());
+  if (m_report_interval > 0 && m_frame_times.size() >= static_cast<size_t>(m_report_interval)) {
+    report();
+  }
+}
+
+bool RenderProfiler::takeProfile(Profile* profile) {
+  size_t frames = m_frame_times.size();
+  if (frames == 0) {
+    return false;
+  }
+  std::sort(m_frame_times.begin(), m_frame_times.end());
+  profile->frames = frames;
+  profile->p50 = m_frame_times[frames * 50 / 100];
+  profile->p90 = m_frame_times[frames * 90 / 100];
+  profile->p99 = m_frame_times[frames * 99 / 100];
+  profile->max = m_frame_times[frames - 1];
+  profile->total_draw_calls = 0.0;
+  for (int i = 0; i < totalStages; ++i) {
+    profile->stage_time[i] = m_stage_time[i] / frames;
+    profile->draw_calls[i] = (double) m_draw_calls[i] / frames;
+    profile->total_draw_calls += profile->draw_calls[i];
+    m_stage_time[i] = 0.0;
+    m_draw_calls[i] = 0;
+  }
+  m_frame_times.clear();
+
+  size_t samples = m_input_latencies.size();
+  profile->latency_samples = samples;
+  profile->latency_p50 = profile->latency_p90 = profile->latency_max = 0.0f;
+  if (samples > 0) {
+    std::sort(m_input_latencies.begin(), m_input_latencies.end());
+    profile->latency_p50 = m_input_latencies[samples * 50 / 100];
+    profile->latency_p90 = m_input_latencies[samples * 90 / 100];
+    profile->latency_max = m_input_latencies[samples - 1];
+    m_input_latencies.clear();
+  }
+  return true;
+}
+
+const char* RenderProfiler::getStageName(RenderStage stage) {
+  return stageNames[static_cast<int>(stage)];
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void RenderProfiler::report() {
+  Profile profile;
+  if (!takeProfile(&profile)) {
+    return;
+  }
+  INF("Render profile over %zu frames: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms, %.1f draw calls per frame",
+      profile.frames, profile.p50, profile.p90, profile.p99, profile.max, profile.total_draw_calls);
+  for (int i = 0; i < totalStages; ++i) {
+    INF("  %-12s: %.3f ms, %.1f draw calls per frame",
+        getStageName(static_cast<RenderStage>(i)), profile.stage_time[i], profile.draw_calls[i]);
+  }
+  if (profile.latency_samples > 0) {
+    INF("  touch-to-bite latency over %zu batches: p50 %.3f ms, p90 %.3f ms, max %.3f ms",
+        profile.latency_samples, profile.latency_p50, profile.latency_p90, profile.latency_max);
+  }
+}
+
+}
@@ -0,0 +1,900 @@
+#include <algorithm>
+
+#include <GLES2/gl2.h>
+
+#include "logger.h"
+#include "Macro.h"
+#include "Params.h"
+#include "Renderer.h"
+#include "utils.h"
+
+namespace game {
+
+/* Public API */
+// ----------------------------------------------------------------------------
+Renderer::Renderer(int report_interval)
+  : m_width(0), m_height(0)
+  , m_aspect(1.0f)
+  , m_is_ready(false)
+  , m_bite_vertex_buffer(new GLfloat[8])
+  , m_bite_color_buffer(new GLubyte[16])
+  , m_ball_vertex_buffer(new GLfloat[18])
+  , m_ball_color_buffer(new GLubyte[36])
+  , m_bg_vertex_buffer(new GLfloat[8]{-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f})
+  , m_particle_spiral_buffer(new GLfloat[particleSpiralSize * particleSpiralSystemSize])
+  , m_rectangle_index_buffer(new GLushort[6]{0, 3, 2, 0, 1, 3})
+  , m_octagon_index_buffer(new GLushort[24]{0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 7, 0, 7, 8, 0, 8, 1})
+  , m_rectangle_texCoord_buffer(new GLfloat[8]{1.f, 1.f, 0.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+  , m_static_layer_texCoord_buffer(new GLfloat[8]{0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f})
+  , m_level(nullptr)
+  , m_level_vertex_vbo(0)
+  , m_level_color_vbo(0)
+  , m_particle_vbo(0)
+  , m_static_layer_fbo(0)
+  , m_static_layer_texture(0)
+  , m_static_layer_valid(false)
+  , m_frame_arena(4096)
+  , m_profiler(report_interval)
+  , m_particle_system()
+  , m_level_shader(nullptr)
+  , m_bite_shader(nullptr)
+  , m_ball_shader(nullptr)
+  , m_explosion_shader(nullptr)
+  , m_sample_shader(nullptr)
+  , m_prize_shader(nullptr)
+  , m_prize_catch_shader(nullptr)
+  , m_laser_shader(nullptr)
+  , m_bg_texture(nullptr)
+  , m_smoke_texture(nullptr)
+  , m_spark_texture(nullptr)
+  , m_laser_texture(nullptr) {
+  std::fill(m_block_textures, m_block_textures + BlockUtils::totalBlocks, nullptr);
+  std::fill(m_prize_textures, m_prize_textures + PrizeUtils::totalPrizes + 1, nullptr);
+  setBiteBallAppearance(BallEffect::NONE);
+  initParticleSystem();
+}
+
+Renderer::~Renderer() noexcept {
+  delete [] m_bite_vertex_buffer; m_bite_vertex_buffer = nullptr;
+  delete [] m_bite_color_buffer; m_bite_color_buffer = nullptr;
+  delete [] m_ball_vertex_buffer; m_ball_vertex_buffer = nullptr;
+  delete [] m_ball_color_buffer; m_ball_color_buffer = nullptr;
+  delete [] m_bg_vertex_buffer; m_bg_vertex_buffer = nullptr;
+  delete [] m_particle_spiral_buffer; m_particle_spiral_buffer = nullptr;
+  delete [] m_rectangle_index_buffer; m_rectangle_index_buffer = nullptr;
+  delete [] m_octagon_index_buffer; m_octagon_index_buffer = nullptr;
+  delete [] m_rectangle_texCoord_buffer; m_rectangle_texCoord_buffer = nullptr;
+  delete [] m_static_layer_texCoord_buffer; m_static_layer_texCoord_buffer = nullptr;
+  m_level = nullptr;
+}
+
+/* Context group */
+// ----------------------------------------------------------------------------
+void Renderer::init(GLint width, GLint height) {
+  m_width = width;
+  m_height = height;
+  m_aspect = (GLfloat) width / height;
+
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glViewport(-4, -4, m_width + 4, m_height + 4);
+
+  m_level_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
+  m_bite_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
+  m_ball_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleShader());
+  m_explosion_shader = std::make_shared<shader::ShaderHelper>(shader::ParticleSystemShader());
+  m_sample_shader = std::make_shared<shader::ShaderHelper>(shader::SimpleTextureShader());
+  m_prize_shader = std::make_shared<shader::ShaderHelper>(shader::VerticalFallShader());
+  m_prize_catch_shader = std::make_shared<shader::ShaderHelper>(shader::ParticleMoveShader());
+  m_laser_shader = std::make_shared<shader::ShaderHelper>(shader::VerticalClimbShader());
+  m_is_ready = true;
+
+  uploadLevelBuffers();  // buffer objects of previous context are gone
+  initStaticLayer();
+  m_particle_system.setAspect(m_aspect);
+}
+
+void Renderer::release() {
+  if (m_level_vertex_vbo != 0) {
+    glDeleteBuffers(1, &m_level_vertex_vbo);
+    glDeleteBuffers(1, &m_level_color_vbo);
+  }
+  if (m_particle_vbo != 0) {
+    glDeleteBuffers(1, &m_particle_vbo);
+  }
+  if (m_static_layer_fbo != 0) {
+    glDeleteFramebuffers(1, &m_static_layer_fbo);
+    glDeleteTextures(1, &m_static_layer_texture);
+  }
+  m_level_vertex_vbo = 0;
+  m_level_color_vbo = 0;
+  m_particle_vbo = 0;
+  m_static_layer_fbo = 0;
+  m_static_layer_texture = 0;
+  m_static_layer_valid = false;
+  m_is_ready = false;
+}
+
+/* Scene group */
+// ----------------------------------------------------------------------------
+void Renderer::setTextures(const Resources* resources) {
+#if USE_TEXTURE
+  for (int i = 0; i < BlockUtils::totalBlocks; ++i) {
+    const char* texture = BlockUtils::getBlockTexture(static_cast<Block>(i));
+    m_block_textures[i] = texture == nullptr ? nullptr : resources->getTexture(texture);
+  }
+#endif
+  for (int i = 0; i <= PrizeUtils::totalPrizes; ++i) {
+    m_prize_textures[i] = resources->getPrizeTexture(static_cast<Prize>(i));
+  }
+  m_smoke_texture = resources->getTexture("smoke.png");
+  m_spark_texture = resources->getTexture("spark.png");
+  m_laser_texture = resources->getTexture("ef_laser.png");
+  invalidateStaticLayer();
+}
+
+void Renderer::setBackground(const native::Texture* background) {
+  m_bg_texture = background;
+  invalidateStaticLayer();
+}
+
+void Renderer::setLevel(Level::Ptr level, PreparedLevel* prepared) {
+  m_level = level;
+  m_level_vertex_buffer.swap(prepared->vertices);
+  m_level_color_buffer.swap(prepared->colors);
+  m_level_index_buffer.swap(prepared->indices);
+  uploadLevelBuffers();
+  invalidateStaticLayer();
+}
+
+void Renderer::changeLevel(Level::Ptr snapshot, const std::vector<RowCol>& changes) {
+  m_level = snapshot;
+  for (auto& cell : changes) {
+    if (cell.row < 0 || cell.row >= m_level->numRows() || cell.col < 0 || cell.col >= m_level->numCols()) {
+      WRN("Changed block is absent in level!");
+      continue;
+    }
+    m_level->fillColorArrayAtBlock(&m_level_color_buffer[0], cell.row, cell.col);
+    updateLevelColorBuffer(cell.row, cell.col);
+  }
+  invalidateStaticLayer();
+}
+
+void Renderer::setBitePose(const Bite& bite, GLfloat x) {
+  util::setRectangleVertices(
+      &m_bite_vertex_buffer[0],
+      bite.getDimens().width(), bite.getDimens().height(),
+      -bite.getDimens().halfWidth() + x,
+      -BiteParams::neg_biteElevation,
+      1, 1);
+}
+
+void Renderer::setBallPose(const Ball& ball, GLfloat x, GLfloat y) {
+  util::setOctagonVertices(
+      &m_ball_vertex_buffer[0],
+      ball.getDimens().width(), ball.getDimens().height(),
+      -ball.getDimens().halfWidth() + x,
+      ball.getDimens().halfHeight() + y,
+      1, 1);
+}
+
+void Renderer::setBiteBallAppearance(BallEffect effect) {
+  switch (effect) {
+    default:
+    case BallEffect::NONE:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
+      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
+      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::EASY:
+    case BallEffect::EASY_T:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::YELLOW, &m_ball_color_buffer[0], 4);
+      util::setColor(util::TITAN, &m_ball_color_buffer[4], 16);
+      util::setColor(util::MIDAS, &m_ball_color_buffer[20], 4);
+      util::setColor(util::MIDAS_EDGE, &m_ball_color_buffer[24], 12);
+      util::setColor(util::TITAN_EDGE, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::EXPLODE:
+    case BallEffect::JUMP:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::WATER_EDGE, &m_ball_color_buffer[0], 4);
+      util::setColor(util::WATER, &m_ball_color_buffer[4], 16);
+      util::setColor(util::ULTRA, &m_ball_color_buffer[20], 4);
+      util::setColor(util::ULTRA_EDGE, &m_ball_color_buffer[24], 12);
+      util::setColor(util::MAGENTA, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::GOO:
+      // bite
+      util::setColor(util::ZYGOTE_SPAWN, &m_bite_color_buffer[0], 8);
+      util::setColor(util::ZYGOTE_SPAWN_EDGE, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::GREEN, &m_ball_color_buffer[0], 4);
+      util::setColor(util::ZYGOTE_SPAWN, &m_ball_color_buffer[4], 16);
+      util::setColor(util::NETWORK, &m_ball_color_buffer[20], 4);
+      util::setColor(util::ZYGOTE_EDGE, &m_ball_color_buffer[24], 12);
+      util::setColor(util::NETWORK, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::PIERCE:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::BLACK, &m_ball_color_buffer[0], 4);
+      util::setColor(util::DESTROY, &m_ball_color_buffer[4], 16);
+      util::setColor(util::KNOCK_EDGE, &m_ball_color_buffer[20], 4);
+      util::setColor(util::ROLLING, &m_ball_color_buffer[24], 12);
+      util::setColor(util::ROLLING_EDGE, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::MIRROR:
+      // bite
+      util::setColor(util::MIRROR, &m_bite_color_buffer[0], 8);
+      util::setColor(util::MIRROR_EDGE, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
+      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
+      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::PROTECT:
+      // bite
+      util::setColor(util::TITAN, &m_bite_color_buffer[0], 8);
+      util::setColor(util::TITAN_EDGE, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
+      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
+      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::RANDOM:
+      // bite
+      util::setColor(util::MAGENTA, &m_bite_color_buffer[0], 8);
+      util::setColor(util::PURPLE, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::ORANGE, &m_ball_color_buffer[0], 4);
+      util::setColor(util::SIENNA_LIGHT, &m_ball_color_buffer[4], 16);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[20], 4);
+      util::setColor(util::SIENNA_DARK, &m_ball_color_buffer[24], 12);
+      util::setColor(util::SIENNA, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::UPGRADE:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::GREEN, &m_ball_color_buffer[0], 4);
+      util::setColor(util::ZYGOTE_SPAWN, &m_ball_color_buffer[4], 16);
+      util::setColor(util::NETWORK, &m_ball_color_buffer[20], 4);
+      util::setColor(util::ZYGOTE_EDGE, &m_ball_color_buffer[24], 12);
+      util::setColor(util::NETWORK, &m_ball_color_buffer[32], 4);
+      break;
+    case BallEffect::DEGRADE:
+      // bite
+      util::setColor(util::SALMON, &m_bite_color_buffer[0], 8);
+      util::setColor(util::SIENNA_DARK, &m_bite_color_buffer[8], 8);
+      // ball
+      util::setColor(util::RED, &m_ball_color_buffer[0], 4);
+      util::setColor(util::ORIGIN, &m_ball_color_buffer[4], 16);
+      util::setColor(util::BRICK, &m_ball_color_buffer[20], 4);
+      util::setColor(util::DESTROY_EDGE, &m_ball_color_buffer[24], 12);
+      util::setColor(util::BRICK, &m_ball_color_buffer[32], 4);
+      break;
+//    case BallEffect::ZYGOTE:
+//      TODO ZYGOTE
+//      break;
+  }
+}
+
+void Renderer::spawnExplosion(const ExplosionPackage& package) {
+  m_particle_system.spawn(package);
+}
+
+/* Drawings group */
+// ----------------------------------------------------------------------------
+void Renderer::beginFrame() {
+  m_profiler.beginFrame();
+}
+
+void Renderer::endFrame() {
+  m_profiler.endFrame();
+  m_frame_arena.reset();
+}
+
+void Renderer::drawStaticLayer() {
+  if (m_static_layer_fbo == 0) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawStaticLayerDirect();  // no offscreen cache available, draw directly
+    return;
+  }
+  if (!m_static_layer_valid) {
+    renderStaticLayer();
+  }
+  drawStaticLayerCache();
+}
+
+void Renderer::drawLevel() {
+  m_level_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_position");
+  GLuint a_color = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_color");
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_color);
+
+  glDrawElements(GL_TRIANGLES, m_level->size() * 6, GL_UNSIGNED_SHORT, &m_level_index_buffer[0]);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_color);
+}
+
+void Renderer::drawBlock(int row, int col) {
+  m_level_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_position");
+  GLuint a_color = (GLuint) glGetAttribLocation(m_level_shader->getProgram(), "a_color");
+
+  int block = col + row * m_level->numCols();
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<const GLvoid*>(block * 8 * sizeof(GLfloat)));
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, reinterpret_cast<const GLvoid*>(block * 16 * sizeof(GLubyte)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_color);
+
+  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_color);
+}
+
+void Renderer::drawTexturedBlock(int row, int col, const native::Texture* texture) {
+  m_sample_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
+  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
+
+  int block = col + row * m_level->numCols();
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<const GLvoid*>(block * 8 * sizeof(GLfloat)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+
+  texture->apply();
+  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_texCoord);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_texCoord);
+}
+
+void Renderer::drawBite() {
+  m_bite_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_bite_shader->getProgram(), "a_position");
+  GLuint a_color = (GLuint) glGetAttribLocation(m_bite_shader->getProgram(), "a_color");
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &m_bite_vertex_buffer[0]);
+  glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, &m_bite_color_buffer[0]);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_color);
+  glDisable(GL_BLEND);
+
+  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_color);
+}
+
+void Renderer::drawBall() {
+  m_ball_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_ball_shader->getProgram(), "a_position");
+  GLuint a_color = (GLuint) glGetAttribLocation(m_ball_shader->getProgram(), "a_color");
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &m_ball_vertex_buffer[0]);
+  glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, &m_ball_color_buffer[0]);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_color);
+  glDisable(GL_BLEND);
+
+  glDrawElements(GL_TRIANGLES, 24, GL_UNSIGNED_SHORT, &m_octagon_index_buffer[0]);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_color);
+}
+
+void Renderer::drawExplosion() {
+  if (m_particle_system.empty()) {
+    return;
+  }
+  m_particle_system.update();
+  if (m_particle_system.empty()) {
+    return;
+  }
+
+  m_explosion_shader->useProgram();
+
+  GLint u_time = glGetUniformLocation(m_explosion_shader->getProgram(), "u_time");
+  GLint u_duration = glGetUniformLocation(m_explosion_shader->getProgram(), "u_duration");
+  glUniform1f(u_time, m_particle_system.getTime());
+  glUniform1f(u_duration, ParticleSystem::emitterDuration);
+
+  GLuint a_lifetime = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_lifetime");
+  GLuint a_startPosition = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_startPosition");
+  GLuint a_endPosition = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_endPosition");
+  GLuint a_centerPosition = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_centerPosition");
+  GLuint a_startTime = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_startTime");
+  GLuint a_color = (GLuint) glGetAttribLocation(m_explosion_shader->getProgram(), "a_color");
+
+  {
+    GLsizei stride = ParticleSystem::vertexSize * sizeof(GLfloat);
+    if (m_particle_vbo == 0) {
+      glGenBuffers(1, &m_particle_vbo);
+      glBindBuffer(GL_ARRAY_BUFFER, m_particle_vbo);
+      glBufferData(GL_ARRAY_BUFFER, ParticleSystem::getCapacity() * stride, nullptr, GL_DYNAMIC_DRAW);
+      m_particle_system.markDirty();  // live slots are lost along with previous buffer
+    } else {
+      glBindBuffer(GL_ARRAY_BUFFER, m_particle_vbo);
+    }
+    // only slots of freshly spawned emitters are transferred
+    if (m_particle_system.isDirty()) {
+      int offset = m_particle_system.getDirtyVertexOffset();
+      glBufferSubData(GL_ARRAY_BUFFER, offset * stride, m_particle_system.getDirtyVertexCount() * stride,
+                      &m_particle_system.getVertexBuffer()[offset * ParticleSystem::vertexSize]);
+      m_particle_system.markClean();
+    }
+    glVertexAttribPointer(a_lifetime, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::lifetimeOffset * sizeof(GLfloat)));
+    glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::startOffset * sizeof(GLfloat)));
+    glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::endOffset * sizeof(GLfloat)));
+    glVertexAttribPointer(a_centerPosition, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::centerOffset * sizeof(GLfloat)));
+    glVertexAttribPointer(a_startTime, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::startTimeOffset * sizeof(GLfloat)));
+    glVertexAttribPointer(a_color, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(ParticleSystem::colorOffset * sizeof(GLfloat)));
+  }
+
+  m_smoke_texture->apply();
+  GLint sampler = glGetUniformLocation(m_explosion_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_lifetime);
+  glEnableVertexAttribArray(a_startPosition);
+  glEnableVertexAttribArray(a_endPosition);
+  glEnableVertexAttribArray(a_centerPosition);
+  glEnableVertexAttribArray(a_startTime);
+  glEnableVertexAttribArray(a_color);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+  glDrawArrays(GL_POINTS, 0, m_particle_system.getVertexCount());
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_lifetime);
+  glDisableVertexAttribArray(a_startPosition);
+  glDisableVertexAttribArray(a_endPosition);
+  glDisableVertexAttribArray(a_centerPosition);
+  glDisableVertexAttribArray(a_startTime);
+  glDisableVertexAttribArray(a_color);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::drawStaticLayerDirect() {
+  if (m_bg_texture != nullptr) {
+    drawBackground();
+  }
+  if (m_level == nullptr) {
+    return;  // no level has been loaded yet
+  }
+
+  for (int r = 0; r < m_level->numRows(); ++r) {
+    for (int c = 0; c < m_level->numCols(); ++c) {
+      auto block = m_level->getBlock(r, c);
+      switch (block) {
+        case Block::NONE:
+          glEnable(GL_BLEND);
+          break;
+        default:
+          glDisable(GL_BLEND);
+          break;
+      }
+#if USE_TEXTURE
+      auto texture = m_block_textures[static_cast<int>(block)];
+      if (texture == nullptr) {
+        drawBlock(r, c);
+      } else {
+        drawTexturedBlock(r, c, texture);
+      }
+#else
+      drawBlock(r, c);
+#endif
+    }
+  }
+}
+
+void Renderer::drawStaticLayerCache() {
+  m_sample_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
+  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &m_bg_vertex_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_static_layer_texCoord_buffer[0]);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_static_layer_texture);
+  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_texCoord);
+  glDisable(GL_BLEND);
+
+  // cached layer covers whole surface, so neither clear nor blend are needed,
+  // but texels must map 1:1 to pixels, unlike regular viewport
+  glViewport(0, 0, m_width, m_height);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  m_profiler.onDrawCall();
+  glViewport(-4, -4, m_width + 4, m_height + 4);
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_texCoord);
+}
+
+void Renderer::drawBackground() {
+  m_sample_shader->useProgram();
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
+  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &m_bg_vertex_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+
+  m_bg_texture->apply();
+  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_texCoord);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_texCoord);
+}
+
+void Renderer::drawPrize(const PrizePackage& prize, float time, bool is_visible) {
+  m_prize_shader->useProgram();
+
+  GLint u_time = glGetUniformLocation(m_prize_shader->getProgram(), "u_time");
+  GLint u_velocity = glGetUniformLocation(m_prize_shader->getProgram(), "u_velocity");
+  GLint u_visible = glGetUniformLocation(m_prize_shader->getProgram(), "u_visible");
+  glUniform1f(u_time, time);
+  glUniform1f(u_velocity, PrizeParams::prizeSpeed);
+  glUniform1i(u_visible, is_visible ? 1 : 0);
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_prize_shader->getProgram(), "a_position");
+  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_prize_shader->getProgram(), "a_texCoord");
+
+  GLfloat* prize_vertices = m_frame_arena.allocate<GLfloat>(8);
+  util::setRectangleVertices(
+      prize_vertices,
+      PrizeParams::prizeWidth,
+      PrizeParams::prizeHeight * m_aspect,
+      prize.getX() - PrizeParams::prizeHalfWidth,
+      prize.getY() - PrizeParams::prizeHalfHeight,
+      1, 1);
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &prize_vertices[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+
+  m_prize_textures[static_cast<int>(prize.getPrize())]->apply();
+  GLint sampler = glGetUniformLocation(m_prize_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_texCoord);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_texCoord);
+}
+
+void Renderer::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, float time) {
+  m_prize_catch_shader->useProgram();
+
+  GLint u_time = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_time");
+  GLint u_centerPosition = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_centerPosition");
+  GLint u_color = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_color");
+
+  GLfloat* coord = m_frame_arena.allocate<GLfloat>(2);
+  coord[0] = x;  coord[1] = y;
+  GLfloat* color = m_frame_arena.allocate<GLfloat>(4);
+  color[0] = bgra.b;  color[1] = bgra.g;  color[2] = bgra.r;  color[3] = 0.5f;
+  glUniform2fv(u_centerPosition, 1, &coord[0]);
+  glUniform4fv(u_color, 1, &color[0]);
+  glUniform1f(u_time, time);
+
+  GLuint a_startPosition = (GLuint) glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_startPosition");
+  GLuint a_endPosition = (GLuint) glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_endPosition");
+
+  glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[2]);
+  glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[0]);
+
+  m_spark_texture->apply();
+  GLint sampler = glGetUniformLocation(m_prize_catch_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_startPosition);
+  glEnableVertexAttribArray(a_endPosition);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+  glDrawArrays(GL_POINTS, 0, particleSpiralSystemSize);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_startPosition);
+  glDisableVertexAttribArray(a_endPosition);
+}
+
+void Renderer::drawLaser(GLfloat x, GLfloat y, float time, bool is_visible) {
+  m_laser_shader->useProgram();
+
+  GLint u_time = glGetUniformLocation(m_laser_shader->getProgram(), "u_time");
+  GLint u_velocity = glGetUniformLocation(m_laser_shader->getProgram(), "u_velocity");
+  GLint u_visible = glGetUniformLocation(m_laser_shader->getProgram(), "u_visible");
+  glUniform1f(u_time, time);
+  glUniform1f(u_velocity, LaserParams::laserSpeed);
+  glUniform1i(u_visible, is_visible ? 1 : 0);
+
+  GLuint a_position = (GLuint) glGetAttribLocation(m_laser_shader->getProgram(), "a_position");
+  GLuint a_texCoord = (GLuint) glGetAttribLocation(m_laser_shader->getProgram(), "a_texCoord");
+
+  GLfloat* laser_vertices = m_frame_arena.allocate<GLfloat>(8);
+  util::setRectangleVertices(
+      laser_vertices,
+      LaserParams::laserWidth,
+      LaserParams::laserHeight * m_aspect,
+      x - LaserParams::laserHalfWidth,
+      y - LaserParams::laserHalfHeight,
+      1, 1);
+
+  glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, &laser_vertices[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+
+  m_laser_texture->apply();
+  GLint sampler = glGetUniformLocation(m_laser_shader->getProgram(), "s_texture");
+  glUniform1i(sampler, 0);
+
+  glEnableVertexAttribArray(a_position);
+  glEnableVertexAttribArray(a_texCoord);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  m_profiler.onDrawCall();
+
+  glDisableVertexAttribArray(a_position);
+  glDisableVertexAttribArray(a_texCoord);
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void Renderer::initParticleSystem() {
+  GLfloat step = 0.001f;
+  GLfloat halfStep = 0.5f * step;
+  // branch 0
+  {
+    int bi = 0 * particleSpiralSize * particleSpiralSystemBranchSize;
+    int i = 0;
+    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
+      int index = i * particleSpiralSize;
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = -halfStep * i;
+      m_particle_spiral_buffer[index + 3 + bi] = step * i;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = step * i;
+      m_particle_spiral_buffer[index + 1 + bi] = halfStep * i;
+    }
+    GLfloat offset = 0;//-halfStep * (i - 1);
+    for (; i < particleSpiralSystemBranchSize; ++i) {
+      int index = i * particleSpiralSize;
+      int j = i - (particleSpiralSystemBranchSize >> 1);
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = offset + halfStep * j;
+      m_particle_spiral_buffer[index + 3 + bi] = step * j;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = step * j;
+      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * j;
+    }
+  }
+  // branch 1
+  {
+    int bi = 1 * particleSpiralSize * particleSpiralSystemBranchSize;
+    int i = 0;
+    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
+      int index = i * particleSpiralSize;
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = step * i;
+      m_particle_spiral_buffer[index + 3 + bi] = halfStep * i;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = halfStep * i;
+      m_particle_spiral_buffer[index + 1 + bi] = -step * i;
+    }
+    GLfloat offset = 0;//halfStep * (i - 1);
+    for (; i < particleSpiralSystemBranchSize; ++i) {
+      int index = i * particleSpiralSize;
+      int j = i - (particleSpiralSystemBranchSize >> 1);
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = step * j;
+      m_particle_spiral_buffer[index + 3 + bi] = offset - halfStep * j;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * j;
+      m_particle_spiral_buffer[index + 1 + bi] = -step * j;
+    }
+  }
+  // branch 2
+  {
+    int bi = 2 * particleSpiralSize * particleSpiralSystemBranchSize;
+    int i = 0;
+    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
+      int index = i * particleSpiralSize;
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = halfStep * i;
+      m_particle_spiral_buffer[index + 3 + bi] = -step * i;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = -step * i;
+      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * i;
+    }
+    GLfloat offset = 0;//halfStep * (i - 1);
+    for (; i < particleSpiralSystemBranchSize; ++i) {
+      int index = i * particleSpiralSize;
+      int j = i - (particleSpiralSystemBranchSize >> 1);
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = offset - halfStep * j;
+      m_particle_spiral_buffer[index + 3 + bi] = -step * j;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = -step * j;
+      m_particle_spiral_buffer[index + 1 + bi] = halfStep * j;
+    }
+  }
+  // branch 3
+  {
+    int bi = 3 * particleSpiralSize * particleSpiralSystemBranchSize;
+    int i = 0;
+    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
+      int index = i * particleSpiralSize;
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = -step * i;
+      m_particle_spiral_buffer[index + 3 + bi] = -halfStep * i;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * i;
+      m_particle_spiral_buffer[index + 1 + bi] = step * i;
+    }
+    GLfloat offset = 0;//-halfStep * (i - 1);
+    for (; i < particleSpiralSystemBranchSize; ++i) {
+      int index = i * particleSpiralSize;
+      int j = i - (particleSpiralSystemBranchSize >> 1);
+      // Start position of particle
+      m_particle_spiral_buffer[index + 2 + bi] = -step * j;
+      m_particle_spiral_buffer[index + 3 + bi] = offset + halfStep * j;
+      // End position of particle
+      m_particle_spiral_buffer[index + 0 + bi] = halfStep * j;
+      m_particle_spiral_buffer[index + 1 + bi] = step * j;
+    }
+  }
+}
+
+void Renderer::uploadLevelBuffers() {
+  if (!m_is_ready || m_level_vertex_buffer.empty()) {
+    return;  // will be uploaded as soon as both context and level are ready
+  }
+  if (m_level_vertex_vbo == 0) {
+    glGenBuffers(1, &m_level_vertex_vbo);
+    glGenBuffers(1, &m_level_color_vbo);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glBufferData(GL_ARRAY_BUFFER, m_level->size() * 8 * sizeof(GLfloat), &m_level_vertex_buffer[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glBufferData(GL_ARRAY_BUFFER, m_level->size() * 16 * sizeof(GLubyte), &m_level_color_buffer[0], GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::updateLevelColorBuffer(int row, int col) {
+  if (m_level_color_vbo == 0) {
+    return;
+  }
+  int offset = (col + row * m_level->numCols()) * 16;
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(GLubyte), 16 * sizeof(GLubyte), &m_level_color_buffer[offset]);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::initStaticLayer() {
+  m_static_layer_valid = false;
+
+  glGenTextures(1, &m_static_layer_texture);
+  glBindTexture(GL_TEXTURE_2D, m_static_layer_texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_width, m_height, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glGenFramebuffers(1, &m_static_layer_fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_static_layer_fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_static_layer_texture, 0);
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    WRN("Static layer framebuffer is incomplete: 0x%x, fallback to direct drawing", status);
+    glDeleteFramebuffers(1, &m_static_layer_fbo);
+    glDeleteTextures(1, &m_static_layer_texture);
+    m_static_layer_fbo = 0;
+    m_static_layer_texture = 0;
+  }
+}
+
+void Renderer::renderStaticLayer() {
+  glBindFramebuffer(GL_FRAMEBUFFER, m_static_layer_fbo);
+  glClear(GL_COLOR_BUFFER_BIT);
+  drawStaticLayerDirect();
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  m_static_layer_valid = true;
+}
+
+}  // namespace game
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "logger.h"
 #include "Resources.h"
 
@@ -10,16 +12,10 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_init
   return descriptor;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readTexture
-  (JNIEnv *, jobject, jlong descriptor, jstring filename) {
-  game::Resources* ptr = reinterpret_cast<game::Resources*>(descriptor);
-  return (jboolean) ptr->readTexture(filename);
-}
-
-JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readSound
-  (JNIEnv *, jobject, jlong descriptor, jstring filename) {
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readAssets
+  (JNIEnv *, jobject, jlong descriptor) {
   game::Resources* ptr = reinterpret_cast<game::Resources*>(descriptor);
-  return (jboolean) ptr->readSound(filename);
+  return (jboolean) ptr->readAssets();
 }
 
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_release
@@ -35,101 +31,162 @@ namespace game {
 
 Resources::Resources(JNIEnv* jenv, jobject assets, jstring internalFileStorage_Java)
   : m_jenv(jenv)
-  , m_assets(new AssetStorage(m_jenv, assets)) {
+  , m_assets(new AssetStorage(m_jenv, assets))
+  , m_background_residency("backgrounds", defaultBackgroundBudget,
+      [](const native::Texture* texture) { return texture->getID() != 0 ? texture->getMemoryUsage() : 0; },
+      [](native::Texture* texture) { texture->unload(); })
+  , m_sound_residency("sounds", defaultSoundBudget,
+      [](const native::SoundBuffer* sound) { return sound->getData() != nullptr ? (size_t) sound->getLength() : 0; },
+      [](native::SoundBuffer* sound) { sound->unload(); }) {
+  std::fill(m_prize_textures, m_prize_textures + PrizeUtils::totalPrizes + 1, nullptr);
   const char* internal_file_storage = jenv->GetStringUTFChars(internalFileStorage_Java, 0);
   m_assets->setInternalFileStorage(internal_file_storage);
+  m_assets->openPack();
+  openLevelPack();
+  m_texture_cache = new native::TextureCache(std::string(internal_file_storage) + "/textures");
   jenv->ReleaseStringUTFChars(internalFileStorage_Java, internal_file_storage);
 }
 
 Resources::~Resources() noexcept {
-  delete m_assets;
-  m_assets = nullptr;
+  delete m_texture_cache;
+  m_texture_cache = nullptr;
   for (auto& item : m_textures) {
     delete item.second;
     item.second = nullptr;
   }
   m_textures.clear();
+  m_texture_table.clear();
+  m_texture_groups.clear();
   for (auto& item: m_sounds) {
     delete item.second;
     item.second = nullptr;
   }
   m_sounds.clear();
+  for (auto& group : m_sound_groups) {
+    group.clear();
+  }
+  m_level_pack.reset();
+  delete m_assets;  // sounds and levels could reference data within asset pack
+  m_assets = nullptr;
   m_jenv = nullptr;
 }
 
+bool Resources::readAssets() {
+  auto textures = m_assets->list("texture");
+  auto sounds = m_assets->list("sound");
+  bool success = !textures.empty() && !sounds.empty();
+  for (auto& name : textures) {
+    success &= readTexture(name);
+  }
+  for (auto& name : sounds) {
+    success &= readSound(name);
+  }
+  INF("Registered %zu textures and %zu sounds", textures.size(), sounds.size());
+  return success;
+}
+
+/* Levels group */
+// ----------------------------------------------------------------------------
+void Resources::openLevelPack() {
+  const void* data = nullptr;
+  off_t length = 0;
+  AAsset* asset = nullptr;
+  if (!m_assets->map(LevelPack::filename, &data, &length, &asset)) {
+    INF("No level pack, levels are passed from Java");
+    return;
+  }
+  m_level_pack = std::make_shared<LevelPack>(data, length, [asset]() { AssetStorage::unmap(asset); });
+  if (!m_level_pack->isValid()) {
+    ERR("Level pack is corrupted!");
+    m_level_pack.reset();
+    return;
+  }
+  INF("Level pack has been mapped: %i levels", m_level_pack->getCount());
+}
+
+bool Resources::hasLevelPack() const {
+  return m_level_pack != nullptr;
+}
+
+int Resources::getLevelsCount() const {
+  return m_level_pack != nullptr ? m_level_pack->getCount() : 0;
+}
+
+Level::Ptr Resources::loadLevel(int index) const {
+  if (m_level_pack == nullptr) {
+    return nullptr;
+  }
+  if (index < 0 || index >= m_level_pack->getCount()) {
+    index = 0;
+  }
+  return m_level_pack->load(index);
+}
+
 /* Texture group */
 // ----------------------------------------------------------------------------
-bool Resources::readTexture(jstring filename) {
-  const char* raw_name = m_jenv->GetStringUTFChars(filename, nullptr);
+bool Resources::readTexture(const std::string& name) {
+  const char* raw_name = name.c_str();
   native::Texture* texture = nullptr;
   {
     std::string prefix = "texture/" + std::string(raw_name);
     texture = new native::PNGTexture(m_assets, prefix.c_str());
+    texture->setCache(m_texture_cache);
+    setTextureFormat(texture, raw_name);
     DBG("Read texture resource: %s", raw_name);
   }
   m_textures[raw_name] = texture;
-  m_jenv->ReleaseStringUTFChars(filename, raw_name);
+  m_texture_handles[raw_name] = static_cast<TextureHandle>(m_texture_table.size());
+  m_texture_table.push_back(texture);
+
+  size_t underscore = name.find('_');
+  if (underscore != std::string::npos) {
+    m_texture_groups[name.substr(0, underscore)].push_back(texture);
+  }
+  for (int i = 0; i <= PrizeUtils::totalPrizes; ++i) {
+    const char* prize_texture = PrizeUtils::getPrizeTexture(static_cast<Prize>(i));
+    if (prize_texture != nullptr && name == prize_texture) {
+      m_prize_textures[i] = texture;
+    }
+  }
   return true;
 }
 
+void Resources::setTextureFormat(native::Texture* texture, const std::string& name) {
+  if (isBackground(name)) {
+    // opaque over black background, largest images
+    texture->setTargetFormat(native::TargetFormat::RGB565, true);
+  } else if (name.find("smoke") == 0) {
+    texture->setTargetFormat(native::TargetFormat::LA88, false);
+  } else {
+    // sprites: prizes, effects, particles
+    texture->setTargetFormat(native::TargetFormat::RGBA4444, true);
+  }
+}
+
+Resources::TextureHandle Resources::getTextureHandle(const std::string& name) const {
+  auto it = m_texture_handles.find(name);
+  return it != m_texture_handles.end() ? it->second : invalidHandle;
+}
+
+const native::Texture* const Resources::getTexture(TextureHandle handle) const {
+  if (handle < 0 || static_cast<size_t>(handle) >= m_texture_table.size()) {
+    ERR("Invalid texture handle: %i", handle);
+    return nullptr;
+  }
+  return m_texture_table[handle];
+}
+
 const native::Texture* const Resources::getTexture(const std::string& name) const {
-  return m_textures.at(name);
+  return getTexture(getTextureHandle(name));
 }
 
 const native::Texture* const Resources::getRandomTexture(const std::string& prefix) const {
-  native::Texture* texture = nullptr;
-  bool success = false;
-  do {
-    size_t random_index = std::rand() % m_textures.size();
-    auto shift = m_textures.begin();
-    for (int i = 0; i < random_index; ++i) {
-      ++shift;
-    }
-    success = (shift->first.find(prefix) == 0);
-    texture = shift->second;
-  } while (!success);
-  return texture;
+  auto it = m_texture_groups.find(prefix);
+  return it != m_texture_groups.end() ? pickRandom(it->second) : nullptr;
 }
 
 const native::Texture* const Resources::getPrizeTexture(const Prize& prize) const {
-  switch (prize) {
-    case Prize::BLOCK:     return getTexture("pr_brick.png");
-    case Prize::CLIMB:     return getTexture("pr_earth.png");
-    case Prize::DESTROY:   return getTexture("pr_skull.png");
-    case Prize::DRAGON:    return getTexture("pr_egg.png");
-    case Prize::EASY:      return getTexture("pr_fire.png");
-    case Prize::EASY_T:    return getTexture("pr_fire_t.png");
-    case Prize::EVAPORATE: return getTexture("pr_waterdrop.png");
-    case Prize::EXPLODE:   return getTexture("pr_explode.png");
-    case Prize::EXTEND:    return getTexture("pr_extend.png");
-    case Prize::FAST:      return getTexture("pr_clock.png");
-    case Prize::FOG:       return getTexture("pr_fog.png");
-    case Prize::GOO:       return getTexture("pr_glue.png");
-    case Prize::HYPER:     return getTexture("pr_hyper.png");
-    case Prize::INIT:      return getTexture("pr_radar.png");
-    case Prize::JUMP:      return getTexture("pr_jump.png");
-    case Prize::LASER:     return getTexture("pr_laser.png");
-    case Prize::MIRROR:    return getTexture("pr_mirror.png");
-    case Prize::PIERCE:    return getTexture("pr_pierce.png");
-    case Prize::PROTECT:   return getTexture("pr_protect.png");
-    case Prize::RANDOM:    return getTexture("pr_dice.png");
-    case Prize::SHORT:     return getTexture("pr_short.png");
-    case Prize::SLOW:      return getTexture("pr_frozen_clock.png");
-    case Prize::UPGRADE:   return getTexture("pr_arrow.png");
-    case Prize::DEGRADE:   return getTexture("pr_down.png");
-    case Prize::VITALITY:  return getTexture("pr_ball.png");
-    case Prize::WIN:       return getTexture("pr_diamond.png");
-    case Prize::ZYGOTE:    return getTexture("pr_zygote.png");
-    case Prize::SCORE_1:   return getTexture("pr_candy.png");
-    case Prize::SCORE_2:   return getTexture("pr_coin.png");
-    case Prize::SCORE_3:   return getTexture("pr_star.png");
-    case Prize::SCORE_4:   return getTexture("pr_newyear.png");
-    case Prize::SCORE_5:   return getTexture("pr_butterfly.png");
-    default:
-    case Prize::NONE:  // NONE prize is ignored by GameProcessor
-      break;
-  }
-  return nullptr;
+  return m_prize_textures[static_cast<int>(prize)];
 }
 
 Resources::tex_iterator Resources::beginTexture() { return m_textures.begin(); }
@@ -143,8 +200,8 @@ Resources::Ptr Resources::getSharedPtr() {
 
 /* Sound group */
 // ----------------------------------------------------------------------------
-bool Resources::readSound(jstring filename) {
-  const char* raw_name = m_jenv->GetStringUTFChars(filename, nullptr);
+bool Resources::readSound(const std::string& name) {
+  const char* raw_name = name.c_str();
   native::SoundBuffer* sound = nullptr;
   {
     std::string prefix = "sound/" + std::string(raw_name);
@@ -152,7 +209,12 @@ bool Resources::readSound(jstring filename) {
     DBG("Read sound resource: %s", raw_name);
   }
   m_sounds[raw_name] = sound;
-  m_jenv->ReleaseStringUTFChars(filename, raw_name);
+  SoundGroup group = SoundGroupUtils::fromFilename(raw_name);
+  if (group != SoundGroup::NONE) {
+    m_sound_groups[static_cast<int>(group)].push_back(sound);
+  } else {
+    WRN("Sound resource %s doesn't belong to any group", raw_name);
+  }
   return true;
 }
 
@@ -160,21 +222,9 @@ const native::SoundBuffer* const Resources::getSound(const std::string& name) co
   return m_sounds.at(name);
 }
 
-const native::SoundBuffer* const Resources::getRandomSound(const std::string& prefix) const {
-  native::SoundBuffer* sound = nullptr;
-  if (prefix.empty()) return sound;
-
-  bool success = false;
-  do {
-    size_t random_index = std::rand() % m_sounds.size();
-    auto shift = m_sounds.begin();
-    for (int i = 0; i < random_index; ++i) {
-      ++shift;
-    }
-    success = (shift->first.find(prefix) == 0);
-    sound = shift->second;
-  } while (!success);
-  return sound;
+const native::SoundBuffer* const Resources::getRandomSound(SoundGroup group) const {
+  if (group == SoundGroup::NONE) return nullptr;
+  return pickRandom(m_sound_groups[static_cast<int>(group)]);
 }
 
 Resources::sound_iterator Resources::beginSound() { return m_sounds.begin(); }
@@ -182,4 +232,79 @@ Resources::sound_iterator Resources::endSound() { return m_sounds.end(); }
 Resources::const_sound_iterator Resources::cbeginSound() const { return m_sounds.cbegin(); }
 Resources::const_sound_iterator Resources::cendSound() const { return m_sounds.cend(); }
 
+/* Residency group */
+// ----------------------------------------------------------------------------
+bool Resources::isBackground(const std::string& name) {
+  return name.find("bg") == 0;
+}
+
+void Resources::setBackgroundBudget(size_t bytes) {
+  m_background_residency.setBudget(bytes);
+}
+
+void Resources::setSoundBudget(size_t bytes) {
+  m_sound_residency.setBudget(bytes);
+}
+
+native::Texture* Resources::acquireBackground() {
+  native::Texture* texture = pickRandom(m_texture_groups["bg"]);
+  if (texture == nullptr) {
+    ERR("No background textures registered !");
+    return nullptr;
+  }
+  m_background_residency.touch(texture);
+  return texture;
+}
+
+void Resources::trimBackgrounds() {
+  m_background_residency.trim();
+}
+
+const native::SoundBuffer* const Resources::acquireSound(SoundGroup group, const SoundPinned& pinned) {
+  if (group == SoundGroup::NONE) return nullptr;
+
+  native::SoundBuffer* sound = pickRandom(m_sound_groups[static_cast<int>(group)]);
+  if (sound == nullptr) {
+    WRN("No sounds registered in group %s", SoundGroupUtils::getPrefix(group));
+    return nullptr;
+  }
+  if (!m_sound_residency.touch(sound)) {
+    DBG("Loading sound on demand: %s", sound->getFilename());
+    if (!sound->load()) {
+      return nullptr;
+    }
+    m_sound_residency.trim(pinned);
+  }
+  return sound;
+}
+
+bool Resources::prefetchSounds(SoundGroup group, const SoundPinned& pinned) {
+  if (group == SoundGroup::NONE) return true;
+
+  bool success = true;
+  for (auto sound : m_sound_groups[static_cast<int>(group)]) {
+    if (!m_sound_residency.touch(sound, true /* prefetch */)) {
+      success &= sound->load();
+    }
+  }
+  m_sound_residency.trim(pinned);
+  return success;
+}
+
+void Resources::reportBackgroundResidency() const {
+  m_background_residency.report();
+}
+
+void Resources::reportSoundResidency() const {
+  m_sound_residency.report();
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+template <typename T>
+T* Resources::pickRandom(const std::vector<T*>& group) {
+  if (group.empty()) return nullptr;
+  return group[std::rand() % group.size()];
+}
+
 }
@@ -0,0 +1,160 @@
+#include <cstring>
+
+#include "RiffReader.h"
+
+namespace native {
+
+static inline uint16_t readLE16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readLE32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+      (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void writeLE16(uint8_t* p, uint16_t value) {
+  p[0] = static_cast<uint8_t>(value);
+  p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static inline void writeLE32(uint8_t* p, uint32_t value) {
+  writeLE16(p, static_cast<uint16_t>(value));
+  writeLE16(p + 2, static_cast<uint16_t>(value >> 16));
+}
+
+const char* toString(RiffError error) {
+  switch (error) {
+    case RiffError::NONE:       return "none";
+    case RiffError::TRUNCATED:  return "truncated";
+    case RiffError::NOT_RIFF:   return "not RIFF";
+    case RiffError::NOT_WAVE:   return "not WAVE";
+    case RiffError::NO_FORMAT:  return "no format";
+    case RiffError::BAD_FORMAT: return "bad format";
+    case RiffError::NO_DATA:    return "no data";
+  }
+  return "unknown";
+}
+
+RiffError parseWAV(const uint8_t* data, size_t size,
+                   PCMFormat* format, const uint8_t** pcm, size_t* pcm_size) {
+  if (data == nullptr || size < 12) {
+    return RiffError::TRUNCATED;
+  }
+  if (std::memcmp(data, "RIFF", 4) != 0) {
+    return RiffError::NOT_RIFF;
+  }
+  if (std::memcmp(data + 8, "WAVE", 4) != 0) {
+    return RiffError::NOT_WAVE;
+  }
+
+  bool has_format = false;
+  size_t offset = 12;
+  while (size - offset >= 8) {
+    const uint8_t* chunk = data + offset;
+    size_t chunk_size = readLE32(chunk + 4);
+    size_t available = size - offset - 8;
+
+    if (std::memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_size < 16 || chunk_size > available) {
+        return chunk_size < 16 ? RiffError::BAD_FORMAT : RiffError::TRUNCATED;
+      }
+      format->audio_format = readLE16(chunk + 8);
+      format->channels = readLE16(chunk + 10);
+      format->sample_rate = readLE32(chunk + 12);
+      format->block_align = readLE16(chunk + 20);
+      format->bits_per_sample = readLE16(chunk + 22);
+      if (format->channels == 0 || format->sample_rate == 0) {
+        return RiffError::BAD_FORMAT;
+      }
+      switch (format->audio_format) {
+        case WAVE_FORMAT_PCM:
+          if ((format->bits_per_sample != 8 && format->bits_per_sample != 16) ||
+              format->block_align != format->channels * (format->bits_per_sample / 8)) {
+            return RiffError::BAD_FORMAT;
+          }
+          break;
+        case WAVE_FORMAT_IMA_ADPCM:
+          // 4-byte header per channel followed by codes
+          if (format->bits_per_sample != 4 || format->block_align <= 4 * format->channels) {
+            return RiffError::BAD_FORMAT;
+          }
+          break;
+        default:
+          return RiffError::BAD_FORMAT;
+      }
+      has_format = true;
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      if (!has_format) {
+        return RiffError::NO_FORMAT;
+      }
+      if (chunk_size > available) {
+        chunk_size = available;  // truncated file, keep what is there
+      }
+      *pcm = chunk + 8;
+      *pcm_size = format->audio_format == WAVE_FORMAT_PCM ?
+          chunk_size - chunk_size % format->block_align : chunk_size;
+      return RiffError::NONE;
+    }
+
+    if (chunk_size > available) {
+      break;
+    }
+    // chunks are padded to even size
+    size_t padded = chunk_size + (chunk_size & 1);
+    if (padded > available) {
+      break;
+    }
+    offset += 8 + padded;
+  }
+  return has_format ? RiffError::NO_DATA : RiffError::NO_FORMAT;
+}
+
+size_t getWAVHeaderSize(const PCMFormat& format) {
+  return format.audio_format == WAVE_FORMAT_IMA_ADPCM ? WAV_ADPCM_HEADER_SIZE : WAV_HEADER_SIZE;
+}
+
+/// @brief Samples per channel in IMA-ADPCM block of @a size bytes:
+/// header sample of each channel followed by 4-bit codes.
+static uint32_t getAdpcmSamples(uint32_t size, uint16_t channels) {
+  uint32_t header_size = 4u * channels;
+  return size > header_size ? (size - header_size) * 2 / channels + 1 : (size > 0 ? 1 : 0);
+}
+
+void writeWAVHeader(const PCMFormat& format, uint32_t data_size, uint8_t* header) {
+  bool adpcm = format.audio_format == WAVE_FORMAT_IMA_ADPCM;
+  uint32_t header_size = static_cast<uint32_t>(getWAVHeaderSize(format));
+  uint32_t format_size = adpcm ? 20 : 16;
+  uint32_t byte_rate = format.sample_rate * format.block_align;
+  uint32_t samples_per_block = 0;
+  if (adpcm) {
+    samples_per_block = getAdpcmSamples(format.block_align, format.channels);
+    byte_rate = format.sample_rate * format.block_align / samples_per_block;
+  }
+  std::memcpy(header, "RIFF", 4);
+  writeLE32(header + 4, header_size - 8 + data_size);
+  std::memcpy(header + 8, "WAVE", 4);
+  std::memcpy(header + 12, "fmt ", 4);
+  writeLE32(header + 16, format_size);
+  writeLE16(header + 20, format.audio_format);
+  writeLE16(header + 22, format.channels);
+  writeLE32(header + 24, format.sample_rate);
+  writeLE32(header + 28, byte_rate);
+  writeLE16(header + 32, format.block_align);
+  writeLE16(header + 34, format.bits_per_sample);
+  uint8_t* chunk = header + 36;
+  if (adpcm) {
+    writeLE16(chunk, 2);  // cbSize
+    writeLE16(chunk + 2, static_cast<uint16_t>(samples_per_block));
+    uint32_t samples = data_size / format.block_align * samples_per_block +
+        getAdpcmSamples(data_size % format.block_align, format.channels);
+    std::memcpy(chunk + 4, "fact", 4);
+    writeLE32(chunk + 8, 4);
+    writeLE32(chunk + 12, samples);
+    chunk += 16;
+  }
+  std::memcpy(chunk, "data", 4);
+  writeLE32(chunk + 4, data_size);
+}
+
+}  // namespace native
@@ -0,0 +1,42 @@
+#include "SampleConverter.h"
+
+namespace native {
+
+/// @brief Reads frame as single 16-bit sample, channels are averaged.
+static int32_t readMonoSample(const uint8_t* frame, const PCMFormat& format) {
+  int32_t sum = 0;
+  for (int channel = 0; channel < format.channels; ++channel) {
+    if (format.bits_per_sample == 8) {
+      sum += (static_cast<int32_t>(frame[channel]) - 128) << 8;  // unsigned 8-bit
+    } else {
+      const uint8_t* p = frame + channel * 2;
+      sum += static_cast<int16_t>(p[0] | (p[1] << 8));
+    }
+  }
+  return sum / format.channels;
+}
+
+size_t getConvertedFrames(size_t size, const PCMFormat& format, uint32_t sample_rate) {
+  size_t in_frames = size / format.block_align;
+  return static_cast<size_t>(static_cast<uint64_t>(in_frames) * sample_rate / format.sample_rate);
+}
+
+void convertToMono16(const uint8_t* pcm, size_t size, const PCMFormat& format,
+                     uint32_t sample_rate, int16_t* output) {
+  size_t in_frames = size / format.block_align;
+  size_t out_frames = getConvertedFrames(size, format, sample_rate);
+
+  // linear resampling, source position is 32.16 fixed point
+  const uint64_t step = (static_cast<uint64_t>(format.sample_rate) << 16) / sample_rate;
+  uint64_t position = 0;
+  for (size_t i = 0; i < out_frames; ++i, position += step) {
+    size_t index = static_cast<size_t>(position >> 16);
+    int32_t fraction = static_cast<int32_t>(position & 0xFFFF);
+    int32_t current = readMonoSample(pcm + index * format.block_align, format);
+    int32_t next = index + 1 < in_frames ?
+        readMonoSample(pcm + (index + 1) * format.block_align, format) : current;
+    output[i] = static_cast<int16_t>(current + (((next - current) * fraction) >> 16));
+  }
+}
+
+}  // namespace native
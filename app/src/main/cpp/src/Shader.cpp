@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include <GLES2/gl2.h>
 
 #include "Exceptions.h"
@@ -111,23 +113,23 @@ Shader::~Shader() {
 
 SimpleShader::SimpleShader()
   : Shader(
-      "  attribute vec4 a_position;   \n"
-      "  attribute vec4 a_color;      \n"
-      "                               \n"
-      "  varying vec4 v_color;        \n"
-      "                               \n"
-      "  void main() {                \n"
-      "    v_color = a_color;         \n"
-      "    gl_Position = a_position;  \n"
-      "  }                            \n"
+      "  attribute vec2 a_position;                  \n"
+      "  attribute vec4 a_color;                     \n"
+      "                                              \n"
+      "  varying vec4 v_color;                       \n"
+      "                                              \n"
+      "  void main() {                               \n"
+      "    v_color = a_color;                        \n"
+      "    gl_Position = vec4(a_position, 0.0, 1.0); \n"
+      "  }                                           \n"
       ,
-      "  precision mediump float;     \n"
-      "                               \n"
-      "  varying vec4 v_color;        \n"
-      "                               \n"
-      "  void main() {                \n"
-      "    gl_FragColor = v_color;    \n"
-      "  }                            \n") {
+      "  precision mediump float;                    \n"
+      "                                              \n"
+      "  varying vec4 v_color;                       \n"
+      "                                              \n"
+      "  void main() {                               \n"
+      "    gl_FragColor = v_color;                   \n"
+      "  }                                           \n") {
 }
 
 void SimpleShader::bindColorAttribLocation(GLuint program, GLuint color_location) const {
@@ -140,14 +142,14 @@ void SimpleShader::bindTexCoordAttribLocation(GLuint program, GLuint texCoord_lo
 
 SimpleTextureShader::SimpleTextureShader()
   : Shader(
-      "  attribute vec4 a_position;                                            \n"
+      "  attribute vec2 a_position;                                            \n"
       "  attribute vec2 a_texCoord;                                            \n"
       "                                                                        \n"
       "  varying vec2 v_texCoord;                                              \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
       "    v_texCoord = a_texCoord;                                            \n"
-      "    gl_Position = a_position;                                           \n"
+      "    gl_Position = vec4(a_position, 0.0, 1.0);                           \n"
       "  }                                                                     \n"
       ,
       "  precision mediump float;                                              \n"
@@ -171,38 +173,44 @@ void SimpleTextureShader::bindTexCoordAttribLocation(GLuint program, GLuint texC
 ParticleSystemShader::ParticleSystemShader()
   : Shader(
       "  uniform float u_time;                                                 \n"
-      "  uniform vec2 u_centerPosition;                                        \n"
+      "  uniform float u_duration;                                             \n"
       "                                                                        \n"
       "  attribute float a_lifetime;                                           \n"
       "  attribute vec2 a_startPosition;                                       \n"
       "  attribute vec2 a_endPosition;                                         \n"
+      "  attribute vec2 a_centerPosition;                                      \n"
+      "  attribute float a_startTime;                                          \n"
+      "  attribute vec3 a_color;                                               \n"
       "                                                                        \n"
       "  varying float v_lifetime;                                             \n"
+      "  varying vec3 v_color;                                                 \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
-      "    if (u_time <= a_lifetime) {                                         \n"
-      "      gl_Position.xy = a_startPosition + (u_time * a_endPosition);      \n"
-      "      gl_Position.xy += u_centerPosition;                               \n"
+      "    float time = u_time - a_startTime;                                  \n"
+      "    if (time >= 0.0 && time <= a_lifetime && time < u_duration) {       \n"
+      "      gl_Position.xy = a_startPosition + (time * a_endPosition);        \n"
+      "      gl_Position.xy += a_centerPosition;                               \n"
       "      gl_Position.z = 0.0;                                              \n"
       "      gl_Position.w = 1.0;                                              \n"
       "    } else {                                                            \n"
       "      gl_Position = vec4(-1000, -1000, 0, 0);                           \n"
       "    }                                                                   \n"
-      "    v_lifetime = 1.0 - (u_time / a_lifetime);                           \n"
+      "    v_lifetime = 1.0 - (time / a_lifetime);                             \n"
       "    v_lifetime = clamp(v_lifetime, 0.0, 1.0);                           \n"
+      "    v_color = a_color;                                                  \n"
       "    gl_PointSize = (v_lifetime * v_lifetime) * 40.0;                    \n"
       "  }                                                                     \n"
       ,
       "  precision mediump float;                            \n"
       "                                                      \n"
-      "  uniform vec4 u_color;                               \n"
       "  varying float v_lifetime;                           \n"
+      "  varying vec3 v_color;                               \n"
       "  uniform sampler2D s_texture;                        \n"
       "                                                      \n"
       "  void main() {                                       \n"
       "    vec4 texColor;                                    \n"
       "    texColor = texture2D(s_texture, gl_PointCoord);   \n"
-      "    gl_FragColor = vec4(u_color) * texColor;          \n"
+      "    gl_FragColor = vec4(v_color, 0.5) * texColor;     \n"
       "    gl_FragColor.a *= v_lifetime;                     \n"
       "  }                                                   \n") {
 }
@@ -221,14 +229,14 @@ VerticalFallShader::VerticalFallShader()
       "  uniform float u_velocity;                                             \n"
       "  uniform int u_visible;                                                \n"
       "                                                                        \n"
-      "  attribute vec4 a_position;                                            \n"
+      "  attribute vec2 a_position;                                            \n"
       "  attribute vec2 a_texCoord;                                            \n"
       "                                                                        \n"
       "  varying vec2 v_texCoord;                                              \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
       "    if (u_visible != 0 && u_time <= 3.0) {                              \n"
-      "      gl_Position = a_position;                                         \n"
+      "      gl_Position = vec4(a_position, 0.0, 1.0);                         \n"
       "      gl_Position.y -= u_time * u_velocity;                             \n"
       "    } else {                                                            \n"
       "      gl_Position = vec4(-1000, -1000, 0, 0);                           \n"
@@ -260,14 +268,14 @@ VerticalClimbShader::VerticalClimbShader()
       "  uniform float u_velocity;                                             \n"
       "  uniform int u_visible;                                                \n"
       "                                                                        \n"
-      "  attribute vec4 a_position;                                            \n"
+      "  attribute vec2 a_position;                                            \n"
       "  attribute vec2 a_texCoord;                                            \n"
       "                                                                        \n"
       "  varying vec2 v_texCoord;                                              \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
       "    if (u_visible != 0 && u_time <= 0.6) {                              \n"
-      "      gl_Position = a_position;                                         \n"
+      "      gl_Position = vec4(a_position, 0.0, 1.0);                         \n"
       "      gl_Position.y += u_time * u_velocity;                             \n"
       "    } else {                                                            \n"
       "      gl_Position = vec4(-1000, -1000, 0, 0);                           \n"
@@ -0,0 +1,205 @@
+#include <cstring>
+
+#include "byteutils.h"
+#include "logger.h"
+#include "Snapshot.h"
+
+namespace game {
+
+static const char snapshotMagic[4] = { 'A', 'R', 'K', 'S' };
+
+static inline uint8_t byteAt(const std::vector<uint8_t>& payload, size_t i) {
+  return i < payload.size() ? payload[i] : 0;
+}
+
+/* Writer */
+// ----------------------------------------------------------------------------
+SnapshotWriter::SnapshotWriter(std::vector<uint8_t>* out)
+  : m_out(out)
+  , m_section(0) {
+}
+
+void SnapshotWriter::putBytes(const void* data, size_t size) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  m_out->insert(m_out->end(), bytes, bytes + size);
+}
+
+void SnapshotWriter::putString(const std::string& str) {
+  put(static_cast<uint32_t>(str.size()));
+  putBytes(str.data(), str.size());
+}
+
+void SnapshotWriter::beginSection(SnapshotSection section) {
+  put(static_cast<uint8_t>(section));
+  m_section = m_out->size();
+  put(static_cast<uint32_t>(0));  // patched in endSection()
+}
+
+void SnapshotWriter::endSection() {
+  uint32_t size = static_cast<uint32_t>(m_out->size() - m_section - sizeof(uint32_t));
+  std::memcpy(&(*m_out)[m_section], &size, sizeof(uint32_t));
+}
+
+/* Reader */
+// ----------------------------------------------------------------------------
+SnapshotReader::SnapshotReader()
+  : m_data(nullptr)
+  , m_size(0)
+  , m_offset(0)
+  , m_is_valid(false) {
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size)
+  : m_data(data)
+  , m_size(size)
+  , m_offset(0)
+  , m_is_valid(data != nullptr || size == 0) {
+}
+
+bool SnapshotReader::getBytes(void* data, size_t size) {
+  if (!m_is_valid || m_size - m_offset < size) {
+    m_is_valid = false;
+    return false;
+  }
+  std::memcpy(data, m_data + m_offset, size);
+  m_offset += size;
+  return true;
+}
+
+bool SnapshotReader::getString(std::string* str) {
+  uint32_t size = 0;
+  if (!get(&size) || m_size - m_offset < size) {
+    m_is_valid = false;
+    return false;
+  }
+  str->assign(reinterpret_cast<const char*>(m_data + m_offset), size);
+  m_offset += size;
+  return true;
+}
+
+bool SnapshotReader::nextSection(SnapshotSection* section, SnapshotReader* body) {
+  if (atEnd()) {
+    return false;
+  }
+  uint8_t tag = 0;
+  uint32_t size = 0;
+  if (!get(&tag) || !get(&size) || m_size - m_offset < size) {
+    m_is_valid = false;
+    return false;
+  }
+  *section = static_cast<SnapshotSection>(tag);
+  *body = SnapshotReader(m_data + m_offset, size);
+  m_offset += size;
+  return true;
+}
+
+/* Snapshot */
+// ----------------------------------------------------------------------------
+void Snapshot::pack(const std::vector<uint8_t>& payload, std::vector<uint8_t>* blob) {
+  SnapshotHeader header;
+  std::memcpy(header.magic, snapshotMagic, 4);
+  header.version = Snapshot::version;
+  header.flags = 0;
+  header.size = static_cast<uint32_t>(payload.size());
+  header.checksum = checksum(payload.data(), payload.size());
+  header.base_checksum = 0;
+
+  blob->resize(sizeof(SnapshotHeader));
+  std::memcpy(&(*blob)[0], &header, sizeof(SnapshotHeader));
+  blob->insert(blob->end(), payload.begin(), payload.end());
+}
+
+void Snapshot::packDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& payload, std::vector<uint8_t>* blob) {
+  SnapshotHeader header;
+  std::memcpy(header.magic, snapshotMagic, 4);
+  header.version = Snapshot::version;
+  header.flags = Snapshot::DELTA;
+  header.size = static_cast<uint32_t>(payload.size());
+  header.checksum = checksum(payload.data(), payload.size());
+  header.base_checksum = checksum(base.data(), base.size());
+
+  blob->resize(sizeof(SnapshotHeader));
+  std::memcpy(&(*blob)[0], &header, sizeof(SnapshotHeader));
+
+  // base is zero-extended or cut to the size of payload
+  size_t i = 0;
+  while (i < payload.size()) {
+    size_t same = i;
+    while (same < payload.size() && payload[same] == byteAt(base, same)) {
+      ++same;
+    }
+    if (same == payload.size()) {
+      break;  // the rest is unchanged
+    }
+    size_t changed = same;
+    while (changed < payload.size() && payload[changed] != byteAt(base, changed)) {
+      ++changed;
+    }
+    util::putVarint(blob, same - i);
+    util::putVarint(blob, changed - same);
+    for (size_t k = same; k < changed; ++k) {
+      blob->push_back(payload[k] ^ byteAt(base, k));
+    }
+    i = changed;
+  }
+}
+
+bool Snapshot::unpack(const uint8_t* blob, size_t size, const std::vector<uint8_t>& base, std::vector<uint8_t>* payload) {
+  SnapshotHeader header;
+  if (blob == nullptr || size < sizeof(SnapshotHeader)) {
+    ERR("Snapshot is truncated");
+    return false;
+  }
+  std::memcpy(&header, blob, sizeof(SnapshotHeader));
+  if (std::memcmp(header.magic, snapshotMagic, 4) != 0 || header.version != Snapshot::version) {
+    ERR("Snapshot is of unknown format or version");
+    return false;
+  }
+
+  const uint8_t* body = blob + sizeof(SnapshotHeader);
+  size_t body_size = size - sizeof(SnapshotHeader);
+  if ((header.flags & Snapshot::DELTA) == 0) {
+    if (body_size != header.size) {
+      ERR("Snapshot is truncated");
+      return false;
+    }
+    payload->assign(body, body + body_size);
+  } else {
+    if (header.base_checksum != checksum(base.data(), base.size())) {
+      ERR("Snapshot delta has been made against other base");
+      return false;
+    }
+    payload->resize(header.size);
+    for (size_t i = 0; i < payload->size(); ++i) {
+      (*payload)[i] = byteAt(base, i);
+    }
+    size_t offset = 0, position = 0;
+    while (offset < body_size) {
+      size_t same = 0, changed = 0;
+      if (!util::getVarint(body, body_size, &offset, &same) ||
+          !util::getVarint(body, body_size, &offset, &changed) ||
+          same > header.size - position ||
+          changed > header.size - position - same ||
+          changed > body_size - offset) {
+        ERR("Snapshot delta is corrupted");
+        return false;
+      }
+      position += same;
+      for (size_t k = 0; k < changed; ++k) {
+        (*payload)[position++] ^= body[offset++];
+      }
+    }
+  }
+
+  if (checksum(payload->data(), payload->size()) != header.checksum) {
+    ERR("Snapshot checksum mismatch");
+    return false;
+  }
+  return true;
+}
+
+uint32_t Snapshot::checksum(const uint8_t* data, size_t size) {
+  return util::fnv1a(data, size);
+}
+
+}
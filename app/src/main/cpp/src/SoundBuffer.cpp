@@ -2,128 +2,235 @@
 #include <cctype>
 #include <cstdio>
 #include <cstring>
-#include <libgen.h>
+#include <fcntl.h>
+#include <new>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "ImaAdpcm.h"
 #include "logger.h"
+#include "SampleConverter.h"
 #include "SoundBuffer.h"
 
 namespace native {
 
-SoundBuffer::SoundBuffer(AssetStorage* assets, const char* filename)
+SoundBuffer::SoundBuffer(AssetStorage* assets, const char* filename, Encoding encoding)
   : m_read_mode(ReadMode::ASSETS)
   , m_assets(assets)
   , m_filename(new char[128])
   , m_length(0)
   , m_data(nullptr)
+  , m_encoding(encoding)
+  , m_frames(0)
+  , m_block_align(0)
+  , m_owned_data(nullptr)
+  , m_asset_mapping(nullptr)
+  , m_file_mapping(nullptr)
+  , m_file_mapping_size(0)
   , m_error_code(0) {
   strcpy(m_filename, filename);
 }
 
-SoundBuffer::SoundBuffer(const char* filepath)
+SoundBuffer::SoundBuffer(const char* filepath, Encoding encoding)
   : m_read_mode(ReadMode::FILESYSTEM)
   , m_assets(nullptr)
   , m_filename(new char[128])
   , m_length(0)
   , m_data(nullptr)
+  , m_encoding(encoding)
+  , m_frames(0)
+  , m_block_align(0)
+  , m_owned_data(nullptr)
+  , m_asset_mapping(nullptr)
+  , m_file_mapping(nullptr)
+  , m_file_mapping_size(0)
   , m_error_code(0) {
   strcpy(m_filename, filepath);
 }
 
 SoundBuffer::~SoundBuffer() {
+  unload();
   m_assets = nullptr;
   delete [] m_filename;  m_filename = nullptr;
-  unload();
 }
 
 const char* SoundBuffer::getFilename() const { return m_filename; }
 
 const char* SoundBuffer::getName() const {
   if (m_filename != nullptr) {
-    std::string lower = m_filename;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    return basename(lower.c_str());
+    // points into m_filename, rather than into a temporary string
+    const char* slash = strrchr(m_filename, '/');
+    return slash != nullptr ? slash + 1 : m_filename;
   }
   return nullptr;
 }
 
-uint8_t* const SoundBuffer::getData() const { return m_data; }
+const uint8_t* SoundBuffer::getData() const { return m_data; }
 off_t SoundBuffer::getLength() const { return m_length; }
+SoundBuffer::Encoding SoundBuffer::getEncoding() const { return m_encoding; }
+size_t SoundBuffer::getFrames() const { return m_frames; }
+size_t SoundBuffer::getBlockAlign() const { return m_block_align; }
+
+size_t SoundBuffer::getSamplesPerBlock() const {
+  return ImaAdpcm::getSamplesPerBlock(m_block_align);
+}
+
+size_t SoundBuffer::decodeBlock(size_t block, int16_t* output) const {
+  size_t offset = block * m_block_align;
+  size_t first_sample = block * getSamplesPerBlock();
+  if (m_data == nullptr || offset >= static_cast<size_t>(m_length) || first_sample >= m_frames) {
+    return 0;
+  }
+  size_t size = std::min(m_block_align, static_cast<size_t>(m_length) - offset);
+  return ImaAdpcm::decodeBlock(m_data + offset, size, output, m_frames - first_sample);
+}
 
 bool SoundBuffer::load() {
   m_data = loadSound();
   if (m_data == nullptr) {
     ERR("Internal error during loading sound! Code: %i", m_error_code);
+    m_length = 0;
+    m_frames = 0;
     return false;
   }
   return true;
 }
 
 void SoundBuffer::unload() {
-  delete [] m_data;  m_data = nullptr;
+  m_data = nullptr;
+  delete [] m_owned_data;  m_owned_data = nullptr;
+  unmapFile();
   m_length = 0;
+  m_frames = 0;
+}
+
+const uint8_t* SoundBuffer::mapFile(size_t* size) {
+  const void* data = nullptr;
+  off_t length = 0;
+  int descriptor = -1;
+  struct stat status;
+  int error_code = 0;
+
+  switch (m_read_mode) {
+    case ReadMode::ASSETS:
+      if (!m_assets->map(m_filename, &data, &length, &m_asset_mapping)) { error_code = 1; goto ERROR_MAP; }
+      *size = static_cast<size_t>(length);
+      break;
+    case ReadMode::FILESYSTEM:
+      descriptor = ::open(m_filename, O_RDONLY);
+      if (descriptor < 0) { error_code = 4; goto ERROR_MAP; }
+      if (fstat(descriptor, &status) != 0 || status.st_size <= 0) { error_code = 5; goto ERROR_MAP; }
+      data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (data == MAP_FAILED) { data = nullptr; error_code = 5; goto ERROR_MAP; }
+      ::close(descriptor);  // mapping outlives descriptor
+      m_file_mapping = const_cast<void*>(data);
+      m_file_mapping_size = status.st_size;
+      *size = m_file_mapping_size;
+      break;
+  }
+  return static_cast<const uint8_t*>(data);
+
+  ERROR_MAP:
+    m_error_code = 2020 + error_code;
+    ERR("Error while mapping raw sound: %i", m_error_code);
+    if (descriptor >= 0) {
+      ::close(descriptor);
+    }
+    return nullptr;
+}
+
+void SoundBuffer::unmapFile() {
+  AssetStorage::unmap(m_asset_mapping);  m_asset_mapping = nullptr;
+  if (m_file_mapping != nullptr) {
+    munmap(m_file_mapping, m_file_mapping_size);
+    m_file_mapping = nullptr;
+    m_file_mapping_size = 0;
+  }
 }
 
 // ----------------------------------------------------------------------------
 WAVSound::WAVSound(AssetStorage* assets, const char* filename)
-  : SoundBuffer(assets, filename) {
+  : SoundBuffer(assets, filename, Encoding::PCM16) {
 }
 
 WAVSound::WAVSound(const char* filepath)
-  : SoundBuffer(filepath) {
+  : SoundBuffer(filepath, Encoding::PCM16) {
 }
 
 WAVSound::~WAVSound() {
 }
 
-uint8_t* WAVSound::loadSound() {
-  WAVHeader* header = new WAVHeader();
-  uint8_t* data = nullptr;
-  FILE* file_descriptor = nullptr;
+const uint8_t* WAVSound::loadSound() {
+  size_t size = 0;
+  const uint8_t* file = mapFile(&size);
+  if (file == nullptr) {
+    return nullptr;  // error code is set by mapFile()
+  }
+
+  PCMFormat format;
+  const uint8_t* pcm = nullptr;
+  size_t pcm_size = 0;
+  uint8_t* converted = nullptr;
   int error_code = 0;
 
-  switch (m_read_mode) {
-    case ReadMode::ASSETS:
-      if (!m_assets->open(m_filename)) { error_code = 1; goto ERROR_SOUND; }
-      m_length = m_assets->length() - sizeof(WAVHeader);
-      data = new (std::nothrow) uint8_t[m_length];
-      if (data == nullptr) { error_code = 2; goto ERROR_SOUND; }
-      m_assets->read(header, sizeof(WAVHeader));
-      if (!m_assets->read(data, m_length)) { error_code = 3; goto ERROR_SOUND; }
-      m_assets->close();
-      break;
-    case ReadMode::FILESYSTEM:
-      file_descriptor = std::fopen(m_filename, "rb");
-      if (file_descriptor == nullptr) { error_code = 4; goto ERROR_SOUND; }
-      fseek(file_descriptor, 0, SEEK_END);
-      m_length = ftell(file_descriptor) - sizeof(WAVHeader);
-      rewind(file_descriptor);
-      data = new (std::nothrow) uint8_t(m_length);
-      if (data == nullptr) { error_code = 5; goto ERROR_SOUND; }
-      std::fread(header, 1, sizeof(WAVHeader), file_descriptor);
-      if (m_length != std::fread(data, 1, m_length, file_descriptor)) { error_code = 6; goto ERROR_SOUND; }
-      std::fclose(file_descriptor);
-      break;
+  RiffError riff_error = parseWAV(file, size, &format, &pcm, &pcm_size);
+  if (riff_error == RiffError::BAD_FORMAT) { error_code = 3; goto ERROR_SOUND; }
+  if (riff_error != RiffError::NONE) { error_code = 2; goto ERROR_SOUND; }
+
+  if (format.audio_format == WAVE_FORMAT_IMA_ADPCM) {
+    if (format.channels != 1 || format.sample_rate != outputSampleRate) { error_code = 7; goto ERROR_SOUND; }
+    // blocks are decoded while mixing, right from the mapped file
+    m_encoding = Encoding::IMA_ADPCM;
+    m_block_align = format.block_align;
+    m_frames = ImaAdpcm::getSamplesCount(pcm_size, m_block_align);
+    m_length = pcm_size;
+    return pcm;
   }
-  delete header;
-  return data;
+
+  if (format.channels == 1 && format.bits_per_sample == 16 &&
+      format.sample_rate == outputSampleRate &&
+      reinterpret_cast<uintptr_t>(pcm) % alignof(int16_t) == 0) {
+    m_frames = pcm_size / sizeof(int16_t);
+  } else {
+    DBG("Converting sound %s: %i channels, %i bits, %i Hz", m_filename,
+        format.channels, format.bits_per_sample, format.sample_rate);
+    converted = convert(pcm, pcm_size, format);
+    if (converted == nullptr) { error_code = 6; goto ERROR_SOUND; }
+  }
+
+  m_block_align = 0;
+  m_length = m_frames * sizeof(int16_t);
+  if (converted == nullptr) {
+    return pcm;  // play samples right from the mapped file
+  }
+  m_owned_data = converted;
+  unmapFile();  // source samples are no longer needed
+  return m_owned_data;
 
   ERROR_SOUND:
     m_error_code = 2020 + error_code;
-    ERR("Error while reading raw sound: %i", m_error_code);
-    switch (m_read_mode) {
-      case ReadMode::ASSETS:
-        m_assets->close();
-        break;
-      case ReadMode::FILESYSTEM:
-        std::fclose(file_descriptor);
-        break;
-    }
-    if (data != nullptr) {
-      delete [] data;  data = nullptr;
-    }
-    delete header;
+    ERR("Error while reading raw sound %s: %i (%s)", m_filename, m_error_code, toString(riff_error));
+    delete [] converted;  converted = nullptr;
+    unmapFile();
     return nullptr;
 }
 
+/* Private */
+// ----------------------------------------------------------------------------
+uint8_t* WAVSound::convert(const uint8_t* pcm, size_t size, const PCMFormat& format) {
+  size_t out_frames = getConvertedFrames(size, format, outputSampleRate);
+  if (out_frames == 0) {
+    return nullptr;
+  }
+  uint8_t* data = new (std::nothrow) uint8_t[out_frames * sizeof(int16_t)];
+  if (data == nullptr) {
+    return nullptr;
+  }
+  convertToMono16(pcm, size, format, outputSampleRate, reinterpret_cast<int16_t*>(data));
+  m_frames = out_frames;
+  return data;
+}
+
 }
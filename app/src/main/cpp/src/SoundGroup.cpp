@@ -0,0 +1,89 @@
+#include <cstring>
+
+#include "SoundGroup.h"
+
+namespace game {
+
+const char* SoundGroupUtils::getPrefix(SoundGroup group) {
+  switch (group) {
+    case SoundGroup::BITE:      return "bite_";
+    case SoundGroup::BLOCK:     return "block_";
+    case SoundGroup::BOOM:      return "boom_";
+    case SoundGroup::CHANGE:    return "change_";
+    case SoundGroup::DESTROY:   return "destroy_";
+    case SoundGroup::EXPLODE:   return "explode_";
+    case SoundGroup::FOG:       return "fog_";
+    case SoundGroup::GLASS:     return "glass_";
+    case SoundGroup::HYPER:     return "hyper_";
+    case SoundGroup::INIT:      return "init_";
+    case SoundGroup::INVUL:     return "invul_";
+    case SoundGroup::IRON:      return "iron_";
+    case SoundGroup::LASER:     return "laser_";
+    case SoundGroup::LOSE:      return "lose_";
+    case SoundGroup::MAGIC:     return "magic_";
+    case SoundGroup::MIDAS:     return "midas_";
+    case SoundGroup::PREQUICK:  return "prequick_";
+    case SoundGroup::PRIZE:     return "prize_";
+    case SoundGroup::PROTECT:   return "protect_";
+    case SoundGroup::QUICK:     return "quick_";
+    case SoundGroup::SHORT:     return "short_";
+    case SoundGroup::SKULL:     return "skull_";
+    case SoundGroup::ULTRA:     return "ultra_";
+    case SoundGroup::VITALITY:  return "vitality_";
+    case SoundGroup::WATER:     return "water_";
+    case SoundGroup::WIN:       return "win_";
+    case SoundGroup::ZYGOTE:    return "zygote_";
+    case SoundGroup::NONE:
+    default:
+      break;
+  }
+  return "";
+}
+
+SoundGroup SoundGroupUtils::fromFilename(const char* filename) {
+  for (int i = 0; i < totalGroups; ++i) {
+    SoundGroup group = static_cast<SoundGroup>(i);
+    const char* prefix = getPrefix(group);
+    if (strncmp(filename, prefix, strlen(prefix)) == 0) {
+      return group;
+    }
+  }
+  return SoundGroup::NONE;
+}
+
+int SoundGroupUtils::getPriority(SoundGroup group) {
+  switch (group) {
+    case SoundGroup::LOSE:
+    case SoundGroup::WIN:
+    case SoundGroup::SKULL:
+    case SoundGroup::DESTROY:
+      return 3;  // game outcome
+    case SoundGroup::PRIZE:
+    case SoundGroup::INIT:
+    case SoundGroup::PROTECT:
+    case SoundGroup::SHORT:
+    case SoundGroup::VITALITY:
+    case SoundGroup::HYPER:
+      return 2;  // prizes and rare events
+    case SoundGroup::BITE:
+    case SoundGroup::LASER:
+      return 0;  // frequent and short
+    default:
+      break;
+  }
+  return 1;  // block impacts
+}
+
+int SoundGroupUtils::getMinInterval(SoundGroup group) {
+  switch (getPriority(group)) {
+    case 0:
+      return 80;  // bite and laser hits could come every tick
+    case 1:
+      return 50;  // cascades of block impacts
+    default:
+      break;
+  }
+  return 0;  // important cues are never limited
+}
+
+}
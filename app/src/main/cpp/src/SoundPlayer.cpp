@@ -1,18 +1,117 @@
+#include <cstring>
+
+#include "logger.h"
 #include "SoundPlayer.h"
 
 namespace native {
 namespace sound {
 
-SoundPlayer::SoundPlayer() {
+SoundPlayer::SoundPlayer(SLEngineItf engine, SLObjectItf output_mix)
+  : m_engine(engine)
+  , m_output_mix(output_mix)
+  , m_player(nullptr)
+  , m_player_interface(nullptr)
+  , m_player_queue(nullptr)
+  , m_buffers(new int16_t[buffersCount * bufferFrames])
+  , m_next_buffer(0)
+  , m_error_code(0) {
 }
 
 SoundPlayer::~SoundPlayer() {
+  stop();
+  delete [] m_buffers;  m_buffers = nullptr;
+  m_engine = nullptr;
+  m_output_mix = nullptr;
+}
+
+bool SoundPlayer::start(RenderCallback render) {
+  SLDataLocator_AndroidSimpleBufferQueue data_locator_in {
+    SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE,
+    SoundPlayer::buffersCount
+  };
+
+  SLDataFormat_PCM data_format {
+    SL_DATAFORMAT_PCM,
+    1 /* mono sound */,
+    SL_SAMPLINGRATE_44_1,
+    SL_PCMSAMPLEFORMAT_FIXED_16,
+    SL_PCMSAMPLEFORMAT_FIXED_16,
+    SL_SPEAKER_FRONT_CENTER,
+    SL_BYTEORDER_LITTLEENDIAN
+  };
+
+  SLDataSource data_source {
+    &data_locator_in,
+    &data_format
+  };
+
+  SLDataLocator_OutputMix data_locator_out {
+    SL_DATALOCATOR_OUTPUTMIX,
+    m_output_mix
+  };
+
+  SLDataSink data_sink {
+    &data_locator_out,
+    nullptr
+  };
+
+  const SLInterfaceID player_ids[2] { SL_IID_PLAY, SL_IID_BUFFERQUEUE };
+  const SLboolean player_required[2] { SL_BOOLEAN_TRUE, SL_BOOLEAN_TRUE };
+
+  m_render = render;
+  int error_code = 0;
+  SLresult result = (*m_engine)->CreateAudioPlayer(m_engine, &m_player, &data_source, &data_sink, 2, player_ids, player_required);
+  if (result != SL_RESULT_SUCCESS) { error_code = 6; goto ERROR_PLAYER; }
+  result = (*m_player)->Realize(m_player, SL_BOOLEAN_FALSE);
+  if (result != SL_RESULT_SUCCESS) { error_code = 7; goto ERROR_PLAYER; }
+  result = (*m_player)->GetInterface(m_player, SL_IID_PLAY, &m_player_interface);
+  if (result != SL_RESULT_SUCCESS) { error_code = 8; goto ERROR_PLAYER; }
+  result = (*m_player)->GetInterface(m_player, SL_IID_BUFFERQUEUE, &m_player_queue);
+  if (result != SL_RESULT_SUCCESS) { error_code = 9; goto ERROR_PLAYER; }
+  result = (*m_player_queue)->RegisterCallback(m_player_queue, &SoundPlayer::callback_bufferQueue, this);
+  if (result != SL_RESULT_SUCCESS) { error_code = 10; goto ERROR_PLAYER; }
+  result = (*m_player_interface)->SetPlayState(m_player_interface, SL_PLAYSTATE_PLAYING);
+  if (result != SL_RESULT_SUCCESS) { error_code = 11; goto ERROR_PLAYER; }
+  // prime the queue, each played buffer is refilled from callback afterwards
+  for (int i = 0; i < SoundPlayer::buffersCount; ++i) {
+    if (!enqueue()) { error_code = 12; goto ERROR_PLAYER; }
+  }
+  return true;
+
+  ERROR_PLAYER:
+    m_error_code = 2000 + error_code;
+    ERR("Error while starting sound player: %i", m_error_code);
+    stop();
+    return false;
+}
+
+void SoundPlayer::stop() {
   if (m_player != nullptr) {
-    (*m_player)->Destroy(m_player);
+    (*m_player)->Destroy(m_player);  // no callbacks after return
     m_player = nullptr;
     m_player_interface = nullptr;
     m_player_queue = nullptr;
   }
+  m_render = nullptr;
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void SoundPlayer::callback_bufferQueue(SLBufferQueueItf queue, void* context) {
+  SoundPlayer* player = reinterpret_cast<SoundPlayer*>(context);
+  player->enqueue();
+}
+
+bool SoundPlayer::enqueue() {
+  int16_t* buffer = &m_buffers[m_next_buffer * bufferFrames];
+  m_next_buffer = (m_next_buffer + 1) % buffersCount;
+  if (m_render) {
+    m_render(buffer, bufferFrames);
+  } else {
+    std::memset(buffer, 0, bufferFrames * sizeof(int16_t));
+  }
+  SLresult result = (*m_player_queue)->Enqueue(m_player_queue, buffer, bufferFrames * sizeof(int16_t));
+  return result == SL_RESULT_SUCCESS;
 }
 
 }
@@ -12,12 +12,11 @@ SoundProcessor::SoundProcessor(JavaVM* jvm)
   , master_object(nullptr)
   , m_error_code(0)
   , m_engine(nullptr)
-  , m_mixer(nullptr)
+  , m_output_mix(nullptr)
   , m_interface(nullptr)
-  , m_players(new SoundPlayer[playersCount])
-  , m_queue_size(0)
-  , m_selected_player(0)
-  , m_impacted_block(game::Block::NONE)
+  , m_player(nullptr)
+  , m_level(nullptr)
+  , m_next_level(nullptr)
   , m_prize(game::Prize::NONE)
   , m_ball_effect(game::BallEffect::NONE) {
 
@@ -29,6 +28,8 @@ SoundProcessor::SoundProcessor(JavaVM* jvm)
   }
 
   m_load_resources_received.store(false);
+  m_load_level_received.store(false);
+  m_preload_level_received.store(false);
   m_lost_ball_received.store(false);
   m_bite_impact_received.store(false);
   m_block_impact_received.store(false);
@@ -40,6 +41,7 @@ SoundProcessor::SoundProcessor(JavaVM* jvm)
   m_laser_block_impact_received.store(false);
   m_laser_pulse_received.store(false);
   m_ball_effect_received.store(false);
+  m_is_playing = [this](const SoundBuffer* sound) { return isPlaying(sound); };
   DBG("exit SoundProcessor ctor");
 }
 
@@ -60,6 +62,22 @@ void SoundProcessor::callback_loadResources(bool /* dummy */) {
   interrupt();
 }
 
+void SoundProcessor::callback_loadLevel(game::Level::Ptr level) {
+  std::lock_guard<std::mutex> lock(m_load_level_mutex);
+  DBG("EVENT CALLBACK: callback_loadLevel");
+  m_level = level;
+  m_load_level_received.store(true);
+  interrupt();
+}
+
+void SoundProcessor::callback_preloadLevel(game::Level::Ptr level) {
+  std::lock_guard<std::mutex> lock(m_load_level_mutex);
+  DBG("EVENT CALLBACK: callback_preloadLevel");
+  m_next_level = level;
+  m_preload_level_received.store(true);
+  interrupt();
+}
+
 void SoundProcessor::callback_lostBall(game::BallLost status) {
   std::lock_guard<std::mutex> lock(m_lost_ball_mutex);
   DBG("EVENT CALLBACK: callback_lostBall(%i)", static_cast<int>(status));
@@ -82,11 +100,22 @@ void SoundProcessor::callback_biteImpact(bool /* dummy */) {
   interrupt();
 }
 
-void SoundProcessor::callback_blockImpact(game::RowCol block) {
-  std::lock_guard<std::mutex> lock(m_block_impact_mutex);
-  DBG("EVENT CALLBACK: callback_blockImpact(%i, %i, %i)", block.row, block.col, static_cast<int>(block.block));
-  m_impacted_block = block.block;
-  m_block_impact_received.store(true);
+void SoundProcessor::callback_blockChanged(game::BlockChangeBatch::Ptr batch) {
+  DBG("EVENT CALLBACK: callback_blockChanged(%zu, %zu)", batch->changes.size(), batch->explosions.size());
+  {
+    std::lock_guard<std::mutex> lock(m_block_impact_mutex);
+    for (auto& change : batch->changes) {
+      if (change.impacted) {
+        // block appeared by hit, like prize BLOCK, sounds as the new one
+        m_impacted_blocks.push_back(change.old_block != game::Block::NONE ? change.old_block : change.new_block);
+        m_block_impact_received.store(true);
+      }
+    }
+  }
+  if (!batch->explosions.empty()) {
+    std::lock_guard<std::mutex> lock(m_explosion_mutex);
+    m_explosion_received.store(true);
+  }
   interrupt();
 }
 
@@ -104,13 +133,6 @@ void SoundProcessor::callback_levelFinished(bool is_finished) {
   interrupt();
 }
 
-void SoundProcessor::callback_explosion(game::ExplosionPackage package) {
-  std::lock_guard<std::mutex> lock(m_explosion_mutex);
-  DBG("EVENT CALLBACK: callback_explosion");
-  m_explosion_received.store(true);
-  interrupt();
-}
-
 void SoundProcessor::callback_prizeCaught(game::PrizePackage package) {
   std::lock_guard<std::mutex> lock(m_prize_caught_mutex);
   DBG("EVENT CALLBACK: callback_prizeCaught");
@@ -182,6 +204,8 @@ void SoundProcessor::onStop() {
 
 bool SoundProcessor::checkForWakeUp() {
   return m_load_resources_received.load() ||
+      m_load_level_received.load() ||
+      m_preload_level_received.load() ||
       m_lost_ball_received.load() ||
       m_bite_impact_received.load() ||
       m_block_impact_received.load() ||
@@ -200,6 +224,14 @@ void SoundProcessor::eventHandler() {
     m_load_resources_received.store(false);
     process_loadResources();
   }
+  if (m_load_level_received.load()) {
+    m_load_level_received.store(false);
+    process_loadLevel();
+  }
+  if (m_preload_level_received.load()) {
+    m_preload_level_received.store(false);
+    process_preloadLevel();
+  }
   if (m_explosion_received.load()) {
     m_explosion_received.store(false);
     process_explosion();
@@ -244,6 +276,7 @@ void SoundProcessor::eventHandler() {
     m_ball_effect_received.store(false);
     process_ballEffect();
   }
+  m_scheduler.dispatch([this](game::SoundGroup group) { return playSound(group); });
 }
 
 /* Processors group */
@@ -251,115 +284,49 @@ void SoundProcessor::eventHandler() {
 void SoundProcessor::process_loadResources() {
   std::lock_guard<std::mutex> lock(m_load_resources_mutex);
   if (m_resources != nullptr) {
-    for (auto it = m_resources->beginSound(); it != m_resources->endSound(); ++it) {
-      DBG("Loading sound resources: %s %p", it->first.c_str(), it->second);
-      if (!it->second->load()) {
-        // notify Java layer about internal problem
-        m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorSoundLoad_id);
-      }
+    // sounds of blocks are prefetched by level, the rest are loaded on demand
+    bool success = true;
+    for (auto group : {game::SoundGroup::BITE, game::SoundGroup::LOSE, game::SoundGroup::WIN, game::SoundGroup::PRIZE}) {
+      success &= m_resources->prefetchSounds(group, m_is_playing);
+    }
+    if (!success) {
+      // notify Java layer about internal problem
+      m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorSoundLoad_id);
     }
   } else {
     ERR("Resources pointer was not set !");
   }
 }
 
+void SoundProcessor::process_loadLevel() {
+  std::lock_guard<std::mutex> lock(m_load_level_mutex);
+  DBG("EVENT PROCESS: process_loadLevel");
+  prefetchLevelSounds(m_level);
+}
+
+void SoundProcessor::process_preloadLevel() {
+  std::lock_guard<std::mutex> lock(m_load_level_mutex);
+  DBG("EVENT PROCESS: process_preloadLevel");
+  prefetchLevelSounds(m_next_level);
+  m_next_level = nullptr;  // level itself is kept by preloader
+}
+
 void SoundProcessor::process_lostBall() {
   std::lock_guard<std::mutex> lock(m_lost_ball_mutex);
-  auto sound = m_resources->getRandomSound("lose_");
-  playSound(sound);
+  m_scheduler.request(game::SoundGroup::LOSE);
 }
 
 void SoundProcessor::process_biteImpact() {
   std::lock_guard<std::mutex> lock(m_bite_impact_mutex);
-  auto sound = m_resources->getRandomSound("bite_");
-  playSound(sound);
+  m_scheduler.request(game::SoundGroup::BITE);
 }
 
 void SoundProcessor::process_blockImpact() {
   std::lock_guard<std::mutex> lock(m_block_impact_mutex);
-  std::string sound_prefix = "";
-
-  switch (m_impacted_block) {
-    case game::Block::ALUMINIUM:
-    case game::Block::BRICK:
-    case game::Block::CLAY:
-    case game::Block::JELLY:
-    case game::Block::ROLLING:
-    case game::Block::SIMPLE:
-      sound_prefix = "block_";
-      break;
-    case game::Block::FOG:
-      sound_prefix = "fog_";
-      break;
-    case game::Block::GLASS:
-    case game::Block::GLASS_1:
-      sound_prefix = "glass_";
-      break;
-    case game::Block::ELECTRO:
-      sound_prefix = "boom_";
-      break;
-    case game::Block::KNOCK_VERTICAL:
-    case game::Block::KNOCK_HORIZONTAL:
-      sound_prefix = "explode_";
-      break;
-    case game::Block::ARTIFICAL:
-      sound_prefix = "magic_";
-      break;
-    case game::Block::MAGIC:
-      sound_prefix = "change_";
-      break;
-    case game::Block::IRON:
-    case game::Block::STEEL:
-    case game::Block::PLUMBUM:
-      sound_prefix = "iron_";
-      break;
-    case game::Block::HYPER:
-    case game::Block::ORIGIN:
-    case game::Block::NETWORK:
-      sound_prefix = "hyper_";
-      break;
-    case game::Block::ULTRA:
-    case game::Block::ULTRA_4:
-    case game::Block::ULTRA_3:
-    case game::Block::ULTRA_2:
-    case game::Block::ULTRA_1:
-      sound_prefix = "ultra_";
-      break;
-    case game::Block::TITAN:
-    case game::Block::INVUL:
-    case game::Block::EXTRA:
-      sound_prefix = "invul_";
-      break;
-    case game::Block::QUICK:
-    case game::Block::QUICK_2:
-      sound_prefix = "prequick_";
-      break;
-    case game::Block::QUICK_1:
-      sound_prefix = "quick_";
-      break;
-    case game::Block::WATER:
-    case game::Block::YOGURT:
-    case game::Block::YOGURT_1:
-      sound_prefix = "water_";
-      break;
-    case game::Block::ZYGOTE:
-    case game::Block::ZYGOTE_1:
-    case game::Block::ZYGOTE_SPAWN:
-      sound_prefix = "zygote_";
-      break;
-    case game::Block::DESTROY:
-      sound_prefix = "destroy_";
-      break;
-    case game::Block::MIDAS:
-      sound_prefix = "midas_";
-      break;
-    case game::Block::NONE:
-    default:
-      return;  // no sound to play
+  for (auto block : m_impacted_blocks) {
+    m_scheduler.request(game::BlockUtils::getBlockSound(block));
   }
-
-  auto sound = m_resources->getRandomSound(sound_prefix);
-  playSound(sound);
+  m_impacted_blocks.clear();
 }
 
 void SoundProcessor::process_wallImpact() {
@@ -369,8 +336,7 @@ void SoundProcessor::process_wallImpact() {
 
 void SoundProcessor::process_levelFinished() {
   std::lock_guard<std::mutex> lock(m_level_finished_mutex);
-  auto sound = m_resources->getRandomSound("win_");
-  playSound(sound);
+  m_scheduler.request(game::SoundGroup::WIN);
 }
 
 void SoundProcessor::process_explosion() {
@@ -380,37 +346,7 @@ void SoundProcessor::process_explosion() {
 
 void SoundProcessor::process_prizeCaught() {
   std::lock_guard<std::mutex> lock(m_prize_caught_mutex);
-  std::string sound_prefix = "";
-
-  switch (m_prize) {
-    case game::Prize::DESTROY:
-      sound_prefix = "skull_";
-      break;
-    case game::Prize::HYPER:
-      sound_prefix = "hyper_";
-      break;
-    case game::Prize::INIT:
-      sound_prefix = "init_";
-      break;
-    case game::Prize::PROTECT:
-      sound_prefix = "protect_";
-      break;
-    case game::Prize::EXTEND:
-    case game::Prize::SHORT:
-      sound_prefix = "short_";
-      break;
-    case game::Prize::VITALITY:
-      sound_prefix = "vitality_";
-      break;
-    case game::Prize::WIN:
-      sound_prefix = "win_";
-      break;
-    default:
-      sound_prefix = "prize_";
-      break;
-  }
-  auto sound = m_resources->getRandomSound(sound_prefix);
-  playSound(sound);
+  m_scheduler.request(game::PrizeUtils::getPrizeSound(m_prize));
 }
 
 void SoundProcessor::process_laserBeamVisibility() {
@@ -425,33 +361,31 @@ void SoundProcessor::process_laserBlockImpact() {
 
 void SoundProcessor::process_laserPulse() {
   std::lock_guard<std::mutex> lock(m_laser_pulse_mutex);
-  auto sound = m_resources->getRandomSound("laser_");
-  playSound(sound);
+  m_scheduler.request(game::SoundGroup::LASER);
 }
 
 void SoundProcessor::process_ballEffect() {
   std::lock_guard<std::mutex> lock(m_ball_effect_mutex);
-  std::string sound_prefix = "";
+  game::SoundGroup group = game::SoundGroup::NONE;
 
   switch (m_ball_effect) {
     case game::BallEffect::EASY:
     case game::BallEffect::EASY_T:
     case game::BallEffect::EXPLODE:
     case game::BallEffect::JUMP:
-      sound_prefix = "boom_";
+      group = game::SoundGroup::BOOM;
       break;
     case game::BallEffect::PIERCE:
-      sound_prefix = "explode_";
+      group = game::SoundGroup::EXPLODE;
       break;
     case game::BallEffect::UPGRADE:
     case game::BallEffect::DEGRADE:
-      sound_prefix = "change_";
+      group = game::SoundGroup::CHANGE;
       break;
     default:
       return;  // no sound to play
   }
-  auto sound = m_resources->getRandomSound(sound_prefix);
-  playSound(sound);
+  m_scheduler.request(group);
 }
 
 /* CoreFunc group */
@@ -461,7 +395,6 @@ bool SoundProcessor::init() {
   const SLboolean required[1] {SL_BOOLEAN_TRUE};
   const SLInterfaceID mix_ids[] {};
   const SLboolean mix_required[] {};
-  bool queue_init_result = true;
   int error_code = 0;
 
   SLresult result = slCreateEngine(&m_engine, 0, nullptr, 1, ids, required);
@@ -470,15 +403,18 @@ bool SoundProcessor::init() {
   if (result != SL_RESULT_SUCCESS) { error_code = 2; goto ERROR_SOUND; }
   result = (*m_engine)->GetInterface(m_engine, SL_IID_ENGINE, &m_interface);
   if (result != SL_RESULT_SUCCESS) { error_code = 3; goto ERROR_SOUND; }
-  result = (*m_interface)->CreateOutputMix(m_interface, &m_mixer, 0, mix_ids, mix_required);
+  result = (*m_interface)->CreateOutputMix(m_interface, &m_output_mix, 0, mix_ids, mix_required);
   if (result != SL_RESULT_SUCCESS) { error_code = 4; goto ERROR_SOUND; }
-  result = (*m_mixer)->Realize(m_mixer, SL_BOOLEAN_FALSE);
+  result = (*m_output_mix)->Realize(m_output_mix, SL_BOOLEAN_FALSE);
   if (result != SL_RESULT_SUCCESS) { error_code = 5; goto ERROR_SOUND; }
 
-  for (int i = 0; i < SoundProcessor::playersCount; ++i) {
-    queue_init_result &= initPlayerQueue(i);
+  m_player = new SoundPlayer(m_interface, m_output_mix);
+  if (!m_player->start([this](int16_t* buffer, size_t frames) { m_mixer.mix(buffer, frames); })) {
+    m_error_code = m_player->getErrorCode();
+    destroy();
+    return false;
   }
-  return queue_init_result;
+  return true;
 
   ERROR_SOUND:
     m_error_code = 2000 + error_code;
@@ -487,101 +423,60 @@ bool SoundProcessor::init() {
     return false;
 }
 
-bool SoundProcessor::initPlayerQueue(int player_id) {
-  SLDataLocator_AndroidSimpleBufferQueue data_locator_in {
-    SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE,
-    SoundProcessor::queueMaxSize  // no more than 'queueMaxSize' sound buffer in queue at any moment
-  };
-
-  SLDataFormat_PCM data_format {
-    SL_DATAFORMAT_PCM,
-    1 /* mono sound */,
-    SL_SAMPLINGRATE_44_1,
-    SL_PCMSAMPLEFORMAT_FIXED_16,
-    SL_PCMSAMPLEFORMAT_FIXED_16,
-    SL_SPEAKER_FRONT_CENTER,
-    SL_BYTEORDER_LITTLEENDIAN
-  };
-
-  SLDataSource data_source {
-    &data_locator_in,
-    &data_format
-  };
-
-  SLDataLocator_OutputMix data_locator_out {
-    SL_DATALOCATOR_OUTPUTMIX,
-    m_mixer
-  };
-
-  SLDataSink data_sink {
-    &data_locator_out,
-    nullptr
-  };
-
-  const SLInterfaceID player_ids[2] { SL_IID_PLAY, SL_IID_BUFFERQUEUE };
-  const SLboolean player_required[2] { SL_BOOLEAN_TRUE, SL_BOOLEAN_TRUE };
-
-  int error_code = 0;
-  SLresult result = (*m_interface)->CreateAudioPlayer(m_interface, &m_players[player_id].m_player, &data_source, &data_sink, 2, player_ids, player_required);
-  if (result != SL_RESULT_SUCCESS) { error_code = 6; goto ERROR_PLAYER; }
-  result = (*m_players[player_id].m_player)->Realize(m_players[player_id].m_player, SL_BOOLEAN_FALSE);
-  if (result != SL_RESULT_SUCCESS) { error_code = 7; goto ERROR_PLAYER; }
-  result = (*m_players[player_id].m_player)->GetInterface(m_players[player_id].m_player, SL_IID_PLAY, &m_players[player_id].m_player_interface);
-  if (result != SL_RESULT_SUCCESS) { error_code = 8; goto ERROR_PLAYER; }
-  result = (*m_players[player_id].m_player)->GetInterface(m_players[player_id].m_player, SL_IID_BUFFERQUEUE, &m_players[player_id].m_player_queue);
-  if (result != SL_RESULT_SUCCESS) { error_code = 9; goto ERROR_PLAYER; }
-  result = (*m_players[player_id].m_player_interface)->SetPlayState(m_players[player_id].m_player_interface, SL_PLAYSTATE_PLAYING);
-  if (result != SL_RESULT_SUCCESS) { error_code = 10; goto ERROR_PLAYER; }
-  return true;
+bool SoundProcessor::playSound(const SoundBuffer* sound, int priority) {
+  if (sound == nullptr) return false;
+  return m_mixer.play(sound, SoundProcessor::voiceGain, priority);
+}
 
-  ERROR_PLAYER:
-    m_error_code = 2000 + error_code;
-    ERR("Error while initializing sound buffers queue: %i", m_error_code);
+bool SoundProcessor::playSound(game::SoundGroup group) {
+  auto sound = m_resources->acquireSound(group, m_is_playing);
+  if (sound == nullptr) {
+    // notify Java layer about internal problem
+    m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorSoundLoad_id);
     return false;
+  }
+  return playSound(sound, game::SoundGroupUtils::getPriority(group));
 }
 
-bool SoundProcessor::playSound(const SoundBuffer* sound) {
-  if (sound == nullptr) return false;
+bool SoundProcessor::isPlaying(const SoundBuffer* sound) {
+  return m_mixer.isPlaying(sound);
+}
 
-  if (m_selected_player >= SoundProcessor::playersCount) {
-    m_selected_player = 0;
+void SoundProcessor::prefetchLevelSounds(const game::Level::Ptr& level) {
+  if (m_resources == nullptr || level == nullptr) {
+    return;
   }
-
-  int error_code = 0;
-  SLuint32 player_state = 0;
-  (*m_players[m_selected_player].m_player)->GetState(m_players[m_selected_player].m_player, &player_state);
-
-  if (player_state == SL_OBJECT_STATE_REALIZED) {
-    SLresult result = SL_RESULT_SUCCESS;
-    if (m_queue_size >= SoundProcessor::queueMaxSize) {
-      // stop all sounds in queue before playing a new one
-      result = (*m_players[m_selected_player].m_player_queue)->Clear(m_players[m_selected_player].m_player_queue);
-      if (result != SL_RESULT_SUCCESS) { error_code = 11; goto ERROR_PLAY; }
-      m_queue_size = 0;
+  bool present[game::SoundGroupUtils::totalGroups] {};
+  for (int r = 0; r < level->numRows(); ++r) {
+    for (int c = 0; c < level->numCols(); ++c) {
+      auto group = game::BlockUtils::getBlockSound(level->getBlock(r, c));
+      if (group != game::SoundGroup::NONE) {
+        present[static_cast<int>(group)] = true;
+      }
     }
-    int16_t* buffer = reinterpret_cast<int16_t*>(sound->getData());
-    off_t length = sound->getLength();
-    result = (*m_players[m_selected_player].m_player_queue)->Enqueue(m_players[m_selected_player].m_player_queue, buffer, length);
-    if (result != SL_RESULT_SUCCESS) { error_code = 12; goto ERROR_PLAY; }
-    ++m_queue_size;
-    ++m_selected_player;
   }
-  return true;
-
-  ERROR_PLAY:
-    m_error_code = 2000 + error_code;
-    ERR("Error while playing sound %s, code: %i", sound->getName(), m_error_code);
-    return false;
+  bool success = true;
+  for (int i = 0; i < game::SoundGroupUtils::totalGroups; ++i) {
+    if (present[i]) {
+      success &= m_resources->prefetchSounds(static_cast<game::SoundGroup>(i), m_is_playing);
+    }
+  }
+  if (!success) {
+    m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorSoundLoad_id);
+  }
+  m_resources->reportSoundResidency();
 }
 
+
 void SoundProcessor::destroy() {
-  if (m_players != nullptr) {
-    delete [] m_players;
-    m_players = nullptr;
+  if (m_player != nullptr) {
+    delete m_player;  // stops output stream, so mixer is no longer accessed
+    m_player = nullptr;
   }
-  if (m_mixer != nullptr) {
-    (*m_mixer)->Destroy(m_mixer);
-    m_mixer = nullptr;
+  m_mixer.stopAll();
+  if (m_output_mix != nullptr) {
+    (*m_output_mix)->Destroy(m_output_mix);
+    m_output_mix = nullptr;
   }
   if (m_engine != nullptr) {
     (*m_engine)->Destroy(m_engine);
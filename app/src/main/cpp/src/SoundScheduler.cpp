@@ -0,0 +1,76 @@
+#include <algorithm>
+
+#include "logger.h"
+#include "SoundScheduler.h"
+
+namespace native {
+namespace sound {
+
+SoundScheduler::SoundScheduler() {
+  reset();
+}
+
+SoundScheduler::~SoundScheduler() noexcept {
+}
+
+void SoundScheduler::request(game::SoundGroup group) {
+  if (group == game::SoundGroup::NONE) {
+    return;
+  }
+  m_requested[static_cast<int>(group)] = true;
+  ++m_total_requested;
+}
+
+int SoundScheduler::dispatch(const Play& play) {
+  if (m_total_requested == 0) {
+    return 0;
+  }
+
+  game::SoundGroup pending[game::SoundGroupUtils::totalGroups];
+  int total_pending = 0;
+  for (int i = 0; i < game::SoundGroupUtils::totalGroups; ++i) {
+    if (m_requested[i]) {
+      pending[total_pending++] = static_cast<game::SoundGroup>(i);
+      m_requested[i] = false;
+    }
+  }
+  std::stable_sort(pending, pending + total_pending,
+      [](game::SoundGroup lhs, game::SoundGroup rhs) {
+        return game::SoundGroupUtils::getPriority(lhs) > game::SoundGroupUtils::getPriority(rhs);
+      });
+
+  auto now = clock::now();
+  int played = 0;
+  int ordinary = 0;
+  for (int i = 0; i < total_pending; ++i) {
+    game::SoundGroup group = pending[i];
+    if (game::SoundGroupUtils::getPriority(group) < criticalPriority) {
+      auto interval = std::chrono::milliseconds(game::SoundGroupUtils::getMinInterval(group));
+      if (ordinary >= maxPerDispatch || now - m_last_played[static_cast<int>(group)] < interval) {
+        continue;  // dropped
+      }
+      ++ordinary;
+    }
+    if (play(group)) {
+      m_last_played[static_cast<int>(group)] = now;
+      ++played;
+    }
+  }
+
+  if (m_total_requested > played) {
+    DBG("Sound scheduler: played %i of %i requests", played, m_total_requested);
+  }
+  m_total_requested = 0;
+  return played;
+}
+
+void SoundScheduler::reset() {
+  for (int i = 0; i < game::SoundGroupUtils::totalGroups; ++i) {
+    m_requested[i] = false;
+    m_last_played[i] = clock::time_point();
+  }
+  m_total_requested = 0;
+}
+
+}
+}
@@ -30,10 +30,14 @@
 #include <cctype>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "logger.h"
 #include "Texture.h"
+#include "PixelConverter.h"
+#include "TextureCache.h"
 
 
 namespace native {
@@ -43,6 +47,12 @@ Texture::Texture(AssetStorage* assets, const char* filename)
   , m_assets(assets)
   , m_filename(new char[128])
   , m_data_size(0)
+  , m_pixels(nullptr)
+  , m_pixels_mapping(0)
+  , m_cache(nullptr)
+  , m_target_format(TargetFormat::SOURCE)
+  , m_dither(false)
+  , m_source_format(0)
   , m_id(0)
   , m_format(0)
   , m_width(0)
@@ -56,6 +66,12 @@ Texture::Texture(const char* filepath)
   , m_assets(nullptr)
   , m_filename(new char[128])
   , m_data_size(0)
+  , m_pixels(nullptr)
+  , m_pixels_mapping(0)
+  , m_cache(nullptr)
+  , m_target_format(TargetFormat::SOURCE)
+  , m_dither(false)
+  , m_source_format(0)
   , m_id(0)
   , m_format(0)
   , m_width(0)
@@ -67,6 +83,7 @@ Texture::Texture(const char* filepath)
 Texture::~Texture() {
   m_assets = nullptr;
   delete [] m_filename;  m_filename = nullptr;
+  releasePixels();
   unload();
 }
 
@@ -79,19 +96,67 @@ int Texture::getErrorCode() const { return m_error_code; }
 
 const char* Texture::getName() const {
   if (m_filename != nullptr) {
-    std::string lower = m_filename;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    return basename(lower.c_str());
+    // points into m_filename, rather than into a temporary string
+    const char* slash = strrchr(m_filename, '/');
+    return slash != nullptr ? slash + 1 : m_filename;
   }
   return nullptr;
 }
 
 bool Texture::load() {
-  const uint8_t* image_buffer = loadImage();
-  if (image_buffer == nullptr) {
+  return decode() && upload();
+}
+
+bool Texture::decode() {
+  releasePixels();
+  uint32_t checksum = 0;
+  bool cacheable = m_cache != nullptr && readSourceChecksum(&checksum);
+  if (cacheable) {
+    // cached image is valid for the same conversion only
+    uint32_t policy = (static_cast<uint32_t>(m_target_format) << 1) | (m_dither ? 1 : 0);
+    checksum = TextureCache::checksum(reinterpret_cast<const uint8_t*>(&policy), sizeof(policy), checksum);
+    TextureCache::Header header;
+    m_pixels = m_cache->load(m_filename, checksum, &header, &m_pixels_mapping);
+    if (m_pixels != nullptr) {
+      DBG("Texture %s has been loaded from cache", m_filename);
+      m_format = header.format;
+      m_source_format = header.source_format;
+      m_type = header.type;
+      m_width = header.width;
+      m_height = header.height;
+      m_data_size = header.data_size;
+      return true;
+    }
+  }
+
+  m_pixels = loadImage();
+  if (m_pixels == nullptr) {
     ERR("Internal error during loading texture! Code: %i", m_error_code);
     return false;
   }
+  m_source_format = m_format;
+  convertPixels();
+  if (cacheable) {
+    TextureCache::Header header;
+    header.magic = TextureCache::magic;
+    header.version = TextureCache::version;
+    header.checksum = checksum;
+    header.format = m_format;
+    header.source_format = m_source_format;
+    header.type = m_type;
+    header.width = m_width;
+    header.height = m_height;
+    header.data_size = m_data_size;
+    m_cache->store(m_filename, header, m_pixels);
+  }
+  return true;
+}
+
+bool Texture::upload() {
+  if (m_pixels == nullptr) {
+    ERR("Texture %s has not been decoded before upload", m_filename);
+    return false;
+  }
 
   glGenTextures(1, &m_id);
   glBindTexture(GL_TEXTURE_2D, m_id);
@@ -100,8 +165,9 @@ bool Texture::load() {
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0, m_format, m_type, image_buffer);
-  delete [] image_buffer;  image_buffer = nullptr;
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // rows are tightly packed
+  glTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0, m_format, m_type, m_pixels);
+  releasePixels();
   glBindTexture(GL_TEXTURE_2D, 0);
 
   GLenum glerror = glGetError();
@@ -130,6 +196,124 @@ void Texture::apply() const {
   glBindTexture(GL_TEXTURE_2D, m_id);
 }
 
+void Texture::setCache(const TextureCache* cache) {
+  m_cache = cache;
+}
+
+void Texture::setTargetFormat(TargetFormat format, bool dither) {
+  m_target_format = format;
+  m_dither = dither;
+}
+
+size_t Texture::getMemoryUsage() const {
+  return m_data_size;
+}
+
+size_t Texture::getSourceMemoryUsage() const {
+  switch (m_source_format) {
+    case GL_RGBA:            return (size_t) m_width * m_height * 4;
+    case GL_RGB:             return (size_t) m_width * m_height * 3;
+    case GL_LUMINANCE_ALPHA: return (size_t) m_width * m_height * 2;
+    default:                 return (size_t) m_width * m_height;
+  }
+}
+
+void Texture::convertPixels() {
+  int channels = 0;
+  switch (m_format) {
+    case GL_RGBA: channels = 4; break;
+    case GL_RGB:  channels = 3; break;
+    default: break;  // gray images are already compact
+  }
+  if (m_target_format == TargetFormat::SOURCE || channels == 0) {
+    return;
+  }
+
+  size_t pixels = (size_t) m_width * m_height;
+  uint8_t* converted = new uint8_t[pixels * 2];
+  uint16_t* converted16 = reinterpret_cast<uint16_t*>(converted);
+  switch (m_target_format) {
+    case TargetFormat::RGB565:
+      convertToRGB565(m_pixels, channels, converted16, m_width, m_height, true /* premultiply */, m_dither);
+      m_format = GL_RGB;
+      m_type = GL_UNSIGNED_SHORT_5_6_5;
+      break;
+    case TargetFormat::RGBA4444:
+      convertToRGBA4444(m_pixels, channels, converted16, m_width, m_height, m_dither);
+      m_format = GL_RGBA;
+      m_type = GL_UNSIGNED_SHORT_4_4_4_4;
+      break;
+    case TargetFormat::RGBA5551:
+      convertToRGBA5551(m_pixels, channels, converted16, m_width, m_height, m_dither);
+      m_format = GL_RGBA;
+      m_type = GL_UNSIGNED_SHORT_5_5_5_1;
+      break;
+    case TargetFormat::LA88:
+      convertToLA88(m_pixels, channels, converted, m_width, m_height);
+      m_format = GL_LUMINANCE_ALPHA;
+      m_type = GL_UNSIGNED_BYTE;
+      break;
+    default:
+      break;
+  }
+  releasePixels();
+  m_pixels = converted;
+  m_data_size = pixels * 2;
+}
+
+void Texture::releasePixels() {
+  if (m_pixels_mapping != 0) {
+    TextureCache::release(m_pixels, m_pixels_mapping);
+  } else {
+    delete [] m_pixels;
+  }
+  m_pixels = nullptr;
+  m_pixels_mapping = 0;
+}
+
+bool Texture::readSourceChecksum(uint32_t* checksum) const {
+  std::vector<uint8_t> content;
+  switch (m_read_mode) {
+    case ReadMode::ASSETS:
+      {
+        // checksum is computed right over mapped content
+        const void* data = nullptr;
+        off_t length = 0;
+        AAsset* asset = nullptr;
+        if (!m_assets->map(m_filename, &data, &length, &asset)) {
+          return false;
+        }
+        bool success = length > 0;
+        if (success) {
+          *checksum = TextureCache::checksum(static_cast<const uint8_t*>(data), length);
+        }
+        AssetStorage::unmap(asset);
+        return success;
+      }
+    case ReadMode::FILESYSTEM:
+      {
+        FILE* file = std::fopen(m_filename, "rb");
+        if (file == nullptr) {
+          return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        content.resize(std::ftell(file));
+        std::fseek(file, 0, SEEK_SET);
+        bool success = std::fread(&content[0], 1, content.size(), file) == content.size();
+        std::fclose(file);
+        if (!success) {
+          return false;
+        }
+      }
+      break;
+  }
+  if (content.empty()) {
+    return false;
+  }
+  *checksum = TextureCache::checksum(&content[0], content.size());
+  return true;
+}
+
 // ----------------------------------------------------------------------------
 PNGTexture::PNGTexture(AssetStorage* assets, const char* filename)
   : Texture(assets, filename) {
@@ -143,6 +327,8 @@ PNGTexture::~PNGTexture() {
 }
 
 const uint8_t* PNGTexture::loadImage() {
+  // own reader, so that textures could be decoded concurrently
+  std::unique_ptr<AssetStorage> assets(m_assets != nullptr ? new AssetStorage(*m_assets) : nullptr);
   FILE* file_descriptor = nullptr;
   png_byte header[8];
   png_structp png_ptr = nullptr;
@@ -156,8 +342,8 @@ const uint8_t* PNGTexture::loadImage() {
   size_t header_size = sizeof(header);
   switch (m_read_mode) {
     case ReadMode::ASSETS:
-      if (!m_assets->open(m_filename)) { error_code = 1; goto ERROR_PNG; }
-      if (!m_assets->read(header, header_size)) { error_code = 2; goto ERROR_PNG; }
+      if (!assets->open(m_filename)) { error_code = 1; goto ERROR_PNG; }
+      if (!assets->read(header, header_size)) { error_code = 2; goto ERROR_PNG; }
       break;
     case ReadMode::FILESYSTEM:
       file_descriptor = std::fopen(m_filename, "rb");
@@ -174,7 +360,7 @@ const uint8_t* PNGTexture::loadImage() {
 
   switch (m_read_mode) {
     case ReadMode::ASSETS:
-      png_set_read_fn(png_ptr, m_assets, callback_read_assets);
+      png_set_read_fn(png_ptr, assets.get(), callback_read_assets);
       break;
     case ReadMode::FILESYSTEM:
       png_set_read_fn(png_ptr, file_descriptor, callback_read_file);
@@ -232,6 +418,7 @@ const uint8_t* PNGTexture::loadImage() {
 
   row_size = png_get_rowbytes(png_ptr, info_ptr);
   if (row_size <= 0) { error_code = 7; goto ERROR_PNG; }
+  m_data_size = row_size * height;
   image_buffer = new (std::nothrow) png_byte[row_size * height];
   if (image_buffer == nullptr) { error_code = 8; goto ERROR_PNG; }
 
@@ -244,7 +431,7 @@ const uint8_t* PNGTexture::loadImage() {
 
   switch (m_read_mode) {
     case ReadMode::ASSETS:
-      m_assets->close();
+      assets->close();
       break;
     case ReadMode::FILESYSTEM:
       std::fclose(file_descriptor);
@@ -259,7 +446,7 @@ const uint8_t* PNGTexture::loadImage() {
     ERR("Error while reading PNG file: %s, code %i", m_filename, m_error_code);
     switch (m_read_mode) {
       case ReadMode::ASSETS:
-        m_assets->close();
+        assets->close();
         break;
       case ReadMode::FILESYSTEM:
         std::fclose(file_descriptor);
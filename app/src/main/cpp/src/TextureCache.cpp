@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "logger.h"
+#include "TextureCache.h"
+
+namespace native {
+
+TextureCache::TextureCache(const std::string& directory)
+  : m_directory(directory) {
+  if (mkdir(m_directory.c_str(), 0700) != 0 && errno != EEXIST) {
+    ERR("Failed to create texture cache directory %s, errno %i", m_directory.c_str(), errno);
+  }
+}
+
+TextureCache::~TextureCache() noexcept {
+}
+
+const uint8_t* TextureCache::load(const char* name, uint32_t checksum, Header* header, size_t* mapping_size) const {
+  std::string path = getPath(name);
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;  // not cached yet
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  size_t size = info.st_size;
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    WRN("Failed to map cached texture %s, errno %i", path.c_str(), errno);
+    return nullptr;
+  }
+
+  std::memcpy(header, mapping, sizeof(Header));
+  if (header->magic != magic ||
+      header->version != version ||
+      header->checksum != checksum ||
+      header->data_size != size - sizeof(Header)) {
+    DBG("Cached texture %s is outdated", path.c_str());
+    munmap(mapping, size);
+    return nullptr;
+  }
+  *mapping_size = size;
+  return static_cast<const uint8_t*>(mapping) + sizeof(Header);
+}
+
+bool TextureCache::store(const char* name, const Header& header, const uint8_t* pixels) const {
+  std::string path = getPath(name);
+  std::string temp_path = path + ".tmp";
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    WRN("Failed to open %s for writing, errno %i", temp_path.c_str(), errno);
+    return false;
+  }
+  bool success =
+      std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+      std::fwrite(pixels, 1, header.data_size, file) == header.data_size;
+  success = (std::fclose(file) == 0) && success;
+  // rename is atomic, so that partially written file is never visible
+  if (!success || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    WRN("Failed to store cached texture %s", path.c_str());
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void TextureCache::release(const uint8_t* pixels, size_t mapping_size) {
+  munmap(const_cast<uint8_t*>(pixels - sizeof(Header)), mapping_size);
+}
+
+uint32_t TextureCache::checksum(const uint8_t* data, size_t size, uint32_t seed) {
+  return static_cast<uint32_t>(crc32(seed, data, size));
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+std::string TextureCache::getPath(const char* name) const {
+  std::string filename = name;
+  std::replace(filename.begin(), filename.end(), '/', '_');
+  return m_directory + "/" + filename + ".tex";
+}
+
+}  // namespace native
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "logger.h"
+#include "TextureLoader.h"
+
+namespace native {
+
+TextureLoader::TextureLoader()
+  : m_stopped(false)
+  , m_processed(0)
+  , m_total(0) {
+}
+
+TextureLoader::~TextureLoader() noexcept {
+  join();
+}
+
+void TextureLoader::decode(const std::vector<Texture*>& textures, DecodedCallback on_decoded) {
+  if (isFinished()) {
+    m_textures.clear();
+    m_processed = 0;
+    m_total = 0;
+    m_start_time = std::chrono::steady_clock::now();
+  }
+  size_t queued = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_jobs_mutex);
+    for (auto texture : textures) {
+      if (std::find(m_textures.begin(), m_textures.end(), texture) != m_textures.end()) {
+        continue;  // being loaded within current batch
+      }
+      m_textures.push_back(texture);
+      m_jobs.push_back({texture, on_decoded});
+      ++queued;
+    }
+  }
+  m_total += static_cast<int>(queued);
+  m_jobs_condition.notify_all();
+
+  if (m_workers.empty() && queued > 0) {
+    int total_workers = std::max(1u, std::thread::hardware_concurrency());
+    DBG("Starting %i texture decoding threads", total_workers);
+    for (int i = 0; i < total_workers; ++i) {
+      m_workers.emplace_back(&TextureLoader::worker, this);
+    }
+  }
+  DBG("Decoding %zu textures, %i of %i processed", queued, m_processed, m_total);
+}
+
+int TextureLoader::upload(std::chrono::milliseconds budget) {
+  auto deadline = std::chrono::steady_clock::now() + budget;
+  int failed = 0;
+  do {
+    std::pair<Texture*, bool> item;
+    {
+      std::lock_guard<std::mutex> lock(m_decoded_mutex);
+      if (m_decoded.empty()) {
+        break;
+      }
+      item = m_decoded.front();
+      m_decoded.pop();
+    }
+    if (!item.second || !item.first->upload()) {
+      ++failed;
+    }
+    ++m_processed;
+  } while (std::chrono::steady_clock::now() < deadline);
+
+  if (isFinished() && m_total > 0) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start_time);
+    INF("%i textures have been loaded in %lli ms", m_total, (long long) elapsed.count());
+    size_t memory = 0, source_memory = 0;
+    for (auto texture : m_textures) {
+      memory += texture->getMemoryUsage();
+      source_memory += texture->getSourceMemoryUsage();
+    }
+    INF("Texture memory: %zu KB (%zu KB at 8 bits per channel)", memory >> 10, source_memory >> 10);
+  }
+  return failed;
+}
+
+bool TextureLoader::hasPendingUploads() {
+  std::lock_guard<std::mutex> lock(m_decoded_mutex);
+  return !m_decoded.empty();
+}
+
+/* Private */
+// ----------------------------------------------------------------------------
+void TextureLoader::worker() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(m_jobs_mutex);
+      m_jobs_condition.wait(lock, [this]() { return m_stopped || !m_jobs.empty(); });
+      if (m_stopped) {
+        return;
+      }
+      job = m_jobs.front();
+      m_jobs.pop_front();
+    }
+    bool decoded = job.texture->decode();
+    {
+      std::lock_guard<std::mutex> lock(m_decoded_mutex);
+      m_decoded.emplace(job.texture, decoded);
+    }
+    if (job.on_decoded) {
+      job.on_decoded();
+    }
+  }
+}
+
+void TextureLoader::join() {
+  {
+    std::lock_guard<std::mutex> lock(m_jobs_mutex);
+    m_stopped = true;
+  }
+  m_jobs_condition.notify_all();
+  for (auto& worker : m_workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  m_workers.clear();
+}
+
+}  // namespace native
@@ -1,3 +1,17 @@
+#include <cstring>
+
+// UTILS_SCALAR forces scalar fills, so that host tests compare them with vector ones.
+// Both must round identically, hence this file is built with -ffp-contract=off:
+// fused multiply-add in scalar code only would break bit-exactness on arm64.
+#if defined(UTILS_SCALAR)
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define UTILS_NEON 1
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define UTILS_SSE2 1
+#endif
+
 #include "utils.h"
 
 namespace util {
@@ -11,7 +25,19 @@ int div(int def, float ratio) {
 }
 
 void setColor(const GLfloat* const bgra, GLfloat* const color_buffer, size_t size) {
-  for (size_t i = 0; i < size; i += 4) {
+  size_t i = 0;
+#if UTILS_NEON
+  const float32x4_t color = vld1q_f32(bgra);
+  for (; i + 4 <= size; i += 4) {
+    vst1q_f32(color_buffer + i, color);
+  }
+#elif UTILS_SSE2
+  const __m128 color = _mm_loadu_ps(bgra);
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(color_buffer + i, color);
+  }
+#endif
+  for (; i < size; i += 4) {
     color_buffer[i + 0] = bgra[0];
     color_buffer[i + 1] = bgra[1];
     color_buffer[i + 2] = bgra[2];
@@ -19,6 +45,40 @@ void setColor(const GLfloat* const bgra, GLfloat* const color_buffer, size_t siz
   }
 }
 
+void setColor(const BGRA<GLfloat>& bgra, GLubyte* const color_buffer, size_t size) {
+  GLubyte b = toUnsignedByte(bgra.b);
+  GLubyte g = toUnsignedByte(bgra.g);
+  GLubyte r = toUnsignedByte(bgra.r);
+  GLubyte a = toUnsignedByte(bgra.a);
+  size_t i = 0;
+#if UTILS_NEON || UTILS_SSE2
+  const GLubyte bytes[4] = { b, g, r, a };
+  uint32_t pattern;
+  std::memcpy(&pattern, bytes, sizeof(pattern));
+#  if UTILS_NEON
+  const uint8x16_t color = vreinterpretq_u8_u32(vdupq_n_u32(pattern));
+  for (; i + 16 <= size; i += 16) {
+    vst1q_u8(color_buffer + i, color);
+  }
+#  else
+  const __m128i color = _mm_set1_epi32(static_cast<int>(pattern));
+  for (; i + 16 <= size; i += 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(color_buffer + i), color);
+  }
+#  endif
+#endif
+  for (; i < size; i += 4) {
+    color_buffer[i + 0] = b;
+    color_buffer[i + 1] = g;
+    color_buffer[i + 2] = r;
+    color_buffer[i + 3] = a;
+  }
+}
+
+void setColor(const GLfloat* const bgra, GLubyte* const color_buffer, size_t size) {
+  setColor(BGRA<GLfloat>(bgra), color_buffer, size);
+}
+
 void setRectangleVertices(
     GLfloat* const array,
     GLfloat width,
@@ -28,30 +88,52 @@ void setRectangleVertices(
     size_t cols,
     size_t rows) {
 
-  size_t cols16 = cols * 16;
+  size_t cols8 = cols * 8;
   for (size_t r = 0; r < rows; ++r) {
-    for (size_t c = 0; c < cols; ++c) {
-      size_t index = (c * 16) + (r * cols16);
+    size_t c = 0;
+    GLfloat upper = y_offset - height * r;
+    GLfloat lower = y_offset - height * (r + 1);
+#if UTILS_NEON || UTILS_SSE2
+    // single rectangle is (x0, x1, x0, x1) zipped with (upper, upper, lower, lower),
+    // products and sums are rounded separately just as scalar ones
+#  if UTILS_NEON
+    const float32x4_t x = vdupq_n_f32(x_offset);
+    const float32x4_t w = vdupq_n_f32(width);
+    const float32x4_t y = { upper, upper, lower, lower };
+    float32x4_t column = { 0.0f, 1.0f, 0.0f, 1.0f };
+    for (; c < cols; ++c) {
+      float32x4x2_t corners = vzipq_f32(vaddq_f32(x, vmulq_f32(w, column)), y);
+      vst1q_f32(array + c * 8 + r * cols8, corners.val[0]);
+      vst1q_f32(array + c * 8 + r * cols8 + 4, corners.val[1]);
+      column = vaddq_f32(column, vdupq_n_f32(1.0f));
+    }
+#  else
+    const __m128 x = _mm_set1_ps(x_offset);
+    const __m128 w = _mm_set1_ps(width);
+    const __m128 y = _mm_setr_ps(upper, upper, lower, lower);
+    __m128 column = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+    for (; c < cols; ++c) {
+      __m128 edges = _mm_add_ps(x, _mm_mul_ps(w, column));
+      _mm_storeu_ps(array + c * 8 + r * cols8, _mm_unpacklo_ps(edges, y));
+      _mm_storeu_ps(array + c * 8 + r * cols8 + 4, _mm_unpackhi_ps(edges, y));
+      column = _mm_add_ps(column, _mm_set1_ps(1.0f));
+    }
+#  endif
+#endif
+    for (; c < cols; ++c) {
+      size_t index = (c * 8) + (r * cols8);
       // upper left corner
       array[index + 0] = x_offset + width * c;
-      array[index + 1] = y_offset - height * r;
-      array[index + 2] = 0.0f;
-      array[index + 3] = 1.0f;
+      array[index + 1] = upper;
       // upper right corner
-      array[index + 4] = x_offset + width * (c + 1);
-      array[index + 5] = y_offset - height * r;
-      array[index + 6] = 0.0f;
-      array[index + 7] = 1.0f;
+      array[index + 2] = x_offset + width * (c + 1);
+      array[index + 3] = upper;
       // lower left corner
-      array[index + 8] = x_offset + width * c;
-      array[index + 9] = y_offset - height * (r + 1);
-      array[index + 10] = 0.0f;
-      array[index + 11] = 1.0f;
+      array[index + 4] = x_offset + width * c;
+      array[index + 5] = lower;
       // lower right corner
-      array[index + 12] = x_offset + width * (c + 1);
-      array[index + 13] = y_offset - height * (r + 1);
-      array[index + 14] = 0.0f;
-      array[index + 15] = 1.0f;
+      array[index + 6] = x_offset + width * (c + 1);
+      array[index + 7] = lower;
     }
   }
 }
@@ -65,62 +147,75 @@ void setOctagonVertices(
     size_t cols,
     size_t rows) {
 
-  size_t cols36 = cols * 36;
+  size_t cols18 = cols * 18;
   GLfloat w2 = width * 0.5f;
   GLfloat h2 = height * 0.5f;
   GLfloat w4 = width * 0.25f;
   GLfloat h4 = height * 0.25f;
   for (size_t r = 0; r < rows; ++r) {
     for (size_t c = 0; c < cols; ++c) {
-      size_t index = (c * 36) + (r * cols36);
+      size_t index = (c * 18) + (r * cols18);
       // center
       array[index + 0] = x_offset + w2;
       array[index + 1] = y_offset - h2;
-      array[index + 2] = 0.0f;
-      array[index + 3] = 1.0f;
       // upper left corner
-      array[index + 4] = x_offset + width * c;
-      array[index + 5] = y_offset - height * r - h4;
-      array[index + 6] = 0.0f;
-      array[index + 7] = 1.0f;
-      array[index + 8] = x_offset + width * c + w4;
-      array[index + 9] = y_offset - height * r;
-      array[index + 10] = 0.0f;
-      array[index + 11] = 1.0f;
+      array[index + 2] = x_offset + width * c;
+      array[index + 3] = y_offset - height * r - h4;
+      array[index + 4] = x_offset + width * c + w4;
+      array[index + 5] = y_offset - height * r;
       // upper right corner
-      array[index + 12] = x_offset + width * (c + 1) - w4;
-      array[index + 13] = y_offset - height * r;
-      array[index + 14] = 0.0f;
-      array[index + 15] = 1.0f;
-      array[index + 16] = x_offset + width * (c + 1);
-      array[index + 17] = y_offset - height * r - h4;
-      array[index + 18] = 0.0f;
-      array[index + 19] = 1.0f;
+      array[index + 6] = x_offset + width * (c + 1) - w4;
+      array[index + 7] = y_offset - height * r;
+      array[index + 8] = x_offset + width * (c + 1);
+      array[index + 9] = y_offset - height * r - h4;
       // lower right corner
-      array[index + 20] = x_offset + width * (c + 1);
-      array[index + 21] = y_offset - height * (r + 1) + h4;
-      array[index + 22] = 0.0f;
-      array[index + 23] = 1.0f;
-      array[index + 24] = x_offset + width * (c + 1) - w4;
-      array[index + 25] = y_offset - height * (r + 1);
-      array[index + 26] = 0.0f;
-      array[index + 27] = 1.0f;
+      array[index + 10] = x_offset + width * (c + 1);
+      array[index + 11] = y_offset - height * (r + 1) + h4;
+      array[index + 12] = x_offset + width * (c + 1) - w4;
+      array[index + 13] = y_offset - height * (r + 1);
       // lower left corner
-      array[index + 28] = x_offset + width * c + w4;
-      array[index + 29] = y_offset - height * (r + 1);
-      array[index + 30] = 0.0f;
-      array[index + 31] = 1.0f;
-      array[index + 32] = x_offset + width * c;
-      array[index + 33] = y_offset - height * (r + 1) + h4;
-      array[index + 34] = 0.0f;
-      array[index + 35] = 1.0f;
+      array[index + 14] = x_offset + width * c + w4;
+      array[index + 15] = y_offset - height * (r + 1);
+      array[index + 16] = x_offset + width * c;
+      array[index + 17] = y_offset - height * (r + 1) + h4;
     }
   }
 }
 
 void rectangleIndices(GLushort* const indices, size_t size) {
+  size_t i = 0;
   size_t j = 0;
-  for (size_t i = 0; i < size; i += 6, ++j) {
+#if UTILS_NEON || UTILS_SSE2
+  // four rectangles take exactly three vectors of 8 indices
+  static const GLushort pattern[24] = {
+    0, 3, 2, 0, 1, 3,  4, 7, 6, 4, 5, 7,  8, 11, 10, 8, 9, 11,  12, 15, 14, 12, 13, 15
+  };
+#  if UTILS_NEON
+  const uint16x8_t pattern0 = vld1q_u16(pattern);
+  const uint16x8_t pattern1 = vld1q_u16(pattern + 8);
+  const uint16x8_t pattern2 = vld1q_u16(pattern + 16);
+  uint16x8_t base = vdupq_n_u16(0);
+  for (; i + 24 <= size; i += 24, j += 4) {
+    vst1q_u16(indices + i, vaddq_u16(pattern0, base));
+    vst1q_u16(indices + i + 8, vaddq_u16(pattern1, base));
+    vst1q_u16(indices + i + 16, vaddq_u16(pattern2, base));
+    base = vaddq_u16(base, vdupq_n_u16(16));
+  }
+#  else
+  const __m128i pattern0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+  const __m128i pattern1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 8));
+  const __m128i pattern2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+  __m128i base = _mm_setzero_si128();
+  for (; i + 24 <= size; i += 24, j += 4) {
+    __m128i* dst = reinterpret_cast<__m128i*>(indices + i);
+    _mm_storeu_si128(dst, _mm_add_epi16(pattern0, base));
+    _mm_storeu_si128(dst + 1, _mm_add_epi16(pattern1, base));
+    _mm_storeu_si128(dst + 2, _mm_add_epi16(pattern2, base));
+    base = _mm_add_epi16(base, _mm_set1_epi16(16));
+  }
+#  endif
+#endif
+  for (; i < size; i += 6, ++j) {
     indices[i + 0] = (GLushort) (0 + 4 * j);
     indices[i + 1] = (GLushort) (3 + 4 * j);
     indices[i + 2] = (GLushort) (2 + 4 * j);
@@ -2,9 +2,31 @@ package com.orcchg.arkanoid.surface;
 
 import android.view.Surface;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
+
 class AsyncContext {
   private final long descriptor;
   
+  /* Words of UI state block, see UiState.h */
+  private static final int UI_SEQUENCE = 0;
+  private static final int UI_SCORE = 1;
+  private static final int UI_CARDINALITY = 2;
+  private static final int UI_ANGLE = 3;
+  private static final int UI_FLAGS = 4;
+  private static final int UI_PRIZES_WRITTEN = 5;
+  private static final int UI_PRIZES = 6;
+  private static final int UI_PRIZES_CAPACITY = 16;
+  private static final int UI_FLAG_BALL_FLYING = 1;
+  
+  private final IntBuffer mUiState;
+  private int mUiSequence = 0;
+  private int mUiScore = 0;
+  private int mUiCardinality = 0;
+  private int mUiAngle = 0;
+  private int mUiPrizesRead = 0;
+  
   interface CoreEventListener {
     void onRefreshLives();
     void onRefreshLevel();
@@ -17,6 +39,7 @@ class AsyncContext {
     void onCardinalityChanged(int new_cardinality);
     void onPrizeCatch(@Prize.Type int prize);
     void onErrorTextureLoad();
+    void onTextureLoadProgress(int loaded, int total);
     void onErrorSoundLoad();
     void onDebugMessage(String message);
   }
@@ -25,6 +48,7 @@ class AsyncContext {
   
   AsyncContext(int fdn) {
     descriptor = init(fdn);
+    mUiState = getUiState(descriptor).order(ByteOrder.nativeOrder()).asIntBuffer();
   }
   
   /* Package API */
@@ -37,11 +61,36 @@ class AsyncContext {
   void loadResources() { loadResources(descriptor); }
   
   /* User actions */
-  void shiftGamepad(float position) { shiftGamepad(descriptor, position); }
+  /**
+   * Timestamped positions of user's pointer (times in nanos of uptime clock),
+   * queued lock-free and applied by render thread once per frame.
+   */
+  void shiftGamepad(final float[] positions, final long[] times, int count) {
+    shiftGamepad(descriptor, positions, times, count);
+  }
+  void setBitePrediction(boolean enabled) { setBitePrediction(descriptor, enabled); }
   void throwBall(float angle) { throwBall(descriptor, angle); }
 
   /* Tools */
   void loadLevel(final String[] level) { loadLevel(descriptor, level); }
+  /**
+   * Loads level, which is instant if it has been preloaded, then starts
+   * preloading of the next one in background.
+   */
+  void loadLevel(int index) {
+    if (!loadLevelFromPack(descriptor, index)) {
+      loadLevel(descriptor, Levels.get(index));
+    }
+    preloadLevel(index + 1);
+  }
+  void preloadLevel(int index) {
+    if (index >= Levels.TOTAL_LEVELS) {
+      index = 0;
+    }
+    if (!preloadLevelFromPack(descriptor, index)) {
+      preloadLevel(descriptor, index, Levels.get(index));
+    }
+  }
   void setBonusPrizes(int prizeType) { setBonusPrizes(descriptor, prizeType); }
   
   String saveLevel() {
@@ -56,11 +105,69 @@ class AsyncContext {
     return builder.toString();
   }
   
+  /**
+   * Complete state of game: level, ball, effects, timers and falling prizes,
+   * as compact binary snapshot, null if no level has been loaded yet.
+   * Delta snapshot could be restored only within the same session.
+   */
+  byte[] saveState(boolean delta) { return saveState(descriptor, delta); }
+  boolean restoreState(final byte[] snapshot) {
+    return snapshot != null && restoreState(descriptor, snapshot);
+  }
+  /**
+   * Recording of inputs with periodic keyframes, started with keyframe of
+   * current state. Any tick of recording is resimulated by {@link #replayState}
+   * into snapshot, so that {@link #restoreState} seeks the game to that tick.
+   */
+  boolean startRecording() { return startRecording(descriptor); }
+  byte[] stopRecording() { return stopRecording(descriptor); }
+  byte[] replayState(final byte[] recording, int tick) {
+    return recording != null ? nativeReplayState(recording, tick) : null;
+  }
+  
   /* Events coming from native Core */
   void setCoreEventListener(CoreEventListener listener) {
     mListener = listener;
   }
   
+  /**
+   * Dispatches score, cardinality, angle and caught prizes, which native
+   * threads store into shared block instead of calling Java. Supposed to be
+   * called on UI thread once per frame, cheap while nothing has changed.
+   */
+  void pollUiState() {
+    int sequence = mUiState.get(UI_SEQUENCE);
+    if (sequence == mUiSequence || mListener == null) {
+      return;
+    }
+    mUiSequence = sequence;
+    
+    int written = mUiState.get(UI_PRIZES_WRITTEN);
+    if (written - mUiPrizesRead > UI_PRIZES_CAPACITY) {
+      mUiPrizesRead = written - UI_PRIZES_CAPACITY;  // overwritten ones are lost
+    }
+    for (; mUiPrizesRead != written; ++mUiPrizesRead) {
+      mListener.onPrizeCatch(mUiState.get(UI_PRIZES + mUiPrizesRead % UI_PRIZES_CAPACITY));
+    }
+    int score = mUiState.get(UI_SCORE);
+    if (score != mUiScore) {
+      mListener.onScoreUpdated(score - mUiScore);
+      mUiScore = score;
+    }
+    int cardinality = mUiState.get(UI_CARDINALITY);
+    if (cardinality != mUiCardinality) {
+      mUiCardinality = cardinality;
+      mListener.onCardinalityChanged(cardinality);
+    }
+    int angle = mUiState.get(UI_ANGLE);
+    if (angle != mUiAngle) {
+      mUiAngle = angle;
+      mListener.onAngleChanged(angle);
+    }
+  }
+  
+  boolean isBallFlying() { return (mUiState.get(UI_FLAGS) & UI_FLAG_BALL_FLYING) != 0; }
+  
   void fireJavaEvent_refreshLives() {
     if (mListener != null) {
       mListener.onRefreshLives();
@@ -103,27 +210,15 @@ class AsyncContext {
     }
   }
   
-  void fireJavaEvent_angleChanged(int angle) {
-    if (mListener != null) {
-      mListener.onAngleChanged(angle);
-    }
-  }
-  
-  void fireJavaEvent_cardinalityChanged(int new_cardinality) {
-    if (mListener != null) {
-      mListener.onCardinalityChanged(new_cardinality);
-    }
-  }
-  
-  void fireJavaEvent_prizeCatch(int prize) {
+  void fireJavaEvent_errorTextureLoad() {
     if (mListener != null) {
-      mListener.onPrizeCatch(prize);
+      mListener.onErrorTextureLoad();
     }
   }
   
-  void fireJavaEvent_errorTextureLoad() {
+  void fireJavaEvent_textureLoadProgress(int loaded, int total) {
     if (mListener != null) {
-      mListener.onErrorTextureLoad();
+      mListener.onTextureLoadProgress(loaded, total);
     }
   }
   
@@ -150,12 +245,22 @@ class AsyncContext {
   private native void loadResources(long descriptor);
   
   /* User actions */
-  private native void shiftGamepad(long descriptor, float position);
+  private native void shiftGamepad(long descriptor, float[] positions, long[] times, int count);
+  private native void setBitePrediction(long descriptor, boolean enabled);
   private native void throwBall(long descriptor, float angle);
   
   /* Tools */
   private native void loadLevel(long descriptor, String[] in_level);
+  private native boolean loadLevelFromPack(long descriptor, int index);
+  private native void preloadLevel(long descriptor, int index, String[] in_level);
+  private native boolean preloadLevelFromPack(long descriptor, int index);
   private native String[] saveLevel(long descriptor);
+  private native byte[] saveState(long descriptor, boolean delta);
+  private native boolean restoreState(long descriptor, byte[] snapshot);
+  private native ByteBuffer getUiState(long descriptor);
+  private native boolean startRecording(long descriptor);
+  private native byte[] stopRecording(long descriptor);
+  private static native byte[] nativeReplayState(byte[] recording, int tick);  //!< headless, needs no context
   private native void setBonusPrizes(long descriptor, int prizeType);
   private native void drop(long descriptor);
   private native int getScore(long descriptor);
@@ -23,6 +23,10 @@ public class GameSurface extends SurfaceView implements SurfaceHolder.Callback {
   float touchCurrentY = 0.0f;
   float VERTICAL_SWIPE_THRESHOLD;
   
+  /* Samples of a single motion event, including historical ones */
+  float[] mTouchPositions = new float[16];
+  long[] mTouchTimes = new long[16];
+  
   WeakReference<AsyncContext> mAsyncContextRef;
   
   public GameSurface(Context context) {
@@ -74,11 +78,11 @@ public class GameSurface extends SurfaceView implements SurfaceHolder.Callback {
         touchCurrentY = event.getY();
         break;
       case MotionEvent.ACTION_MOVE:
-        float position = event.getX() - mHalfWidth;
         if (mAsyncContextRef != null) {
           AsyncContext acontext = mAsyncContextRef.get();
           if (acontext != null) {
-            acontext.shiftGamepad(position / mHalfWidth);
+            int count = collectTouchSamples(event);
+            acontext.shiftGamepad(mTouchPositions, mTouchTimes, count);
           }
         }
         break;
@@ -112,6 +116,26 @@ public class GameSurface extends SurfaceView implements SurfaceHolder.Callback {
   
   /* Internal methods */
   // --------------------------------------------------------------------------
+  /**
+   * Puts historical and current positions of motion event, normalized,
+   * along with their times (in nanos) into re-usable arrays.
+   */
+  int collectTouchSamples(final MotionEvent event) {
+    int history = event.getHistorySize();
+    int count = history + 1;
+    if (mTouchPositions.length < count) {
+      mTouchPositions = new float[count * 2];
+      mTouchTimes = new long[count * 2];
+    }
+    for (int i = 0; i < history; ++i) {
+      mTouchPositions[i] = (event.getHistoricalX(i) - mHalfWidth) / mHalfWidth;
+      mTouchTimes[i] = event.getHistoricalEventTime(i) * 1000000L;
+    }
+    mTouchPositions[history] = (event.getX() - mHalfWidth) / mHalfWidth;
+    mTouchTimes[history] = event.getEventTime() * 1000000L;
+    return count;
+  }
+  
   void setAsyncContext(final AsyncContext acontext) {
     mAsyncContextRef = new WeakReference<>(acontext);
   }
@@ -10,6 +10,8 @@ import android.graphics.Color;
 import android.graphics.drawable.Drawable;
 import android.graphics.drawable.GradientDrawable;
 import android.os.Bundle;
+import android.os.Handler;
+import android.os.Looper;
 import android.view.KeyEvent;
 import android.view.MenuItem;
 import android.view.View;
@@ -23,6 +25,10 @@ import com.orcchg.arkanoid.R;
 import com.orcchg.arkanoid.surface.Database.DatabaseException;
 import com.orcchg.arkanoid.surface.Database.GameStat;
 
+import java.io.Closeable;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
 import java.io.IOException;
 import java.lang.ref.WeakReference;
 
@@ -33,6 +39,8 @@ public class MainActivity extends FragmentActivity {
   static final int INITIAL_LIVES = 3;
   static final int INITIAL_LEVEL = 0;
   static final int INITIAL_SCORE = 0;
+  static final String SNAPSHOT_FILENAME = "game_state.snapshot";
+  static final long UI_POLL_DELAY_MILLIS = 16;  // once per UI frame
   int currentLives = INITIAL_LIVES;
   int currentLevel = INITIAL_LEVEL;
   int currentScore = INITIAL_SCORE;
@@ -56,6 +64,15 @@ public class MainActivity extends FragmentActivity {
 
   EdgeColor mEdgeColor;
   
+  final Handler mUiPollHandler = new Handler(Looper.getMainLooper());
+  final Runnable mUiPollRunnable = new Runnable() {
+    @Override
+    public void run() {
+      mAsyncContext.pollUiState();
+      mUiPollHandler.postDelayed(this, UI_POLL_DELAY_MILLIS);
+    }
+  };
+  
   @Override
   protected void onCreate(Bundle savedInstanceState) {
     super.onCreate(savedInstanceState);
@@ -93,19 +110,8 @@ public class MainActivity extends FragmentActivity {
     
     // ------------------------------------------
     mNativeResources = new NativeResources(getAssets(), getFilesDir().getAbsolutePath());
-    try {
-      String[] texture_resources = getAssets().list("texture");
-      for (String texture : texture_resources) {
-//        Timber.d(TAG, "Texture asset: " + texture);
-        mNativeResources.readTexture(texture);
-      }
-      String[] sound_resources = getAssets().list("sound");
-      for (String sound : sound_resources) {
-//        Timber.d(TAG, "Sound asset: " + sound);
-        mNativeResources.readSound(sound);
-      }
-    } catch (IOException e) {
-      e.printStackTrace();
+    if (!mNativeResources.readAssets()) {
+      Timber.e("Failed to read assets");
     }
     mAsyncContext.setResourcesPtr(mNativeResources.getPtr());
     
@@ -143,14 +149,24 @@ public class MainActivity extends FragmentActivity {
       mAsyncContext.fireJavaEvent_refreshLevel();
       mAsyncContext.fireJavaEvent_refreshScore();
     }
-    mAsyncContext.loadLevel(Levels.get(currentLevel, level_state));
+    if (level_state.isEmpty()) {
+      mAsyncContext.loadLevel(currentLevel);
+    } else {
+      if (!mAsyncContext.restoreState(readSnapshot())) {
+        mAsyncContext.loadLevel(Levels.get(currentLevel, level_state));
+      }
+      mAsyncContext.preloadLevel(currentLevel + 1);
+    }
     setBonusPrizes();
+    mUiPollHandler.post(mUiPollRunnable);
     super.onResume();
   }
   
   @Override
   protected void onPause() {
     Timber.d("onPause");
+    mUiPollHandler.removeCallbacks(mUiPollRunnable);
+    mAsyncContext.pollUiState();  // the latest score goes to stat
     setStat(PLAYER_ID, currentLives, currentLevel, currentScore);
     mAsyncContext.stop();
     finish();
@@ -197,13 +213,14 @@ public class MainActivity extends FragmentActivity {
       case R.id.dropStat:
         ArkanoidApplication app = (ArkanoidApplication) getApplication();
         app.DATABASE.clearStat(PLAYER_ID);
+        writeSnapshot(null);
         setLives(INITIAL_LIVES);
         setLevel(INITIAL_LEVEL);
         setScore(INITIAL_SCORE);
         mAsyncContext.fireJavaEvent_refreshLives();
         mAsyncContext.fireJavaEvent_refreshLevel();
         mAsyncContext.fireJavaEvent_refreshScore();
-        mAsyncContext.loadLevel(Levels.get(currentLevel));
+        mAsyncContext.loadLevel(currentLevel);
         setBonusPrizes();
         break;
     }
@@ -216,7 +233,7 @@ public class MainActivity extends FragmentActivity {
     Timber.i("Game is lost!");
     setLives(INITIAL_LIVES);
     mAsyncContext.fireJavaEvent_refreshLives();
-    mAsyncContext.loadLevel(Levels.get(currentLevel, ""));
+    mAsyncContext.loadLevel(currentLevel);
     setBonusPrizes();
   }
   
@@ -234,6 +251,7 @@ public class MainActivity extends FragmentActivity {
     Timber.i("Stat to be stored: [%s, %s, %s]", lives, level, score);
     String levelState = mAsyncContext.saveLevel();
     Timber.i("Level: %s", levelState);
+    writeSnapshot(mAsyncContext.saveState(false));
     if (!app.DATABASE.updateStat(player_id, lives, level, score, levelState)) {
       try {
         app.DATABASE.insertStat(player_id, lives, level, score, levelState);
@@ -243,6 +261,62 @@ public class MainActivity extends FragmentActivity {
     }
   }
   
+  /** Keeps snapshot of game state next to stat, removes it if null. */
+  void writeSnapshot(byte[] snapshot) {
+    File file = new File(getFilesDir(), SNAPSHOT_FILENAME);
+    if (snapshot == null) {
+      if (file.exists() && !file.delete()) {
+        Timber.w("Unable to delete snapshot");
+      }
+      return;
+    }
+    FileOutputStream stream = null;
+    try {
+      stream = new FileOutputStream(file);
+      stream.write(snapshot);
+    } catch (IOException e) {
+      Timber.e(e, "Unable to write snapshot");
+    } finally {
+      closeSilently(stream);
+    }
+  }
+  
+  byte[] readSnapshot() {
+    File file = new File(getFilesDir(), SNAPSHOT_FILENAME);
+    if (!file.exists()) {
+      return null;
+    }
+    byte[] snapshot = new byte[(int) file.length()];
+    FileInputStream stream = null;
+    try {
+      stream = new FileInputStream(file);
+      int offset = 0;
+      while (offset < snapshot.length) {
+        int read = stream.read(snapshot, offset, snapshot.length - offset);
+        if (read < 0) {
+          return null;
+        }
+        offset += read;
+      }
+    } catch (IOException e) {
+      Timber.e(e, "Unable to read snapshot");
+      return null;
+    } finally {
+      closeSilently(stream);
+    }
+    return snapshot;
+  }
+  
+  private static void closeSilently(Closeable closeable) {
+    if (closeable != null) {
+      try {
+        closeable.close();
+      } catch (IOException e) {
+        // nothing to do
+      }
+    }
+  }
+  
   void setLives(int lives) {
     int auxLives = lives;
     if (lives > mLifeViews.length) {
@@ -421,7 +495,7 @@ public class MainActivity extends FragmentActivity {
           currentLevel = INITIAL_LEVEL;
         }
         activity.setLevel(currentLevel);
-        activity.mAsyncContext.loadLevel(Levels.get(currentLevel));
+        activity.mAsyncContext.loadLevel(currentLevel);
         activity.setBonusPrizes();
         activity.levelFinishedAdditional();
       }
@@ -498,7 +572,7 @@ public class MainActivity extends FragmentActivity {
         case Prize.INIT:
           final MainActivity activity = activityRef.get();
           if (activity != null) {
-            activity.mAsyncContext.loadLevel(Levels.get(currentLevel, ""));
+            activity.mAsyncContext.loadLevel(currentLevel);
             activity.setBonusPrizes();
           }
           break;
@@ -577,6 +651,11 @@ public class MainActivity extends FragmentActivity {
       warningDialog();
     }
     
+    @Override
+    public void onTextureLoadProgress(int loaded, int total) {
+      Timber.d("Textures loaded: %s / %s", loaded, total);
+    }
+    
     @Override
     public void onErrorSoundLoad() {
       warningDialog();
@@ -14,14 +14,12 @@ class NativeResources {
   
   /* Package API */
   // --------------------------------------------------------------------------
-  boolean readTexture(String filename) { return readTexture(descriptor, filename); }
-  boolean readSound(String filename) { return readSound(descriptor, filename); }
+  boolean readAssets() { return readAssets(descriptor); }
   void release() { release(descriptor); }
   
   /* Private methods */
   // --------------------------------------------------------------------------
   private native long init(AssetManager assets, String internal_storage);
-  private native boolean readTexture(long descriptor, String filename);
-  private native boolean readSound(long descriptor, String filename);
+  private native boolean readAssets(long descriptor);
   private native void release(long descriptor);
 }
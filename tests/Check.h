@@ -0,0 +1,38 @@
+#ifndef __ARKANOID_TESTS_CHECK__H__
+#define __ARKANOID_TESTS_CHECK__H__
+
+#include <cstdio>
+
+/**
+ * @file Check.h
+ * @brief Minimal assertions for host tests: failed check is reported
+ * and counted, test executable returns non-zero if any check has failed.
+ */
+namespace test {
+
+/// @brief Total checks failed so far.
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+/// @brief Exit status of test executable.
+inline int status() {
+  if (failures() > 0) {
+    fprintf(stderr, "%i check(s) failed\n", failures());
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+#define CHECK(condition)                                                     \
+  do {                                                                       \
+    if (!(condition)) {                                                      \
+      fprintf(stderr, "%s:%i: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      ++test::failures();                                                    \
+    }                                                                        \
+  } while (false)
+
+#endif  // __ARKANOID_TESTS_CHECK__H__
@@ -0,0 +1,176 @@
+/**
+ * Level pack: levels written by tools/levelpack are read back the same,
+ * either RLE or raw encoded, while corrupted or truncated packs are
+ * rejected without reading past their end.
+ *
+ *   level_pack_test [level pack]
+ *
+ * Level pack generated from Levels.java, if given, must load every level.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "Level.h"
+#include "LevelPack.h"
+#include "LevelPackWriter.h"
+
+using game::Level;
+using game::LevelEncoding;
+using game::LevelPack;
+using game::LevelPackHeader;
+using game::LevelRecord;
+
+/// @brief Levels of blocks with runs both shorter and longer than 255 cells.
+static std::vector<std::vector<std::string>> testLevels() {
+  std::string wide(200, 'A');
+  return {
+    { "ABCD", "DCBA", "ABCD" },                  // no runs, stored raw
+    { wide, wide, std::string(200, ' '), wide },  // runs over rows, longer than 255
+    { "AAAA", "", "AA" },                        // shorter rows are padded with blanks
+    { "S" }
+  };
+}
+
+/// @brief Level strings padded to the widest row.
+static std::vector<std::string> padded(const std::vector<std::string>& rows) {
+  size_t cols = 0;
+  for (auto& row : rows) {
+    cols = std::max(cols, row.length());
+  }
+  std::vector<std::string> result;
+  for (auto& row : rows) {
+    result.push_back(row + std::string(cols - row.length(), ' '));
+  }
+  return result;
+}
+
+static const LevelRecord* record(const std::vector<uint8_t>& pack, int index) {
+  const LevelPackHeader* header = reinterpret_cast<const LevelPackHeader*>(pack.data());
+  const uint32_t* table = reinterpret_cast<const uint32_t*>(pack.data() + header->table_offset);
+  return reinterpret_cast<const LevelRecord*>(pack.data() + table[index]);
+}
+
+static void testRLE() {
+  CHECK(tools::encodeRLE({}).empty());
+  std::vector<uint8_t> cells(600, 'A');
+  cells.push_back('B');
+  std::vector<uint8_t> expected = { 255, 'A', 255, 'A', 90, 'A', 1, 'B' };
+  CHECK(tools::encodeRLE(cells) == expected);
+}
+
+/// @brief Levels are read back as written, with encoding chosen by size.
+static void testRoundTrip() {
+  auto levels = testLevels();
+  std::vector<uint8_t> pack;
+  tools::writeLevelPack(levels, &pack);
+  LevelPack reader(pack.data(), pack.size(), nullptr);
+  CHECK(reader.isValid());
+  CHECK(reader.getCount() == static_cast<int>(levels.size()));
+  for (int i = 0; i < reader.getCount(); ++i) {
+    Level::Ptr level = reader.load(i);
+    CHECK(level != nullptr);
+    if (level != nullptr) {
+      std::vector<std::string> rows;
+      level->toStringArray(&rows);
+      CHECK(rows == padded(levels[i]));
+    }
+  }
+  CHECK(record(pack, 0)->encoding == static_cast<uint8_t>(LevelEncoding::RAW));
+  CHECK(record(pack, 1)->encoding == static_cast<uint8_t>(LevelEncoding::RLE));
+  CHECK(reader.load(-1) == nullptr && reader.load(reader.getCount()) == nullptr);
+}
+
+/// @brief Every truncation of pack is rejected, copied to exact size so that overreads are caught.
+static void testTruncated() {
+  std::vector<uint8_t> pack;
+  tools::writeLevelPack(testLevels(), &pack);
+  for (size_t size = 0; size < pack.size(); ++size) {
+    std::vector<uint8_t> truncated(pack.begin(), pack.begin() + size);
+    LevelPack reader(truncated.data(), truncated.size(), nullptr);
+    CHECK(!reader.isValid() && reader.getCount() == 0 && reader.load(0) == nullptr);
+  }
+}
+
+/// @brief Corrupted header and table invalidate pack, corrupted level is not loaded.
+static void testCorrupted() {
+  std::vector<uint8_t> pack;
+  tools::writeLevelPack(testLevels(), &pack);
+  auto corrupt = [&pack](size_t offset, uint8_t value) {
+    std::vector<uint8_t> copy(pack);
+    copy[offset] = value;
+    return copy;
+  };
+  auto tableOffset = [&pack](int index) {
+    return reinterpret_cast<const LevelPackHeader*>(pack.data())->table_offset + index * sizeof(uint32_t);
+  };
+  auto recordOffset = [&pack](int index) {
+    return static_cast<size_t>(reinterpret_cast<const uint8_t*>(record(pack, index)) - pack.data());
+  };
+
+  {  // magic
+    std::vector<uint8_t> copy = corrupt(0, 'X');
+    CHECK(!LevelPack(copy.data(), copy.size(), nullptr).isValid());
+  }
+  {  // version
+    std::vector<uint8_t> copy = corrupt(offsetof(LevelPackHeader, version), LevelPack::version + 1);
+    CHECK(!LevelPack(copy.data(), copy.size(), nullptr).isValid());
+  }
+  {  // count beyond table
+    std::vector<uint8_t> copy = corrupt(offsetof(LevelPackHeader, count) + 3, 0x7F);
+    CHECK(!LevelPack(copy.data(), copy.size(), nullptr).isValid());
+  }
+  {  // offsets out of order
+    std::vector<uint8_t> copy(pack);
+    std::fill(copy.begin() + tableOffset(1), copy.begin() + tableOffset(2), 0);
+    CHECK(!LevelPack(copy.data(), copy.size(), nullptr).isValid());
+  }
+  {  // unknown encoding
+    std::vector<uint8_t> copy = corrupt(recordOffset(0) + offsetof(LevelRecord, encoding), 7);
+    LevelPack reader(copy.data(), copy.size(), nullptr);
+    CHECK(reader.isValid() && reader.load(0) == nullptr && reader.load(1) != nullptr);
+  }
+  {  // raw cell, caught by checksum
+    std::vector<uint8_t> copy = corrupt(recordOffset(0) + sizeof(LevelRecord), 'S');
+    LevelPack reader(copy.data(), copy.size(), nullptr);
+    CHECK(reader.isValid() && reader.load(0) == nullptr);
+  }
+  {  // run longer than level
+    std::vector<uint8_t> copy = corrupt(recordOffset(1) + sizeof(LevelRecord), 255);
+    copy[recordOffset(1) + sizeof(LevelRecord) + 2] = 255;
+    LevelPack reader(copy.data(), copy.size(), nullptr);
+    CHECK(reader.isValid() && reader.load(1) == nullptr);
+  }
+  {  // rows of record larger than payload of raw level
+    std::vector<uint8_t> copy = corrupt(recordOffset(0) + offsetof(LevelRecord, rows), 200);
+    LevelPack reader(copy.data(), copy.size(), nullptr);
+    CHECK(reader.isValid() && reader.load(0) == nullptr);
+  }
+}
+
+/// @brief Pack generated from Levels.java loads every level.
+static void testShippedPack(const char* path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file.good());
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  LevelPack reader(data.data(), data.size(), nullptr);
+  CHECK(reader.isValid() && reader.getCount() > 0);
+  for (int i = 0; i < reader.getCount(); ++i) {
+    CHECK(reader.load(i) != nullptr);
+  }
+}
+
+int main(int argc, char** argv) {
+  testRLE();
+  testRoundTrip();
+  testTruncated();
+  testCorrupted();
+  if (argc > 1) {
+    testShippedPack(argv[1]);
+  }
+  return test::status();
+}
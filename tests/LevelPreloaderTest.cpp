@@ -0,0 +1,108 @@
+/**
+ * LevelPreloader: takeLevel() never waits for worker, level still being
+ * preloaded is dropped; repeated preload of the same level is skipped.
+ */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Check.h"
+#include "LevelPreloader.h"
+
+using game::Level;
+using game::LevelPreloader;
+
+static const GLfloat aspect = 0.5625f;
+
+/// @brief Source of level which is blocked until released.
+class GatedSource {
+public:
+  GatedSource() : m_open(false), calls(0) {}
+
+  LevelPreloader::Source get() {
+    return [this]() {
+      ++calls;
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_open; });
+      return Level::fromStringArray({ "AAAA", "B  B" }, 2);
+    };
+  }
+
+  void release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_open = true;
+    m_condition.notify_all();
+  }
+
+  std::atomic<int> calls;
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_open;
+};
+
+/// @brief Waits for level to be preloaded along with its geometry.
+static bool waitForLevel(LevelPreloader* preloader, int index) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!preloader->isPreloaded(index)) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+/// @brief Level taken while worker is blocked: no waiting, result dropped.
+static void testTakeLevelInProgress() {
+  LevelPreloader preloader;
+  preloader.setAspect(aspect);
+  GatedSource source;
+  preloader.preload(3, source.get(), nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+  CHECK(preloader.takeLevel(3) == nullptr);
+  CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+  source.release();
+
+  // level dropped, so it's preloaded again rather than skipped
+  std::atomic<int> loaded(0);
+  GatedSource again;
+  again.release();
+  preloader.preload(3, again.get(), [&loaded](Level::Ptr) { ++loaded; });
+  CHECK(waitForLevel(&preloader, 3) && loaded.load() == 1);
+  Level::Ptr level = preloader.takeLevel(3);
+  CHECK(level != nullptr);
+
+  game::PreparedLevel prepared;
+  CHECK(preloader.takeGeometry(level, aspect, &prepared));
+  CHECK(prepared.vertices.size() == level->size() * 8);
+}
+
+/// @brief Preload of the same level while it's being preloaded or ready is skipped.
+static void testPreloadSameLevel() {
+  LevelPreloader preloader;
+  preloader.setAspect(aspect);
+  std::atomic<int> loaded(0);
+  GatedSource source;
+  preloader.preload(5, source.get(), [&loaded](Level::Ptr) { ++loaded; });
+  preloader.preload(5, source.get(), [&loaded](Level::Ptr) { ++loaded; });  // in progress
+  source.release();
+  CHECK(waitForLevel(&preloader, 5) && loaded.load() == 1);
+  preloader.preload(5, source.get(), [&loaded](Level::Ptr) { ++loaded; });  // ready
+  CHECK(source.calls.load() == 1);
+  CHECK(!preloader.isPreloaded(4));
+  CHECK(preloader.takeLevel(4) == nullptr);  // other level
+  CHECK(preloader.takeLevel(5) != nullptr);
+  CHECK(preloader.takeLevel(5) == nullptr);  // taken once
+  CHECK(!preloader.isPreloaded(5));
+}
+
+int main() {
+  testTakeLevelInProgress();
+  testPreloadSameLevel();
+  return test::status();
+}
@@ -0,0 +1,68 @@
+/**
+ * Level versioning: clones share rows copy-on-write, so that neither
+ * published snapshot nor level it's been cloned from sees blocks set
+ * by the other one afterwards.
+ */
+#include "Check.h"
+#include "Level.h"
+
+using game::Block;
+using game::Level;
+using game::RowCol;
+
+/// @brief Rows shared by clone are copied on write, both ways.
+static void testCloneCopyOnWrite() {
+  Level::Ptr level = Level::fromStringArray({ "AAAA", "BBBB" }, 2);
+  Level::Ptr snapshot = level->clone();
+  level->setBlock(0, 1, Block::NONE);
+  CHECK(level->getBlock(0, 1) == Block::NONE);
+  CHECK(snapshot->getBlock(0, 1) == Block::ALUMINIUM);
+  CHECK(snapshot->getBlock(1, 1) == level->getBlock(1, 1));
+
+  Level::Ptr copy = snapshot->clone();
+  copy->setBlock(1, 2, Block::NONE);
+  CHECK(snapshot->getBlock(1, 2) != Block::NONE);
+  CHECK(level->getBlock(1, 2) != Block::NONE);
+}
+
+/// @brief Row copied once is owned until the next clone.
+static void testCloneAfterWrite() {
+  Level::Ptr level = Level::fromStringArray({ "AAAA", "BBBB" }, 2);
+  Level::Ptr first = level->clone();
+  level->setBlock(0, 0, Block::NONE);
+  level->setBlock(0, 1, Block::NONE);  // row is private already
+  Level::Ptr second = level->clone();
+  level->setBlock(0, 2, Block::NONE);
+
+  CHECK(first->getBlock(0, 0) == Block::ALUMINIUM && first->getBlock(0, 1) == Block::ALUMINIUM);
+  CHECK(second->getBlock(0, 0) == Block::NONE && second->getBlock(0, 1) == Block::NONE);
+  CHECK(second->getBlock(0, 2) == Block::ALUMINIUM);
+  CHECK(level->getBlock(0, 2) == Block::NONE);
+  first.reset();
+  second.reset();
+  level->setBlock(1, 0, Block::NONE);  // rows outlive released clones
+  CHECK(level->getBlock(1, 0) == Block::NONE && level->getBlock(1, 1) != Block::NONE);
+}
+
+/// @brief Journal holds cells set since the last commit, with new blocks.
+static void testCommit() {
+  Level::Ptr level = Level::fromStringArray({ "AAAA", "BBBB" }, 2);
+  CHECK(!level->hasChanges());
+  level->setBlock(1, 3, Block::NONE);
+  level->setBlock(0, 2, Block::ALUMINIUM);
+  CHECK(level->hasChanges());
+
+  std::vector<RowCol> changes;
+  CHECK(level->commit(&changes) == level->getVersion() && level->getVersion() == 1);
+  CHECK(changes.size() == 2);
+  CHECK(changes[0].row == 1 && changes[0].col == 3 && changes[0].block == Block::NONE);
+  CHECK(changes[1].row == 0 && changes[1].col == 2 && changes[1].block == Block::ALUMINIUM);
+  CHECK(!level->hasChanges() && level->clone()->getVersion() == 1);
+}
+
+int main() {
+  testCloneCopyOnWrite();
+  testCloneAfterWrite();
+  testCommit();
+  return test::status();
+}
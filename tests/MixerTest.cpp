@@ -0,0 +1,292 @@
+/**
+ * Mixer: output of vectorized mixing of PCM16 and IMA-ADPCM voices
+ * must match scalar reference bit-exactly, directly and through sinks.
+ *
+ *   mixer_test [--benchmark iterations]
+ *
+ * With --benchmark all voices are mixed into buffers of typical size,
+ * timed against scalar reference mixing samples decoded beforehand.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "AudioSink.h"
+#include "Check.h"
+#include "ImaAdpcm.h"
+#include "Mixer.h"
+#include "RiffReader.h"
+#include "SoundBuffer.h"
+
+using native::ImaAdpcm;
+using native::SoundBuffer;
+using native::sound::Mixer;
+
+/// @brief Sound made of samples in memory.
+class MemorySound : public SoundBuffer {
+public:
+  MemorySound(const char* name, const std::vector<int16_t>& samples, Encoding encoding)
+    : SoundBuffer(name, encoding)
+    , m_samples(samples) {
+    load();
+  }
+
+  /// @brief Samples as they are heard, i.e. decoded if encoded.
+  std::vector<int16_t> getDecodedSamples() const {
+    if (m_encoding == Encoding::PCM16) {
+      return m_samples;
+    }
+    std::vector<int16_t> decoded(m_frames);
+    std::vector<int16_t> block(getSamplesPerBlock());
+    for (size_t offset = 0, index = 0; offset < decoded.size(); ++index) {
+      size_t count = decodeBlock(index, &block[0]);
+      std::copy(block.begin(), block.begin() + count, decoded.begin() + offset);
+      offset += count;
+    }
+    return decoded;
+  }
+
+protected:
+  const uint8_t* loadSound() override final {
+    m_frames = m_samples.size();
+    if (m_encoding == Encoding::PCM16) {
+      m_length = m_samples.size() * sizeof(int16_t);
+      return reinterpret_cast<const uint8_t*>(m_samples.data());
+    }
+    m_block_align = ImaAdpcm::defaultBlockAlign;
+    m_length = ImaAdpcm::getEncodedSize(m_samples.size(), m_block_align);
+    m_owned_data = new uint8_t[m_length];
+    ImaAdpcm::encode(m_samples.data(), m_samples.size(), m_block_align, m_owned_data);
+    return m_owned_data;
+  }
+
+private:
+  std::vector<int16_t> m_samples;
+};
+
+struct Voice {
+  std::vector<int16_t> samples;  //!< Decoded samples.
+  float gain;
+  size_t start;  //!< Frame of output where voice starts.
+};
+
+/// @brief Scalar reference of Mixer: Q14 gain, 32-bit accumulation, saturation.
+static std::vector<int16_t> mixReference(const std::vector<Voice>& voices, size_t frames) {
+  std::vector<int32_t> accumulator(frames, 0);
+  for (auto& voice : voices) {
+    int32_t gain = std::min(32767, static_cast<int>(voice.gain * (1 << 14) + 0.5f));
+    for (size_t i = 0; i < voice.samples.size() && voice.start + i < frames; ++i) {
+      accumulator[voice.start + i] += (static_cast<int32_t>(voice.samples[i]) * gain) >> 14;
+    }
+  }
+  std::vector<int16_t> output(frames);
+  for (size_t i = 0; i < frames; ++i) {
+    output[i] = static_cast<int16_t>(std::min(32767, std::max(-32768, accumulator[i])));
+  }
+  return output;
+}
+
+static std::vector<int16_t> makeTone(size_t frames, float frequency, float amplitude) {
+  std::vector<int16_t> samples(frames);
+  for (size_t i = 0; i < frames; ++i) {
+    samples[i] = static_cast<int16_t>(amplitude * std::sin(6.2831853f * frequency * i / SoundBuffer::outputSampleRate));
+  }
+  return samples;
+}
+
+static std::vector<int16_t> makeNoise(size_t frames, uint32_t seed) {
+  std::vector<int16_t> samples(frames);
+  for (size_t i = 0; i < frames; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    samples[i] = static_cast<int16_t>(seed >> 16);
+  }
+  return samples;
+}
+
+/// @brief Mixes in chunks of odd size, so that vector loops have tails.
+static void testDirect() {
+  MemorySound tone("tone", makeTone(3001, 440.0f, 12000.0f), SoundBuffer::Encoding::PCM16);
+  MemorySound noise("noise", makeNoise(5003, 7), SoundBuffer::Encoding::PCM16);
+  MemorySound encoded("encoded", makeTone(4000, 1000.0f, 20000.0f), SoundBuffer::Encoding::IMA_ADPCM);
+  MemorySound late("late", makeNoise(777, 11), SoundBuffer::Encoding::PCM16);
+
+  const size_t chunk = 333;
+  const size_t frames = 7 * chunk * 3;
+  std::vector<Voice> voices = {
+      {tone.getDecodedSamples(), 1.0f, 0},
+      {noise.getDecodedSamples(), 0.7f, 0},
+      {encoded.getDecodedSamples(), 2.0f, 0},  // saturates along with others
+      {late.getDecodedSamples(), 1.3f, 4 * chunk}};
+  std::vector<int16_t> expected = mixReference(voices, frames);
+
+  Mixer mixer;
+  CHECK(mixer.play(&tone, 1.0f, 0));
+  CHECK(mixer.play(&noise, 0.7f, 0));
+  CHECK(mixer.play(&encoded, 2.0f, 0));
+  std::vector<int16_t> output(frames);
+  for (size_t offset = 0; offset < frames; offset += chunk) {
+    if (offset == voices[3].start) {
+      CHECK(mixer.play(&late, 1.3f, 0));
+    }
+    mixer.mix(&output[offset], chunk);
+  }
+  CHECK(output == expected);
+  CHECK(!mixer.isPlaying(&tone) && !mixer.isPlaying(&encoded));
+}
+
+/// @brief Buffer larger than accumulator is mixed in chunks seamlessly.
+static void testLargeBuffer() {
+  MemorySound tone("tone", makeTone(Mixer::maxChunkFrames * 3 + 17, 330.0f, 25000.0f), SoundBuffer::Encoding::IMA_ADPCM);
+  MemorySound noise("noise", makeNoise(Mixer::maxChunkFrames + 5, 5), SoundBuffer::Encoding::PCM16);
+  const size_t frames = Mixer::maxChunkFrames * 4 + 99;
+  std::vector<Voice> voices = {
+      {tone.getDecodedSamples(), 1.5f, 0},
+      {noise.getDecodedSamples(), 0.8f, 0}};
+
+  Mixer mixer;
+  CHECK(mixer.play(&tone, 1.5f, 0));
+  CHECK(mixer.play(&noise, 0.8f, 0));
+  std::vector<int16_t> output(frames);
+  mixer.mix(&output[0], frames);
+  CHECK(output == mixReference(voices, frames));
+  CHECK(!mixer.isPlaying(&tone) && !mixer.isPlaying(&noise));
+}
+
+/// @brief Mixes through WavFileSink and reads the file back.
+static void testWavFileSink() {
+  MemorySound tone("tone", makeTone(20000, 220.0f, 30000.0f), SoundBuffer::Encoding::IMA_ADPCM);
+  MemorySound noise("noise", makeNoise(9000, 3), SoundBuffer::Encoding::PCM16);
+
+  char path[] = "/tmp/mixer_test_XXXXXX";
+  int descriptor = mkstemp(path);
+  CHECK(descriptor >= 0);
+  if (descriptor < 0) {
+    return;
+  }
+  close(descriptor);
+
+  Mixer mixer;
+  CHECK(mixer.play(&tone, 0.9f, 0));
+  CHECK(mixer.play(&noise, 1.1f, 0));
+  {
+    native::sound::WavFileSink sink(path);
+    CHECK(sink.start([&mixer](int16_t* buffer, size_t frames) { mixer.mix(buffer, frames); }));
+    while (sink.getRenderedFrames() < 20000) {
+      std::this_thread::yield();
+    }
+    sink.stop();
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  std::remove(path);
+
+  native::PCMFormat format;
+  const uint8_t* pcm = nullptr;
+  size_t pcm_size = 0;
+  CHECK(native::parseWAV(content.data(), content.size(), &format, &pcm, &pcm_size) == native::RiffError::NONE);
+  if (pcm == nullptr) {
+    return;
+  }
+  CHECK(format.audio_format == native::WAVE_FORMAT_PCM && format.channels == 1 && format.bits_per_sample == 16);
+  CHECK(format.sample_rate == SoundBuffer::outputSampleRate);
+  size_t frames = pcm_size / sizeof(int16_t);
+  CHECK(frames >= 20000 && frames % native::sound::NullSink::bufferFrames == 0);
+
+  std::vector<int16_t> output(frames);
+  std::copy(pcm, pcm + frames * sizeof(int16_t), reinterpret_cast<uint8_t*>(&output[0]));
+  std::vector<Voice> voices = {
+      {tone.getDecodedSamples(), 0.9f, 0},
+      {noise.getDecodedSamples(), 1.1f, 0}};
+  CHECK(output == mixReference(voices, frames));
+}
+
+/// @brief Real-time NullSink pulls buffers at pace of playback.
+static void testNullSink() {
+  Mixer mixer;
+  native::sound::NullSink sink;
+  CHECK(sink.start([&mixer](int16_t* buffer, size_t frames) { mixer.mix(buffer, frames); }));
+  CHECK(!sink.start([](int16_t*, size_t) {}));  // already running
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sink.stop();
+  size_t rendered = sink.getRenderedFrames();
+  // ~4410 frames within 100 ms, i.e. a few buffers rather than thousands
+  CHECK(rendered >= native::sound::NullSink::bufferFrames);
+  CHECK(rendered <= 16 * native::sound::NullSink::bufferFrames);
+}
+
+/* Benchmark */
+// ----------------------------------------------------------------------------
+/// @brief Times mixing of all voices, half of them encoded, into buffers
+/// of NullSink size, as the audio callback does.
+static void benchmark(int iterations) {
+  const size_t length = SoundBuffer::outputSampleRate;  // 1 s sounds, replayed while mixing
+  const size_t buffer = native::sound::NullSink::bufferFrames;
+  std::vector<std::unique_ptr<MemorySound>> sounds;
+  std::vector<Voice> voices;
+  for (int i = 0; i < Mixer::maxVoices; ++i) {
+    auto encoding = i % 2 == 0 ? SoundBuffer::Encoding::PCM16 : SoundBuffer::Encoding::IMA_ADPCM;
+    sounds.emplace_back(new MemorySound("voice", makeTone(length, 100.0f + 50.0f * i, 2000.0f), encoding));
+    voices.push_back({sounds.back()->getDecodedSamples(), 0.5f, 0});
+  }
+
+  Mixer mixer;
+  std::vector<int16_t> output(buffer);
+  const int restart = static_cast<int>(length / buffer);  // voices are restarted before they end
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (i % restart == 0) {
+      for (auto& sound : sounds) {
+        mixer.play(sound.get(), 0.5f, 0);
+      }
+    }
+    mixer.mix(&output[0], buffer);
+  }
+  std::chrono::duration<double, std::nano> mixer_ns = std::chrono::steady_clock::now() - start;
+
+  std::vector<int32_t> accumulator(buffer);
+  int32_t gain = 1 << 13;  // 0.5 in Q14
+  volatile int16_t sink = 0;  // keeps reference from being optimized out
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    size_t offset = static_cast<size_t>(i % restart) * buffer;
+    std::fill(accumulator.begin(), accumulator.end(), 0);
+    for (auto& voice : voices) {
+      for (size_t j = 0; j < buffer; ++j) {
+        accumulator[j] += (static_cast<int32_t>(voice.samples[offset + j]) * gain) >> 14;
+      }
+    }
+    for (size_t j = 0; j < buffer; ++j) {
+      output[j] = static_cast<int16_t>(std::min(32767, std::max(-32768, accumulator[j])));
+    }
+    sink = output[0];
+  }
+  std::chrono::duration<double, std::nano> reference_ns = std::chrono::steady_clock::now() - start;
+
+  double frames = static_cast<double>(iterations) * buffer;
+  std::printf("mix %d voices (%zu frames)  mixer ns/frame  reference ns/frame  realtime x\n", Mixer::maxVoices, buffer);
+  std::printf("%31.2f  %18.2f  %10.0f\n", mixer_ns.count() / frames, reference_ns.count() / frames,
+      1e9 / SoundBuffer::outputSampleRate / (mixer_ns.count() / frames));
+}
+
+int main(int argc, char** argv) {
+  testDirect();
+  testLargeBuffer();
+  testWavFileSink();
+  testNullSink();
+
+  if (argc == 3 && std::strcmp(argv[1], "--benchmark") == 0) {
+    benchmark(std::atoi(argv[2]));
+  }
+  return test::status();
+}
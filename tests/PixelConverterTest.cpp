@@ -0,0 +1,219 @@
+/**
+ * Conversions of PixelConverter.cpp: vector paths (NEON / SSE2), or
+ * scalar ones if built with PIXEL_CONVERTER_SCALAR, must match scalar
+ * reference bit-exactly for every format, RGB and RGBA source, with and
+ * without dithering and premultiplication, and for any width, including
+ * vector tails.
+ *
+ *   pixel_converter_test [--benchmark iterations]
+ *
+ * With --benchmark conversions of 1024 x 1024 background are timed against reference.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "PixelConverter.h"
+
+/* Reference */
+// ----------------------------------------------------------------------------
+namespace reference {
+
+static const uint8_t bayer[4][4] = {
+  { 0,  8,  2, 10},
+  {12,  4, 14,  6},
+  { 3, 11,  1,  9},
+  {15,  7, 13,  5}
+};
+
+static uint32_t dither(uint32_t value, uint32_t threshold, int bits) {
+  return std::min(255u, value + ((threshold << (8 - bits)) >> 4));
+}
+
+static void convertToRGB565(const uint8_t* src, int channels, uint16_t* dst,
+                            uint32_t width, uint32_t height, bool premultiply, bool use_dither) {
+  for (size_t i = 0; i < (size_t) width * height; ++i) {
+    const uint8_t* px = src + i * channels;
+    uint32_t r = px[0], g = px[1], b = px[2];
+    if (premultiply && channels == 4) {
+      uint32_t a = px[3];
+      r = (r * a + 127) / 255;
+      g = (g * a + 127) / 255;
+      b = (b * a + 127) / 255;
+    }
+    if (use_dither) {
+      uint32_t threshold = bayer[(i / width) & 3][(i % width) & 3];
+      r = dither(r, threshold, 5);
+      g = dither(g, threshold, 6);
+      b = dither(b, threshold, 5);
+    }
+    dst[i] = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+  }
+}
+
+static void convertToRGBA4444(const uint8_t* src, int channels, uint16_t* dst,
+                              uint32_t width, uint32_t height, bool use_dither) {
+  for (size_t i = 0; i < (size_t) width * height; ++i) {
+    const uint8_t* px = src + i * channels;
+    uint32_t r = px[0], g = px[1], b = px[2];
+    uint32_t a = channels == 4 ? px[3] : 255;
+    if (use_dither) {
+      uint32_t threshold = bayer[(i / width) & 3][(i % width) & 3];
+      r = dither(r, threshold, 4);
+      g = dither(g, threshold, 4);
+      b = dither(b, threshold, 4);
+    }
+    dst[i] = static_cast<uint16_t>(((r >> 4) << 12) | ((g >> 4) << 8) | ((b >> 4) << 4) | (a >> 4));
+  }
+}
+
+static void convertToRGBA5551(const uint8_t* src, int channels, uint16_t* dst,
+                              uint32_t width, uint32_t height, bool use_dither) {
+  for (size_t i = 0; i < (size_t) width * height; ++i) {
+    const uint8_t* px = src + i * channels;
+    uint32_t r = px[0], g = px[1], b = px[2];
+    uint32_t a = channels == 4 ? px[3] : 255;
+    if (use_dither) {
+      uint32_t threshold = bayer[(i / width) & 3][(i % width) & 3];
+      r = dither(r, threshold, 5);
+      g = dither(g, threshold, 5);
+      b = dither(b, threshold, 5);
+    }
+    dst[i] = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 3) << 6) | ((b >> 3) << 1) | (a >> 7));
+  }
+}
+
+static void convertToLA88(const uint8_t* src, int channels, uint8_t* dst,
+                          uint32_t width, uint32_t height) {
+  for (size_t i = 0; i < (size_t) width * height; ++i) {
+    const uint8_t* px = src + i * channels;
+    dst[i * 2 + 0] = static_cast<uint8_t>((px[0] * 77 + px[1] * 150 + px[2] * 29 + 128) >> 8);
+    dst[i * 2 + 1] = channels == 4 ? px[3] : 255;
+  }
+}
+
+}  // namespace reference
+
+/* Test */
+// ----------------------------------------------------------------------------
+/// @brief Random image, with extremes frequent enough to hit saturation
+/// of dithering and zero or opaque alpha.
+static std::vector<uint8_t> randomImage(std::mt19937* rng, size_t size) {
+  static const uint8_t extremes[] = { 0, 1, 127, 128, 254, 255 };
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> image(size);
+  for (auto& value : image) {
+    int random = byte(*rng);
+    value = random < 64 ? extremes[random % sizeof(extremes)] : static_cast<uint8_t>(byte(*rng));
+  }
+  return image;
+}
+
+static void testConversions(std::mt19937* rng) {
+  const uint32_t heights[] = { 1, 3, 5 };
+  for (int channels = 3; channels <= 4; ++channels) {
+    for (uint32_t width = 1; width <= 70; ++width) {
+      for (uint32_t height : heights) {
+        size_t pixels = (size_t) width * height;
+        std::vector<uint8_t> image = randomImage(rng, pixels * channels);
+        // guards past the end catch overwrites by vector tails
+        std::vector<uint16_t> converted(pixels + 16, 0xdead), expected(converted);
+        std::vector<uint8_t> converted8(pixels * 2 + 32, 0xad), expected8(converted8);
+        for (int dither = 0; dither <= 1; ++dither) {
+          for (int premultiply = 0; premultiply <= 1; ++premultiply) {
+            native::convertToRGB565(&image[0], channels, &converted[0], width, height, premultiply, dither);
+            reference::convertToRGB565(&image[0], channels, &expected[0], width, height, premultiply, dither);
+            CHECK(converted == expected);
+          }
+          native::convertToRGBA4444(&image[0], channels, &converted[0], width, height, dither);
+          reference::convertToRGBA4444(&image[0], channels, &expected[0], width, height, dither);
+          CHECK(converted == expected);
+
+          native::convertToRGBA5551(&image[0], channels, &converted[0], width, height, dither);
+          reference::convertToRGBA5551(&image[0], channels, &expected[0], width, height, dither);
+          CHECK(converted == expected);
+        }
+        native::convertToLA88(&image[0], channels, &converted8[0], width, height);
+        reference::convertToLA88(&image[0], channels, &expected8[0], width, height);
+        CHECK(converted8 == expected8);
+      }
+    }
+  }
+}
+
+/// @brief Every value against every alpha, premultiplied and dithered on each row of Bayer matrix.
+static void testPremultiplyExhaustive() {
+  const uint32_t width = 256, height = 4;
+  for (uint32_t alpha = 0; alpha < 256; ++alpha) {
+    std::vector<uint8_t> image(width * height * 4);
+    for (uint32_t i = 0; i < width * height; ++i) {
+      uint8_t value = static_cast<uint8_t>(i % width);
+      image[i * 4 + 0] = value;
+      image[i * 4 + 1] = static_cast<uint8_t>(255 - value);
+      image[i * 4 + 2] = value;
+      image[i * 4 + 3] = static_cast<uint8_t>(alpha);
+    }
+    std::vector<uint16_t> converted(width * height), expected(width * height);
+    native::convertToRGB565(&image[0], 4, &converted[0], width, height, true, true);
+    reference::convertToRGB565(&image[0], 4, &expected[0], width, height, true, true);
+    CHECK(converted == expected);
+  }
+}
+
+/* Benchmark */
+// ----------------------------------------------------------------------------
+template <typename Func>
+static double measure(int iterations, Func func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func();
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+/// @brief Times conversions with settings of Resources::setTextureFormat().
+static void benchmark(std::mt19937* rng, int iterations) {
+  const uint32_t width = 1024, height = 1024;
+  std::vector<uint8_t> rgba = randomImage(rng, width * height * 4);
+  std::vector<uint8_t> rgb = randomImage(rng, width * height * 3);
+  std::vector<uint16_t> converted(width * height);
+  uint8_t* converted8 = reinterpret_cast<uint8_t*>(&converted[0]);
+  volatile uint16_t sink = 0;  // keeps conversions from being optimized out
+
+  std::printf("conversion (%ux%u)                 converter us  reference us\n", width, height);
+  for (int channels = 3; channels <= 4; ++channels) {
+    const uint8_t* src = channels == 4 ? &rgba[0] : &rgb[0];
+    double rgb565_us = measure(iterations, [&]() {
+      native::convertToRGB565(src, channels, &converted[0], width, height, true, true); sink = converted[width]; });
+    double rgb565_reference_us = measure(iterations, [&]() {
+      reference::convertToRGB565(src, channels, &converted[0], width, height, true, true); sink = converted[width]; });
+    double rgba4444_us = measure(iterations, [&]() {
+      native::convertToRGBA4444(src, channels, &converted[0], width, height, true); sink = converted[width]; });
+    double rgba4444_reference_us = measure(iterations, [&]() {
+      reference::convertToRGBA4444(src, channels, &converted[0], width, height, true); sink = converted[width]; });
+    double la88_us = measure(iterations, [&]() {
+      native::convertToLA88(src, channels, converted8, width, height); sink = converted[width]; });
+    double la88_reference_us = measure(iterations, [&]() {
+      reference::convertToLA88(src, channels, converted8, width, height); sink = converted[width]; });
+    const char* source = channels == 4 ? "RGBA" : "RGB ";
+    std::printf("%s RGB565, premultiplied, dithered  %12.0f  %12.0f\n", source, rgb565_us, rgb565_reference_us);
+    std::printf("%s RGBA4444, dithered               %12.0f  %12.0f\n", source, rgba4444_us, rgba4444_reference_us);
+    std::printf("%s LA88                             %12.0f  %12.0f\n", source, la88_us, la88_reference_us);
+  }
+}
+
+int main(int argc, char** argv) {
+  std::mt19937 rng(33);
+  testConversions(&rng);
+  testPremultiplyExhaustive();
+  if (argc == 3 && std::strcmp(argv[1], "--benchmark") == 0) {
+    benchmark(&rng, std::atoi(argv[2]));
+  }
+  return test::status();
+}
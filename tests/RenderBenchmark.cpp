@@ -0,0 +1,447 @@
+/**
+ * Headless render benchmark: scripted game session is drawn by Renderer,
+ * the very draw routines of AsyncContext, with textures decoded from shipped
+ * PNG assets, into off-screen surface of Mesa surfaceless EGL display,
+ * and RenderProfiler statistics are reported.
+ *
+ *   render_benchmark --assets <shipped assets> --levels <generated assets>
+ *                    [--level 0] [--frames 600] [--width 720] [--height 1280]
+ *                    [--max-frame-ms 16.7]
+ *
+ * Session advances by fixed frame time, so that every run draws the same
+ * frames: ball bounces across the field with bite following it, blocks are
+ * knocked out one by one with explosions, some of them drop prizes caught
+ * by bite, laser fires periodically and ball's effect changes. Level is
+ * reloaded once it's cleared.
+ *
+ * Fails if p90 frame time exceeds --max-frame-ms, returns 77 (skipped)
+ * if EGL is not available.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+
+#include "AssetStorage.h"
+#include "Check.h"
+#include "ExplosionPackage.h"
+#include "Level.h"
+#include "LevelPack.h"
+#include "LevelPreloader.h"
+#include "Params.h"
+#include "PrizePackage.h"
+#include "Renderer.h"
+#include "Resources.h"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+static constexpr int skipped = 77;
+
+struct Options {
+  std::string assets;
+  std::string levels;
+  int level = 0;
+  int frames = 600;
+  int width = 720;
+  int height = 1280;
+  float max_frame_ms = 0.0f;  //!< No budget if zero.
+};
+
+static bool parseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--assets") == 0) {
+      options->assets = argv[i + 1];
+    } else if (strcmp(argv[i], "--levels") == 0) {
+      options->levels = argv[i + 1];
+    } else if (strcmp(argv[i], "--level") == 0) {
+      options->level = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "--frames") == 0) {
+      options->frames = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "--width") == 0) {
+      options->width = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "--height") == 0) {
+      options->height = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "--max-frame-ms") == 0) {
+      options->max_frame_ms = static_cast<float>(atof(argv[i + 1]));
+    } else {
+      return false;
+    }
+  }
+  return !options->assets.empty() && !options->levels.empty() &&
+         options->frames > 0 && options->width > 0 && options->height > 0;
+}
+
+/* Headless EGL */
+// ----------------------------------------------------------------------------
+struct HeadlessContext {
+  EGLDisplay display = EGL_NO_DISPLAY;
+  EGLSurface surface = EGL_NO_SURFACE;
+  EGLContext context = EGL_NO_CONTEXT;
+
+  bool init(int width, int height) {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay != nullptr) {
+      display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+      display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+      display = EGL_NO_DISPLAY;
+      return false;
+    }
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE};
+    EGLConfig config;
+    EGLint total_configs = 0;
+    if (!eglChooseConfig(display, config_attribs, &config, 1, &total_configs) || total_configs == 0) {
+      return false;
+    }
+    const EGLint surface_attribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    const EGLint context_attribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT) {
+      return false;
+    }
+    return eglMakeCurrent(display, surface, surface, context);
+  }
+
+  ~HeadlessContext() {
+    if (display == EGL_NO_DISPLAY) {
+      return;
+    }
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT) {
+      eglDestroyContext(display, context);
+    }
+    if (surface != EGL_NO_SURFACE) {
+      eglDestroySurface(display, surface);
+    }
+    eglTerminate(display);
+  }
+};
+
+/* Assets */
+// ----------------------------------------------------------------------------
+static game::Level::Ptr loadLevel(const std::string& levels, int index) {
+  std::ifstream file(levels + "/" + game::LevelPack::filename, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  game::LevelPack pack(data.data(), data.size(), nullptr);
+  return pack.load(index);
+}
+
+/// @brief Decodes and uploads all textures but backgrounds, and one background
+/// the way AsyncContext acquires it. Disk cache is bypassed, so that it isn't
+/// filled in temporary storage.
+/// @return Background, nullptr if any texture has failed to load.
+static native::Texture* loadTextures(game::Resources* resources) {
+  for (auto it = resources->beginTexture(); it != resources->endTexture(); ++it) {
+    if (!game::Resources::isBackground(it->first)) {
+      it->second->setCache(nullptr);
+      if (!it->second->load()) {
+        fprintf(stderr, "Failed to load texture %s\n", it->first.c_str());
+        return nullptr;
+      }
+    }
+  }
+  native::Texture* background = resources->acquireBackground();
+  if (background != nullptr) {
+    background->setCache(nullptr);
+    if (!background->load()) {
+      return nullptr;
+    }
+  }
+  return background;
+}
+
+static void removeDirectory(const std::string& path) {
+  if (DIR* dir = opendir(path.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_type == DT_REG) {
+        std::remove((path + "/" + entry->d_name).c_str());
+      }
+    }
+    closedir(dir);
+  }
+  rmdir(path.c_str());
+}
+
+/* Session */
+// ----------------------------------------------------------------------------
+static constexpr float frameTime = 1.0f / 60.0f;  //!< Fixed step of session, seconds.
+static constexpr int impactPeriod = 6;    //!< Frames between block impacts.
+static constexpr int prizePeriod = 4;     //!< Impacts between dropped prizes.
+static constexpr int laserPeriod = 60;    //!< Frames of laser being off, then on.
+static constexpr int effectPeriod = 90;   //!< Frames between changes of ball's effect.
+static constexpr float laserPulse = 0.6f;          //!< As in AsyncContext::drawLaser().
+static constexpr float prizeCatchDuration = 1.0f;  //!< As in AsyncContext::drawPrizeCatch().
+
+static const game::BallEffect effects[] = {
+    game::BallEffect::NONE, game::BallEffect::EASY, game::BallEffect::EXPLODE, game::BallEffect::GOO,
+    game::BallEffect::PIERCE, game::BallEffect::MIRROR, game::BallEffect::PROTECT};
+
+/// @brief Triangle wave of @a period, ranging from 0 to 1.
+static GLfloat triangle(float time, float period) {
+  float phase = time / period;
+  return 2.0f * std::fabs(phase - std::floor(phase + 0.5f));
+}
+
+/// @brief Game session scripted frame by frame, drawn by Renderer in the
+/// same stages as AsyncContext::render() does.
+class Session {
+public:
+  Session(game::Renderer* renderer, const game::Resources& resources, game::Level::Ptr origin, GLfloat aspect)
+    : impacts(0), prizes_dropped(0), prizes_caught(0), reloads(0)
+    , m_renderer(renderer)
+    , m_origin(origin)
+    , m_dimens(0, 0, 0.0f, 0.0f, 0.0f, 0.0f)
+    , m_aspect(aspect)
+    , m_bite(game::BiteParams::biteWidth, game::BiteParams::biteHeight * aspect)
+    , m_ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect)
+    , m_cursor(0)
+    , m_laser_time(0.0f)
+    , m_catch_time(0.0f) {
+    for (int i = 1; i < game::PrizeUtils::totalPrizes; ++i) {
+      game::Prize prize = static_cast<game::Prize>(i);
+      if (resources.getPrizeTexture(prize) != nullptr) {
+        m_prizes.push_back(prize);
+      }
+    }
+    loadLevel();
+  }
+
+  /// @brief Advances session by one frame and draws it.
+  void frame(int index) {
+    advance(index);
+    render(index);
+  }
+
+  int impacts;
+  int prizes_dropped;
+  int prizes_caught;
+  int reloads;
+
+private:
+  struct FallingPrize {
+    game::PrizePackage package;
+    float time;  //!< Time of falling, seconds.
+  };
+
+  void loadLevel() {
+    m_level = m_origin->clone();
+    game::PreparedLevel prepared;
+    prepared.level = m_level->clone();
+    game::LevelPreloader::buildGeometry(m_aspect, &prepared);
+    m_dimens = prepared.dimens;
+    m_renderer->setLevel(prepared.level, &prepared);
+    m_cursor = 0;
+  }
+
+  void advance(int index) {
+    float time = index * frameTime;
+    GLfloat ball_x = -0.9f + 1.8f * triangle(time, 2.3f);
+    GLfloat ball_y = -game::BiteParams::neg_biteElevation + m_ball.getDimens().halfHeight() + 1.6f * triangle(time, 1.7f);
+    m_bite.setXPose(ball_x);
+    m_renderer->setBitePose(m_bite, ball_x);
+    m_renderer->setBallPose(m_ball, ball_x, ball_y);
+    if (index % effectPeriod == 0) {
+      m_renderer->setBiteBallAppearance(effects[index / effectPeriod % (sizeof(effects) / sizeof(effects[0]))]);
+    }
+    if (index % impactPeriod == 0) {
+      impact();
+    }
+
+    for (auto& prize : m_falling_prizes) {
+      prize.time += frameTime;
+    }
+    for (auto it = m_falling_prizes.begin(); it != m_falling_prizes.end();) {
+      if (it->package.getY() - it->time * game::PrizeParams::prizeSpeed < -game::BiteParams::neg_biteElevation) {
+        m_caught_x.push_back(m_bite.getXPose());
+        m_catch_time = 0.0f;
+        ++prizes_caught;
+        it = m_falling_prizes.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (!m_caught_x.empty()) {
+      m_catch_time += frameTime;
+      if (m_catch_time >= prizeCatchDuration) {
+        m_catch_time = 0.0f;
+        m_caught_x.clear();
+      }
+    }
+    m_laser_time = isLaserOn(index) ? std::fmod(m_laser_time + frameTime, laserPulse) : 0.0f;
+  }
+
+  /// @brief Knocks out the next block of level, which explodes and might drop
+  /// a prize. Level is reloaded once it's cleared.
+  void impact() {
+    int total = m_level->size();
+    while (m_cursor < total && m_level->getBlock(m_cursor / m_level->numCols(), m_cursor % m_level->numCols()) == game::Block::NONE) {
+      ++m_cursor;
+    }
+    if (m_cursor == total) {
+      loadLevel();
+      ++reloads;
+      return;
+    }
+    int row = m_cursor / m_level->numCols();
+    int col = m_cursor % m_level->numCols();
+    game::Block block = m_level->getBlock(row, col);
+    m_level->setBlock(row, col, game::Block::NONE);
+    std::vector<game::RowCol> changes;
+    m_level->commit(&changes);
+    m_renderer->changeLevel(m_level->clone(), changes);
+
+    // center of block, as by GameProcessor::getCenterOfBlock()
+    GLfloat top = 0.0f, bottom = 0.0f, left = 0.0f, right = 0.0f;
+    m_dimens.getBlockDimens(row, col, &top, &bottom, &left, &right);
+    GLfloat x = 0.5f * (right + left) - 1.0f;
+    GLfloat y = -0.5f * (bottom + top) + 1.0f;
+    m_renderer->spawnExplosion(game::ExplosionPackage(x, y, game::BlockUtils::getBlockColor(block), static_cast<game::Kind>(impacts % 3)));
+    if (impacts % prizePeriod == 0 && !m_prizes.empty()) {
+      game::Prize prize = m_prizes[prizes_dropped % m_prizes.size()];
+      m_falling_prizes.push_back({game::PrizePackage(x, y, prize), 0.0f});
+      ++prizes_dropped;
+    }
+    ++impacts;
+  }
+
+  inline bool isLaserOn(int index) const { return index / laserPeriod % 2 == 1; }
+
+  void render(int index) {
+    util::RenderProfiler& profiler = m_renderer->getProfiler();
+    m_renderer->beginFrame();
+    m_renderer->drawStaticLayer();
+    profiler.endStage(util::RenderStage::STATIC_LAYER);
+    m_renderer->drawBite();
+    m_renderer->drawBall();
+    profiler.endStage(util::RenderStage::BITE_BALL);
+
+    m_renderer->drawExplosion();
+    profiler.endStage(util::RenderStage::EXPLOSION);
+
+    if (isLaserOn(index)) {
+      GLfloat y = -game::BiteParams::neg_biteElevation;
+      bool is_visible = y + m_laser_time * game::LaserParams::laserSpeed <= 1.0f + game::LaserParams::laserHalfHeight;
+      m_renderer->drawLaser(m_bite.getXPose(), y, m_laser_time, is_visible);
+    }
+    for (auto& prize : m_falling_prizes) {
+      m_renderer->drawPrize(prize.package, prize.time, true);
+    }
+    for (auto& x : m_caught_x) {
+      m_renderer->drawPrizeCatch(x, -game::BiteParams::neg_biteElevation, util::MIDAS, m_catch_time);
+    }
+    profiler.endStage(util::RenderStage::SPRITES);
+
+    glFinish();  // pbuffer is not swapped, wait for driver instead
+    profiler.endStage(util::RenderStage::SWAP);
+    m_renderer->endFrame();
+  }
+
+  game::Renderer* m_renderer;
+  game::Level::Ptr m_origin;  //!< Level as loaded from pack, reloaded once cleared.
+  game::Level::Ptr m_level;   //!< Working copy of level, blocks are knocked out of.
+  game::LevelDimens m_dimens;
+  GLfloat m_aspect;
+  game::Bite m_bite;
+  game::Ball m_ball;
+  int m_cursor;  //!< Cell to look for the next block to knock out from.
+  std::vector<game::Prize> m_prizes;  //!< Prizes having textures.
+  std::vector<FallingPrize> m_falling_prizes;
+  std::vector<GLfloat> m_caught_x;  //!< Positions of bite prizes have been caught at.
+  float m_laser_time;
+  float m_catch_time;
+};
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, &options)) {
+    fprintf(stderr, "Usage: %s --assets <dir> --levels <dir> [--level N] [--frames N] [--width W] [--height H] [--max-frame-ms MS]\n", argv[0]);
+    return 2;
+  }
+  game::Level::Ptr level = loadLevel(options.levels, options.level);
+  if (level == nullptr) {
+    fprintf(stderr, "Failed to load level %i from %s\n", options.level, options.levels.c_str());
+    return 1;
+  }
+
+  HeadlessContext context;
+  if (!context.init(options.width, options.height)) {
+    fprintf(stderr, "Headless EGL display is not available, skipped\n");
+    return skipped;
+  }
+  printf("Renderer: %s, %ix%i, level %i (%ix%i)\n", glGetString(GL_RENDERER),
+         options.width, options.height, options.level, level->numRows(), level->numCols());
+
+  char storage[] = "/tmp/render_benchmark_XXXXXX";
+  CHECK(mkdtemp(storage) != nullptr);
+  JNIEnv jenv;
+  _jstring storage_path(storage);
+  AAssetManager* manager = AAssetManager_createHost(options.assets.c_str());
+  util::RenderProfiler::Profile profile;
+  bool rendered = false;
+  {
+    game::Resources resources(&jenv, reinterpret_cast<jobject>(manager), &storage_path);
+    CHECK(resources.readAssets());
+    native::Texture* background = loadTextures(&resources);
+    CHECK(background != nullptr);
+
+    game::Renderer renderer(0);
+    renderer.init(options.width, options.height);
+    renderer.setTextures(&resources);
+    renderer.setBackground(background);
+    if (background != nullptr) {
+      Session session(&renderer, resources, level, static_cast<GLfloat>(options.width) / options.height);
+      for (int frame = 0; frame < options.frames; ++frame) {
+        session.frame(frame);
+      }
+      printf("Session: %i blocks knocked out, %i prizes dropped, %i caught, %i level reloads\n",
+             session.impacts, session.prizes_dropped, session.prizes_caught, session.reloads);
+      CHECK(session.impacts > 0);
+      rendered = glGetError() == GL_NO_ERROR && renderer.getProfiler().takeProfile(&profile);
+    }
+    renderer.release();
+  }
+  AAssetManager_destroyHost(manager);
+  removeDirectory(std::string(storage) + "/textures");
+  removeDirectory(storage);
+  if (!rendered) {
+    fprintf(stderr, "Rendering has failed\n");
+    return 1;
+  }
+
+  printf("Frames: %zu, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms, %.1f draw calls per frame\n",
+         profile.frames, profile.p50, profile.p90, profile.p99, profile.max, profile.total_draw_calls);
+  for (int i = 0; i < util::RenderProfiler::totalStages; ++i) {
+    printf("  %-12s: %.3f ms, %.1f draw calls per frame\n",
+           util::RenderProfiler::getStageName(static_cast<util::RenderStage>(i)),
+           profile.stage_time[i], profile.draw_calls[i]);
+  }
+  if (options.max_frame_ms > 0.0f && profile.p90 > options.max_frame_ms) {
+    fprintf(stderr, "p90 frame time %.3f ms exceeds budget of %.3f ms\n", profile.p90, options.max_frame_ms);
+    return 1;
+  }
+  return test::status();
+}
@@ -0,0 +1,238 @@
+/**
+ * Input recording: session played live by GameProcessor thread over
+ * several keyframe intervals is recorded, then resimulated by standalone
+ * GameProcessor:
+ *
+ *  - resimulated from the initial keyframe only, snapshot at each periodic
+ *    keyframe must match the live state the keyframe has been taken of;
+ *  - seeking between keyframes must match resimulation from the start;
+ *  - snapshot at the last recorded tick must match saveState() of the live
+ *    processor byte by byte.
+ *
+ *   replay_test <generated assets directory>
+ *
+ * Reports speed of resimulation against real time of the live session.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "GameProcessor.h"
+#include "InputRecording.h"
+#include "LevelPack.h"
+#include "LevelPreloader.h"
+#include "Params.h"
+#include "Snapshot.h"
+
+using game::GameProcessor;
+
+static const int levelIndex = 0;
+static const GLfloat aspect = 360.0f / 640.0f;
+static const jint frameDelay = game::ProcessorParams::moveDelay;
+/// @brief Ball moves played live, past three periodic keyframes and halfway to the fourth.
+static const int liveMoves = game::InputRecorder::keyframeInterval * 7 / 2;
+
+/// @brief Counts ball moves and stops notified by live processor, tracks the ball.
+class Probe {
+public:
+  Probe() : moves(0), stops(0), ball_x(0.0f) {}
+
+  void callback_moveBall(game::Ball ball) { ball_x.store(ball.getPose().getX()); ++moves; }
+  void callback_stopBall(bool) { ++stops; }
+
+  std::atomic<int> moves;
+  std::atomic<int> stops;
+  std::atomic<GLfloat> ball_x;
+  EventListener<game::Ball> move_ball_listener;
+  EventListener<bool> stop_ball_listener;
+};
+
+/// @brief Waits for @a counter to reach @a value, FALSE on timeout.
+static bool waitFor(const std::atomic<int>& counter, int value) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (counter.load() < value) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+static game::Level::Ptr loadLevel(const std::string& assets, int index) {
+  std::ifstream file(assets + "/" + game::LevelPack::filename, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  game::LevelPack pack(data.data(), data.size(), nullptr);
+  return pack.isValid() ? pack.load(index) : nullptr;
+}
+
+/// @brief Ball resting on bite, the way AsyncContext places it.
+static game::Ball makeBall(const game::Bite& bite) {
+  game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+  ball.setXPose(bite.getXPose());
+  ball.setYPose(-game::BiteParams::neg_biteElevation + ball.getDimens().halfHeight());
+  return ball;
+}
+
+static game::Bite makeBite(GLfloat x) {
+  game::Bite bite(game::BiteParams::biteWidth, game::BiteParams::biteHeight * aspect);
+  bite.setXPose(x);
+  return bite;
+}
+
+/// @brief Plays session on launched processor, bite following the ball so that
+/// it isn't lost, records it and saves final state once the ball is stopped,
+/// so that no tick is missed.
+static bool playLive(game::Level::Ptr level, std::vector<uint8_t>* recording, std::vector<uint8_t>* state) {
+  JavaVM jvm;
+  Probe probe;
+  GameProcessor processor(&jvm, frameDelay);
+  probe.move_ball_listener = processor.move_ball_event.createListener(&Probe::callback_moveBall, &probe);
+  probe.stop_ball_listener = processor.stop_ball_event.createListener(&Probe::callback_stopBall, &probe);
+  processor.launch();
+
+  game::PreparedLevel prepared;
+  prepared.level = level;
+  game::LevelPreloader::buildGeometry(aspect, &prepared);
+  game::Bite bite = makeBite(0.0f);
+  processor.callback_aspectMeasured(aspect);
+  processor.callback_loadLevel(level);
+  processor.callback_levelDimens(prepared.dimens);
+  processor.callback_initBall(makeBall(bite));
+  processor.callback_initBite(bite);
+  CHECK(waitFor(probe.stops, 2));  // level loaded and ball placed
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  bool recording_started = processor.startRecording();
+  CHECK(recording_started);
+  int stops = probe.stops.load();
+  processor.callback_throwBall(util::PI4);
+  for (int i = 1; probe.moves.load() < liveMoves && probe.stops.load() == stops; ++i) {
+    CHECK(waitFor(probe.moves, i * 5));
+    // bite is kept still around periodic keyframes, so that inputs don't share their ticks
+    int phase = probe.moves.load() % static_cast<int>(game::InputRecorder::keyframeInterval);
+    if (phase > 10 && phase < static_cast<int>(game::InputRecorder::keyframeInterval) - 10) {
+      // off the centre of bite, so that the ball is reflected aslant
+      processor.callback_biteMoved(makeBite(probe.ball_x.load() + 0.02f * (i % 5 - 2)));
+    }
+  }
+  CHECK(probe.moves.load() >= liveMoves && probe.stops.load() == stops);  // ball isn't lost
+
+  processor.callback_initBall(makeBall(bite));  // recorded input stops the ball
+  CHECK(waitFor(probe.stops, stops + 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  processor.stop();
+
+  if (!recording_started || !processor.stopRecording(recording)) {
+    return false;
+  }
+  game::SnapshotWriter writer(state);
+  return processor.saveState(&writer);
+}
+
+static bool replay(const std::vector<uint8_t>& recording, uint32_t tick, std::vector<uint8_t>* state) {
+  game::InputReplay input(recording.data(), recording.size());
+  GameProcessor replayer(nullptr, input.getFrameDelay());
+  game::SnapshotWriter writer(state);
+  return replayer.replay(&input, tick, &writer);
+}
+
+/// @brief Copy of recording without periodic keyframes, so that replay
+/// resimulates from the very start instead of resuming at the latest keyframe.
+static std::vector<uint8_t> initialKeyframeOnly(const std::vector<uint8_t>& recording) {
+  game::InputReplay input(recording.data(), recording.size());
+  game::InputRecorder recorder(input.getFrameDelay());
+  game::InputEvent event;
+  bool initial = true;
+  while (input.next(&event)) {
+    if (event.type != game::InputType::KEYFRAME) {
+      recorder.record(event.tick, event.type, event.words);
+    } else if (initial) {
+      recorder.recordKeyframe(event.tick, std::vector<uint8_t>(event.keyframe, event.keyframe + event.keyframe_size));
+      initial = false;
+    }
+  }
+  return recorder.getData();
+}
+
+template <typename Func>
+static double measure(Func func) {
+  auto start = std::chrono::steady_clock::now();
+  func();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s <generated assets directory>\n", argv[0]);
+    return 2;
+  }
+  game::Level::Ptr level = loadLevel(argv[1], levelIndex);
+  CHECK(level != nullptr);
+  if (level == nullptr) {
+    return test::status();
+  }
+
+  std::vector<uint8_t> recording, live_state;
+  CHECK(playLive(level, &recording, &live_state));
+
+  game::InputReplay input(recording.data(), recording.size());
+  CHECK(input.isValid());
+  game::InputEvent event;
+  std::vector<game::InputEvent> keyframes;
+  std::vector<uint32_t> input_ticks;
+  while (input.next(&event)) {
+    if (event.type == game::InputType::KEYFRAME) {
+      keyframes.push_back(event);
+    } else {
+      input_ticks.push_back(event.tick);
+    }
+  }
+  uint32_t last_tick = input.getDuration();
+  CHECK(keyframes.size() >= 4 && last_tick > 3 * game::InputRecorder::keyframeInterval);
+
+  // keyframe is taken after the ball move, before inputs processed at the same tick
+  std::vector<uint8_t> resimulated = initialKeyframeOnly(recording);
+  int compared = 0;
+  for (size_t i = 1; i < keyframes.size(); ++i) {
+    uint32_t tick = keyframes[i].tick;
+    if (std::find(input_ticks.begin(), input_ticks.end(), tick) != input_ticks.end()) {
+      continue;
+    }
+    std::vector<uint8_t> state;
+    CHECK(replay(resimulated, tick, &state));
+    // keyframe is the state, followed by environment of processor
+    CHECK(!state.empty() && state.size() < keyframes[i].keyframe_size &&
+          std::equal(state.begin(), state.end(), keyframes[i].keyframe));
+    ++compared;
+  }
+  CHECK(compared + 1 == static_cast<int>(keyframes.size()));
+
+  // seeking into the middle of interval resumes at keyframe and plays the rest
+  uint32_t middle = (keyframes[2].tick + keyframes[3].tick) / 2;
+  std::vector<uint8_t> sought, from_start;
+  CHECK(replay(recording, middle, &sought));
+  CHECK(replay(resimulated, middle, &from_start));
+  CHECK(!sought.empty() && sought == from_start && sought != live_state);
+
+  std::vector<uint8_t> replayed_state, full_state;
+  double seek_ms = measure([&]() { CHECK(replay(recording, last_tick, &replayed_state)); });
+  double full_ms = measure([&]() { CHECK(replay(resimulated, last_tick, &full_state)); });
+  CHECK(!live_state.empty() && replayed_state == live_state && full_state == live_state);
+
+  double realtime_ms = last_tick * (frameDelay / 1e6);
+  std::printf("Replayed %u ticks, %zu keyframes (%d compared), recording %zu bytes\n",
+      last_tick, keyframes.size(), compared, recording.size());
+  std::printf("Resimulated in %.1f ms, %.0fx real time of %.0f ms; seek to the last tick %.2f ms\n",
+      full_ms, realtime_ms / full_ms, realtime_ms, seek_ms);
+  CHECK(full_ms < realtime_ms);
+  return test::status();
+}
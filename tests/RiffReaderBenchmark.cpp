@@ -0,0 +1,124 @@
+/**
+ * Load time of WAV files: mapping a file and walking its chunks with
+ * parseWAV() against the former path, which read the whole file into
+ * a heap buffer past fixed 44-byte header. Both must yield the same samples.
+ *
+ *   riff_reader_benchmark [--iterations N] <file.wav ...>
+ *
+ * Samples of mapped file are paged in lazily, once the sound is played.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Check.h"
+#include "RiffReader.h"
+
+/// @brief Samples located by either path.
+struct Loaded {
+  std::vector<uint8_t> samples;
+  bool valid = false;
+};
+
+/// @brief Former WAVSound::loadSound(), FILESYSTEM mode: copies everything
+/// behind canonical header.
+static bool loadCopy(const char* path, Loaded* loaded) {
+  FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  long length = std::ftell(file) - static_cast<long>(native::WAV_HEADER_SIZE);
+  std::rewind(file);
+  uint8_t header[native::WAV_HEADER_SIZE];
+  uint8_t* data = length > 0 ? new (std::nothrow) uint8_t[length] : nullptr;
+  bool read = data != nullptr &&
+      std::fread(header, 1, sizeof(header), file) == sizeof(header) &&
+      std::fread(data, 1, length, file) == static_cast<size_t>(length);
+  std::fclose(file);
+  if (read && loaded != nullptr) {
+    loaded->samples.assign(data, data + length);
+    loaded->valid = true;
+  }
+  delete [] data;
+  return read;
+}
+
+/// @brief WAVSound::mapFile() and parseWAV(), FILESYSTEM mode.
+static bool loadMapped(const char* path, Loaded* loaded) {
+  int descriptor = ::open(path, O_RDONLY);
+  if (descriptor < 0) {
+    return false;
+  }
+  struct stat status;
+  void* mapping = MAP_FAILED;
+  if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+    mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  }
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  native::PCMFormat format;
+  const uint8_t* pcm = nullptr;
+  size_t pcm_size = 0;
+  bool parsed = native::parseWAV(static_cast<const uint8_t*>(mapping), status.st_size, &format, &pcm, &pcm_size) == native::RiffError::NONE;
+  if (parsed && loaded != nullptr) {
+    loaded->samples.assign(pcm, pcm + pcm_size);
+    loaded->valid = true;
+  }
+  munmap(mapping, status.st_size);
+  return parsed;
+}
+
+template <typename Func>
+static double measure(int iterations, const char* path, Func func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func(path, nullptr);
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+int main(int argc, char** argv) {
+  int iterations = 100;
+  int first = 1;
+  if (argc > 2 && std::strcmp(argv[1], "--iterations") == 0) {
+    iterations = std::max(1, std::atoi(argv[2]));
+    first = 3;
+  }
+  CHECK(first < argc);  // no files
+
+  double total_copy = 0.0, total_mapped = 0.0;
+  std::printf("%-24s %10s %10s %10s\n", "file", "bytes", "copy us", "mapped us");
+  for (int i = first; i < argc; ++i) {
+    const char* path = argv[i];
+    Loaded copied, mapped;
+    CHECK(loadCopy(path, &copied));
+    CHECK(loadMapped(path, &mapped));
+    // copy path assumed canonical header, so that rest of longer IMA-ADPCM header precedes samples
+    CHECK(copied.valid && mapped.valid && copied.samples.size() >= mapped.samples.size());
+    if (copied.valid && mapped.valid && copied.samples.size() >= mapped.samples.size()) {
+      CHECK(std::equal(mapped.samples.begin(), mapped.samples.end(), copied.samples.end() - mapped.samples.size()));
+    }
+
+    double copy_us = measure(iterations, path, loadCopy);
+    double mapped_us = measure(iterations, path, loadMapped);
+    total_copy += copy_us;
+    total_mapped += mapped_us;
+    const char* name = std::strrchr(path, '/');
+    std::printf("%-24s %10zu %10.1f %10.1f\n", name != nullptr ? name + 1 : path, copied.samples.size() + native::WAV_HEADER_SIZE, copy_us, mapped_us);
+  }
+  std::printf("%-24s %10s %10.1f %10.1f\n", "total", "", total_copy, total_mapped);
+  return test::status();
+}
@@ -0,0 +1,175 @@
+/**
+ * parseWAV() fuzzing: truncated, oversized and mutated chunk headers of
+ * seed files must never make parser read past the buffer nor return
+ * samples outside of it.
+ *
+ *   riff_reader_fuzz [file.wav ...]
+ *
+ * Built-in seeds are used along with given files. With ARKANOID_LIBFUZZER
+ * the same check is exposed as libFuzzer entry point instead of main().
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "RiffReader.h"
+
+using native::PCMFormat;
+using native::RiffError;
+
+static constexpr int randomMutations = 20000;
+static constexpr size_t headersSize = 512;  //!< Prefix of seed truncated at every byte.
+static constexpr size_t maxSeedSize = 4096;  //!< Mutated prefix of seed.
+
+/// @brief Parses exact copy of @a data, so that sanitizers catch
+/// any access past its end, and validates the result.
+static void parse(const uint8_t* data, size_t size) {
+  std::vector<uint8_t> copy(data, data + size);
+  PCMFormat format;
+  const uint8_t* pcm = nullptr;
+  size_t pcm_size = 0;
+  const uint8_t* begin = copy.empty() ? nullptr : &copy[0];
+  RiffError error = native::parseWAV(begin, copy.size(), &format, &pcm, &pcm_size);
+  if (error != RiffError::NONE) {
+    return;
+  }
+  CHECK(pcm >= begin && pcm <= begin + copy.size());
+  CHECK(pcm_size <= static_cast<size_t>(begin + copy.size() - pcm));
+  CHECK(format.channels > 0 && format.sample_rate > 0);
+  CHECK(format.audio_format == native::WAVE_FORMAT_PCM || format.audio_format == native::WAVE_FORMAT_IMA_ADPCM);
+  if (format.audio_format == native::WAVE_FORMAT_PCM) {
+    CHECK(format.block_align > 0 && pcm_size % format.block_align == 0);
+  }
+}
+
+#ifdef ARKANOID_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  parse(data, size);
+  if (test::failures() > 0) {
+    __builtin_trap();
+  }
+  return 0;
+}
+
+#else
+
+static void appendChunk(std::vector<uint8_t>* file, const char* id, const std::vector<uint8_t>& payload) {
+  uint32_t size = static_cast<uint32_t>(payload.size());
+  file->insert(file->end(), id, id + 4);
+  for (int i = 0; i < 4; ++i) {
+    file->push_back(static_cast<uint8_t>(size >> (8 * i)));
+  }
+  file->insert(file->end(), payload.begin(), payload.end());
+  if (size & 1) {
+    file->push_back(0);  // padding
+  }
+}
+
+/// @brief WAV file with an unknown chunk of odd size before 'data'.
+static std::vector<uint8_t> makeSeed(const PCMFormat& format, size_t data_size) {
+  std::vector<uint8_t> header(native::getWAVHeaderSize(format));
+  native::writeWAVHeader(format, static_cast<uint32_t>(data_size), &header[0]);
+  std::vector<uint8_t> file(header.begin(), header.end() - 8);  // up to 'data' chunk
+  appendChunk(&file, "LIST", std::vector<uint8_t>(5, 'x'));
+  std::vector<uint8_t> samples(data_size);
+  for (size_t i = 0; i < data_size; ++i) {
+    samples[i] = static_cast<uint8_t>(i * 7);
+  }
+  appendChunk(&file, "data", samples);
+  uint32_t riff_size = static_cast<uint32_t>(file.size() - 8);
+  for (int i = 0; i < 4; ++i) {
+    file[4 + i] = static_cast<uint8_t>(riff_size >> (8 * i));
+  }
+  return file;
+}
+
+static std::vector<std::vector<uint8_t>> makeSeeds() {
+  PCMFormat pcm16 {native::WAVE_FORMAT_PCM, 1, 44100, 2, 16};
+  PCMFormat stereo8 {native::WAVE_FORMAT_PCM, 2, 22050, 2, 8};
+  PCMFormat adpcm {native::WAVE_FORMAT_IMA_ADPCM, 1, 44100, 256, 4};
+  return {makeSeed(pcm16, 200), makeSeed(stereo8, 101), makeSeed(adpcm, 600)};
+}
+
+/// @brief Offsets of chunk size fields, walking chunks as written.
+static std::vector<size_t> findSizeFields(const std::vector<uint8_t>& file) {
+  std::vector<size_t> fields;
+  if (file.size() >= 8) {
+    fields.push_back(4);  // RIFF size
+  }
+  size_t offset = 12;
+  while (offset + 8 <= file.size()) {
+    fields.push_back(offset + 4);
+    uint32_t size = file[offset + 4] | (file[offset + 5] << 8) | (file[offset + 6] << 16) | (static_cast<uint32_t>(file[offset + 7]) << 24);
+    offset += 8 + size + (size & 1);
+  }
+  return fields;
+}
+
+static void writeLE32(std::vector<uint8_t>* file, size_t offset, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    (*file)[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+static void fuzz(const std::vector<uint8_t>& full_seed, std::mt19937* rng) {
+  // every truncation within headers, including empty input, sampled ones past them
+  for (size_t size = 0; size <= full_seed.size(); size += size < headersSize ? 1 : full_seed.size() / 64 + 1) {
+    parse(full_seed.data(), size);
+  }
+  parse(full_seed.data(), full_seed.size());
+  // samples are never read by parser, so long seeds are cut to keep mutations cheap
+  std::vector<uint8_t> seed(full_seed.begin(), full_seed.begin() + std::min(full_seed.size(), maxSeedSize));
+  // oversized and undersized chunk headers
+  const uint32_t sizes[] = {0, 1, 15, 16, 17, 0x7fffffff, 0x80000000, 0xfffffff7, 0xfffffffe, 0xffffffff};
+  for (size_t field : findSizeFields(seed)) {
+    for (uint32_t value : sizes) {
+      std::vector<uint8_t> mutated(seed);
+      writeLE32(&mutated, field, value);
+      parse(mutated.data(), mutated.size());
+      uint32_t past_end = static_cast<uint32_t>(mutated.size() - field - 4 + 1);
+      writeLE32(&mutated, field, past_end);
+      parse(mutated.data(), mutated.size());
+    }
+  }
+  // random bytes overwritten, mostly within headers
+  std::uniform_int_distribution<int> byte_distribution(0, 255);
+  for (int i = 0; i < randomMutations; ++i) {
+    std::vector<uint8_t> mutated(seed);
+    size_t limit = std::min<size_t>(mutated.size(), 64);
+    int count = 1 + (*rng)() % 4;
+    for (int j = 0; j < count; ++j) {
+      mutated[(*rng)() % limit] = static_cast<uint8_t>(byte_distribution(*rng));
+    }
+    parse(mutated.data(), (*rng)() % (mutated.size() + 1));
+  }
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::vector<uint8_t>> seeds = makeSeeds();
+  for (auto& seed : seeds) {
+    PCMFormat format;
+    const uint8_t* pcm = nullptr;
+    size_t pcm_size = 0;
+    CHECK(native::parseWAV(seed.data(), seed.size(), &format, &pcm, &pcm_size) == RiffError::NONE);
+  }
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    CHECK(file.good());
+    seeds.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  }
+
+  std::mt19937 rng(37);
+  for (auto& seed : seeds) {
+    fuzz(seed, &rng);
+  }
+  printf("Fuzzed %zu seeds\n", seeds.size());
+  return test::status();
+}
+
+#endif  // ARKANOID_LIBFUZZER
@@ -0,0 +1,152 @@
+/**
+ * Sound bank quality and speed: each PCM master is converted to mono 16-bit
+ * at output sample rate, as tools/soundbank does before encoding, and compared
+ * with its IMA-ADPCM encoding decoded block by block, as the mixer does.
+ *
+ *   sound_bank_benchmark [--iterations N] [--min-snr-db D] <masters directory> <encoded directory>
+ *
+ * Reports signal-to-noise ratio of every sound and time of decoding it
+ * per sample, fails if any sound falls below --min-snr-db.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include "Check.h"
+#include "ImaAdpcm.h"
+#include "RiffReader.h"
+#include "SampleConverter.h"
+#include "SoundBuffer.h"
+
+using native::ImaAdpcm;
+using native::PCMFormat;
+using native::RiffError;
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* content) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  content->resize(std::ftell(file));
+  std::fseek(file, 0, SEEK_SET);
+  bool success = std::fread(content->data(), 1, content->size(), file) == content->size();
+  std::fclose(file);
+  return success;
+}
+
+static std::vector<std::string> listSounds(const std::string& directory) {
+  std::vector<std::string> names;
+  if (DIR* dir = opendir(directory.c_str())) {
+    while (dirent* item = readdir(dir)) {
+      std::string name = item->d_name;
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".wav") == 0) {
+        names.push_back(name);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/// @brief Decodes all blocks of IMA-ADPCM sound.
+static size_t decode(const uint8_t* data, size_t size, size_t block_align, int16_t* output, size_t frames) {
+  size_t decoded = 0;
+  for (size_t offset = 0; offset < size && decoded < frames; offset += block_align) {
+    size_t block_size = std::min(block_align, size - offset);
+    decoded += ImaAdpcm::decodeBlock(data + offset, block_size, output + decoded, frames - decoded);
+  }
+  return decoded;
+}
+
+/// @return Signal-to-noise ratio, dB.
+static double snr(const std::vector<int16_t>& reference, const std::vector<int16_t>& decoded) {
+  double signal = 0.0, noise = 0.0;
+  for (size_t i = 0; i < reference.size(); ++i) {
+    double error = static_cast<double>(reference[i]) - decoded[i];
+    signal += static_cast<double>(reference[i]) * reference[i];
+    noise += error * error;
+  }
+  return noise > 0.0 ? 10.0 * std::log10(signal / noise) : INFINITY;
+}
+
+int main(int argc, char** argv) {
+  int iterations = 20;
+  double min_snr_db = 0.0;
+  int first = 1;
+  for (; first + 1 < argc && std::strncmp(argv[first], "--", 2) == 0; first += 2) {
+    if (std::strcmp(argv[first], "--iterations") == 0) {
+      iterations = std::max(1, std::atoi(argv[first + 1]));
+    } else if (std::strcmp(argv[first], "--min-snr-db") == 0) {
+      min_snr_db = std::atof(argv[first + 1]);
+    }
+  }
+  if (first + 2 != argc) {
+    std::fprintf(stderr, "Usage: %s [--iterations N] [--min-snr-db D] <masters directory> <encoded directory>\n", argv[0]);
+    return 2;
+  }
+  std::string masters = argv[first], encoded = argv[first + 1];
+  std::vector<std::string> names = listSounds(masters);
+  CHECK(!names.empty());
+
+  const uint32_t sample_rate = native::SoundBuffer::outputSampleRate;
+  double min_snr = INFINITY, total_ns = 0.0;
+  size_t total_samples = 0, total_master = 0, total_encoded = 0;
+  std::printf("%-16s %9s %9s %8s %13s\n", "sound", "master", "encoded", "SNR dB", "decode ns/smp");
+  for (auto& name : names) {
+    std::vector<uint8_t> master_file, encoded_file;
+    CHECK(readFile(masters + "/" + name, &master_file));
+    CHECK(readFile(encoded + "/" + name, &encoded_file));
+    PCMFormat master_format, encoded_format;
+    const uint8_t* pcm = nullptr;
+    const uint8_t* adpcm = nullptr;
+    size_t pcm_size = 0, adpcm_size = 0;
+    if (native::parseWAV(master_file.data(), master_file.size(), &master_format, &pcm, &pcm_size) != RiffError::NONE ||
+        native::parseWAV(encoded_file.data(), encoded_file.size(), &encoded_format, &adpcm, &adpcm_size) != RiffError::NONE) {
+      std::fprintf(stderr, "Failed to parse %s\n", name.c_str());
+      ++test::failures();
+      continue;
+    }
+    CHECK(master_format.audio_format == native::WAVE_FORMAT_PCM);
+    CHECK(encoded_format.audio_format == native::WAVE_FORMAT_IMA_ADPCM);
+
+    std::vector<int16_t> reference(native::getConvertedFrames(pcm_size, master_format, sample_rate));
+    native::convertToMono16(pcm, pcm_size, master_format, sample_rate, reference.data());
+    // the last block of encoding could hold one more sample, padding its last byte
+    size_t frames = reference.size();
+    std::vector<int16_t> decoded(ImaAdpcm::getSamplesCount(adpcm_size, encoded_format.block_align));
+    CHECK(decoded.size() >= frames && decoded.size() <= frames + 1);
+    if (decoded.size() < frames) {
+      continue;
+    }
+    CHECK(decode(adpcm, adpcm_size, encoded_format.block_align, decoded.data(), frames) == frames);
+    decoded.resize(frames);
+    double sound_snr = snr(reference, decoded);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      decode(adpcm, adpcm_size, encoded_format.block_align, decoded.data(), frames);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double ns = elapsed.count() / iterations;
+
+    min_snr = std::min(min_snr, sound_snr);
+    total_ns += ns;
+    total_samples += frames;
+    total_master += master_file.size();
+    total_encoded += encoded_file.size();
+    std::printf("%-16s %9zu %9zu %8.1f %13.2f\n", name.c_str(), master_file.size(), encoded_file.size(), sound_snr, ns / frames);
+  }
+  std::printf("%-16s %9zu %9zu %8.1f %13.2f  (min SNR, mean ns per sample)\n",
+      "total", total_master, total_encoded, min_snr, total_ns / std::max<size_t>(1, total_samples));
+  CHECK(min_snr >= min_snr_db);
+  return test::status();
+}
@@ -0,0 +1,113 @@
+/**
+ * Sound bank: shipped sounds are encoded from PCM masters into IMA-ADPCM
+ * at build time, so that runtime only decodes them, and PCM sounds are
+ * never encoded at runtime.
+ *
+ *   sound_bank_test <encoded file.wav ...>
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Check.h"
+#include "ImaAdpcm.h"
+#include "RiffReader.h"
+#include "SampleConverter.h"
+#include "SoundBuffer.h"
+
+using native::SoundBuffer;
+using native::WAVSound;
+
+static void testShipped(const char* filepath) {
+  WAVSound sound(filepath);
+  CHECK(sound.load());
+  if (sound.getData() == nullptr) {
+    fprintf(stderr, "Failed to load %s\n", filepath);
+    return;
+  }
+  if (sound.getEncoding() != SoundBuffer::Encoding::IMA_ADPCM) {
+    fprintf(stderr, "%s isn't encoded by tools/soundbank\n", filepath);
+    ++test::failures();
+    return;
+  }
+  CHECK(sound.getFrames() > 0);
+  CHECK(sound.getBlockAlign() == native::ImaAdpcm::defaultBlockAlign);
+
+  std::vector<int16_t> block(sound.getSamplesPerBlock());
+  size_t decoded = 0;
+  for (size_t index = 0; decoded < sound.getFrames(); ++index) {
+    size_t count = sound.decodeBlock(index, &block[0]);
+    CHECK(count > 0);
+    if (count == 0) {
+      break;
+    }
+    decoded += count;
+  }
+  CHECK(decoded == sound.getFrames());
+}
+
+/// @brief IMA-ADPCM header has extended 'fmt ' chunk and 'fact' chunk, and is parsed back.
+static void testAdpcmHeader() {
+  const size_t samples = 1000;
+  native::PCMFormat format {native::WAVE_FORMAT_IMA_ADPCM, 1, 44100, native::ImaAdpcm::defaultBlockAlign, 4};
+  size_t data_size = native::ImaAdpcm::getEncodedSize(samples, format.block_align);
+  size_t header_size = native::getWAVHeaderSize(format);
+  CHECK(header_size == native::WAV_ADPCM_HEADER_SIZE);
+  std::vector<uint8_t> file(header_size + data_size);
+  native::writeWAVHeader(format, static_cast<uint32_t>(data_size), &file[0]);
+
+  auto le16 = [&file](size_t offset) { return file[offset] | (file[offset + 1] << 8); };
+  auto le32 = [&le16](size_t offset) { return static_cast<uint32_t>(le16(offset) | (le16(offset + 2) << 16)); };
+  CHECK(std::memcmp(&file[12], "fmt ", 4) == 0 && le32(16) == 20);
+  CHECK(le16(36) == 2);  // cbSize
+  CHECK(le16(38) == static_cast<int>(native::ImaAdpcm::getSamplesPerBlock(format.block_align)));
+  CHECK(std::memcmp(&file[40], "fact", 4) == 0 && le32(44) == 4);
+  CHECK(le32(48) == native::ImaAdpcm::getSamplesCount(data_size, format.block_align));
+  CHECK(le32(4) == file.size() - 8);
+
+  native::PCMFormat parsed;
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  CHECK(native::parseWAV(file.data(), file.size(), &parsed, &data, &size) == native::RiffError::NONE);
+  CHECK(data == &file[header_size] && size == data_size);
+  CHECK(parsed.audio_format == format.audio_format && parsed.block_align == format.block_align);
+}
+
+/// @brief Stereo 8-bit PCM at 22050 Hz is converted, but not encoded.
+static void testPcmIsNotEncoded() {
+  native::PCMFormat format {native::WAVE_FORMAT_PCM, 2, 22050, 2, 8};
+  std::vector<uint8_t> file(native::WAV_HEADER_SIZE + 2 * 1000);
+  native::writeWAVHeader(format, 2 * 1000, &file[0]);
+  for (size_t i = native::WAV_HEADER_SIZE; i < file.size(); ++i) {
+    file[i] = static_cast<uint8_t>(i * 13);
+  }
+  char path[] = "/tmp/sound_bank_test_XXXXXX";
+  int descriptor = mkstemp(path);
+  CHECK(descriptor >= 0);
+  if (descriptor < 0) {
+    return;
+  }
+  CHECK(write(descriptor, file.data(), file.size()) == static_cast<ssize_t>(file.size()));
+  close(descriptor);
+
+  WAVSound sound(path);
+  CHECK(sound.load());
+  CHECK(sound.getEncoding() == SoundBuffer::Encoding::PCM16);
+  size_t frames = native::getConvertedFrames(2 * 1000, format, SoundBuffer::outputSampleRate);
+  CHECK(sound.getFrames() == frames);
+  CHECK(sound.getLength() == static_cast<off_t>(frames * sizeof(int16_t)));
+  std::remove(path);
+}
+
+int main(int argc, char** argv) {
+  CHECK(argc > 1);  // no shipped sounds
+  for (int i = 1; i < argc; ++i) {
+    testShipped(argv[i]);
+  }
+  testAdpcmHeader();
+  testPcmIsNotEncoded();
+  return test::status();
+}
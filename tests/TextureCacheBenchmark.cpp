@@ -0,0 +1,114 @@
+/**
+ * Texture disk cache over shipped textures: each texture is decoded
+ * from PNG and converted into format chosen by Resources, then loaded
+ * from cache, which must yield the very same pixels.
+ *
+ *   texture_cache_benchmark [--iterations N] <assets directory>
+ *
+ * Both paths run Texture::decode() through asset manager, as the game does:
+ * cached one includes checksum of source file and mapping of cache file.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "AssetStorage.h"
+#include "Check.h"
+#include "Resources.h"
+#include "Texture.h"
+#include "TextureCache.h"
+
+/// @brief Texture exposing decoded pixels.
+class ProbeTexture : public native::PNGTexture {
+public:
+  ProbeTexture(AssetStorage* assets, const char* filename)
+    : native::PNGTexture(assets, filename) {
+  }
+
+  std::vector<uint8_t> getPixels() const {
+    return m_pixels != nullptr ? std::vector<uint8_t>(m_pixels, m_pixels + m_data_size) : std::vector<uint8_t>();
+  }
+};
+
+template <typename Func>
+static double measure(int iterations, Func func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func();
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+static void removeDirectory(const std::string& path) {
+  if (DIR* dir = opendir(path.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_type == DT_REG) {
+        std::remove((path + "/" + entry->d_name).c_str());
+      }
+    }
+    closedir(dir);
+  }
+  rmdir(path.c_str());
+}
+
+int main(int argc, char** argv) {
+  int iterations = 10;
+  int first = 1;
+  if (argc > 2 && std::strcmp(argv[1], "--iterations") == 0) {
+    iterations = std::max(1, std::atoi(argv[2]));
+    first = 3;
+  }
+  if (first >= argc) {
+    std::fprintf(stderr, "Usage: %s [--iterations N] <assets directory>\n", argv[0]);
+    return 2;
+  }
+
+  char directory[] = "/tmp/texture_cache_benchmark_XXXXXX";
+  CHECK(mkdtemp(directory) != nullptr);
+  JNIEnv jenv;
+  AAssetManager* manager = AAssetManager_createHost(argv[first]);
+  AssetStorage assets(&jenv, reinterpret_cast<jobject>(manager));
+  std::vector<std::string> names = assets.list("texture");
+  CHECK(!names.empty());
+  {
+    native::TextureCache cache(std::string(directory) + "/textures");
+
+    double total_decode = 0.0, total_cached = 0.0;
+    size_t total_size = 0;
+    std::printf("%-22s %9s %11s %11s %8s\n", "texture", "bytes", "decode us", "cached us", "speedup");
+    for (auto& name : names) {
+      std::string filename = "texture/" + name;
+      ProbeTexture texture(&assets, filename.c_str());
+      game::Resources::setTextureFormat(&texture, name);
+
+      texture.setCache(nullptr);
+      CHECK(texture.decode());
+      std::vector<uint8_t> decoded = texture.getPixels();
+      double decode_us = measure(iterations, [&texture]() { texture.decode(); });
+
+      texture.setCache(&cache);
+      CHECK(texture.decode());  // stores decoded image
+      CHECK(texture.decode());  // loads it back
+      CHECK(!decoded.empty() && texture.getPixels() == decoded);
+      double cached_us = measure(iterations, [&texture]() { texture.decode(); });
+
+      total_decode += decode_us;
+      total_cached += cached_us;
+      total_size += decoded.size();
+      std::printf("%-22s %9zu %11.1f %11.1f %7.1fx\n", name.c_str(), decoded.size(), decode_us, cached_us, decode_us / cached_us);
+    }
+    std::printf("%-22s %9zu %11.1f %11.1f %7.1fx\n", "total", total_size, total_decode, total_cached, total_decode / total_cached);
+  }
+  removeDirectory(std::string(directory) + "/textures");
+  removeDirectory(directory);
+  AAssetManager_destroyHost(manager);
+  return test::status();
+}
@@ -0,0 +1,158 @@
+/**
+ * TextureCache: round-trip of decoded image through disk cache,
+ * rejection of stale and corrupt cache files.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Check.h"
+#include "TextureCache.h"
+
+using native::TextureCache;
+
+static const char* name = "texture/bg/background.png";
+static const char* filename = "texture_bg_background.png.tex";  //!< Cache file of @a name.
+static const uint32_t sourceChecksum = 0x12345678;
+
+static TextureCache::Header makeHeader(size_t data_size) {
+  TextureCache::Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = TextureCache::magic;
+  header.version = TextureCache::version;
+  header.checksum = sourceChecksum;
+  header.format = GL_RGBA;
+  header.source_format = GL_RGBA;
+  header.type = GL_UNSIGNED_SHORT_4_4_4_4;
+  header.width = 16;
+  header.height = 8;
+  header.data_size = static_cast<uint32_t>(data_size);
+  return header;
+}
+
+static std::vector<uint8_t> serialize(const TextureCache::Header& header, const std::vector<uint8_t>& pixels) {
+  std::vector<uint8_t> content(sizeof(header) + pixels.size());
+  std::memcpy(&content[0], &header, sizeof(header));
+  std::memcpy(&content[sizeof(header)], pixels.data(), pixels.size());
+  return content;
+}
+
+/// @brief Overwrites cache file with raw @a content, bypassing TextureCache::store().
+static void writeCacheFile(const std::string& directory, const std::vector<uint8_t>& content) {
+  std::string path = directory + "/" + filename;
+  FILE* file = std::fopen(path.c_str(), "wb");
+  CHECK(file != nullptr);
+  if (file != nullptr) {
+    CHECK(std::fwrite(content.data(), 1, content.size(), file) == content.size());
+    std::fclose(file);
+  }
+}
+
+static bool isRejected(const TextureCache& cache, uint32_t checksum = sourceChecksum) {
+  TextureCache::Header header;
+  size_t mapping_size = 0;
+  const uint8_t* pixels = cache.load(name, checksum, &header, &mapping_size);
+  if (pixels != nullptr) {
+    TextureCache::release(pixels, mapping_size);
+    return false;
+  }
+  return true;
+}
+
+static void testRoundTrip(const TextureCache& cache, const std::vector<uint8_t>& pixels) {
+  CHECK(isRejected(cache));  // not cached yet
+
+  TextureCache::Header stored = makeHeader(pixels.size());
+  CHECK(cache.store(name, stored, pixels.data()));
+
+  TextureCache::Header loaded;
+  size_t mapping_size = 0;
+  const uint8_t* data = cache.load(name, sourceChecksum, &loaded, &mapping_size);
+  CHECK(data != nullptr);
+  if (data == nullptr) {
+    return;
+  }
+  CHECK(std::memcmp(&loaded, &stored, sizeof(stored)) == 0);
+  CHECK(mapping_size == sizeof(stored) + pixels.size());
+  CHECK(std::memcmp(data, pixels.data(), pixels.size()) == 0);
+  TextureCache::release(data, mapping_size);
+}
+
+static void testStale(const TextureCache& cache, const std::string& directory, const std::vector<uint8_t>& pixels) {
+  CHECK(cache.store(name, makeHeader(pixels.size()), pixels.data()));
+  CHECK(isRejected(cache, sourceChecksum + 1));  // source file has changed
+
+  TextureCache::Header header = makeHeader(pixels.size());
+  header.version = TextureCache::version + 1;  // cached by other version of the game
+  writeCacheFile(directory, serialize(header, pixels));
+  CHECK(isRejected(cache));
+}
+
+static void testCorrupt(const TextureCache& cache, const std::string& directory, const std::vector<uint8_t>& pixels) {
+  TextureCache::Header header = makeHeader(pixels.size());
+  std::vector<uint8_t> content = serialize(header, pixels);
+
+  std::vector<uint8_t> truncated(content.begin(), content.end() - 1);
+  writeCacheFile(directory, truncated);
+  CHECK(isRejected(cache));
+
+  std::vector<uint8_t> oversized(content);
+  oversized.push_back(0);
+  writeCacheFile(directory, oversized);
+  CHECK(isRejected(cache));
+
+  std::vector<uint8_t> partial_header(content.begin(), content.begin() + sizeof(header) / 2);
+  writeCacheFile(directory, partial_header);
+  CHECK(isRejected(cache));
+
+  writeCacheFile(directory, std::vector<uint8_t>());
+  CHECK(isRejected(cache));
+
+  std::vector<uint8_t> bad_magic(content);
+  bad_magic[0] ^= 0xff;
+  writeCacheFile(directory, bad_magic);
+  CHECK(isRejected(cache));
+
+  // valid file is accepted again once stored
+  CHECK(cache.store(name, header, pixels.data()));
+  CHECK(!isRejected(cache));
+}
+
+static void testChecksum() {
+  const uint8_t data[] = "source file content";
+  size_t size = sizeof(data) - 1;
+  uint32_t whole = TextureCache::checksum(data, size);
+  uint32_t combined = TextureCache::checksum(data + 7, size - 7, TextureCache::checksum(data, 7));
+  CHECK(whole == combined);
+  CHECK(whole != TextureCache::checksum(data, size - 1));
+}
+
+int main() {
+  char directory_template[] = "/tmp/texture_cache_test_XXXXXX";
+  const char* temp = mkdtemp(directory_template);
+  CHECK(temp != nullptr);
+  if (temp == nullptr) {
+    return test::status();
+  }
+  std::string directory = temp;
+
+  std::vector<uint8_t> pixels(16 * 8 * 2);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  {
+    TextureCache cache(directory);
+    testRoundTrip(cache, pixels);
+    testStale(cache, directory, pixels);
+    testCorrupt(cache, directory, pixels);
+    testChecksum();
+  }
+
+  std::remove((directory + "/" + filename).c_str());
+  rmdir(directory.c_str());
+  return test::status();
+}
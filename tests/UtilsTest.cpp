@@ -0,0 +1,177 @@
+/**
+ * Geometry and color fills of utils.cpp: vector paths (NEON / SSE2), or
+ * scalar ones if built with UTILS_SCALAR, must match scalar reference
+ * bit-exactly for any size, including vector tails.
+ *
+ *   utils_test [--benchmark iterations]
+ *
+ * With --benchmark fills of typical level size are timed against reference.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "utils.h"
+
+/* Reference */
+// ----------------------------------------------------------------------------
+namespace reference {
+
+static void setColor(const GLfloat* const bgra, GLfloat* const color_buffer, size_t size) {
+  for (size_t i = 0; i < size; i += 4) {
+    color_buffer[i + 0] = bgra[0];
+    color_buffer[i + 1] = bgra[1];
+    color_buffer[i + 2] = bgra[2];
+    color_buffer[i + 3] = bgra[3];
+  }
+}
+
+static void setColor(const GLfloat* const bgra, GLubyte* const color_buffer, size_t size) {
+  GLubyte b = util::toUnsignedByte(bgra[0]);
+  GLubyte g = util::toUnsignedByte(bgra[1]);
+  GLubyte r = util::toUnsignedByte(bgra[2]);
+  GLubyte a = util::toUnsignedByte(bgra[3]);
+  for (size_t i = 0; i < size; i += 4) {
+    color_buffer[i + 0] = b;
+    color_buffer[i + 1] = g;
+    color_buffer[i + 2] = r;
+    color_buffer[i + 3] = a;
+  }
+}
+
+static void setRectangleVertices(GLfloat* const array, GLfloat width, GLfloat height,
+    GLfloat x_offset, GLfloat y_offset, size_t cols, size_t rows) {
+  size_t cols8 = cols * 8;
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < cols; ++c) {
+      size_t index = (c * 8) + (r * cols8);
+      array[index + 0] = x_offset + width * c;
+      array[index + 1] = y_offset - height * r;
+      array[index + 2] = x_offset + width * (c + 1);
+      array[index + 3] = y_offset - height * r;
+      array[index + 4] = x_offset + width * c;
+      array[index + 5] = y_offset - height * (r + 1);
+      array[index + 6] = x_offset + width * (c + 1);
+      array[index + 7] = y_offset - height * (r + 1);
+    }
+  }
+}
+
+static void rectangleIndices(GLushort* const indices, size_t size) {
+  for (size_t i = 0, j = 0; i < size; i += 6, ++j) {
+    indices[i + 0] = (GLushort) (0 + 4 * j);
+    indices[i + 1] = (GLushort) (3 + 4 * j);
+    indices[i + 2] = (GLushort) (2 + 4 * j);
+    indices[i + 3] = (GLushort) (0 + 4 * j);
+    indices[i + 4] = (GLushort) (1 + 4 * j);
+    indices[i + 5] = (GLushort) (3 + 4 * j);
+  }
+}
+
+}
+
+/* Tests */
+// ----------------------------------------------------------------------------
+template <typename T>
+static bool equalBits(const std::vector<T>& lhs, const std::vector<T>& rhs) {
+  return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+}
+
+static void testColors(std::mt19937* rng) {
+  std::uniform_real_distribution<float> component(-0.25f, 1.25f);  // clamped to bytes
+  for (size_t cells = 0; cells <= 67; ++cells) {
+    const GLfloat bgra[4] = { component(*rng), component(*rng), component(*rng), component(*rng) };
+    size_t size = cells * 4;
+    std::vector<GLfloat> floats(size + 4, -1.0f), expected_floats(floats);
+    util::setColor(bgra, &floats[0], size);
+    reference::setColor(bgra, &expected_floats[0], size);
+    CHECK(equalBits(floats, expected_floats));  // including untouched guard
+
+    std::vector<GLubyte> bytes(size + 4, 0xcd), expected_bytes(bytes);
+    util::setColor(bgra, &bytes[0], size);
+    reference::setColor(bgra, &expected_bytes[0], size);
+    CHECK(bytes == expected_bytes);
+  }
+}
+
+static void testRectangles(std::mt19937* rng) {
+  std::uniform_real_distribution<float> extent(0.001f, 0.5f);
+  std::uniform_real_distribution<float> offset(-1.5f, 1.5f);
+  for (size_t rows = 1; rows <= 19; ++rows) {
+    for (size_t cols = 1; cols <= 19; ++cols) {
+      GLfloat width = extent(*rng), height = extent(*rng);
+      GLfloat x_offset = offset(*rng), y_offset = offset(*rng);
+      size_t size = rows * cols * 8;
+      std::vector<GLfloat> vertices(size + 8, -7.0f), expected(vertices);
+      util::setRectangleVertices(&vertices[0], width, height, x_offset, y_offset, cols, rows);
+      reference::setRectangleVertices(&expected[0], width, height, x_offset, y_offset, cols, rows);
+      CHECK(equalBits(vertices, expected));
+    }
+  }
+}
+
+static void testIndices() {
+  for (size_t rectangles = 0; rectangles <= 1000; ++rectangles) {
+    size_t size = rectangles * 6;
+    std::vector<GLushort> indices(size + 6, 0xdead), expected(indices);
+    util::rectangleIndices(&indices[0], size);
+    reference::rectangleIndices(&expected[0], size);
+    CHECK(indices == expected);
+  }
+}
+
+/* Benchmark */
+// ----------------------------------------------------------------------------
+template <typename Func>
+static double measure(int iterations, Func func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func();
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+/// @brief Times fills of level of 15 x 20 blocks, as in LevelPreloader::buildGeometry().
+static void benchmark(int iterations) {
+  const size_t cols = 15, rows = 20, blocks = cols * rows;
+  const GLfloat bgra[4] = { 0.2f, 0.4f, 0.6f, 1.0f };
+  std::vector<GLfloat> vertices(blocks * 8);
+  std::vector<GLubyte> colors(blocks * 16);
+  std::vector<GLushort> indices(blocks * 6);
+  volatile GLfloat sink = 0.0f;  // keeps fills from being optimized out
+
+  double vertices_ns = measure(iterations, [&]() {
+    util::setRectangleVertices(&vertices[0], 0.13f, 0.07f, -1.0f, 1.0f, cols, rows); sink = vertices[blocks]; });
+  double vertices_reference_ns = measure(iterations, [&]() {
+    reference::setRectangleVertices(&vertices[0], 0.13f, 0.07f, -1.0f, 1.0f, cols, rows); sink = vertices[blocks]; });
+  double colors_ns = measure(iterations, [&]() {
+    util::setColor(bgra, &colors[0], colors.size()); sink = colors[blocks]; });
+  double colors_reference_ns = measure(iterations, [&]() {
+    reference::setColor(bgra, &colors[0], colors.size()); sink = colors[blocks]; });
+  double indices_ns = measure(iterations, [&]() {
+    util::rectangleIndices(&indices[0], indices.size()); sink = indices[blocks]; });
+  double indices_reference_ns = measure(iterations, [&]() {
+    reference::rectangleIndices(&indices[0], indices.size()); sink = indices[blocks]; });
+
+  std::printf("fill (%zu blocks)      utils ns  reference ns\n", blocks);
+  std::printf("rectangle vertices  %9.0f  %12.0f\n", vertices_ns, vertices_reference_ns);
+  std::printf("byte colors         %9.0f  %12.0f\n", colors_ns, colors_reference_ns);
+  std::printf("rectangle indices   %9.0f  %12.0f\n", indices_ns, indices_reference_ns);
+}
+
+int main(int argc, char** argv) {
+  std::mt19937 rng(47);
+  testColors(&rng);
+  testRectangles(&rng);
+  testIndices();
+
+  if (argc == 3 && std::strcmp(argv[1], "--benchmark") == 0) {
+    benchmark(std::atoi(argv[2]));
+  }
+  return test::status();
+}
@@ -0,0 +1,91 @@
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+
+struct AAssetManager {
+  std::string directory;
+};
+
+struct AAssetDir {
+  std::vector<std::string> names;
+  size_t next;
+};
+
+struct AAsset {
+  std::vector<char> content;
+  size_t position;
+};
+
+AAssetManager* AAssetManager_createHost(const char* directory) {
+  return new AAssetManager{directory};
+}
+
+void AAssetManager_destroyHost(AAssetManager* manager) {
+  delete manager;
+}
+
+AAssetManager* AAssetManager_fromJava(JNIEnv*, jobject assetManager) {
+  return reinterpret_cast<AAssetManager*>(assetManager);
+}
+
+AAsset* AAssetManager_open(AAssetManager* manager, const char* filename, int) {
+  std::ifstream file(manager->directory + "/" + filename, std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  AAsset* asset = new AAsset();
+  file.seekg(0, std::ios::end);
+  asset->content.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0, std::ios::beg);
+  file.read(asset->content.data(), asset->content.size());
+  asset->position = 0;
+  return asset;
+}
+
+AAssetDir* AAssetManager_openDir(AAssetManager* manager, const char* dirname) {
+  AAssetDir* dir = new AAssetDir();
+  dir->next = 0;
+  if (DIR* handle = opendir((manager->directory + "/" + dirname).c_str())) {
+    while (dirent* entry = readdir(handle)) {
+      if (entry->d_type == DT_REG) {
+        dir->names.push_back(entry->d_name);
+      }
+    }
+    closedir(handle);
+  }
+  return dir;
+}
+
+const char* AAssetDir_getNextFileName(AAssetDir* dir) {
+  return dir->next < dir->names.size() ? dir->names[dir->next++].c_str() : nullptr;
+}
+
+void AAssetDir_close(AAssetDir* dir) {
+  delete dir;
+}
+
+int AAsset_read(AAsset* asset, void* buffer, size_t count) {
+  size_t left = asset->content.size() - asset->position;
+  count = count < left ? count : left;
+  std::memcpy(buffer, asset->content.data() + asset->position, count);
+  asset->position += count;
+  return static_cast<int>(count);
+}
+
+const void* AAsset_getBuffer(AAsset* asset) {
+  return asset->content.data();
+}
+
+off_t AAsset_getLength(AAsset* asset) {
+  return static_cast<off_t>(asset->content.size());
+}
+
+void AAsset_close(AAsset* asset) {
+  delete asset;
+}
@@ -0,0 +1,37 @@
+#ifndef __ARKANOID_TESTS_HOST_ASSET_MANAGER__H__
+#define __ARKANOID_TESTS_HOST_ASSET_MANAGER__H__
+
+#include <sys/types.h>
+
+/**
+ * @file asset_manager.h
+ * @brief Subset of NDK asset manager which native core refers to,
+ * implemented on host over files within assets directory.
+ */
+
+struct AAssetManager;
+struct AAssetDir;
+struct AAsset;
+
+enum {
+  AASSET_MODE_UNKNOWN = 0,
+  AASSET_MODE_RANDOM = 1,
+  AASSET_MODE_STREAMING = 2,
+  AASSET_MODE_BUFFER = 3
+};
+
+AAsset* AAssetManager_open(AAssetManager* manager, const char* filename, int mode);
+AAssetDir* AAssetManager_openDir(AAssetManager* manager, const char* dirname);
+const char* AAssetDir_getNextFileName(AAssetDir* dir);
+void AAssetDir_close(AAssetDir* dir);
+int AAsset_read(AAsset* asset, void* buffer, size_t count);
+const void* AAsset_getBuffer(AAsset* asset);
+off_t AAsset_getLength(AAsset* asset);
+void AAsset_close(AAsset* asset);
+
+/// @brief Host only: creates manager serving files from @a directory,
+/// to be passed to AAssetManager_fromJava() in place of Java object.
+AAssetManager* AAssetManager_createHost(const char* directory);
+void AAssetManager_destroyHost(AAssetManager* manager);
+
+#endif  // __ARKANOID_TESTS_HOST_ASSET_MANAGER__H__
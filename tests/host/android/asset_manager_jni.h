@@ -0,0 +1,11 @@
+#ifndef __ARKANOID_TESTS_HOST_ASSET_MANAGER_JNI__H__
+#define __ARKANOID_TESTS_HOST_ASSET_MANAGER_JNI__H__
+
+#include <jni.h>
+
+#include "asset_manager.h"
+
+/// @brief Host: @a assetManager is AAssetManager made by AAssetManager_createHost().
+AAssetManager* AAssetManager_fromJava(JNIEnv* env, jobject assetManager);
+
+#endif  // __ARKANOID_TESTS_HOST_ASSET_MANAGER_JNI__H__
@@ -0,0 +1,81 @@
+#ifndef __ARKANOID_TESTS_HOST_JNI__H__
+#define __ARKANOID_TESTS_HOST_JNI__H__
+
+#include <cstdint>
+
+/**
+ * @file jni.h
+ * @brief Subset of JNI which native core refers to, so that it could be
+ * built and run on host without Java. Calls into Java are no-ops.
+ */
+
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef int8_t jbyte;
+typedef uint8_t jboolean;
+typedef uint16_t jchar;
+typedef int16_t jshort;
+typedef float jfloat;
+typedef double jdouble;
+typedef jint jsize;
+
+class _jobject {};
+class _jclass : public _jobject {};
+/// @brief Host only: string is passed to native core as UTF-8 in place of Java one.
+class _jstring : public _jobject {
+public:
+  explicit _jstring(const char* utf = "") : utf(utf) {}
+  const char* utf;
+};
+class _jarray : public _jobject {};
+class _jbyteArray : public _jarray {};
+
+typedef _jobject* jobject;
+typedef _jclass* jclass;
+typedef _jstring* jstring;
+typedef _jarray* jarray;
+typedef _jbyteArray* jbyteArray;
+
+struct _jmethodID;
+typedef _jmethodID* jmethodID;
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+#define JNI_OK 0
+#define JNI_ERR (-1)
+#define JNI_VERSION_1_6 0x00010006
+
+#define JNIEXPORT
+#define JNICALL
+
+struct JNIEnv {
+  void ExceptionDescribe() {}
+  jint ThrowNew(jclass, const char*) { return JNI_OK; }
+  jclass FindClass(const char*) { return nullptr; }
+  jclass GetObjectClass(jobject) { return nullptr; }
+  jmethodID GetMethodID(jclass, const char*, const char*) { return nullptr; }
+  jobject NewGlobalRef(jobject object) { return object; }
+  void DeleteGlobalRef(jobject) {}
+  void DeleteLocalRef(jobject) {}
+  jstring NewStringUTF(const char*) { return nullptr; }
+  const char* GetStringUTFChars(jstring string, jboolean*) { return string != nullptr ? string->utf : ""; }
+  void ReleaseStringUTFChars(jstring, const char*) {}
+  void CallVoidMethod(jobject, jmethodID, ...) {}
+};
+
+struct JavaVM {
+  jint AttachCurrentThread(JNIEnv** jenv, void*) {
+    *jenv = &m_jenv;
+    return JNI_OK;
+  }
+  jint DetachCurrentThread() { return JNI_OK; }
+  jint GetEnv(void** jenv, jint) {
+    *jenv = &m_jenv;
+    return JNI_OK;
+  }
+
+private:
+  JNIEnv m_jenv;
+};
+
+#endif  // __ARKANOID_TESTS_HOST_JNI__H__
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+using native::AssetPack;
+using native::AssetPackEntry;
+using native::AssetPackHeader;
+
+struct Asset {
+  std::string name;  //!< Relative to assets directory, e.g. "sound/bite_1.wav".
+  std::string path;
+  uint32_t hash;
+};
+
+/// @param path Directory on disk, files of which are packed as @a directory/<file>.
+static bool listDirectory(const std::string& path, const std::string& directory, std::vector<Asset>* assets) {
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    std::fprintf(stderr, "Failed to open directory: %s\n", path.c_str());
+    return false;
+  }
+  while (dirent* item = readdir(dir)) {
+    if (item->d_name[0] == '.') {
+      continue;
+    }
+    Asset asset;
+    asset.name = directory + "/" + item->d_name;
+    asset.path = path + "/" + item->d_name;
+    asset.hash = AssetPack::hash(asset.name.c_str(), asset.name.length());
+    assets->push_back(asset);
+  }
+  closedir(dir);
+  return true;
+}
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* content) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  content->resize(std::ftell(file));
+  std::fseek(file, 0, SEEK_SET);
+  bool success = std::fread(content->data(), 1, content->size(), file) == content->size();
+  std::fclose(file);
+  return success;
+}
+
+static uint32_t alignUp(uint32_t value) {
+  return (value + AssetPack::pageSize - 1) / AssetPack::pageSize * AssetPack::pageSize;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    std::fprintf(stderr, "Usage: %s <assets directory> <output pack> <subdirectory>[=<generated directory>]...\n", argv[0]);
+    return 1;
+  }
+  std::string root = argv[1];
+  std::vector<Asset> assets;
+  for (int i = 3; i < argc; ++i) {
+    // generated assets, e.g. level=build/generated/level, are packed as if they were in assets directory
+    std::string directory = argv[i];
+    size_t separator = directory.find('=');
+    std::string path = separator != std::string::npos ? directory.substr(separator + 1) : root + "/" + directory;
+    if (!listDirectory(path, directory.substr(0, separator), &assets)) {
+      return 1;
+    }
+  }
+  std::sort(assets.begin(), assets.end(), [](const Asset& lhs, const Asset& rhs) {
+    return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.name < rhs.name;
+  });
+
+  AssetPackHeader header;
+  std::memcpy(header.magic, "ARKP", 4);
+  header.version = AssetPack::version;
+  header.count = static_cast<uint32_t>(assets.size());
+  header.index_offset = sizeof(AssetPackHeader);
+  header.names_offset = header.index_offset + header.count * sizeof(AssetPackEntry);
+  header.page_size = AssetPack::pageSize;
+
+  std::string names;
+  std::vector<AssetPackEntry> index(assets.size());
+  std::vector<std::vector<uint8_t>> contents(assets.size());
+  for (size_t i = 0; i < assets.size(); ++i) {
+    if (!readFile(assets[i].path, &contents[i])) {
+      std::fprintf(stderr, "Failed to read asset: %s\n", assets[i].path.c_str());
+      return 1;
+    }
+    index[i].hash = assets[i].hash;
+    index[i].name_offset = static_cast<uint32_t>(names.size());
+    index[i].name_length = static_cast<uint32_t>(assets[i].name.size());
+    index[i].format = static_cast<uint32_t>(AssetPack::getFormat(assets[i].name));
+    index[i].size = static_cast<uint32_t>(contents[i].size());
+    names += assets[i].name;
+  }
+  uint32_t offset = alignUp(header.names_offset + static_cast<uint32_t>(names.size()));
+  for (auto& entry : index) {
+    entry.offset = offset;
+    offset = alignUp(offset + entry.size);
+  }
+
+  FILE* output = std::fopen(argv[2], "wb");
+  if (output == nullptr) {
+    std::fprintf(stderr, "Failed to create pack: %s\n", argv[2]);
+    return 1;
+  }
+  std::fwrite(&header, sizeof(header), 1, output);
+  std::fwrite(index.data(), sizeof(AssetPackEntry), index.size(), output);
+  std::fwrite(names.data(), 1, names.size(), output);
+  for (size_t i = 0; i < assets.size(); ++i) {
+    // zero padding up to payload page
+    std::vector<uint8_t> padding(index[i].offset - std::ftell(output), 0);
+    std::fwrite(padding.data(), 1, padding.size(), output);
+    std::fwrite(contents[i].data(), 1, contents[i].size(), output);
+  }
+  bool success = std::ferror(output) == 0;
+  std::fclose(output);
+  std::printf("Packed %zu assets into %s\n", assets.size(), argv[2]);
+  return success ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstring>
+
+#include "LevelPack.h"
+#include "LevelPackWriter.h"
+
+using game::LevelEncoding;
+using game::LevelPack;
+using game::LevelPackHeader;
+using game::LevelRecord;
+
+namespace tools {
+
+std::vector<uint8_t> encodeRLE(const std::vector<uint8_t>& cells) {
+  std::vector<uint8_t> output;
+  for (size_t i = 0; i < cells.size();) {
+    size_t run = 1;
+    while (i + run < cells.size() && run < 255 && cells[i + run] == cells[i]) {
+      ++run;
+    }
+    output.push_back(static_cast<uint8_t>(run));
+    output.push_back(cells[i]);
+    i += run;
+  }
+  return output;
+}
+
+template <typename T>
+static void append(const T& value, std::vector<uint8_t>* output) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  output->insert(output->end(), bytes, bytes + sizeof(T));
+}
+
+size_t writeLevelPack(const std::vector<std::vector<std::string>>& levels, std::vector<uint8_t>* pack) {
+  std::vector<uint8_t> payload;
+  std::vector<uint32_t> table;
+  LevelPackHeader header;
+  std::memcpy(header.magic, "ARKL", 4);
+  header.version = LevelPack::version;
+  header.count = static_cast<uint32_t>(levels.size());
+  header.table_offset = sizeof(LevelPackHeader);
+  uint32_t payload_offset = header.table_offset + (header.count + 1) * sizeof(uint32_t);
+  size_t raw_size = 0;
+
+  for (auto& rows : levels) {
+    size_t cols = 0;
+    for (auto& row : rows) {
+      cols = std::max(cols, row.length());
+    }
+    std::vector<uint8_t> cells(rows.size() * cols, ' ');
+    for (size_t r = 0; r < rows.size(); ++r) {
+      std::copy(rows[r].begin(), rows[r].end(), cells.begin() + r * cols);
+    }
+    std::vector<uint8_t> rle = encodeRLE(cells);
+    bool use_rle = rle.size() < cells.size();
+
+    LevelRecord record;
+    record.rows = static_cast<uint8_t>(rows.size());
+    record.cols = static_cast<uint8_t>(cols);
+    record.encoding = static_cast<uint8_t>(use_rle ? LevelEncoding::RLE : LevelEncoding::RAW);
+    record.reserved = 0;
+    record.checksum = LevelPack::checksum(cells.data(), cells.size());
+
+    table.push_back(payload_offset + static_cast<uint32_t>(payload.size()));
+    append(record, &payload);
+    const auto& encoded = use_rle ? rle : cells;
+    payload.insert(payload.end(), encoded.begin(), encoded.end());
+    raw_size += cells.size();
+  }
+  table.push_back(payload_offset + static_cast<uint32_t>(payload.size()));
+
+  pack->clear();
+  append(header, pack);
+  for (uint32_t offset : table) {
+    append(offset, pack);
+  }
+  pack->insert(pack->end(), payload.begin(), payload.end());
+  return raw_size;
+}
+
+}
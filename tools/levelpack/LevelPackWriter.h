@@ -0,0 +1,22 @@
+#ifndef __ARKANOID_LEVEL_PACK_WRITER__H__
+#define __ARKANOID_LEVEL_PACK_WRITER__H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tools {
+
+/// @brief Encodes cells as pairs of run length (1 - 255) and character, see LevelEncoding::RLE.
+std::vector<uint8_t> encodeRLE(const std::vector<uint8_t>& cells);
+
+/// @brief Packs levels, given as rows of level strings, into format read by game::LevelPack.
+/// @details Shorter rows are padded with blank cells, as by Level::fromStringArray().
+/// Every level is encoded with RLE if that makes it smaller.
+/// @note Levels must have 1 - 255 rows and at most 255 columns.
+/// @return Total size of level cells before encoding.
+size_t writeLevelPack(const std::vector<std::vector<std::string>>& levels, std::vector<uint8_t>* pack);
+
+}
+
+#endif  // __ARKANOID_LEVEL_PACK_WRITER__H__
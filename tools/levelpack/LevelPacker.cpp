@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LevelPackWriter.h"
+
+/// @brief Removes comments, keeping string literals intact.
+static std::string stripComments(const std::string& source) {
+  std::string output;
+  output.reserve(source.size());
+  bool in_string = false;
+  for (size_t i = 0; i < source.size(); ++i) {
+    char ch = source[i];
+    if (in_string) {
+      output += ch;
+      if (ch == '\\' && i + 1 < source.size()) {
+        output += source[++i];
+      } else if (ch == '"') {
+        in_string = false;
+      }
+    } else if (ch == '"') {
+      in_string = true;
+      output += ch;
+    } else if (source.compare(i, 2, "//") == 0) {
+      i = source.find('\n', i);
+      if (i == std::string::npos) break;
+      output += '\n';
+    } else if (source.compare(i, 2, "/*") == 0) {
+      i = source.find("*/", i + 2);
+      if (i == std::string::npos) break;
+      ++i;
+    } else {
+      output += ch;
+    }
+  }
+  return output;
+}
+
+/// @brief Level strings by name of Java constant, e.g. "L0".
+static std::map<std::string, std::vector<std::string>> parseLevels(const std::string& source) {
+  std::map<std::string, std::vector<std::string>> levels;
+  std::regex declaration(R"(String\s*\[\]\s*(\w+)\s*=\s*new\s+String\s*\[\]\s*\{([^}]*)\})");
+  std::regex literal(R"("((?:[^"\\]|\\.)*)\")");
+  for (std::sregex_iterator it(source.begin(), source.end(), declaration), end; it != end; ++it) {
+    std::string body = (*it)[2];
+    std::vector<std::string> rows;
+    for (std::sregex_iterator row(body.begin(), body.end(), literal); row != end; ++row) {
+      rows.push_back((*row)[1]);
+    }
+    levels[(*it)[1]] = rows;
+  }
+  return levels;
+}
+
+/// @brief Names of levels in order of 'levels' array.
+static std::vector<std::string> parseOrder(const std::string& source) {
+  std::vector<std::string> order;
+  std::smatch match;
+  if (std::regex_search(source, match, std::regex(R"(String\s*\[\]\s*\[\]\s*levels\s*=\s*\{([^}]*)\})"))) {
+    std::string body = match[1];
+    std::regex name(R"(\w+)");
+    for (std::sregex_iterator it(body.begin(), body.end(), name), end; it != end; ++it) {
+      order.push_back(it->str());
+    }
+  }
+  return order;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "Usage: %s <Levels.java> <output pack>\n", argv[0]);
+    return 1;
+  }
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::fprintf(stderr, "Failed to open levels: %s\n", argv[1]);
+    return 1;
+  }
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  std::string source = stripComments(buffer.str());
+  auto levels = parseLevels(source);
+  auto order = parseOrder(source);
+  if (order.empty()) {
+    std::fprintf(stderr, "No levels array found in %s\n", argv[1]);
+    return 1;
+  }
+
+  std::vector<std::vector<std::string>> packed;
+  for (auto& name : order) {
+    auto it = levels.find(name);
+    if (it == levels.end() || it->second.empty()) {
+      std::fprintf(stderr, "Level %s is not defined\n", name.c_str());
+      return 1;
+    }
+    size_t cols = 0;
+    for (auto& row : it->second) {
+      cols = std::max(cols, row.length());
+    }
+    if (it->second.size() > 255 || cols > 255) {
+      std::fprintf(stderr, "Level %s is too large\n", name.c_str());
+      return 1;
+    }
+    packed.push_back(it->second);
+  }
+  std::vector<uint8_t> pack;
+  size_t raw_size = tools::writeLevelPack(packed, &pack);
+
+  FILE* output = std::fopen(argv[2], "wb");
+  if (output == nullptr) {
+    std::fprintf(stderr, "Failed to create pack: %s\n", argv[2]);
+    return 1;
+  }
+  std::fwrite(pack.data(), 1, pack.size(), output);
+  bool success = std::ferror(output) == 0;
+  std::fclose(output);
+  std::printf("Packed %zu levels into %s: %zu bytes of cells, %zu bytes packed\n",
+      packed.size(), argv[2], raw_size, pack.size());
+  return success ? 0 : 1;
+}
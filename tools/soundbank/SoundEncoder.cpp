@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include "ImaAdpcm.h"
+#include "RiffReader.h"
+#include "SampleConverter.h"
+
+using native::ImaAdpcm;
+using native::PCMFormat;
+using native::RiffError;
+
+static constexpr uint32_t outputSampleRate = 44100;  //!< SoundBuffer::outputSampleRate.
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* content) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  content->resize(std::ftell(file));
+  std::fseek(file, 0, SEEK_SET);
+  bool success = std::fread(content->data(), 1, content->size(), file) == content->size();
+  std::fclose(file);
+  return success;
+}
+
+/// @brief Writes file atomically, so that interrupted build leaves no partial sound.
+static bool writeFile(const std::string& path, const std::vector<uint8_t>& content) {
+  std::string temp_path = path + ".tmp";
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool success = std::fwrite(content.data(), 1, content.size(), file) == content.size();
+  success = (std::fclose(file) == 0) && success;
+  if (!success || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+/// @brief Encodes WAV file into IMA-ADPCM one.
+/// @return FALSE if file isn't valid WAV or has unsupported format.
+static bool encode(const std::vector<uint8_t>& input, std::vector<uint8_t>* output) {
+  PCMFormat format;
+  const uint8_t* pcm = nullptr;
+  size_t pcm_size = 0;
+  RiffError error = native::parseWAV(input.data(), input.size(), &format, &pcm, &pcm_size);
+  if (error != RiffError::NONE) {
+    std::fprintf(stderr, "  %s\n", native::toString(error));
+    return false;
+  }
+  if (format.audio_format == native::WAVE_FORMAT_IMA_ADPCM) {
+    if (format.channels != 1 || format.sample_rate != outputSampleRate) {
+      std::fprintf(stderr, "  IMA-ADPCM isn't mono at %u Hz\n", outputSampleRate);
+      return false;
+    }
+    *output = input;  // already encoded
+    return true;
+  }
+
+  std::vector<int16_t> samples(native::getConvertedFrames(pcm_size, format, outputSampleRate));
+  if (samples.empty()) {
+    std::fprintf(stderr, "  no samples\n");
+    return false;
+  }
+  native::convertToMono16(pcm, pcm_size, format, outputSampleRate, &samples[0]);
+
+  PCMFormat encoded;
+  encoded.audio_format = native::WAVE_FORMAT_IMA_ADPCM;
+  encoded.channels = 1;
+  encoded.sample_rate = outputSampleRate;
+  encoded.block_align = ImaAdpcm::defaultBlockAlign;
+  encoded.bits_per_sample = 4;
+  size_t header_size = native::getWAVHeaderSize(encoded);
+  size_t data_size = ImaAdpcm::getEncodedSize(samples.size(), encoded.block_align);
+  output->resize(header_size + data_size);
+  data_size = ImaAdpcm::encode(&samples[0], samples.size(), encoded.block_align, &(*output)[header_size]);
+  output->resize(header_size + data_size);
+  native::writeWAVHeader(encoded, static_cast<uint32_t>(data_size), &(*output)[0]);
+  return true;
+}
+
+static bool hasSuffix(const std::string& name, const char* suffix) {
+  size_t length = std::strlen(suffix);
+  return name.length() >= length && name.compare(name.length() - length, length, suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s <input directory> <output directory>\n", argv[0]);
+    return 1;
+  }
+  std::string input_directory = argv[1];
+  std::string output_directory = argv[2];
+  DIR* dir = opendir(input_directory.c_str());
+  if (dir == nullptr) {
+    std::fprintf(stderr, "Failed to open directory: %s\n", input_directory.c_str());
+    return 1;
+  }
+  std::vector<std::string> names;
+  while (dirent* item = readdir(dir)) {
+    if (item->d_name[0] != '.' && hasSuffix(item->d_name, ".wav")) {
+      names.push_back(item->d_name);
+    }
+  }
+  closedir(dir);
+
+  size_t total_input = 0, total_output = 0;
+  int failed = 0;
+  for (auto& name : names) {
+    std::vector<uint8_t> input, output;
+    if (!readFile(input_directory + "/" + name, &input)) {
+      std::fprintf(stderr, "Failed to read %s\n", name.c_str());
+      ++failed;
+      continue;
+    }
+    if (!encode(input, &output)) {
+      std::fprintf(stderr, "Failed to encode %s\n", name.c_str());
+      ++failed;
+      continue;
+    }
+    if (!writeFile(output_directory + "/" + name, output)) {
+      std::fprintf(stderr, "Failed to write %s\n", name.c_str());
+      ++failed;
+      continue;
+    }
+    total_input += input.size();
+    total_output += output.size();
+  }
+  std::printf("Encoded %zu sounds: %zu KB -> %zu KB\n", names.size() - failed, total_input >> 10, total_output >> 10);
+  return failed == 0 ? 0 : 1;
+}